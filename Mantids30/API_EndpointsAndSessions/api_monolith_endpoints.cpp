@@ -27,7 +27,8 @@ bool Endpoints::addEndpoint(const EndpointDefinition &endpointDefinition)
     return false; // Endpoint with given name already exists, cannot add
 }
 
-Endpoints::StatusCode Endpoints::invoke(const std::shared_ptr<Mantids30::Sessions::Session> &session, const std::string &endpointName, const Json::Value &payload, Json::Value *payloadOut)
+Endpoints::StatusCode Endpoints::invoke(const std::shared_ptr<Mantids30::Sessions::Session> &session, const std::string &endpointName, const Json::Value &payload, Json::Value *payloadOut,
+                                       const std::shared_ptr<Memory::Containers::B_Chunks> &inputStream, Memory::Containers::B_Chunks *outputStream)
 {
     // Checks if endpoint with given name exists in endpoints map
     if (m_endpoints.find(endpointName) == m_endpoints.end())
@@ -37,7 +38,15 @@ Endpoints::StatusCode Endpoints::invoke(const std::shared_ptr<Mantids30::Session
     else
     {
         // Invokes the specified endpoint and stores result in payloadOut
-        *payloadOut = m_endpoints[endpointName].endpoint(m_endpoints[endpointName].context, session, payload);
+        const MonolithAPIEndpointFunction &endpointFunction = m_endpoints[endpointName];
+        if (endpointFunction.streamEndpoint)
+        {
+            *payloadOut = endpointFunction.streamEndpoint(endpointFunction.context, session, payload, inputStream, outputStream);
+        }
+        else
+        {
+            *payloadOut = endpointFunction.endpoint(endpointFunction.context, session, payload);
+        }
 
         // If configured, updates the last activity time for the session associated with this invocation
         if (m_endpointUpdateSessionLastActivityOnUsage[endpointName])
@@ -6,6 +6,7 @@
 #include "endpoints_options.h"
 #include "endpoints_requirements_map.h"
 #include <Mantids30/Helpers/json.h>
+#include <Mantids30/Memory/b_chunks.h>
 
 #include <memory>
 #include <string>
@@ -45,6 +46,15 @@ public:
          * @brief Context object to pass to the function pointer.
          */
         void *context;
+
+        /**
+         * @brief Optional streaming variant of the endpoint (called instead of endpoint when defined).
+         *        inputStream is the byte stream sent by the caller (nullptr if none), and the content written into outputStream is
+         *        streamed back to the caller (nullptr if the caller can't receive streams).
+         */
+        Json::Value (*streamEndpoint)(void *context, const std::shared_ptr<Mantids30::Sessions::Session> &session, const Json::Value &parameters,
+                                      const std::shared_ptr<Memory::Containers::B_Chunks> &inputStream, Memory::Containers::B_Chunks *outputStream)
+            = nullptr;
     };
 
     /**
@@ -85,9 +95,12 @@ public:
      * @param endpointName Name of the endpoint to invoke
      * @param payload JSON payload containing parameters for the endpoint
      * @param payloadOut Pointer to store the output JSON from the endpoint
+     * @param inputStream (Optional) Input byte stream for streaming endpoints
+     * @param outputStream (Optional) Output byte stream for streaming endpoints
      * @return int Return code indicating success or failure
      */
-    [[nodiscard]] StatusCode invoke(const std::shared_ptr<Sessions::Session> &session, const std::string &endpointName, const Json::Value &payload, Json::Value *payloadOut);
+    [[nodiscard]] StatusCode invoke(const std::shared_ptr<Sessions::Session> &session, const std::string &endpointName, const Json::Value &payload, Json::Value *payloadOut,
+                                    const std::shared_ptr<Memory::Containers::B_Chunks> &inputStream = nullptr, Memory::Containers::B_Chunks *outputStream = nullptr);
 
     /**
      * @brief Validate endpoint requirements
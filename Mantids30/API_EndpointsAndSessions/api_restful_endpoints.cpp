@@ -22,26 +22,11 @@ bool Endpoints::addEndpoint(const HTTP::Method &httpMethodType, const std::strin
 
 bool Endpoints::addEndpoint(const HTTP::Method &httpMethodType, const std::string &endpointPath, const RESTfulAPIEndpointFullDefinition &apiEndpointFullDefinition)
 {
-    switch (httpMethodType)
+    if (!m_router.addRoute(httpMethodType, endpointPath, m_endpoints.size()))
     {
-    case HTTP::Method::GET:
-        m_endpointsGET[endpointPath] = apiEndpointFullDefinition;
-        break;
-    case HTTP::Method::POST:
-        m_endpointsPOST[endpointPath] = apiEndpointFullDefinition;
-        break;
-    case HTTP::Method::PUT:
-        m_endpointsPUT[endpointPath] = apiEndpointFullDefinition;
-        break;
-    case HTTP::Method::DELETE:
-        m_endpointsDELETE[endpointPath] = apiEndpointFullDefinition;
-        break;
-    case HTTP::Method::PATCH:
-        m_endpointsPATCH[endpointPath] = apiEndpointFullDefinition;
-        break;
-    default:
         return false;
     }
+    m_endpoints.push_back(apiEndpointFullDefinition);
 
     return true;
 }
@@ -58,47 +43,9 @@ Sessions::ClientDetails Endpoints::extractClientDetails(const RequestContext &re
 Endpoints::HandleResult Endpoints::handleEndpoint(const HTTP::Method &httpMethodType, const std::string &endpointPath, RESTful::RequestContext &requestContext,
                                                   const std::set<std::string> &currentScopes, bool isAdmin, const API::Security::ReceivedAuth &securityParameters, APIReturn *apiResponse)
 {
-    RESTfulAPIEndpointFullDefinition endpointFullDefinition;
-    std::map<std::string, RESTfulAPIEndpointFullDefinition>::iterator it = m_endpointsGET.end();
-
-    switch (httpMethodType)
+    if (httpMethodType != HTTP::Method::GET && httpMethodType != HTTP::Method::POST && httpMethodType != HTTP::Method::PUT && httpMethodType != HTTP::Method::DELETE
+        && httpMethodType != HTTP::Method::PATCH)
     {
-    case HTTP::Method::GET:
-        it = m_endpointsGET.find(endpointPath);
-        if (it != m_endpointsGET.end())
-        {
-            endpointFullDefinition = it->second;
-        }
-        break;
-    case HTTP::Method::POST:
-        it = m_endpointsPOST.find(endpointPath);
-        if (it != m_endpointsPOST.end())
-        {
-            endpointFullDefinition = it->second;
-        }
-        break;
-    case HTTP::Method::PUT:
-        it = m_endpointsPUT.find(endpointPath);
-        if (it != m_endpointsPUT.end())
-        {
-            endpointFullDefinition = it->second;
-        }
-        break;
-    case HTTP::Method::DELETE:
-        it = m_endpointsDELETE.find(endpointPath);
-        if (it != m_endpointsDELETE.end())
-        {
-            endpointFullDefinition = it->second;
-        }
-        break;
-    case HTTP::Method::PATCH:
-        it = m_endpointsPATCH.find(endpointPath);
-        if (it != m_endpointsPATCH.end())
-        {
-            endpointFullDefinition = it->second;
-        }
-        break;
-    default:
         if (apiResponse != nullptr)
         {
             apiResponse->setError(HTTP::Status::Code::S_400_BAD_REQUEST, "invalid_invokation", "Invalid Method Mode");
@@ -106,6 +53,10 @@ Endpoints::HandleResult Endpoints::handleEndpoint(const HTTP::Method &httpMethod
         return HandleResult::INVALID_METHOD_MODE;
     }
 
+    std::optional<size_t> routeId = m_router.match(httpMethodType, endpointPath, requestContext.pathParameters);
+    static const RESTfulAPIEndpointFullDefinition notFoundDefinition;
+    const RESTfulAPIEndpointFullDefinition &endpointFullDefinition = routeId ? m_endpoints[*routeId] : notFoundDefinition;
+
     if (endpointFullDefinition.endpointDefinition == nullptr)
     {
         if (apiResponse != nullptr)
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "api_restful_router.h"
 #include "endpoints_options.h"
 
 #include "security.h"
@@ -32,6 +33,8 @@ struct RequestContext
 
     std::shared_ptr<DataFormat::JWT> jwtValidator; ///< Holds the JWT Validator
     std::shared_ptr<DataFormat::JWT> jwtSigner;    ///< Holds the JWT Signer
+
+    PathParameters pathParameters; ///< Holds the parameters captured from the endpoint path (eg. id for "users/{id:uint}").
 };
 
 using APIEndpointFunctionType = APIReturn (*)(void *context,                                        // Context pointer
@@ -98,7 +101,7 @@ public:
      * @brief Add a new resource to the Endpoints with RESTfulAPIDefinition struct.
      *
      * @param httpMethodType The RESTful apiEndpointFullDefinition httpMethodType (GET, POST, PUT, DELETE).
-     * @param endpointPath The name of the resource.
+     * @param endpointPath The name of the resource, may contain path parameters (eg. "users/{id:uint}", "files/{path*}", see Router).
      * @param apiEndpointFullDefinition The RESTfulAPIDefinition struct containing apiEndpointFullDefinition, security, and object pointer.
      * @return Returns true if the resource was added successfully, false otherwise.
      */
@@ -133,11 +136,8 @@ public:
                                               const std::set<std::string> &currentScopes, bool isAdmin, const API::Security::ReceivedAuth &securityParameters, APIReturn *payloadOut);
 
 private:
-    std::map<std::string, RESTfulAPIEndpointFullDefinition> m_endpointsPATCH;  ///< Map of PATCH endpoints.
-    std::map<std::string, RESTfulAPIEndpointFullDefinition> m_endpointsGET;    ///< Map of GET endpoints.
-    std::map<std::string, RESTfulAPIEndpointFullDefinition> m_endpointsPOST;   ///< Map of POST endpoints.
-    std::map<std::string, RESTfulAPIEndpointFullDefinition> m_endpointsPUT;    ///< Map of PUT endpoints.
-    std::map<std::string, RESTfulAPIEndpointFullDefinition> m_endpointsDELETE; ///< Map of DELETE endpoints.
+    std::vector<RESTfulAPIEndpointFullDefinition> m_endpoints; ///< Endpoint definitions (indexed by the router id).
+    Router m_router;                                           ///< Router for all the methods and endpoint paths.
 
     Sessions::ClientDetails extractClientDetails(const RequestContext &requestContext);
 };
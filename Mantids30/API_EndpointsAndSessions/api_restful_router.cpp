@@ -0,0 +1,326 @@
+#include "api_restful_router.h"
+
+#include <limits>
+
+using namespace Mantids30;
+using namespace Mantids30::Network::Protocol;
+using namespace API::RESTful;
+
+std::optional<std::string_view> PathParameters::get(const std::string_view &name) const
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (parameters[i].first == name)
+        {
+            return parameters[i].second;
+        }
+    }
+    return std::nullopt;
+}
+
+// Parse a decimal number, std::nullopt if it's not a number or overflows.
+static std::optional<uint64_t> parseUInt64(const std::string_view &value)
+{
+    if (value.empty())
+    {
+        return std::nullopt;
+    }
+
+    uint64_t r = 0;
+    for (const char &c : value)
+    {
+        if (c < '0' || c > '9')
+        {
+            return std::nullopt;
+        }
+        uint64_t digit = static_cast<uint64_t>(c - '0');
+        if (r > (std::numeric_limits<uint64_t>::max() - digit) / 10)
+        {
+            return std::nullopt;
+        }
+        r = r * 10 + digit;
+    }
+    return r;
+}
+
+std::optional<uint64_t> PathParameters::getAsUInt64(const std::string_view &name) const
+{
+    std::optional<std::string_view> value = get(name);
+    if (!value)
+    {
+        return std::nullopt;
+    }
+    return parseUInt64(*value);
+}
+
+std::optional<int64_t> PathParameters::getAsInt64(const std::string_view &name) const
+{
+    std::optional<std::string_view> value = get(name);
+    if (!value || value->empty())
+    {
+        return std::nullopt;
+    }
+
+    bool negative = value->front() == '-';
+    std::optional<uint64_t> magnitude = parseUInt64(negative ? value->substr(1) : *value);
+    if (!magnitude)
+    {
+        return std::nullopt;
+    }
+
+    if (negative)
+    {
+        if (*magnitude > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) + 1)
+        {
+            return std::nullopt;
+        }
+        return static_cast<int64_t>(0 - *magnitude);
+    }
+
+    if (*magnitude > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))
+    {
+        return std::nullopt;
+    }
+    return static_cast<int64_t>(*magnitude);
+}
+
+Router::Router()
+    : m_root(std::make_unique<Node>())
+{}
+
+Router::~Router() = default;
+
+bool Router::isPattern(const std::string_view &path)
+{
+    return path.find('{') != std::string_view::npos;
+}
+
+bool Router::addRoute(const HTTP::Method &method, const std::string &pattern, const size_t &routeId)
+{
+    size_t methodIndex = static_cast<size_t>(method);
+    if (methodIndex >= METHODS_COUNT || routeId == NO_ROUTE)
+    {
+        return false;
+    }
+
+    Node *node = m_root.get();
+    std::string_view remaining = pattern;
+    size_t parametersCount = 0;
+
+    while (!remaining.empty())
+    {
+        size_t braceStart = remaining.find('{');
+        if (braceStart != 0)
+        {
+            // Static text until the next parameter (or the end):
+            std::string_view staticText = remaining.substr(0, braceStart);
+            if (staticText.find('}') != std::string_view::npos)
+            {
+                return false;
+            }
+            node = insertStatic(node, staticText);
+            remaining.remove_prefix(staticText.size());
+            continue;
+        }
+
+        // Parameters should take the whole segment: "{name}" or "{name:type}" or "{name*}"
+        size_t braceEnd = remaining.find('}');
+        if (braceEnd == std::string_view::npos || (braceEnd + 1 < remaining.size() && remaining[braceEnd + 1] != '/'))
+        {
+            return false;
+        }
+        if (node != m_root.get() && (node->prefix.empty() || node->prefix.back() != '/'))
+        {
+            // The parameter is in the middle of a static segment (eg. "user{id}")
+            return false;
+        }
+        if (++parametersCount > PathParameters::MAX_PARAMETERS)
+        {
+            return false;
+        }
+
+        std::string_view spec = remaining.substr(1, braceEnd - 1);
+        remaining.remove_prefix(braceEnd + 1);
+
+        bool isWildcard = !spec.empty() && spec.back() == '*';
+        if (isWildcard)
+        {
+            spec.remove_suffix(1);
+        }
+
+        ParameterType parameterType = ParameterType::STRING;
+        size_t colonPos = spec.find(':');
+        std::string_view parameterName = spec.substr(0, colonPos);
+        if (colonPos != std::string_view::npos)
+        {
+            std::string_view typeName = spec.substr(colonPos + 1);
+            if (typeName == "int")
+                parameterType = ParameterType::INT;
+            else if (typeName == "uint")
+                parameterType = ParameterType::UINT;
+            else if (typeName == "hex")
+                parameterType = ParameterType::HEX;
+            else if (typeName != "string")
+                return false;
+        }
+
+        if (parameterName.empty() || (isWildcard && (!remaining.empty() || colonPos != std::string_view::npos)))
+        {
+            return false;
+        }
+
+        std::unique_ptr<Node> &child = isWildcard ? node->wildcardChild : node->parameterChild;
+        if (!child)
+        {
+            child = std::make_unique<Node>();
+            child->parameterName = parameterName;
+            child->parameterType = parameterType;
+        }
+        else if (child->parameterName != parameterName || child->parameterType != parameterType)
+        {
+            // Another parameter definition in the same position (ambiguous).
+            return false;
+        }
+        node = child.get();
+    }
+
+    node->routes[methodIndex] = routeId;
+    return true;
+}
+
+std::optional<size_t> Router::match(const HTTP::Method &method, const std::string_view &path, PathParameters &parameters) const
+{
+    parameters.clear();
+
+    size_t methodIndex = static_cast<size_t>(method);
+    if (methodIndex >= METHODS_COUNT)
+    {
+        return std::nullopt;
+    }
+
+    size_t routeId = matchNode(m_root.get(), methodIndex, path, parameters);
+    if (routeId == NO_ROUTE)
+    {
+        parameters.clear();
+        return std::nullopt;
+    }
+    return routeId;
+}
+
+Router::Node *Router::insertStatic(Node *node, std::string_view text)
+{
+    while (!text.empty())
+    {
+        std::unique_ptr<Node> *selectedChild = nullptr;
+        for (std::unique_ptr<Node> &child : node->staticChildren)
+        {
+            if (child->prefix.front() == text.front())
+            {
+                selectedChild = &child;
+                break;
+            }
+        }
+
+        if (selectedChild == nullptr)
+        {
+            node->staticChildren.push_back(std::make_unique<Node>());
+            node->staticChildren.back()->prefix = text;
+            return node->staticChildren.back().get();
+        }
+
+        // Common prefix length:
+        std::string &childPrefix = (*selectedChild)->prefix;
+        size_t commonLength = 0;
+        while (commonLength < childPrefix.size() && commonLength < text.size() && childPrefix[commonLength] == text[commonLength])
+        {
+            commonLength++;
+        }
+
+        if (commonLength < childPrefix.size())
+        {
+            // Split the child node:
+            std::unique_ptr<Node> splitNode = std::make_unique<Node>();
+            splitNode->prefix = childPrefix.substr(0, commonLength);
+            childPrefix.erase(0, commonLength);
+            splitNode->staticChildren.push_back(std::move(*selectedChild));
+            *selectedChild = std::move(splitNode);
+        }
+
+        node = selectedChild->get();
+        text.remove_prefix(commonLength);
+    }
+    return node;
+}
+
+bool Router::isValidParameterValue(const ParameterType &type, const std::string_view &value)
+{
+    switch (type)
+    {
+    case ParameterType::INT:
+    {
+        std::string_view digits = (!value.empty() && value.front() == '-') ? value.substr(1) : value;
+        return !digits.empty() && digits.find_first_not_of("0123456789") == std::string_view::npos;
+    }
+    case ParameterType::UINT:
+        return value.find_first_not_of("0123456789") == std::string_view::npos;
+    case ParameterType::HEX:
+        return value.find_first_not_of("0123456789abcdefABCDEF") == std::string_view::npos;
+    case ParameterType::STRING:
+    default:
+        return true;
+    }
+}
+
+size_t Router::matchNode(const Node *node, const size_t &methodIndex, std::string_view path, PathParameters &parameters)
+{
+    if (path.empty() && node->routes[methodIndex] != NO_ROUTE)
+    {
+        return node->routes[methodIndex];
+    }
+
+    // 1. Static children (only one can start with the same character):
+    if (!path.empty())
+    {
+        for (const std::unique_ptr<Node> &child : node->staticChildren)
+        {
+            if (child->prefix.front() != path.front())
+            {
+                continue;
+            }
+            if (path.compare(0, child->prefix.size(), child->prefix) == 0)
+            {
+                size_t routeId = matchNode(child.get(), methodIndex, path.substr(child->prefix.size()), parameters);
+                if (routeId != NO_ROUTE)
+                {
+                    return routeId;
+                }
+            }
+            break;
+        }
+    }
+
+    // 2. Parameter child (one non-empty segment):
+    if (node->parameterChild && !path.empty() && parameters.count < PathParameters::MAX_PARAMETERS)
+    {
+        std::string_view value = path.substr(0, path.find('/'));
+        if (!value.empty() && isValidParameterValue(node->parameterChild->parameterType, value))
+        {
+            parameters.parameters[parameters.count++] = {node->parameterChild->parameterName, value};
+            size_t routeId = matchNode(node->parameterChild.get(), methodIndex, path.substr(value.size()), parameters);
+            if (routeId != NO_ROUTE)
+            {
+                return routeId;
+            }
+            parameters.count--;
+        }
+    }
+
+    // 3. Wildcard child (the rest of the path):
+    if (node->wildcardChild && node->wildcardChild->routes[methodIndex] != NO_ROUTE && parameters.count < PathParameters::MAX_PARAMETERS)
+    {
+        parameters.parameters[parameters.count++] = {node->wildcardChild->parameterName, path};
+        return node->wildcardChild->routes[methodIndex];
+    }
+
+    return NO_ROUTE;
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <Mantids30/Protocol_HTTP/methods.h>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Mantids30::API::RESTful {
+
+/**
+ * @brief The PathParameters struct holds the parameters captured from the endpoint path (eg. id=123 for "users/{id:uint}").
+ *
+ * The names reference the router patterns and the values reference the requested path, so they are only valid while the
+ * request is being handled (nothing is allocated during the matching).
+ */
+struct PathParameters
+{
+    static constexpr size_t MAX_PARAMETERS = 16;
+
+    /**
+     * @brief get Get the parameter value
+     * @return the value, or std::nullopt if the parameter was not captured
+     */
+    [[nodiscard]] std::optional<std::string_view> get(const std::string_view &name) const;
+    /**
+     * @brief getAsInt64 Get the parameter value as a signed integer (std::nullopt if not captured or not a number)
+     */
+    [[nodiscard]] std::optional<int64_t> getAsInt64(const std::string_view &name) const;
+    /**
+     * @brief getAsUInt64 Get the parameter value as an unsigned integer (std::nullopt if not captured or not a number)
+     */
+    [[nodiscard]] std::optional<uint64_t> getAsUInt64(const std::string_view &name) const;
+
+    [[nodiscard]] size_t size() const { return count; }
+    void clear() { count = 0; }
+
+    std::array<std::pair<std::string_view, std::string_view>, MAX_PARAMETERS> parameters;
+    size_t count = 0;
+};
+
+/**
+ * @brief The Router class matches the endpoint paths against the registered patterns using a radix tree (one lookup per request).
+ *
+ * Pattern syntax (segments are separated by '/'):
+ *  - static text: "users/list"
+ *  - parameter: "{name}" or "{name:type}" with type string (default), int, uint or hex, captures one segment.
+ *  - wildcard: "{name*}" captures the rest of the path (only at the end of the pattern).
+ *
+ * Static text takes precedence over parameters, and parameters over wildcards. Routes are registered at startup (not
+ * thread-safe for modifications), matching is read-only and can be done concurrently.
+ */
+class Router
+{
+public:
+    enum class ParameterType : uint8_t
+    {
+        STRING,
+        INT,
+        UINT,
+        HEX
+    };
+
+    Router();
+    ~Router();
+
+    Router(const Router &) = delete;
+    Router &operator=(const Router &) = delete;
+
+    /**
+     * @brief addRoute Register a route
+     * @param method HTTP method
+     * @param pattern path pattern (eg. "users/{id:uint}/items")
+     * @param routeId value returned when the route matches
+     * @return false if the pattern is invalid or conflicts with a registered one (eg. same position with another parameter name/type)
+     * @note registering the same pattern/method again replaces the route id.
+     */
+    bool addRoute(const Network::Protocol::HTTP::Method &method, const std::string &pattern, const size_t &routeId);
+
+    /**
+     * @brief match Find the route for the path
+     * @param method HTTP method
+     * @param path requested endpoint path
+     * @param parameters output captured parameters (referencing the path)
+     * @return the route id, or std::nullopt if not found
+     */
+    [[nodiscard]] std::optional<size_t> match(const Network::Protocol::HTTP::Method &method, const std::string_view &path, PathParameters &parameters) const;
+
+    /**
+     * @brief isPattern Check if the path contains parameters/wildcards (otherwise it's a static path)
+     */
+    static bool isPattern(const std::string_view &path);
+
+private:
+    static constexpr size_t METHODS_COUNT = 5;
+    static constexpr size_t NO_ROUTE = static_cast<size_t>(-1);
+
+    struct Node
+    {
+        std::string prefix;
+        std::vector<std::unique_ptr<Node>> staticChildren;
+
+        // Parameter and wildcard children:
+        std::unique_ptr<Node> parameterChild;
+        std::unique_ptr<Node> wildcardChild;
+
+        // For parameter/wildcard nodes:
+        std::string parameterName;
+        ParameterType parameterType = ParameterType::STRING;
+
+        std::array<size_t, METHODS_COUNT> routes;
+
+        Node() { routes.fill(NO_ROUTE); }
+    };
+
+    static Node *insertStatic(Node *node, std::string_view text);
+    static bool isValidParameterValue(const ParameterType &type, const std::string_view &value);
+    static size_t matchNode(const Node *node, const size_t &methodIndex, std::string_view path, PathParameters &parameters);
+
+    std::unique_ptr<Node> m_root;
+};
+
+} // namespace Mantids30::API::RESTful
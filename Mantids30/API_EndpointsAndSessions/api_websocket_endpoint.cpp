@@ -4,7 +4,7 @@
 using namespace Mantids30::API::WebSocket;
 
 Endpoint::Endpoint()
-    : connectionsByIdMap(std::make_shared<Threads::Safe::Map<std::string>>())
+    : connectionsByIdMap(std::make_shared<Threads::Safe::ShardedMap<std::string>>())
 {}
 
 size_t Endpoint::getActiveUserConnectionsCount(const std::string &userId) const
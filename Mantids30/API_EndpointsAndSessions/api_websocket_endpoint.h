@@ -3,7 +3,7 @@
 #include "api_websocket_config.h"
 #include "session.h"
 #include <Mantids30/Protocol_HTTP/httpv1_server.h>
-#include <Mantids30/Threads/safe_map.h>
+#include <Mantids30/Threads/safe_shardedmap.h>
 
 #include <Mantids30/DataFormat_JWT/jwt.h>
 #include <Mantids30/Protocol_HTTP/websocket_eventtype.h>
@@ -67,7 +67,7 @@ public:
 
 private:
     // Private Members:
-    std::shared_ptr<Threads::Safe::Map<std::string>> connectionsByIdMap;
+    std::shared_ptr<Threads::Safe::ShardedMap<std::string>> connectionsByIdMap;
     Security security;
     Config **config = nullptr; // autofilled
     void *context = nullptr;
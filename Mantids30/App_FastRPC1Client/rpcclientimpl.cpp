@@ -35,9 +35,13 @@ void RPCClientImpl::runRPClient()
     std::string privKeyPath = Globals::getLC_TLSKeyFilePath();
     std::string pubCertPath = Globals::getLC_TLSCertFilePath();
 
+    // Reconnections to the C2 resume the previous TLS session (abbreviated handshake):
+    std::shared_ptr<Mantids30::Network::Sockets::Socket_TLS::ClientSessionCache> tlsSessionCache = std::make_shared<Mantids30::Network::Sockets::Socket_TLS::ClientSessionCache>();
+
     for (;;)
     {
         std::shared_ptr<Mantids30::Network::Sockets::Socket_TLS> sockRPCClient = std::make_shared<Mantids30::Network::Sockets::Socket_TLS>();
+        sockRPCClient->setClientSessionCache(tlsSessionCache);
 
         if (!Globals::getLC_C2UsePSK())
         {
@@ -184,7 +184,7 @@ std::shared_ptr<DataFormat::JWT> Mantids30::Program::Config::JWT::createJWTValid
                 return nullptr;
             }
         }
-        return createHMACJWT(log, algorithmDetails, hmacSecret, "validation");
+        return configureVerifiedTokensCache(createHMACJWT(log, algorithmDetails, hmacSecret, "validation"), ptr, configClassName);
     }
     else
     {
@@ -221,7 +221,7 @@ std::shared_ptr<DataFormat::JWT> Mantids30::Program::Config::JWT::createJWTValid
 
         std::shared_ptr<DataFormat::JWT> jwtValidator = std::make_shared<DataFormat::JWT>(algorithmDetails.algorithm);
         jwtValidator->setPublicSecret(publicKey);
-        return jwtValidator;
+        return configureVerifiedTokensCache(jwtValidator, ptr, configClassName);
     }
 }
 
@@ -345,6 +345,18 @@ std::string JWT::loadHMACSecret(Logs::AppLog *log, const std::string &hmacFilePa
     return hmacSecret;
 }
 
+std::shared_ptr<DataFormat::JWT> JWT::configureVerifiedTokensCache(std::shared_ptr<DataFormat::JWT> jwtValidator, const boost::property_tree::ptree &ptr,
+                                                                  const std::string &configClassName)
+{
+    size_t cacheMaxBytes = ptr.get<size_t>(configClassName + ".VerifiedTokensCacheMaxBytes", 0);
+    if (jwtValidator && cacheMaxBytes > 0)
+    {
+        jwtValidator->m_cache.setCacheMaxByteCount(cacheMaxBytes);
+        jwtValidator->m_cache.setEnabled(true);
+    }
+    return jwtValidator;
+}
+
 std::shared_ptr<DataFormat::JWT> JWT::createHMACJWT(Logs::AppLog *log, const DataFormat::JWT::AlgorithmDetails &algorithmDetails, const std::string &hmacSecret, const std::string &purpose)
 {
     if (hmacSecret.empty())
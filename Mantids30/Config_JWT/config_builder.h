@@ -43,6 +43,16 @@ public:
     static std::shared_ptr<DataFormat::JWT> createJWTValidator(Program::Logs::AppLog *log, const std::string &algorithm, const std::string &key);
 
 private:
+    /**
+     * @brief Enables the verified token cache of a validator when configured (<configClassName>.VerifiedTokensCacheMaxBytes > 0)
+     * @param jwtValidator JWT validator instance (can be nullptr)
+     * @param ptr Configuration property tree
+     * @param configClassName Configuration class name prefix
+     * @return the same validator instance
+     */
+    static std::shared_ptr<DataFormat::JWT> configureVerifiedTokensCache(std::shared_ptr<DataFormat::JWT> jwtValidator, const boost::property_tree::ptree &ptr,
+                                                                         const std::string &configClassName);
+
     static bool createHMACSecret(Program::Logs::AppLog *log, const std::string &filePath);
     static bool createRSASecret(Program::Logs::AppLog *log, const std::string &keyPath, const std::string &crtPath, uint16_t keySize = 4096);
 
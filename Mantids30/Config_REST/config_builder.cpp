@@ -6,6 +6,7 @@
 
 #include <Mantids30/Net_Sockets/socket_tcp.h>
 #include <Mantids30/Net_Sockets/socket_tls.h>
+#include <algorithm>
 #include <cinttypes>
 #include <memory>
 
@@ -55,17 +56,32 @@ static std::shared_ptr<Mantids30::Network::Sockets::Socket_Stream> createListene
     {
         std::shared_ptr<Sockets::Socket_TLS> tlsSocket = std::make_shared<Sockets::Socket_TLS>();
         tlsSocket->tlsKeys.setSecurityLevel(-1);
+        tlsSocket->tlsKeys.setUseKernelTLS(listenerConfig.get<bool>("TLS.KernelTLS", false));
+        tlsSocket->tlsKeys.setSessionCacheSize(listenerConfig.get<size_t>("TLS.SessionCacheSize", 20480));
+        tlsSocket->tlsKeys.setSessionTimeout(listenerConfig.get<uint32_t>("TLS.SessionTimeout", 3600));
+        tlsSocket->tlsKeys.setUseSessionTickets(listenerConfig.get<bool>("TLS.SessionTickets", true));
+        tlsSocket->tlsKeys.setTicketKeyRotationInterval(listenerConfig.get<uint32_t>("TLS.TicketKeyRotationInterval", 3600));
 
-        if (!tlsSocket->tlsKeys.loadPublicKeyFromPEMFile(listenerConfig.get<std::string>("TLS.CertFile", "snakeoil.crt").c_str()))
+        std::string certFile = listenerConfig.get<std::string>("TLS.CertFile", "snakeoil.crt");
+        std::string keyFile = listenerConfig.get<std::string>("TLS.KeyFile", "snakeoil.key");
+
+        if (!tlsSocket->tlsKeys.loadPublicKeyFromPEMFile(certFile.c_str()))
         {
             appLog->log0(__func__, LogLevel::CRITICAL, "Error creating listener %s: %s", listenerName.c_str(), "Bad TLS Public Key");
             return nullptr;
         }
-        if (!tlsSocket->tlsKeys.loadPrivateKeyFromPEMFile(listenerConfig.get<std::string>("TLS.KeyFile", "snakeoil.key").c_str()))
+        if (!tlsSocket->tlsKeys.loadPrivateKeyFromPEMFile(keyFile.c_str()))
         {
             appLog->log0(__func__, LogLevel::CRITICAL, "Error creating listener %s: %s", listenerName.c_str(), "Bad TLS Private Key");
             return nullptr;
         }
+
+        // Reload the certificate/key when the files change (0: disabled):
+        uint32_t keysWatchInterval = listenerConfig.get<uint32_t>("TLS.KeysWatchInterval", 0);
+        if (keysWatchInterval > 0)
+        {
+            tlsSocket->startTLSKeysFileWatch(certFile, keyFile, "", keysWatchInterval);
+        }
         sock = tlsSocket;
     }
     else
@@ -243,12 +259,51 @@ Mantids30::Network::Servers::RESTful::Engine *Mantids30::Program::Config::RESTfu
         size_t bMaxConnectionsPerUserPerEndpoint = config.get<size_t>("WebSockets.MaxConnectionsPerUserPerEndpoint", 64);
         webServer->config.webSockets.maxConnectionsPerUserPerEndpoint = bMaxConnectionsPerUserPerEndpoint;
 
-        // Use a thread pool or multi-threading based on configuration
+        // HTTP/1.1 persistent connections:
+        webServer->config.keepAlive.enabled = config.get<bool>("KeepAlive.Enabled", true);
+        webServer->config.keepAlive.idleTimeoutInSeconds = config.get<uint32_t>("KeepAlive.IdleTimeout", 15);
+        webServer->config.keepAlive.maxRequestsPerConnection = config.get<uint32_t>("KeepAlive.MaxRequests", 100);
+
+        // HTTP response compression:
+        webServer->config.compression.enabled = config.get<bool>("Compression.Enabled", true);
+        webServer->config.compression.minSize = config.get<size_t>("Compression.MinSize", 1024);
+        webServer->config.compression.gzipLevel = config.get<int>("Compression.GzipLevel", 6);
+        webServer->config.compression.brotliQuality = config.get<int>("Compression.BrotliQuality", 4);
+
+        // In-memory static file cache (opt-in, it keeps an inotify watcher per server):
+        if (config.get<bool>("StaticFileCache.Enabled", false))
+        {
+            webServer->config.staticFileCache = std::make_shared<Network::Protocol::HTTP::StaticFileCache>();
+            webServer->config.staticFileCache->config.maxTotalSize = config.get<size_t>("StaticFileCache.MaxSizeInMB", 64) * 1024 * 1024;
+            webServer->config.staticFileCache->config.maxFileSize = config.get<size_t>("StaticFileCache.MaxFileSizeInKB", 1024) * 1024;
+            webServer->config.staticFileCache->config.precompress = config.get<bool>("StaticFileCache.Precompress", false);
+        }
+
+        // Use an event loop, a thread pool or multi-threading based on configuration
+        bool useEventLoop = config.get<bool>("Threads.UseEventLoop", false);
         bool useThreadPool = config.get<bool>("Threads.UseThreadPool", false);
 
-        appLog->log0(__func__, LogLevel::DEBUG, "[%p] Using %s", reinterpret_cast<void *>(webServer), useThreadPool ? "thread pool" : "multi-threading");
+        // The TLS handshake and records are read in blocking mode, a slow client would pin an event loop worker:
+        if (useEventLoop && std::any_of(listenerSockets.begin(), listenerSockets.end(), [](const std::shared_ptr<Sockets::Socket_Stream> &socket) { return socket->isSecure(); }))
+        {
+            appLog->log0(__func__, LogLevel::WARNING, "[%p] Event loop not available for TLS listeners, using the thread pool", reinterpret_cast<void *>(webServer));
+            useEventLoop = false;
+            useThreadPool = true;
+        }
+
+        appLog->log0(__func__, LogLevel::DEBUG, "[%p] Using %s", reinterpret_cast<void *>(webServer),
+                     useEventLoop ? "event loop" : (useThreadPool ? "thread pool" : "multi-threading"));
 
-        if (useThreadPool)
+        if (useEventLoop)
+        {
+#ifdef __linux__
+            webServer->setAcceptEventLoop(listenerSockets, config.get_child("Threads"));
+#else
+            appLog->log0(__func__, LogLevel::WARNING, "[%p] Event loop not available on this platform, using the thread pool", reinterpret_cast<void *>(webServer));
+            webServer->setAcceptPoolThreaded(listenerSockets, config.get_child("Threads"));
+#endif
+        }
+        else if (useThreadPool)
         {
             webServer->setAcceptPoolThreaded(listenerSockets, config.get_child("Threads"));
         }
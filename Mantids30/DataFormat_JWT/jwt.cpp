@@ -365,6 +365,20 @@ bool JWT::verify(const std::string &fullSignedToken, JWT::Token *tokenPayloadOut
         return false;
     }
 
+    // Check if the token is already verified in the cache (no need to decode or verify it again)
+    if (!verificationCallback)
+    {
+        std::string cachedSignature;
+        if (m_cache.checkToken(fullSignedToken, tokenPayloadOutput, &cachedSignature))
+        {
+            // The token may have been revoked after being cached:
+            tokenPayloadOutput->setRevoked(m_revocation.isSignatureRevoked(cachedSignature));
+
+            // Return if verified, not revoked and not expired.
+            return tokenPayloadOutput->isValid();
+        }
+    }
+
     // Extract the base64-encoded header, payload, and signature substrings from the token
     std::string header_b64 = fullSignedToken.substr(0, pos_header);
     std::string payload_b64 = fullSignedToken.substr(pos_header + 1, pos_payload - pos_header - 1);
@@ -392,16 +406,6 @@ bool JWT::verify(const std::string &fullSignedToken, JWT::Token *tokenPayloadOut
         }
     }
 
-    // Check if the token is already in the cache
-    if (m_cache.checkToken(payload_str))
-    {
-        tokenPayloadOutput->decodePayload(payload_str);
-        tokenPayloadOutput->setSignatureVerified(true);
-
-        // Return if verified and not expired.
-        return tokenPayloadOutput->isValid();
-    }
-
     // Parse the JSON header using the JsonCpp library
     Json::CharReaderBuilder reader;
     std::unique_ptr<Json::CharReader> charReader(reader.newCharReader()); // create a unique_ptr to manage the JsonCpp char reader
@@ -447,10 +451,10 @@ bool JWT::verify(const std::string &fullSignedToken, JWT::Token *tokenPayloadOut
         isSignatureVerified = validateRSASignature(getHashTypeNumber(), header_b64 + '.' + payload_b64, signature_str.data(), signature_str.size()) == 0;
     }
 
-    if (isSignatureVerified)
+    if (isSignatureVerified && tokenPayloadOutput->decodePayload(payload_str))
     {
-        tokenPayloadOutput->decodePayload(payload_str);
-        m_cache.add(payload_str);
+        tokenPayloadOutput->setSignatureVerified(true);
+        m_cache.add(fullSignedToken, *tokenPayloadOutput, signature_str);
     }
     tokenPayloadOutput->setSignatureVerified(isSignatureVerified);
     tokenPayloadOutput->setRevoked(m_revocation.isSignatureRevoked(signature_str));
@@ -1,11 +1,15 @@
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <condition_variable>
+#include <cstring>
 #include <ctime>
 #include <json/json.h>
 #include <json/value.h>
-#include <queue>
+#include <list>
+#include <map>
+#include <mutex>
 #include <set>
 #include <shared_mutex>
 #include <string>
@@ -166,48 +170,64 @@ public:
         bool m_revoked = false;
     };
 
+    /**
+     * @brief Cache of verified tokens, keyed by the SHA-256 digest of the full signed token.
+     *
+     * Holds the already decoded token, so a hit skips the base64 decoding, the signature verification and the JSON parsing.
+     * Entries are evicted in LRU order when the byte budget is exceeded and as soon as the token expires. The entries are
+     * spread across independently locked shards (the revocation list is not cached, it's checked by JWT::verify on every hit).
+     */
     class Cache
     {
     public:
         Cache() = default;
 
-        // Copy constructor (thread-safe)
+        /**
+         * @brief Copy constructor, copies the configuration (the copy starts with an empty cache)
+         */
         Cache(const Cache &other)
-        {
-            // Lock the destination's mutex to prevent concurrent modifications
-            std::unique_lock<std::shared_mutex> lockThis(m_cachedTokensMutex);
-
-            // Copy data
-            m_cacheMaxByteCount = other.m_cacheMaxByteCount;
-            m_cacheCurrentByteCount = other.m_cacheCurrentByteCount;
-            m_enabled = other.m_enabled;
-            m_tokenCache = other.m_tokenCache;
-            m_cacheQueue = other.m_cacheQueue;
-        }
+            : m_cacheMaxByteCount(other.m_cacheMaxByteCount.load())
+            , m_enabled(other.m_enabled.load())
+        {}
 
-        // Copy assignment operator (thread-safe)
+        /**
+         * @brief Copy assignment operator, copies the configuration and clears the cached tokens
+         */
         Cache &operator=(const Cache &other)
         {
             if (this != &other)
             {
-                // Lock the destination's mutex to prevent concurrent modifications
-                std::unique_lock<std::shared_mutex> lockThis(m_cachedTokensMutex);
-
-                // Copy data
-                m_cacheMaxByteCount = other.m_cacheMaxByteCount;
-                m_cacheCurrentByteCount = other.m_cacheCurrentByteCount;
-                m_enabled = other.m_enabled;
-                m_tokenCache = other.m_tokenCache;
-                m_cacheQueue = other.m_cacheQueue;
+                clear();
+                m_cacheMaxByteCount = other.m_cacheMaxByteCount.load();
+                m_enabled = other.m_enabled.load();
             }
             return *this;
         }
 
         // Cache functions:
-        [[nodiscard]] bool checkToken(const std::string &payload);
-        void add(const std::string &payload);
+        /**
+         * @brief checkToken Look for an already verified token
+         * @param fullSignedToken JWT token string (header, payload and signature)
+         * @param tokenOutput where the cached token is copied (if found)
+         * @param signatureOutput where the decoded signature is copied (to check it against the revocation list)
+         * @return true if the token is in the cache and not expired.
+         */
+        [[nodiscard]] bool checkToken(const std::string &fullSignedToken, Token *tokenOutput, std::string *signatureOutput);
+        /**
+         * @brief add Add a verified token to the cache
+         * @param fullSignedToken JWT token string (header, payload and signature)
+         * @param token decoded and verified token
+         * @param signature decoded signature
+         */
+        void add(const std::string &fullSignedToken, const Token &token, const std::string &signature);
+        /**
+         * @brief evictCache Remove the expired tokens and the least recently used ones exceeding the max byte count.
+         */
         void evictCache();
 
+        /**
+         * @brief setCacheMaxByteCount Set the approximate memory budget of the cache (accounted by the token sizes)
+         */
         void setCacheMaxByteCount(std::size_t maxByteCount);
         [[nodiscard]] std::size_t getCacheMaxByteCount();
         void clear();
@@ -216,12 +236,48 @@ public:
         void setEnabled(bool newEnabled);
 
     private:
-        std::size_t m_cacheMaxByteCount = 0;
-        std::size_t m_cacheCurrentByteCount = 0;
-        bool m_enabled = false;
-        std::unordered_map<std::string, bool> m_tokenCache;
-        std::queue<std::string> m_cacheQueue;
-        std::shared_mutex m_cachedTokensMutex;
+        static constexpr std::size_t SHARD_COUNT = 16;
+
+        using Digest = std::array<unsigned char, 32>;
+
+        struct DigestHash
+        {
+            std::size_t operator()(const Digest &digest) const
+            {
+                std::size_t r;
+                memcpy(&r, digest.data(), sizeof(r));
+                return r;
+            }
+        };
+
+        struct CachedToken
+        {
+            Token token;
+            std::string signature;
+            std::size_t byteCount = 0;
+            std::list<Digest>::iterator lruPosition;
+            std::multimap<std::time_t, Digest>::iterator expirationPosition;
+        };
+
+        struct alignas(64) Shard
+        {
+            std::unordered_map<Digest, CachedToken, DigestHash> tokens;
+            std::list<Digest> lruList;                        ///< Most recently used first.
+            std::multimap<std::time_t, Digest> expirations; ///< Tokens by expiration time.
+            std::size_t byteCount = 0;
+            std::mutex mutex;
+        };
+
+        static Digest computeDigest(const std::string &fullSignedToken);
+        // (the shard is picked with the last byte, the first ones are the hash inside the shard)
+        Shard &getShard(const Digest &digest) { return m_shards[digest[digest.size() - 1] % SHARD_COUNT]; }
+
+        static void eraseToken(Shard &shard, std::unordered_map<Digest, CachedToken, DigestHash>::iterator it);
+        void evictShard(Shard &shard, std::time_t now);
+
+        std::atomic<std::size_t> m_cacheMaxByteCount{0};
+        std::atomic<bool> m_enabled{false};
+        std::array<Shard, SHARD_COUNT> m_shards;
     };
 
     class Revocation
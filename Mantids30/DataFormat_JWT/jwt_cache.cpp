@@ -1,104 +1,157 @@
 #include "jwt.h"
-#include <boost/thread/pthread/shared_mutex.hpp>
+#include <openssl/sha.h>
 
 using namespace Mantids30::DataFormat;
 
 void JWT::Cache::setCacheMaxByteCount(std::size_t maxByteCount)
 {
-    {
-        std::unique_lock<std::shared_mutex> writeLock(m_cachedTokensMutex);
-
-        bool doEvict = false;
-        if (m_cacheMaxByteCount > maxByteCount)
-        {
-            doEvict = true;
-        }
-
-        m_cacheMaxByteCount = maxByteCount;
-    }
+    m_cacheMaxByteCount = maxByteCount;
     evictCache();
 }
 
 std::size_t JWT::Cache::getCacheMaxByteCount()
 {
-    std::shared_lock<std::shared_mutex> readLock(m_cachedTokensMutex);
     return m_cacheMaxByteCount;
 }
 
 void JWT::Cache::clear()
 {
-    std::unique_lock<std::shared_mutex> writeLock(m_cachedTokensMutex);
-    while (!m_cacheQueue.empty())
+    for (auto &shard : m_shards)
     {
-        m_cacheQueue.pop();
+        std::unique_lock<std::mutex> lock(shard.mutex);
+        shard.tokens.clear();
+        shard.lruList.clear();
+        shard.expirations.clear();
+        shard.byteCount = 0;
     }
-    m_tokenCache.clear();
 }
 
 bool JWT::Cache::isEnabled()
 {
-    std::shared_lock<std::shared_mutex> readLock(m_cachedTokensMutex);
     return m_enabled;
 }
 
 void JWT::Cache::setEnabled(bool newEnabled)
 {
-    std::unique_lock<std::shared_mutex> writeLock(m_cachedTokensMutex);
+    m_enabled = newEnabled;
     if (!newEnabled)
     {
         // Destroy the cache...
-        while (!m_cacheQueue.empty())
-        {
-            m_cacheQueue.pop();
-        }
-        m_tokenCache.clear();
+        clear();
     }
-    m_enabled = newEnabled;
 }
 
-bool JWT::Cache::checkToken(const std::string &payload)
+bool JWT::Cache::checkToken(const std::string &fullSignedToken, Token *tokenOutput, std::string *signatureOutput)
 {
-    std::shared_lock<std::shared_mutex> readLock(m_cachedTokensMutex);
-
     // Don't report any token
     if (!m_enabled)
     {
         return false;
     }
 
-    std::unordered_map<std::string, bool>::iterator it = m_tokenCache.find(payload);
-    return it != m_tokenCache.end();
+    Digest digest = computeDigest(fullSignedToken);
+    Shard &shard = getShard(digest);
+
+    std::unique_lock<std::mutex> lock(shard.mutex);
+
+    auto it = shard.tokens.find(digest);
+    if (it == shard.tokens.end())
+    {
+        return false;
+    }
+
+    // Expired tokens are not kept:
+    if (it->second.expirationPosition->first <= std::time(nullptr))
+    {
+        eraseToken(shard, it);
+        return false;
+    }
+
+    // Move to the front of the LRU list:
+    shard.lruList.splice(shard.lruList.begin(), shard.lruList, it->second.lruPosition);
+
+    *tokenOutput = it->second.token;
+    *signatureOutput = it->second.signature;
+    return true;
 }
 
-void JWT::Cache::add(const std::string &payload)
+void JWT::Cache::add(const std::string &fullSignedToken, const Token &token, const std::string &signature)
 {
+    // Don't add anything to the cache...
+    if (!m_enabled)
+    {
+        return;
+    }
+
+    std::time_t now = std::time(nullptr);
+    // (tokens without "exp" are kept until evicted by the LRU)
+    std::time_t expirationTime = token.getExpirationTime();
+    if (expirationTime <= now)
     {
-        std::unique_lock<std::shared_mutex> writeLock(m_cachedTokensMutex);
+        return;
+    }
 
-        // TODO: use hash instead? / payload can be huge.
+    Digest digest = computeDigest(fullSignedToken);
+    Shard &shard = getShard(digest);
 
-        // Don't add anything to the cache...
-        if (!m_enabled)
-        {
-            return;
-        }
+    std::unique_lock<std::mutex> lock(shard.mutex);
 
-        m_cacheQueue.push(payload);
-        m_tokenCache[payload] = true;
-        m_cacheCurrentByteCount += payload.size();
+    auto inserted = shard.tokens.try_emplace(digest);
+    if (!inserted.second)
+    {
+        // Already there (verified concurrently).
+        return;
     }
-    evictCache();
+
+    CachedToken &cachedToken = inserted.first->second;
+    cachedToken.token = token;
+    cachedToken.signature = signature;
+    // The decoded token takes roughly the same as the encoded one:
+    cachedToken.byteCount = fullSignedToken.size() + signature.size() + sizeof(CachedToken);
+    cachedToken.lruPosition = shard.lruList.insert(shard.lruList.begin(), digest);
+    cachedToken.expirationPosition = shard.expirations.emplace(expirationTime, digest);
+    shard.byteCount += cachedToken.byteCount;
+
+    evictShard(shard, now);
 }
 
 void JWT::Cache::evictCache()
 {
-    std::unique_lock<std::shared_mutex> writeLock(m_cachedTokensMutex);
+    std::time_t now = std::time(nullptr);
+    for (auto &shard : m_shards)
+    {
+        std::unique_lock<std::mutex> lock(shard.mutex);
+        evictShard(shard, now);
+    }
+}
+
+JWT::Cache::Digest JWT::Cache::computeDigest(const std::string &fullSignedToken)
+{
+    Digest digest;
+    SHA256(reinterpret_cast<const unsigned char *>(fullSignedToken.data()), fullSignedToken.size(), digest.data());
+    return digest;
+}
+
+void JWT::Cache::eraseToken(Shard &shard, std::unordered_map<Digest, CachedToken, DigestHash>::iterator it)
+{
+    shard.byteCount -= it->second.byteCount;
+    shard.lruList.erase(it->second.lruPosition);
+    shard.expirations.erase(it->second.expirationPosition);
+    shard.tokens.erase(it);
+}
+
+void JWT::Cache::evictShard(Shard &shard, std::time_t now)
+{
+    // Remove the expired tokens:
+    while (!shard.expirations.empty() && shard.expirations.begin()->first <= now)
+    {
+        eraseToken(shard, shard.tokens.find(shard.expirations.begin()->second));
+    }
 
-    while (m_cacheCurrentByteCount > m_cacheMaxByteCount)
+    // Each shard takes an equal part of the budget, remove the least recently used tokens:
+    std::size_t maxShardByteCount = m_cacheMaxByteCount / SHARD_COUNT;
+    while (shard.byteCount > maxShardByteCount && !shard.lruList.empty())
     {
-        const std::string &evictedToken = m_cacheQueue.front();
-        m_cacheCurrentByteCount -= evictedToken.size();
-        m_tokenCache.erase(evictedToken);
-        m_cacheQueue.pop();
+        eraseToken(shard, shard.tokens.find(shard.lruList.back()));
     }
 }
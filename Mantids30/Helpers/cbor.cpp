@@ -0,0 +1,465 @@
+#include "cbor.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+using namespace Mantids30::Helpers;
+
+namespace {
+
+enum MajorType : uint8_t
+{
+    MAJOR_UINT = 0,
+    MAJOR_NEGINT = 1,
+    MAJOR_BYTES = 2,
+    MAJOR_TEXT = 3,
+    MAJOR_ARRAY = 4,
+    MAJOR_MAP = 5,
+    MAJOR_TAG = 6,
+    MAJOR_SIMPLE = 7
+};
+
+constexpr uint8_t INFO_INDEFINITE = 31;
+constexpr uint8_t BREAK_CODE = 0xFF;
+
+void encodeHead(const uint8_t &major, const uint64_t &argument, std::string &output)
+{
+    char head[9];
+    size_t headSize;
+    uint8_t initialByte = static_cast<uint8_t>(major << 5);
+
+    if (argument < 24)
+    {
+        head[0] = static_cast<char>(initialByte | argument);
+        headSize = 1;
+    }
+    else if (argument <= std::numeric_limits<uint8_t>::max())
+    {
+        head[0] = static_cast<char>(initialByte | 24);
+        headSize = 2;
+    }
+    else if (argument <= std::numeric_limits<uint16_t>::max())
+    {
+        head[0] = static_cast<char>(initialByte | 25);
+        headSize = 3;
+    }
+    else if (argument <= std::numeric_limits<uint32_t>::max())
+    {
+        head[0] = static_cast<char>(initialByte | 26);
+        headSize = 5;
+    }
+    else
+    {
+        head[0] = static_cast<char>(initialByte | 27);
+        headSize = 9;
+    }
+
+    // Big endian argument:
+    for (size_t i = 1; i < headSize; i++)
+    {
+        head[i] = static_cast<char>((argument >> (8 * (headSize - 1 - i))) & 0xFF);
+    }
+
+    output.append(head, headSize);
+}
+
+void encodeReal(const double &value, std::string &output)
+{
+    char bytes[9];
+    float singleValue = static_cast<float>(value);
+
+    if (static_cast<double>(singleValue) == value || std::isnan(value))
+    {
+        // Exactly representable in single precision (eg. 0.5, 1e10, infinities)
+        uint32_t bits;
+        memcpy(&bits, &singleValue, sizeof(bits));
+        bytes[0] = static_cast<char>(0xFA);
+        for (size_t i = 0; i < 4; i++)
+        {
+            bytes[1 + i] = static_cast<char>((bits >> (8 * (3 - i))) & 0xFF);
+        }
+        output.append(bytes, 5);
+        return;
+    }
+
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    bytes[0] = static_cast<char>(0xFB);
+    for (size_t i = 0; i < 8; i++)
+    {
+        bytes[1 + i] = static_cast<char>((bits >> (8 * (7 - i))) & 0xFF);
+    }
+    output.append(bytes, 9);
+}
+
+class Decoder
+{
+public:
+    Decoder(const char *data, const size_t &size, const size_t &maxDepth)
+        : m_current(reinterpret_cast<const uint8_t *>(data))
+        , m_end(reinterpret_cast<const uint8_t *>(data) + size)
+        , m_maxDepth(maxDepth)
+    {}
+
+    bool decodeItem(Json::Value &value, const size_t &depth);
+    bool finished() const { return m_current == m_end; }
+
+private:
+    size_t remaining() const { return static_cast<size_t>(m_end - m_current); }
+    bool readHead(uint8_t &major, uint8_t &info, uint64_t &argument);
+    bool readBigEndian(const size_t &bytes, uint64_t &argument);
+    bool isBreak() const { return m_current < m_end && *m_current == BREAK_CODE; }
+    bool decodeString(const uint8_t &major, const uint8_t &info, const uint64_t &argument, std::string &output);
+    bool decodeMapKey(std::string &key, const size_t &depth);
+    static double decodeHalf(const uint16_t &half);
+
+    const uint8_t *m_current;
+    const uint8_t *m_end;
+    size_t m_maxDepth;
+};
+
+bool Decoder::readBigEndian(const size_t &bytes, uint64_t &argument)
+{
+    if (remaining() < bytes)
+    {
+        return false;
+    }
+    argument = 0;
+    for (size_t i = 0; i < bytes; i++)
+    {
+        argument = (argument << 8) | *m_current++;
+    }
+    return true;
+}
+
+bool Decoder::readHead(uint8_t &major, uint8_t &info, uint64_t &argument)
+{
+    if (m_current >= m_end)
+    {
+        return false;
+    }
+
+    uint8_t initialByte = *m_current++;
+    major = initialByte >> 5;
+    info = initialByte & 0x1F;
+
+    switch (info)
+    {
+    case 24:
+        return readBigEndian(1, argument);
+    case 25:
+        return readBigEndian(2, argument);
+    case 26:
+        return readBigEndian(4, argument);
+    case 27:
+        return readBigEndian(8, argument);
+    case 28:
+    case 29:
+    case 30:
+        // Reserved.
+        return false;
+    case INFO_INDEFINITE:
+        argument = 0;
+        // Only strings, arrays and maps can have indefinite length (the break code is handled by the containers).
+        return major == MAJOR_BYTES || major == MAJOR_TEXT || major == MAJOR_ARRAY || major == MAJOR_MAP;
+    default:
+        argument = info;
+        return true;
+    }
+}
+
+bool Decoder::decodeString(const uint8_t &major, const uint8_t &info, const uint64_t &argument, std::string &output)
+{
+    if (info != INFO_INDEFINITE)
+    {
+        if (argument > remaining())
+        {
+            return false;
+        }
+        output.append(reinterpret_cast<const char *>(m_current), static_cast<size_t>(argument));
+        m_current += argument;
+        return true;
+    }
+
+    // Indefinite length: definite chunks of the same type until the break code.
+    while (!isBreak())
+    {
+        uint8_t chunkMajor, chunkInfo;
+        uint64_t chunkSize;
+        if (!readHead(chunkMajor, chunkInfo, chunkSize) || chunkMajor != major || chunkInfo == INFO_INDEFINITE)
+        {
+            return false;
+        }
+        if (!decodeString(major, chunkInfo, chunkSize, output))
+        {
+            return false;
+        }
+    }
+    m_current++;
+    return true;
+}
+
+bool Decoder::decodeMapKey(std::string &key, const size_t &depth)
+{
+    uint8_t major = m_current < m_end ? (*m_current >> 5) : 0;
+
+    if (major == MAJOR_TEXT || major == MAJOR_BYTES)
+    {
+        uint8_t info;
+        uint64_t argument;
+        return readHead(major, info, argument) && decodeString(major, info, argument, key);
+    }
+
+    // Other scalar keys (eg. integers) are converted to text:
+    Json::Value keyValue;
+    if (!decodeItem(keyValue, depth) || keyValue.isArray() || keyValue.isObject())
+    {
+        return false;
+    }
+    key = keyValue.isNull() ? "null" : keyValue.asString();
+    return true;
+}
+
+double Decoder::decodeHalf(const uint16_t &half)
+{
+    int exponent = (half >> 10) & 0x1F;
+    int mantissa = half & 0x3FF;
+    double value;
+
+    if (exponent == 0)
+    {
+        value = std::ldexp(mantissa, -24);
+    }
+    else if (exponent != 31)
+    {
+        value = std::ldexp(mantissa + 1024, exponent - 25);
+    }
+    else
+    {
+        value = mantissa == 0 ? std::numeric_limits<double>::infinity() : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    return (half & 0x8000) ? -value : value;
+}
+
+bool Decoder::decodeItem(Json::Value &value, const size_t &depth)
+{
+    uint8_t major, info;
+    uint64_t argument;
+
+    if (!readHead(major, info, argument))
+    {
+        return false;
+    }
+
+    switch (major)
+    {
+    case MAJOR_UINT:
+        // Same representation as the JSON reader: signed when it fits.
+        if (argument <= static_cast<uint64_t>(std::numeric_limits<Json::Int64>::max()))
+        {
+            value = static_cast<Json::Int64>(argument);
+        }
+        else
+        {
+            value = static_cast<Json::UInt64>(argument);
+        }
+        return true;
+    case MAJOR_NEGINT:
+        if (argument <= static_cast<uint64_t>(std::numeric_limits<Json::Int64>::max()))
+        {
+            value = static_cast<Json::Int64>(-1 - static_cast<Json::Int64>(argument));
+        }
+        else
+        {
+            value = -1.0 - static_cast<double>(argument);
+        }
+        return true;
+    case MAJOR_BYTES:
+    case MAJOR_TEXT:
+    {
+        if (info != INFO_INDEFINITE)
+        {
+            if (argument > remaining())
+            {
+                return false;
+            }
+            const char *begin = reinterpret_cast<const char *>(m_current);
+            value = Json::Value(begin, begin + argument);
+            m_current += argument;
+            return true;
+        }
+        std::string str;
+        if (!decodeString(major, info, argument, str))
+        {
+            return false;
+        }
+        value = Json::Value(str.data(), str.data() + str.size());
+        return true;
+    }
+    case MAJOR_ARRAY:
+    {
+        // Each element takes at least one byte (don't trust the declared size, the elements are appended as they are decoded).
+        if (depth >= m_maxDepth || (info != INFO_INDEFINITE && argument > remaining()))
+        {
+            return false;
+        }
+        value = Json::Value(Json::arrayValue);
+        for (Json::ArrayIndex i = 0; info == INFO_INDEFINITE ? !isBreak() : i < argument; i++)
+        {
+            if (!decodeItem(value[i], depth + 1))
+            {
+                return false;
+            }
+        }
+        if (info == INFO_INDEFINITE)
+        {
+            if (m_current >= m_end)
+            {
+                return false;
+            }
+            m_current++;
+        }
+        return true;
+    }
+    case MAJOR_MAP:
+    {
+        // Each pair takes at least two bytes.
+        if (depth >= m_maxDepth || (info != INFO_INDEFINITE && argument > remaining() / 2))
+        {
+            return false;
+        }
+        value = Json::Value(Json::objectValue);
+        for (uint64_t i = 0; info == INFO_INDEFINITE ? !isBreak() : i < argument; i++)
+        {
+            std::string key;
+            if (!decodeMapKey(key, depth + 1) || !decodeItem(value[key], depth + 1))
+            {
+                return false;
+            }
+        }
+        if (info == INFO_INDEFINITE)
+        {
+            if (m_current >= m_end)
+            {
+                return false;
+            }
+            m_current++;
+        }
+        return true;
+    }
+    case MAJOR_TAG:
+        // Tags only add semantics, decode the content (nested tags count as depth).
+        return depth < m_maxDepth && decodeItem(value, depth + 1);
+    case MAJOR_SIMPLE:
+    default:
+        switch (info)
+        {
+        case 20:
+            value = false;
+            return true;
+        case 21:
+            value = true;
+            return true;
+        case 22:
+        case 23:
+            value = Json::Value(Json::nullValue);
+            return true;
+        case 25:
+            value = decodeHalf(static_cast<uint16_t>(argument));
+            return true;
+        case 26:
+        {
+            uint32_t bits = static_cast<uint32_t>(argument);
+            float singleValue;
+            memcpy(&singleValue, &bits, sizeof(singleValue));
+            value = static_cast<double>(singleValue);
+            return true;
+        }
+        case 27:
+        {
+            double doubleValue;
+            memcpy(&doubleValue, &argument, sizeof(doubleValue));
+            value = doubleValue;
+            return true;
+        }
+        default:
+            // Unassigned simple values or unexpected break code.
+            return false;
+        }
+    }
+}
+
+} // namespace
+
+void CBOR::encode(const Json::Value &value, std::string &output)
+{
+    switch (value.type())
+    {
+    case Json::nullValue:
+        output.push_back(static_cast<char>(0xF6));
+        break;
+    case Json::intValue:
+    {
+        Json::Int64 intValue = value.asInt64();
+        if (intValue >= 0)
+        {
+            encodeHead(MAJOR_UINT, static_cast<uint64_t>(intValue), output);
+        }
+        else
+        {
+            encodeHead(MAJOR_NEGINT, static_cast<uint64_t>(-(intValue + 1)), output);
+        }
+    }
+    break;
+    case Json::uintValue:
+        encodeHead(MAJOR_UINT, value.asUInt64(), output);
+        break;
+    case Json::realValue:
+        encodeReal(value.asDouble(), output);
+        break;
+    case Json::stringValue:
+    {
+        const char *begin = nullptr, *end = nullptr;
+        value.getString(&begin, &end);
+        encodeHead(MAJOR_TEXT, static_cast<uint64_t>(end - begin), output);
+        output.append(begin, static_cast<size_t>(end - begin));
+    }
+    break;
+    case Json::booleanValue:
+        output.push_back(static_cast<char>(value.asBool() ? 0xF5 : 0xF4));
+        break;
+    case Json::arrayValue:
+        encodeHead(MAJOR_ARRAY, value.size(), output);
+        for (const Json::Value &element : value)
+        {
+            encode(element, output);
+        }
+        break;
+    case Json::objectValue:
+        encodeHead(MAJOR_MAP, value.size(), output);
+        for (Json::Value::const_iterator it = value.begin(); it != value.end(); ++it)
+        {
+            const char *nameEnd = nullptr;
+            const char *name = it.memberName(&nameEnd);
+            encodeHead(MAJOR_TEXT, static_cast<uint64_t>(nameEnd - name), output);
+            output.append(name, static_cast<size_t>(nameEnd - name));
+            encode(*it, output);
+        }
+        break;
+    }
+}
+
+std::string CBOR::encode(const Json::Value &value)
+{
+    std::string output;
+    encode(value, output);
+    return output;
+}
+
+bool CBOR::decode(const char *data, const size_t &size, Json::Value &value, const size_t &maxDepth)
+{
+    Decoder decoder(data, size, maxDepth);
+    return decoder.decodeItem(value, 0) && decoder.finished();
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+/**
+ * Compact binary encoding (CBOR, RFC 8949) for JSONCPP values.
+ */
+
+#include <json/json.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Mantids30::Helpers::CBOR {
+
+/**
+ * @brief encode Append the CBOR encoding of the value into the output string (written in-place, no intermediate objects).
+ *               Integers keep their sign/width, reals are encoded as doubles and objects as maps with text keys.
+ * @param value JSON value
+ * @param output string where the encoded bytes are appended (reserve it to avoid reallocations)
+ */
+void encode(const Json::Value &value, std::string &output);
+
+/**
+ * @brief encode Encode the value as CBOR
+ * @return the encoded bytes
+ */
+std::string encode(const Json::Value &value);
+
+/**
+ * @brief decode Decode a CBOR data item directly into a JSON value.
+ *               Byte strings are decoded as strings, tags are ignored (the tagged content is decoded), undefined is null,
+ *               and non-text map keys are converted to their JSON text representation.
+ * @param data encoded data
+ * @param size encoded data size
+ * @param value output value
+ * @param maxDepth maximum nesting of arrays/maps
+ * @return false if the data is malformed, truncated, exceeds the nesting limit or has trailing bytes.
+ */
+bool decode(const char *data, const size_t &size, Json::Value &value, const size_t &maxDepth = 128);
+
+} // namespace Mantids30::Helpers::CBOR
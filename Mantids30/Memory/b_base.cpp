@@ -605,9 +605,6 @@ bool B_Base::compare(const void *mem, const size_t &len, bool caseSensitive, con
         return false;
     }
 
-    // No bytes to copy:
-    //if (!len || offset+len==size())
-    return true;
     // No data to compare...
     if (!len)
     {
@@ -669,7 +666,42 @@ std::optional<size_t> B_Base::find(const void *needle, const size_t &needle_len,
     }
 
     size_t currentOffset = offset;
+    const size_t searchEnd = offset + searchSpace;
 
+    // Search the contiguous memory segments directly (vectorized), and check with compare2 the needles crossing two segments:
+    size_t segmentSize = 0;
+    while (const char *segment = getContiguousSegment(currentOffset, &segmentSize))
+    {
+        segmentSize = std::min(segmentSize, searchEnd - currentOffset);
+        if (segmentSize == 0)
+        {
+            break;
+        }
+
+        std::optional<size_t> pos = Search::findNeedle(segment, segmentSize, c_needle, needle_len, caseSensitive);
+        if (pos != std::nullopt)
+        {
+            return currentOffset + pos.value();
+        }
+
+        for (size_t i = segmentSize >= needle_len ? segmentSize - needle_len + 1 : 0; i < segmentSize && currentOffset + i + needle_len <= searchEnd; i++)
+        {
+            // (the segment part first)
+            if (!Helpers::Mem::memicmp2(segment + i, c_needle, segmentSize - i, caseSensitive) && compare2(needle, needle_len, caseSensitive, currentOffset + i))
+            {
+                return currentOffset + i;
+            }
+        }
+
+        currentOffset += segmentSize;
+        if (currentOffset + needle_len > searchEnd)
+        {
+            return std::nullopt;
+        }
+    }
+    searchSpace = searchEnd - currentOffset;
+
+    // The container does not expose the memory, find the first char and compare:
     std::optional<size_t> pos = findChar(c_needle[0], currentOffset, searchSpace, caseSensitive);
     while (pos != std::nullopt) // char detected...
     {
@@ -751,18 +783,96 @@ std::optional<size_t> B_Base::find(const void *needle, const size_t &needle_len,
 }
 
 std::optional<size_t> B_Base::find(const std::list<std::string> &needles, std::string &needleFound, bool caseSensitive, const size_t &offset, const size_t &searchSpace)
+{
+    return find(Search::MultiNeedle(needles, caseSensitive), needleFound, offset, searchSpace);
+}
+
+std::optional<size_t> B_Base::find(const Search::MultiNeedle &needles, std::string &needleFound, const size_t &offset, size_t searchSpace)
 {
     needleFound.clear();
-    for (const std::string &needle : needles)
+
+    size_t currentSize = size();
+
+    // Offset:bytes will overflow...
+    if (CHECK_UINT_OVERFLOW_SUM(offset, searchSpace))
     {
-        std::optional<size_t> f = find(needle.c_str(), needle.size(), caseSensitive, offset, searchSpace);
-        if (f != std::nullopt)
+        return std::nullopt;
+    }
+    if (offset > currentSize || needles.isEmpty())
+    {
+        return std::nullopt;
+    }
+    if (searchSpace == 0)
+    {
+        searchSpace = currentSize - offset;
+    }
+
+    const std::vector<std::string> &needleList = needles.getNeedles();
+    const size_t searchEnd = std::min(offset + searchSpace, currentSize);
+    size_t currentOffset = offset;
+
+    size_t segmentSize = 0;
+    while (const char *segment = getContiguousSegment(currentOffset, &segmentSize))
+    {
+        segmentSize = std::min(segmentSize, searchEnd - currentOffset);
+        if (segmentSize == 0)
+        {
+            break;
+        }
+
+        // Earliest needle fully inside this segment:
+        size_t needleIndex = 0;
+        std::optional<size_t> pos = needles.find(segment, segmentSize, &needleIndex);
+
+        // A needle crossing to the next segment may start before it (or at the same position, being first in the set):
+        size_t crossingEnd = pos != std::nullopt ? pos.value() + 1 : segmentSize;
+        size_t crossingStart = segmentSize >= needles.getMaxNeedleSize() ? segmentSize - needles.getMaxNeedleSize() + 1 : 0;
+        for (size_t i = crossingStart; i < crossingEnd; i++)
+        {
+            size_t crossingNeedles = (pos != std::nullopt && i == pos.value()) ? needleIndex : needleList.size();
+            for (size_t j = 0; j < crossingNeedles; j++)
+            {
+                const std::string &needle = needleList[j];
+                if (i + needle.size() > segmentSize && currentOffset + i + needle.size() <= searchEnd
+                    && !Helpers::Mem::memicmp2(segment + i, needle.data(), segmentSize - i, needles.isCaseSensitive())
+                    && compare2(needle.data(), needle.size(), needles.isCaseSensitive(), currentOffset + i))
+                {
+                    needleFound = needle;
+                    return currentOffset + i;
+                }
+            }
+        }
+
+        if (pos != std::nullopt)
+        {
+            needleFound = needleList[needleIndex];
+            return currentOffset + pos.value();
+        }
+
+        currentOffset += segmentSize;
+        if (currentOffset >= searchEnd)
+        {
+            return std::nullopt;
+        }
+    }
+
+    // The container does not expose the memory, find each needle and keep the earliest:
+    std::optional<size_t> earliestPos;
+    for (const std::string &needle : needleList)
+    {
+        std::optional<size_t> f = find(needle.c_str(), needle.size(), needles.isCaseSensitive(), currentOffset, searchEnd - currentOffset);
+        if (f != std::nullopt && (earliestPos == std::nullopt || f.value() < earliestPos.value()))
         {
+            earliestPos = f;
             needleFound = needle;
-            return f;
         }
     }
-    return std::nullopt;
+    return earliestPos;
+}
+
+const char *B_Base::getContiguousSegment(const size_t &, size_t *)
+{
+    return nullptr;
 }
 
 size_t B_Base::size()
@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "b_chunk.h"
+#include "memsearch.h"
 #include "streamable_object.h"
 #include <Mantids30/Helpers/mem.h>
 
@@ -245,6 +246,23 @@ public:
      * @return position of the needle (if found)
      */
     std::optional<size_t> find(const std::list<std::string> &needles, std::string &needleFound, bool caseSensitive = true, const size_t &offset = 0, const size_t &searchSpace = 0);
+    /**
+     * @brief find the earliest occurrence of any needle of a prebuilt set into the container
+     * @param needles needle set (reuse it across searches to avoid building it again).
+     * @param needleFound output: needle found (the first one in the set order when several match at the same position).
+     * @param offset container offset where to start to find.
+     * @param searchSpace search space size in bytes where is going to find the needles. (zero for all the space)
+     * @return position of the needle (if found)
+     */
+    std::optional<size_t> find(const Search::MultiNeedle &needles, std::string &needleFound, const size_t &offset = 0, size_t searchSpace = 0);
+
+    /**
+     * @brief getContiguousSegment Get the data stored contiguously in memory starting at the offset (used to search it directly)
+     * @param offset container offset
+     * @param segmentSize output: bytes available contiguously from the offset
+     * @return pointer to the data, or nullptr if the offset is out of bounds or the container can't expose its memory.
+     */
+    virtual const char *getContiguousSegment(const size_t &offset, size_t *segmentSize);
 
     // Data Size:
     /**
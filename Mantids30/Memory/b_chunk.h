@@ -1,6 +1,8 @@
 #pragma once
 
+#include "slabpool.h"
 #include <Mantids30/Helpers/mem.h>
+#include <algorithm>
 #include <cstring>
 
 namespace Mantids30::Memory::Containers {
@@ -14,6 +16,8 @@ struct BinaryContainerChunk
     {
         rodata = nullptr;
         rosize = 0;
+        block = nullptr;
+        capacity = 0;
         data = nullptr;
         size = 0;
         offset = 0;
@@ -24,13 +28,15 @@ struct BinaryContainerChunk
      */
     void destroy()
     {
-        delete[] data;
+        SlabPool::deallocate(block, capacity);
+        block = nullptr;
+        capacity = 0;
         data = nullptr;
         size = 0;
     }
 
     /**
-     * @brief Displace Move data backwards, removing the first n bytes.
+     * @brief Displace Remove the first n bytes by moving the data head forward (the block is not copied).
      * @param displLen number of bytes to be displaced
      */
     void displace(size_t displLen)
@@ -49,36 +55,25 @@ struct BinaryContainerChunk
             return;
         }
 
-        size_t nContainerSize = size - displLen;
-        char *ndata = new char[nContainerSize];
-        memcpy(ndata, data + displLen, nContainerSize);
-        destroy();
-        data = ndata;
-        size = nContainerSize;
-
-        //** Remember to rearrange next offsets...
+        data += displLen;
+        size -= displLen;
+        offset += displLen;
     }
 
+    /**
+     * @brief truncate Shrink the chunk data up to an absolute offset (the block is not copied).
+     * @param nSize absolute offset in bytes where the data ends.
+     */
     void truncate(size_t nSize)
     {
-        if (nSize >= (offset + size))
-        {
-            return;
-        }
-        if (!nSize || nSize == offset)
+        // Current new chunk size (offsets are handled in modular arithmetic).
+        nSize -= offset;
+
+        if (!nSize || nSize >= size)
         {
             return;
         }
 
-        // Current new chunk size.
-        nSize -= offset;
-
-        char *ndata = new char[nSize];
-        memcpy(ndata, data, nSize);
-
-        destroy();
-
-        data = ndata;
         size = nSize;
     }
 
@@ -86,21 +81,41 @@ struct BinaryContainerChunk
      * @brief Creates a new memory space and copy linear data inside.
      * @param buf pointer of data to be copied.
      * @param count size of data to be copied.
+     * @param blockCapacity size of the memory space to be created (if less than count, count will be used).
+     *                      The block is taken from the SlabPool, so the capacity may be rounded up.
      * @return true if succeed. false otherwise.
      */
-    bool copy(const void *buf, size_t count)
+    bool copy(const void *buf, size_t count, size_t blockCapacity = 0)
     {
         destroy();
-        data = new char[count];
-        if (!data)
+        block = SlabPool::allocate(std::max(count, blockCapacity), &capacity);
+        if (!block)
         {
             return false;
         }
+        data = block;
         size = count;
         memcpy(data, buf, count);
         return true;
     }
 
+    /**
+     * @brief Free space in the block after the data.
+     * @return bytes that can be appended to this chunk without a new allocation.
+     */
+    [[nodiscard]] size_t spareCapacity() const { return block ? static_cast<size_t>((block + capacity) - (data + size)) : 0; }
+
+    /**
+     * @brief Append data in the free space of the block.
+     * @param buf pointer of data to be copied.
+     * @param count size of data to be copied (should not exceed spareCapacity()).
+     */
+    void appendToSpareCapacity(const void *buf, size_t count)
+    {
+        memcpy(data + size, buf, count);
+        size += count;
+    }
+
     /**
      * @brief Offset of the next/following chunk.
      * @return Current Offset + Size of this container (absolute offset in bytes of the next chunk)
@@ -112,7 +127,7 @@ struct BinaryContainerChunk
      * @param l_offset requested absolute offset in bytes.
      * @return true if the requested offset is on this chunk
      */
-    [[nodiscard]] bool containsOffset(const size_t &l_offset) const { return (l_offset >= offset && l_offset < nextOffset()); }
+    [[nodiscard]] bool containsOffset(const size_t &l_offset) const { return (l_offset - offset) < size; }
 
     /**
      * @brief Move the chunk to some specific offset for manipulation
@@ -130,6 +145,12 @@ struct BinaryContainerChunk
     const char *rodata;
     size_t rosize;
 
+    /**
+     * @brief block Allocated memory space (data points inside of it, after the displaced bytes).
+     */
+    char *block;
+    size_t capacity;
+
     char *data;
     size_t size;
     size_t offset;
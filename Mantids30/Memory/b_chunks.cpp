@@ -1,4 +1,5 @@
 #include "b_chunks.h"
+#include "memsearch.h"
 #include <cstring>
 #include <optional>
 
@@ -94,27 +95,20 @@ std::optional<size_t> B_Chunks::truncate2(const size_t &bytes)
         return std::nullopt;
     }
 
-    // If the offset exactly matches the end of a chunk, remove that chunk and all following chunks.
-    if (m_chunksVector[ival].offset == bytes)
+    // If the offset exactly matches the start of the chunk, remove that chunk and all following chunks.
+    if (m_chunks[ival].offset - m_headOffset != bytes)
     {
-        // Border case. Destroy also the last ival.
-        if (ival >= 0)
-        {
-            ival--;
-        }
-    }
-    else
-    {
-        // Otherwise, truncate the current chunk to the given offset.
-        m_chunksVector[ival].truncate(bytes);
+        // Otherwise, truncate the current chunk to the given offset (keeping the block).
+        m_chunks[ival].truncate(m_headOffset + bytes);
+        ival++;
     }
 
     // Remove all chunks after the truncated chunk.
-    for (size_t i = ival + 1; i < m_chunksVector.size(); ++i)
+    while (m_chunks.size() > ival)
     {
-        m_chunksVector[i].destroy();
+        m_chunks.back().destroy();
+        m_chunks.pop_back();
     }
-    m_chunksVector.resize(ival + 1);
 
     // Update the total container size to reflect the truncation.
     setContainerBytes(bytes);
@@ -161,12 +155,27 @@ std::optional<size_t> B_Chunks::append2(const void *buf, const size_t &roLen, bo
         }
     }
 
+    if (!prependMode && !m_chunks.empty())
+    {
+        // Fill the free space left on the last block first (small appends don't create new chunks).
+        const BinaryContainerChunk &lastChunk = m_chunks.back();
+        size_t spareBytes = lastChunk.size < m_maxChunkSize ? std::min({len, lastChunk.spareCapacity(), m_maxChunkSize - lastChunk.size}) : 0;
+        if (spareBytes)
+        {
+            m_chunks.back().appendToSpareCapacity(buf, spareBytes);
+            incContainerBytesCount(spareBytes);
+            *appendedBytes += spareBytes;
+            buf = (static_cast<const char *>(buf)) + spareBytes;
+            len -= spareBytes;
+        }
+    }
+
     while (len)
     {
         size_t chunkSize = std::min(len, m_maxChunkSize);
 
         // Don't create new chunks if we can't handle them.
-        if (m_chunksVector.size() + 1 > m_maxChunks)
+        if (m_chunks.size() + 1 > m_maxChunks)
         {
             // we don´t return error, just the appended bytes won't match the roLen.
             return appendedBytes;
@@ -175,34 +184,33 @@ std::optional<size_t> B_Chunks::append2(const void *buf, const size_t &roLen, bo
         ///////////////////////////////////////////////////////
         // Copy memory:
         BinaryContainerChunk bcc;
-        if (!bcc.copy(buf, chunkSize))
-        {
-            if (prependMode)
-            {
-                recalcChunkOffsets();
-            }
-            // not enough memory.
-            // we don´t return error, just the appended bytes won't match the roLen.
-            return appendedBytes;
-        }
-
-        ///////////////////////////////////////////////////////
-        // Append or prepend the data.
         if (!prependMode)
         {
-            if (m_chunksVector.empty())
+            // Appended blocks grow geometrically (up to the max chunk size), so streams appended in small pieces
+            // use few chunks, while small containers remain small.
+            size_t blockCapacity = m_chunks.empty() ? chunkSize : std::min(m_maxChunkSize, m_chunks.back().capacity * 2);
+            if (!bcc.copy(buf, chunkSize, blockCapacity))
             {
-                bcc.offset = 0;
+                // not enough memory.
+                // we don´t return error, just the appended bytes won't match the roLen.
+                return appendedBytes;
             }
-            else
-            {
-                bcc.offset = m_chunksVector[m_chunksVector.size() - 1].nextOffset();
-            }
-            m_chunksVector.push_back(bcc);
+            bcc.offset = m_chunks.empty() ? m_headOffset : m_chunks.back().nextOffset();
+            m_chunks.push_back(bcc);
+            buf = (static_cast<const char *>(buf)) + chunkSize;
         }
         else
         {
-            m_chunksVector.emplace(m_chunksVector.begin(), bcc);
+            // Prepend from the end of the buffer, so the chunks remain in order.
+            if (!bcc.copy(static_cast<const char *>(buf) + len - chunkSize, chunkSize))
+            {
+                // not enough memory.
+                // we don´t return error, just the appended bytes won't match the roLen.
+                return appendedBytes;
+            }
+            m_headOffset -= chunkSize;
+            bcc.offset = m_headOffset;
+            m_chunks.push_front(bcc);
         }
 
         ///////////////////////////////////////////////////////
@@ -213,15 +221,9 @@ std::optional<size_t> B_Chunks::append2(const void *buf, const size_t &roLen, bo
 
         ////////////////////////////
         // local counters update...
-        buf = (static_cast<const char *>(buf)) + chunkSize;
         len -= chunkSize;
     }
 
-    if (prependMode)
-    {
-        recalcChunkOffsets();
-    }
-
     return appendedBytes;
 }
 
@@ -238,32 +240,34 @@ std::optional<size_t> B_Chunks::displace2(const size_t &roBytesToDisplace)
 
     while (bytesToDisplace)
     {
-        if (m_chunksVector.empty())
+        if (m_chunks.empty())
         {
             return displaced; // not completely displaced
         }
 
-        if (bytesToDisplace >= m_chunksVector[0].size)
+        BinaryContainerChunk &firstChunk = m_chunks.front();
+
+        if (bytesToDisplace >= firstChunk.size)
         {
             // remove this chunk entirely
-            displaced = *displaced + m_chunksVector[0].size;
-            bytesToDisplace -= m_chunksVector[0].size;
-            decContainerBytesCount(m_chunksVector[0].size);
-            m_chunksVector[0].destroy();
-            m_chunksVector.erase(m_chunksVector.begin());
+            displaced = *displaced + firstChunk.size;
+            bytesToDisplace -= firstChunk.size;
+            decContainerBytesCount(firstChunk.size);
+            m_headOffset += firstChunk.size;
+            firstChunk.destroy();
+            m_chunks.pop_front();
         }
         else
         {
-            // displace the chunk partially.
+            // displace the chunk partially (moving the chunk head, without copying the data).
             displaced = *displaced + bytesToDisplace;
-            m_chunksVector[0].displace(bytesToDisplace);
+            firstChunk.displace(bytesToDisplace);
             decContainerBytesCount(bytesToDisplace);
+            m_headOffset += bytesToDisplace;
             bytesToDisplace = 0;
         }
     }
 
-    // Rearrange offsets here.
-    recalcChunkOffsets();
     return displaced;
 }
 
@@ -280,11 +284,12 @@ bool B_Chunks::clearMmapedContainer()
 
 bool B_Chunks::clearChunks()
 {
-    for (BinaryContainerChunk bcc : m_chunksVector)
+    for (BinaryContainerChunk &bcc : m_chunks)
     {
         bcc.destroy();
     }
-    m_chunksVector.clear();
+    m_chunks.clear();
+    m_headOffset = 0;
     return true;
 }
 
@@ -319,50 +324,7 @@ std::optional<size_t> B_Chunks::copyToStream2(std::ostream &bc, const size_t &ro
         bytes = size() - offset;
     }
 
-    size_t dataToCopy = bytes;
-    std::vector<BinaryContainerChunk> copyChunks;
-
-    // iterate over chunks and put that data on the new bc.
-    for (BinaryContainerChunk &i : m_chunksVector)
-    {
-        BinaryContainerChunk currentChunk = i;
-
-        // arrange from non-ro elements.
-        if (currentChunk.rodata == nullptr)
-        {
-            currentChunk.rodata = currentChunk.data;
-            currentChunk.rosize = currentChunk.size;
-        }
-
-        if (offset > 0)
-        {
-            if (offset > currentChunk.rosize)
-            {
-                // pass this chunk...
-                offset -= currentChunk.rosize;
-                continue; // chunk consumed.
-            }
-            else
-            {
-                currentChunk.rosize -= offset;
-                currentChunk.rodata += offset;
-                offset = 0;
-            }
-        }
-
-        if (!offset)
-        {
-            currentChunk.rosize = std::min(dataToCopy, currentChunk.rosize);
-            copyChunks.push_back(currentChunk);
-            dataToCopy -= currentChunk.rosize;
-            if (!dataToCopy)
-            {
-                break; // :)
-            }
-        }
-    }
-
-    return copyToStreamUsingCleanVector(bc, copyChunks);
+    return copyToStreamUsingCleanVector(bc, getCopyChunks(bytes, offset));
 }
 
 std::optional<size_t> B_Chunks::copyToStreamableObject2(StreamableObject &bc, const size_t &roBytes, const size_t &roOffset)
@@ -396,50 +358,7 @@ std::optional<size_t> B_Chunks::copyToStreamableObject2(StreamableObject &bc, co
         bytes = size() - offset;
     }
 
-    size_t dataToCopy = bytes;
-    std::vector<BinaryContainerChunk> copyChunks;
-
-    // iterate over chunks and put that data on the new bc.
-    for (BinaryContainerChunk &i : m_chunksVector)
-    {
-        BinaryContainerChunk currentChunk = i;
-
-        // arrange from non-ro elements.
-        if (currentChunk.rodata == nullptr)
-        {
-            currentChunk.rodata = currentChunk.data;
-            currentChunk.rosize = currentChunk.size;
-        }
-
-        if (offset > 0)
-        {
-            if (offset > currentChunk.rosize)
-            {
-                // pass this chunk...
-                offset -= currentChunk.rosize;
-                continue; // chunk consumed.
-            }
-            else
-            {
-                currentChunk.rosize -= offset;
-                currentChunk.rodata += offset;
-                offset = 0;
-            }
-        }
-
-        if (!offset)
-        {
-            currentChunk.rosize = std::min(currentChunk.rosize, dataToCopy);
-            copyChunks.push_back(currentChunk);
-            dataToCopy -= currentChunk.rosize;
-            if (!dataToCopy)
-            {
-                break; // :)
-            }
-        }
-    }
-
-    return copyToStreamableObjectUsingCleanVector(bc, copyChunks);
+    return copyToStreamableObjectUsingCleanVector(bc, getCopyChunks(bytes, offset));
 }
 
 std::optional<size_t> B_Chunks::copyToBuffer2(void *buf, const size_t &roBytes, const size_t &offset)
@@ -478,8 +397,8 @@ std::optional<size_t> B_Chunks::copyToBuffer2(void *buf, const size_t &roBytes,
         return std::nullopt;
     }
 
-    BinaryContainerChunk currentChunk = m_chunksVector[icurrentChunk];
-    currentChunk.moveToOffset(offset);
+    BinaryContainerChunk currentChunk = m_chunks[icurrentChunk];
+    currentChunk.moveToOffset(m_headOffset + offset);
 
     while (bytes)
     {
@@ -503,20 +422,19 @@ std::optional<size_t> B_Chunks::copyToBuffer2(void *buf, const size_t &roBytes,
         }
 
         // proceed to the next chunk...
-        if (icurrentChunk == m_chunksVector.size() - 1)
+        if (icurrentChunk == m_chunks.size() - 1)
         {
             break;
         }
         icurrentChunk++;
-        currentChunk = m_chunksVector[icurrentChunk];
+        currentChunk = m_chunks[icurrentChunk];
     }
 
     return copiedBytes;
 }
 
-bool B_Chunks::compare2(const void *buf, const size_t &len, bool caseSensitive, const size_t &roOffset)
+bool B_Chunks::compare2(const void *buf, const size_t &len, bool caseSensitive, const size_t &offset)
 {
-    size_t offset = roOffset;
     if (m_mmapContainer)
     {
         return m_mmapContainer->compare(buf, len, caseSensitive, offset);
@@ -541,70 +459,52 @@ bool B_Chunks::compare2(const void *buf, const size_t &len, bool caseSensitive,
     }
 
     /////////////////////////////
-    size_t dataToCompare = len, dataCompared = 0;
+    size_t dataToCompare = len;
 
-    // iterate over chunks and put that data on the new bc.
-
-    size_t vpos = 0, vsize = m_chunksVector.size();
-    for (; vpos < vsize; vpos++)
+    // start at the chunk containing the offset and compare chunk by chunk.
+    size_t vpos = I_Chunk_GetPosForOffset(offset), vsize = m_chunks.size();
+    if (vpos == MAX_SIZE_T)
     {
-        BinaryContainerChunk *i = &(m_chunksVector[vpos]);
-        BinaryContainerChunk currentChunk = *i; // copy the chunk..
+        return false;
+    }
 
-        // TODO: CHECK.
-        // if offset is >0...
-        if (offset > 0)
-        {
-            if (offset > i->size)
-            {
-                // pass this chunk...
-                offset -= i->size;
-                continue; // chunk consumed.
-            }
-            else
-            {
-                currentChunk.size -= offset;
-                currentChunk.data += offset;
+    BinaryContainerChunk currentChunk = m_chunks[vpos];
+    currentChunk.moveToOffset(m_headOffset + offset);
 
-                offset = 0;
-            }
-        }
+    for (;;)
+    {
+        size_t currentChunkSize = std::min(dataToCompare, currentChunk.size);
 
-        if (!offset)
+        if (Mantids30::Helpers::Mem::memicmp2(currentChunk.data, buf, currentChunkSize, caseSensitive))
         {
-            size_t currentChunkSize = std::min(dataToCompare, currentChunk.size);
+            return false; // does not match!
+        }
 
-            if (Mantids30::Helpers::Mem::memicmp2(currentChunk.data, buf, currentChunkSize, caseSensitive))
-            {
-                return false; // does not match!
-            }
+        dataToCompare -= currentChunkSize;
+        buf = (static_cast<const char *>(buf)) + currentChunkSize;
 
-            dataToCompare -= currentChunkSize;
-            dataCompared += currentChunkSize;
-            buf = (static_cast<const char *>(buf)) + currentChunkSize;
+        // Ended.!
+        if (!dataToCompare)
+        {
+            return true;
+        }
 
-            // Ended.!
-            if (!dataToCompare)
-            {
-                return true;
-            }
+        if (++vpos == vsize)
+        {
+            // If there is any data to compare left, return false.
+            return false;
         }
+        currentChunk = m_chunks[vpos];
     }
-
-    // TODO: check the logic here
-    // If there is any data to compare left, return false.
-    return dataToCompare == 0;
 }
 
-// TODO: ICASE
-std::optional<size_t> B_Chunks::findChar(const int &c, const size_t &roOffset, size_t searchSpace, bool caseSensitive)
+std::optional<size_t> B_Chunks::findChar(const int &c, const size_t &offset, size_t searchSpace, bool caseSensitive)
 {
     if (caseSensitive && !isalpha(static_cast<unsigned char>(c)))
     {
         caseSensitive = false;
     }
 
-    size_t offset = roOffset;
     if (m_mmapContainer)
     {
         return m_mmapContainer->findChar(c, offset);
@@ -622,145 +522,114 @@ std::optional<size_t> B_Chunks::findChar(const int &c, const size_t &roOffset, s
         return std::nullopt;
     }
 
-    size_t retpos = 0;
-    size_t vpos = 0, vsize = m_chunksVector.size();
-    for (; vpos < vsize; vpos++)
+    size_t vpos = I_Chunk_GetPosForOffset(offset), vsize = m_chunks.size();
+    if (vpos == MAX_SIZE_T)
     {
-        BinaryContainerChunk *originalChunk = &(m_chunksVector[vpos]);
-        BinaryContainerChunk currentChunk = *originalChunk; // copy the chunk..
+        return std::nullopt;
+    }
 
-        // if offset is >0...
-        if (offset > 0)
-        {
-            if (offset > originalChunk->size)
-            {
-                // pass this chunk...
-                offset -= originalChunk->size;
-                // chunk discarded.
-                retpos += originalChunk->size;
+    BinaryContainerChunk currentChunk = m_chunks[vpos];
+    currentChunk.moveToOffset(m_headOffset + offset);
+    size_t retpos = offset;
 
-                continue; // chunk consumed.
-            }
-            else
-            {
-                currentChunk.size -= offset;
-                currentChunk.data += offset;
-
-                offset = 0;
-            }
-        }
+    while (searchSpace)
+    {
+        // (when caseSensitive is set, both the upper and the lower case characters are reported)
+        size_t currentSearchSpace = std::min(searchSpace, currentChunk.size);
+        std::optional<size_t> pos = Search::findByte(currentChunk.data, currentSearchSpace, static_cast<unsigned char>(c), !caseSensitive);
 
-        if (offset == 0)
+        if (pos)
         {
-            char *pos = nullptr;
-
-            if (!caseSensitive)
-            {
-                pos = static_cast<char *>(memchr(currentChunk.data, c, std::min(searchSpace, currentChunk.size)));
-            }
-            else
-            {
-                // Case sensitive...
-                size_t currentSearchSpace = std::min(searchSpace, currentChunk.size);
-
-                char *pos_upper = static_cast<char *>(memchr(currentChunk.data, std::toupper(c), currentSearchSpace));
-                char *pos_lower = static_cast<char *>(memchr(currentChunk.data, std::tolower(c), currentSearchSpace));
-
-                if (pos_upper && pos_lower)
-                {
-                    pos = std::min(pos_upper, pos_lower);
-                }
-                else
-                {
-                    pos = pos_upper ? pos_upper : pos_lower;
-                }
-            }
+            // report the position.
+            return *pos + retpos;
+        }
 
-            if (pos)
-            {
-                // report the position.
-                return static_cast<size_t>(pos - (originalChunk->data)) + retpos;
-            }
+        searchSpace -= currentSearchSpace;
+        retpos += currentSearchSpace;
 
-            if (searchSpace > currentChunk.size)
-            {
-                searchSpace -= currentChunk.size;
-            }
-            else
-            {
-                return std::nullopt;
-            }
+        if (++vpos == vsize)
+        {
+            break;
         }
-
-        // chunk discarded.
-        retpos += originalChunk->size;
+        currentChunk = m_chunks[vpos];
     }
     return std::nullopt;
 }
 
-void B_Chunks::recalcChunkOffsets()
+const char *B_Chunks::getContiguousSegment(const size_t &offset, size_t *segmentSize)
 {
-    size_t currentOffset = 0;
-    size_t vpos = 0, vsize = m_chunksVector.size();
-    for (BinaryContainerChunk *i = &(m_chunksVector[vpos]); vpos < vsize; vpos++)
+    if (m_mmapContainer)
     {
-        i->offset = currentOffset;
-        currentOffset = i->nextOffset();
+        return m_mmapContainer->getContiguousSegment(offset, segmentSize);
     }
-}
 
-size_t B_Chunks::I_Chunk_GetPosForOffset(const size_t &offset, size_t curpos, size_t curmax, size_t curmin)
-{
-    // The Search Algorithm!
-    if (m_chunksVector.empty())
+    size_t ival = I_Chunk_GetPosForOffset(offset);
+    if (ival == MAX_SIZE_T)
     {
-        return MAX_SIZE_T;
+        return nullptr;
     }
 
-    // Boundaries definition:
-    if (curpos == MAX_SIZE_T)
-    {
-        curpos = m_chunksVector.size() == 1 ? 0 : (m_chunksVector.size() / 2) - 1;
-    }
-    if (curmax == MAX_SIZE_T)
+    const BinaryContainerChunk &chunk = m_chunks[ival];
+    size_t chunkOffset = (m_headOffset + offset) - chunk.offset;
+    *segmentSize = chunk.size - chunkOffset;
+    return chunk.data + chunkOffset;
+}
+
+std::vector<BinaryContainerChunk> B_Chunks::getCopyChunks(size_t bytes, const size_t &offset)
+{
+    std::vector<BinaryContainerChunk> copyChunks;
+
+    size_t vpos = I_Chunk_GetPosForOffset(offset), vsize = m_chunks.size();
+    if (!bytes || vpos == MAX_SIZE_T)
     {
-        curmax = m_chunksVector.size() == 1 ? 0 : m_chunksVector.size() - 1;
+        return copyChunks;
     }
-    if (curmin == MAX_SIZE_T)
+
+    BinaryContainerChunk currentChunk = m_chunks[vpos];
+    currentChunk.moveToOffset(m_headOffset + offset);
+
+    for (;;)
     {
-        curmin = 0;
+        // arrange from non-ro elements.
+        currentChunk.rodata = currentChunk.data;
+        currentChunk.rosize = std::min(bytes, currentChunk.size);
+        copyChunks.push_back(currentChunk);
+        bytes -= currentChunk.rosize;
+
+        if (!bytes || ++vpos == vsize)
+        {
+            break; // :)
+        }
+        currentChunk = m_chunks[vpos];
     }
 
-    ////////////////////////////////////////////////////////////////
-    // Verify current chunk. (VERIFICATION)
-    if (m_chunksVector[curpos].containsOffset(offset))
+    return copyChunks;
+}
+
+size_t B_Chunks::I_Chunk_GetPosForOffset(const size_t &offset)
+{
+    if (offset >= size())
     {
-        return curpos;
+        return MAX_SIZE_T;
     }
-    ////////////////////////////////////////////////////////////////
 
-    // If not found, continue searching:
-    if (offset < m_chunksVector[curpos].offset)
+    // The chunk offsets are counted from m_headOffset (modular arithmetic), so the relative offsets are sorted.
+    // Find the last chunk starting at or before the requested offset:
+    size_t curmin = 0, curmax = m_chunks.size();
+    while (curmax - curmin > 1)
     {
-        // search down. (from curmin to curpos-1)
-        if (curpos == curmin)
+        size_t curpos = curmin + (curmax - curmin) / 2;
+        if (m_chunks[curpos].offset - m_headOffset <= offset)
         {
-            return MAX_SIZE_T; // Not any element down.
+            curmin = curpos;
         }
-        ///////////////
-        curmax = curpos - 1;
-        return I_Chunk_GetPosForOffset(offset, curmin == curmax ? curmin : curmin + ((curmax + 1 - curmin) / 2) - (curmax - curmin) % 2, curmax, curmin);
-    }
-    else
-    {
-        // search up. (from curpos+1 to curmax)
-        if (curpos == curmax)
+        else
         {
-            return MAX_SIZE_T; // Not any element up.
+            curmax = curpos;
         }
-        curmin = curpos + 1;
-        return I_Chunk_GetPosForOffset(offset, curmin == curmax ? curmin : curmin + ((curmax + 1 - curmin) / 2) - (curmax - curmin) % 2, curmax, curmin);
     }
+
+    return m_chunks[curmin].containsOffset(m_headOffset + offset) ? curmin : MAX_SIZE_T;
 }
 
 std::shared_ptr<B_MMAP> B_Chunks::getMmapContainer() const
@@ -3,6 +3,7 @@
 #include "b_base.h"
 #include "b_mmap.h"
 
+#include <deque>
 #include <memory>
 #include <vector>
 
@@ -68,6 +69,13 @@ public:
      * @return
      */
     std::optional<size_t> findChar(const int &c, const size_t &roOffset = 0, size_t searchSpace = 0, bool caseSensitive = false) override;
+    /**
+     * @brief getContiguousSegment Get the data stored contiguously in memory starting at the offset
+     * @param offset container offset
+     * @param segmentSize output: bytes available contiguously from the offset
+     * @return pointer to the data, or nullptr if out of bounds.
+     */
+    const char *getContiguousSegment(const size_t &offset, size_t *segmentSize) override;
 
 protected:
     /**
@@ -77,7 +85,7 @@ protected:
      */
     std::optional<size_t> truncate2(const size_t &bytes) override;
     /**
-     * @brief Append more data to current chunks. (creates new chunks of data)
+     * @brief Append more data to current chunks. (fills the free space of the last chunk, and creates new chunks of data)
      * @param data data to be appended
      * @param len data size in bytes to be appended
      * @param prependMode mode: true will prepend the data, false will append.
@@ -133,20 +141,30 @@ private:
     bool clearChunks();
 
     /**
-     * @brief Recalculates every offset on the list
+     * @brief getCopyChunks Get the read-only chunk references of a data range (to be copied out).
+     * @param bytes size of the range in bytes (should be inside the container).
+     * @param offset starting point (offset) in bytes.
+     * @return ordered chunk references with rodata/rosize set.
      */
-    void recalcChunkOffsets();
+    std::vector<BinaryContainerChunk> getCopyChunks(size_t bytes, const size_t &offset);
     /**
-     * @brief getChunkForOffset Get chunk containing offset
+     * @brief getChunkForOffset Get chunk containing offset (binary search over the chunk offsets)
      * @param offset offset from zero on binarycontainer.
-     * @return -1 if not found, or the vector position of the chunk.
+     * @return -1 if not found, or the deque position of the chunk.
      */
-    size_t I_Chunk_GetPosForOffset(const size_t &offset, size_t curpos = MAX_SIZE_T, size_t curmax = MAX_SIZE_T, size_t curmin = MAX_SIZE_T);
+    size_t I_Chunk_GetPosForOffset(const size_t &offset);
 
     /**
-     * @brief chunksVector defines a vector containing ordered chunks
+     * @brief m_chunks defines a deque containing ordered chunks
+     *
+     * Each chunk keeps its absolute offset counted from m_headOffset, so displacing or prepending data only moves
+     * m_headOffset (using modular arithmetic) and the offsets of the other chunks remain valid without recalculation.
+     */
+    std::deque<BinaryContainerChunk> m_chunks;
+    /**
+     * @brief m_headOffset absolute offset of the first byte of the container.
      */
-    std::vector<BinaryContainerChunk> m_chunksVector;
+    size_t m_headOffset = 0;
     /**
      * @brief Max number of Chunks in memory
      */
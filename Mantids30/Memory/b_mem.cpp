@@ -111,6 +111,17 @@ std::optional<size_t> B_MEM::findChar(const int &charInt, const size_t &offset,
     return static_cast<size_t>(cPos - linearMem);
 }
 
+const char *B_MEM::getContiguousSegment(const size_t &offset, size_t *segmentSize)
+{
+    size_t currentSize = size();
+    if (!linearMem || offset >= currentSize)
+    {
+        return nullptr;
+    }
+    *segmentSize = currentSize - offset;
+    return linearMem + offset;
+}
+
 std::optional<size_t> B_MEM::truncate2(const size_t &bytes)
 {
     setContainerBytes(bytes);
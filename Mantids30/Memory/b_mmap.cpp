@@ -75,6 +75,11 @@ std::optional<size_t> B_MMAP::findChar(const int &c, const size_t &offset, size_
     return mem.findChar(c, offset, searchSpace, caseSensitive);
 }
 
+const char *B_MMAP::getContiguousSegment(const size_t &offset, size_t *segmentSize)
+{
+    return mem.getContiguousSegment(offset, segmentSize);
+}
+
 std::optional<size_t> B_MMAP::truncate2(const size_t &bytes)
 {
     if (!fileReference.mmapTruncate(bytes))
@@ -149,6 +154,22 @@ std::optional<size_t> B_MMAP::copyToStream2(std::ostream &out, const size_t &byt
 
 std::optional<size_t> B_MMAP::copyToStreamableObject2(StreamableObject &bc, const size_t &bytes, const size_t &offset)
 {
+    // Try the zero-copy path first (bounds already checked by appendTo, and the mmap starts at the file offset 0)
+    if (bytes && fileReference.getFileDescriptor() != -1)
+    {
+        std::optional<size_t> sentBytes = bc.writeFromFileDescriptor(fileReference.getFileDescriptor(), offset, bytes);
+        if (sentBytes != std::nullopt)
+        {
+            if (*sentBytes != bytes)
+            {
+                bc.writeStatus += -1;
+                return std::nullopt;
+            }
+            return sentBytes;
+        }
+    }
+
+    // The destination can't take the file descriptor (eg. a transformer is in the way), copy from the memory map:
     return mem.appendTo(bc, bytes, offset);
 }
 
@@ -164,8 +185,9 @@ bool B_MMAP::compare2(const void *buf, const size_t &count, bool caseSensitive,
 
 void B_MMAP::reMapMemoryContainer()
 {
+    // size() reports the referenced memory, so the new size has to come from the file:
     setContainerBytes(fileReference.getFileOpenSize());
-    mem.reference(fileReference.getMmapAddr(), size());
+    mem.reference(fileReference.getMmapAddr(), fileReference.getFileOpenSize());
 }
 
 std::string B_MMAP::getRandomFileName()
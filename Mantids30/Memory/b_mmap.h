@@ -39,6 +39,13 @@ public:
      * @return
      */
     std::optional<size_t> findChar(const int &c, const size_t &offset = 0, size_t searchSpace = 0, bool caseSensitive = false) override;
+    /**
+     * @brief getContiguousSegment Get the data stored contiguously in memory starting at the offset
+     * @param offset container offset
+     * @param segmentSize output: bytes available contiguously from the offset
+     * @return pointer to the data, or nullptr if out of bounds.
+     */
+    const char *getContiguousSegment(const size_t &offset, size_t *segmentSize) override;
 
 protected:
     /**
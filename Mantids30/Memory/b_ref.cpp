@@ -69,6 +69,23 @@ std::optional<size_t> B_Ref::findChar(const int &c, const size_t &offset, size_t
     return referencedBC->findChar(c, referencedOffset + offset, searchSpace, caseSensitive);
 }
 
+const char *B_Ref::getContiguousSegment(const size_t &offset, size_t *segmentSize)
+{
+    size_t currentSize = size();
+    if (!referencedBC || offset >= currentSize)
+    {
+        return nullptr;
+    }
+
+    const char *segment = referencedBC->getContiguousSegment(referencedOffset + offset, segmentSize);
+    if (segment)
+    {
+        // Don't go beyond the referenced bytes:
+        *segmentSize = std::min(*segmentSize, currentSize - offset);
+    }
+    return segment;
+}
+
 std::optional<size_t> B_Ref::truncate2(const size_t &bytes)
 {
     referencedMaxBytes = bytes;
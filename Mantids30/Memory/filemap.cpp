@@ -153,6 +153,11 @@ char *FileMap::getMmapAddr() const
     return mmapAddr;
 }
 
+int FileMap::getFileDescriptor() const
+{
+    return fd;
+}
+
 size_t FileMap::getFileOpenSize() const
 {
     return fileOpenSize;
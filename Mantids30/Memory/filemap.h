@@ -62,6 +62,11 @@ public:
 
     [[nodiscard]] char *getMmapAddr() const;
 
+    /**
+     * @brief getFileDescriptor Get the file descriptor of the openned file (-1 if there is no file openned)
+     */
+    [[nodiscard]] int getFileDescriptor() const;
+
     void setDeleteFileOnDestruction(bool value);
 
 private:
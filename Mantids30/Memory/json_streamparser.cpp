@@ -0,0 +1,838 @@
+#include "json_streamparser.h"
+
+#include <cstring>
+#include <locale>
+#include <sstream>
+
+using namespace Mantids30::Memory::Streams;
+
+namespace {
+
+const char UTF8_BOM[] = "\xEF\xBB\xBF";
+
+bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+bool isWhitespace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+void appendCodePointAsUTF8(std::string &str, uint32_t cp)
+{
+    if (cp <= 0x7F)
+    {
+        str.push_back(static_cast<char>(cp));
+    }
+    else if (cp <= 0x7FF)
+    {
+        str.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+        str.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+    else if (cp <= 0xFFFF)
+    {
+        str.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+        str.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        str.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+    else
+    {
+        str.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+        str.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+        str.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        str.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+}
+
+} // namespace
+
+JSONStreamParser::JSONStreamParser(Handler *handler)
+{
+    reset(handler);
+}
+
+void JSONStreamParser::reset(Handler *handler)
+{
+    m_handler = handler;
+    m_state = State::VALUE;
+    m_token = Token::BOM;
+    m_containers.clear();
+    m_string.clear();
+    m_tokenChars.clear();
+    m_stringIsKey = false;
+    m_unicodeCodePoint = 0;
+    m_pendingHighSurrogate = 0;
+    m_unicodeDigits = 0;
+    m_parsedBytes = 0;
+    m_elementCount = 0;
+    m_errorMessage.clear();
+}
+
+bool JSONStreamParser::parse(const char *data, size_t size)
+{
+    if (m_state == State::FAILED)
+    {
+        return false;
+    }
+
+    if (size > limits.maxSize - m_parsedBytes)
+    {
+        return fail("document size limit exceeded");
+    }
+
+    size_t i = 0;
+    while (i < size)
+    {
+        if (m_state == State::DONE && m_token == Token::NONE)
+        {
+            // The data after the root value is ignored.
+            break;
+        }
+
+        if (m_token == Token::STRING && !m_pendingHighSurrogate)
+        {
+            // Fast path: copy the unescaped characters at once.
+            size_t j = i;
+            while (j < size && data[j] != '"' && data[j] != '\\')
+            {
+                j++;
+            }
+            if (!appendToString(data + i, j - i))
+            {
+                return false;
+            }
+            m_parsedBytes += j - i;
+            i = j;
+            if (i == size)
+            {
+                break;
+            }
+        }
+        else if (m_token == Token::NONE)
+        {
+            // Fast path: skip the whitespaces.
+            while (i < size && isWhitespace(data[i]))
+            {
+                i++;
+                m_parsedBytes++;
+            }
+            if (i == size)
+            {
+                break;
+            }
+        }
+
+        // Numbers are completed by the next character, which is processed again (as a new token).
+        m_reprocessChar = false;
+        if (!parseChar(data[i]))
+        {
+            return false;
+        }
+        if (m_reprocessChar)
+        {
+            continue;
+        }
+        i++;
+        m_parsedBytes++;
+    }
+
+    return true;
+}
+
+bool JSONStreamParser::finish()
+{
+    if (m_state == State::FAILED)
+    {
+        return false;
+    }
+
+    // A number root value is completed by the end of the document:
+    if (m_token == Token::NUMBER && !completeNumber())
+    {
+        return false;
+    }
+    if (m_token == Token::LITERAL)
+    {
+        return fail("syntax error: value, object or array expected");
+    }
+
+    if (m_state != State::DONE)
+    {
+        return fail(m_parsedBytes ? "unexpected end of the document" : "empty document");
+    }
+    return true;
+}
+
+bool JSONStreamParser::parseChar(char c)
+{
+    switch (m_token)
+    {
+    case Token::BOM:
+        if (m_tokenChars.size() < 3 && c == UTF8_BOM[m_tokenChars.size()])
+        {
+            m_tokenChars.push_back(c);
+            if (m_tokenChars.size() == 3)
+            {
+                m_tokenChars.clear();
+                m_token = Token::NONE;
+            }
+            return true;
+        }
+        if (!m_tokenChars.empty())
+        {
+            return fail("invalid byte order mark");
+        }
+        m_token = Token::NONE;
+        return startToken(c);
+    case Token::NONE:
+        return startToken(c);
+    case Token::STRING:
+        if (m_pendingHighSurrogate && c != '\\')
+        {
+            return fail("expecting the second half of a unicode surrogate pair");
+        }
+        if (c == '"')
+        {
+            m_token = Token::NONE;
+            return completeString();
+        }
+        if (c == '\\')
+        {
+            m_token = Token::STRING_ESCAPE;
+            return true;
+        }
+        return appendToString(&c, 1);
+    case Token::STRING_ESCAPE:
+    {
+        if (m_pendingHighSurrogate && c != 'u')
+        {
+            return fail("expecting the second half of a unicode surrogate pair");
+        }
+        m_token = Token::STRING;
+        char unescaped;
+        switch (c)
+        {
+        case '"':
+        case '\\':
+        case '/':
+            unescaped = c;
+            break;
+        case 'b':
+            unescaped = '\b';
+            break;
+        case 'f':
+            unescaped = '\f';
+            break;
+        case 'n':
+            unescaped = '\n';
+            break;
+        case 'r':
+            unescaped = '\r';
+            break;
+        case 't':
+            unescaped = '\t';
+            break;
+        case 'u':
+            m_token = Token::STRING_UNICODE;
+            m_unicodeCodePoint = 0;
+            m_unicodeDigits = 0;
+            return true;
+        default:
+            return fail("bad escape sequence in string");
+        }
+        return appendToString(&unescaped, 1);
+    }
+    case Token::STRING_UNICODE:
+    {
+        uint32_t digit;
+        if (c >= '0' && c <= '9')
+        {
+            digit = static_cast<uint32_t>(c - '0');
+        }
+        else if (c >= 'a' && c <= 'f')
+        {
+            digit = static_cast<uint32_t>(c - 'a' + 10);
+        }
+        else if (c >= 'A' && c <= 'F')
+        {
+            digit = static_cast<uint32_t>(c - 'A' + 10);
+        }
+        else
+        {
+            return fail("bad unicode escape sequence in string");
+        }
+        m_unicodeCodePoint = (m_unicodeCodePoint << 4) | digit;
+        if (++m_unicodeDigits == 4)
+        {
+            m_token = Token::STRING;
+            return completeUnicodeEscape();
+        }
+        return true;
+    }
+    case Token::NUMBER:
+    {
+        // Number grammar: -?[0-9]+(\.[0-9]*)?([eE][+-]?[0-9]+)?
+        char last = m_tokenChars.back();
+        bool accepted = isDigit(c) || (c == '.' && m_tokenChars.find_first_of(".eE") == std::string::npos && isDigit(last))
+                        || ((c == 'e' || c == 'E') && m_tokenChars.find_first_of("eE") == std::string::npos && last != '-')
+                        || ((c == '+' || c == '-') && (last == 'e' || last == 'E'));
+        if (accepted)
+        {
+            if (m_tokenChars.size() >= limits.maxStringSize)
+            {
+                return fail("number size limit exceeded");
+            }
+            m_tokenChars.push_back(c);
+            return true;
+        }
+        m_reprocessChar = true;
+        return completeNumber();
+    }
+    case Token::LITERAL:
+        // Literals end with their last character (as in JsonCpp)
+        m_tokenChars.push_back(c);
+        if (m_tokenChars == "true" || m_tokenChars == "false" || m_tokenChars == "null")
+        {
+            return completeLiteral();
+        }
+        if (strncmp("true", m_tokenChars.c_str(), m_tokenChars.size()) != 0 && strncmp("false", m_tokenChars.c_str(), m_tokenChars.size()) != 0
+            && strncmp("null", m_tokenChars.c_str(), m_tokenChars.size()) != 0)
+        {
+            return fail("syntax error: value, object or array expected");
+        }
+        return true;
+    case Token::COMMENT_START:
+        if (c == '/')
+        {
+            m_token = Token::LINE_COMMENT;
+            return true;
+        }
+        if (c == '*')
+        {
+            m_token = Token::BLOCK_COMMENT;
+            return true;
+        }
+        return fail("syntax error: unexpected '/'");
+    case Token::LINE_COMMENT:
+        if (c == '\n' || c == '\r')
+        {
+            m_token = Token::NONE;
+        }
+        return true;
+    case Token::BLOCK_COMMENT:
+        if (c == '*')
+        {
+            m_token = Token::BLOCK_COMMENT_STAR;
+        }
+        return true;
+    case Token::BLOCK_COMMENT_STAR:
+        if (c == '/')
+        {
+            m_token = Token::NONE;
+        }
+        else if (c != '*')
+        {
+            m_token = Token::BLOCK_COMMENT;
+        }
+        return true;
+    }
+    return true;
+}
+
+bool JSONStreamParser::startToken(char c)
+{
+    if (isWhitespace(c))
+    {
+        return true;
+    }
+    if (c == '/')
+    {
+        m_token = Token::COMMENT_START;
+        return true;
+    }
+
+    switch (m_state)
+    {
+    case State::VALUE:
+    case State::ARRAY_VALUE_OR_END:
+        if (c == ']' && m_state == State::ARRAY_VALUE_OR_END)
+        {
+            // Empty array or trailing comma.
+            m_containers.pop_back();
+            if (m_handler && !m_handler->onArrayEnd())
+            {
+                return fail("parsing stopped by the handler");
+            }
+            return completeValue();
+        }
+        if (c == '{' || c == '[')
+        {
+            if (m_containers.size() >= limits.maxDepth)
+            {
+                return fail("depth limit exceeded");
+            }
+            if (!startValue())
+            {
+                return false;
+            }
+            m_containers.push_back(c == '[');
+            m_state = c == '[' ? State::ARRAY_VALUE_OR_END : State::OBJECT_KEY_OR_END;
+            if (m_handler && !(c == '[' ? m_handler->onArrayStart() : m_handler->onObjectStart()))
+            {
+                return fail("parsing stopped by the handler");
+            }
+            return true;
+        }
+        if (c == '"')
+        {
+            m_token = Token::STRING;
+            m_stringIsKey = false;
+            m_string.clear();
+            return startValue();
+        }
+        if (c == '-' || isDigit(c))
+        {
+            m_token = Token::NUMBER;
+            m_tokenChars.assign(1, c);
+            return startValue();
+        }
+        if (c >= 'a' && c <= 'z')
+        {
+            m_token = Token::LITERAL;
+            m_tokenChars.clear();
+            if (!startValue())
+            {
+                return false;
+            }
+            return parseChar(c);
+        }
+        return fail("syntax error: value, object or array expected");
+    case State::OBJECT_KEY_OR_END:
+        if (c == '}')
+        {
+            // Empty object or trailing comma.
+            m_containers.pop_back();
+            if (m_handler && !m_handler->onObjectEnd())
+            {
+                return fail("parsing stopped by the handler");
+            }
+            return completeValue();
+        }
+        if (c == '"')
+        {
+            m_token = Token::STRING;
+            m_stringIsKey = true;
+            m_string.clear();
+            return true;
+        }
+        return fail("missing '}' or object member name");
+    case State::OBJECT_COLON:
+        if (c == ':')
+        {
+            m_state = State::VALUE;
+            return true;
+        }
+        return fail("missing ':' after object member name");
+    case State::OBJECT_COMMA_OR_END:
+        if (c == ',')
+        {
+            m_state = State::OBJECT_KEY_OR_END;
+            return true;
+        }
+        if (c == '}')
+        {
+            m_containers.pop_back();
+            if (m_handler && !m_handler->onObjectEnd())
+            {
+                return fail("parsing stopped by the handler");
+            }
+            return completeValue();
+        }
+        return fail("missing ',' or '}' in object declaration");
+    case State::ARRAY_COMMA_OR_END:
+        if (c == ',')
+        {
+            m_state = State::ARRAY_VALUE_OR_END;
+            return true;
+        }
+        if (c == ']')
+        {
+            m_containers.pop_back();
+            if (m_handler && !m_handler->onArrayEnd())
+            {
+                return fail("parsing stopped by the handler");
+            }
+            return completeValue();
+        }
+        return fail("missing ',' or ']' in array declaration");
+    case State::DONE:
+        // Comments/whitespaces after the root value.
+        return true;
+    case State::FAILED:
+        return false;
+    }
+    return true;
+}
+
+bool JSONStreamParser::startValue()
+{
+    if (++m_elementCount > limits.maxElementCount)
+    {
+        return fail("element count limit exceeded");
+    }
+    return true;
+}
+
+bool JSONStreamParser::completeValue()
+{
+    if (m_containers.empty())
+    {
+        m_state = State::DONE;
+    }
+    else
+    {
+        m_state = m_containers.back() ? State::ARRAY_COMMA_OR_END : State::OBJECT_COMMA_OR_END;
+    }
+    return true;
+}
+
+bool JSONStreamParser::completeString()
+{
+    if (m_stringIsKey)
+    {
+        m_state = State::OBJECT_COLON;
+        if (m_handler && !m_handler->onKey(m_string))
+        {
+            return fail("parsing stopped by the handler");
+        }
+        return true;
+    }
+
+    Json::Value value(m_string);
+    if (m_handler && !m_handler->onValue(value))
+    {
+        return fail("parsing stopped by the handler");
+    }
+    return completeValue();
+}
+
+bool JSONStreamParser::completeNumber()
+{
+    m_token = Token::NONE;
+
+    char last = m_tokenChars.back();
+    if (!isDigit(last) && last != '.')
+    {
+        return fail("'" + m_tokenChars + "' is not a number");
+    }
+
+    Json::Value value;
+    bool isInteger = m_tokenChars.find_first_of(".eE") == std::string::npos;
+    bool isNegative = m_tokenChars[0] == '-';
+
+    if (isInteger)
+    {
+        // Same conversion as JsonCpp: Int64 when it fits, otherwise UInt64, otherwise double.
+        const Json::LargestUInt maxIntegerValue = isNegative ? Json::LargestUInt(Json::Value::maxLargestInt) + 1 : Json::Value::maxLargestUInt;
+        Json::LargestUInt integer = 0;
+        for (size_t i = isNegative ? 1 : 0; i < m_tokenChars.size() && isInteger; i++)
+        {
+            Json::UInt digit = static_cast<Json::UInt>(m_tokenChars[i] - '0');
+            if (integer > (maxIntegerValue - digit) / 10)
+            {
+                isInteger = false;
+            }
+            integer = integer * 10 + digit;
+        }
+        if (isInteger)
+        {
+            if (isNegative && integer == maxIntegerValue)
+            {
+                value = Json::Value::minLargestInt;
+            }
+            else if (isNegative)
+            {
+                value = -Json::LargestInt(integer);
+            }
+            else if (integer <= Json::LargestUInt(Json::Value::maxLargestInt))
+            {
+                value = Json::LargestInt(integer);
+            }
+            else
+            {
+                value = integer;
+            }
+        }
+    }
+
+    if (!isInteger)
+    {
+        std::istringstream is(m_tokenChars);
+        is.imbue(std::locale::classic());
+        double number;
+        if (!(is >> number))
+        {
+            return fail("'" + m_tokenChars + "' is not a number");
+        }
+        value = number;
+    }
+
+    if (m_handler && !m_handler->onValue(value))
+    {
+        return fail("parsing stopped by the handler");
+    }
+    return completeValue();
+}
+
+bool JSONStreamParser::completeLiteral()
+{
+    m_token = Token::NONE;
+
+    Json::Value value;
+    if (m_tokenChars == "true")
+    {
+        value = true;
+    }
+    else if (m_tokenChars == "false")
+    {
+        value = false;
+    }
+    else if (m_tokenChars != "null")
+    {
+        return fail("syntax error: value, object or array expected");
+    }
+
+    if (m_handler && !m_handler->onValue(value))
+    {
+        return fail("parsing stopped by the handler");
+    }
+    return completeValue();
+}
+
+bool JSONStreamParser::completeUnicodeEscape()
+{
+    uint32_t cp = m_unicodeCodePoint;
+
+    if (m_pendingHighSurrogate)
+    {
+        if (cp < 0xDC00 || cp > 0xDFFF)
+        {
+            return fail("expecting the second half of a unicode surrogate pair");
+        }
+        cp = 0x10000 + ((m_pendingHighSurrogate & 0x3FF) << 10) + (cp & 0x3FF);
+        m_pendingHighSurrogate = 0;
+    }
+    else if (cp >= 0xD800 && cp <= 0xDBFF)
+    {
+        m_pendingHighSurrogate = cp;
+        return true;
+    }
+
+    std::string utf8;
+    appendCodePointAsUTF8(utf8, cp);
+    return appendToString(utf8.data(), utf8.size());
+}
+
+bool JSONStreamParser::appendToString(const char *data, size_t size)
+{
+    if (size > limits.maxStringSize - m_string.size())
+    {
+        return fail("string size limit exceeded");
+    }
+    m_string.append(data, size);
+    return true;
+}
+
+bool JSONStreamParser::fail(const std::string &message)
+{
+    if (m_state != State::FAILED)
+    {
+        m_state = State::FAILED;
+        m_errorMessage = "JSON parsing error at byte " + std::to_string(m_parsedBytes) + ": " + message;
+    }
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+JSONValueBuilder::JSONValueBuilder(Json::Value *root)
+{
+    reset(root);
+}
+
+void JSONValueBuilder::reset(Json::Value *root)
+{
+    m_root = root;
+    m_frames.clear();
+}
+
+void JSONValueBuilder::setPathFilter(const std::list<std::string> &paths)
+{
+    m_pathFilter.clear();
+    for (const std::string &path : paths)
+    {
+        // JSON pointer: /segment/segment (~1 is '/' and ~0 is '~')
+        std::vector<std::string> segments;
+        size_t pos = path.empty() || path[0] != '/' ? 0 : 1;
+        while (pos <= path.size() && !path.empty())
+        {
+            size_t next = path.find('/', pos);
+            std::string segment = path.substr(pos, next == std::string::npos ? std::string::npos : next - pos);
+            for (size_t escape = segment.find('~'); escape != std::string::npos && escape + 1 < segment.size(); escape = segment.find('~', escape + 1))
+            {
+                if (segment[escape + 1] == '1')
+                {
+                    segment.replace(escape, 2, "/");
+                }
+                else if (segment[escape + 1] == '0')
+                {
+                    segment.replace(escape, 2, "~");
+                }
+            }
+            segments.push_back(segment);
+            if (next == std::string::npos)
+            {
+                break;
+            }
+            pos = next + 1;
+        }
+        m_pathFilter.push_back(segments);
+    }
+}
+
+bool JSONValueBuilder::onObjectStart()
+{
+    return startContainer(false);
+}
+
+bool JSONValueBuilder::onObjectEnd()
+{
+    m_frames.pop_back();
+    return true;
+}
+
+bool JSONValueBuilder::onArrayStart()
+{
+    return startContainer(true);
+}
+
+bool JSONValueBuilder::onArrayEnd()
+{
+    m_frames.pop_back();
+    return true;
+}
+
+bool JSONValueBuilder::onKey(std::string &key)
+{
+    Frame &frame = m_frames.back();
+    if (frame.container)
+    {
+        frame.key.swap(key);
+    }
+    return true;
+}
+
+bool JSONValueBuilder::onValue(Json::Value &value)
+{
+    if (m_frames.empty())
+    {
+        if (m_pathFilter.empty() || matchPath() == PathMatch::SELECTED)
+        {
+            placeValue(std::move(value));
+        }
+        return true;
+    }
+
+    Frame &parent = m_frames.back();
+    if (parent.container && (parent.selected || matchPath() == PathMatch::SELECTED))
+    {
+        placeValue(std::move(value));
+    }
+    if (parent.isArray)
+    {
+        parent.index++;
+    }
+    return true;
+}
+
+JSONValueBuilder::PathMatch JSONValueBuilder::matchPath() const
+{
+    // Path of the value being started:
+    std::vector<std::string> path;
+    path.reserve(m_frames.size());
+    for (const Frame &frame : m_frames)
+    {
+        path.push_back(frame.isArray ? std::to_string(frame.index) : frame.key);
+    }
+
+    bool isAncestor = false;
+    for (const std::vector<std::string> &filter : m_pathFilter)
+    {
+        size_t commonSize = std::min(filter.size(), path.size());
+        size_t i = 0;
+        while (i < commonSize && (filter[i] == "*" || filter[i] == path[i]))
+        {
+            i++;
+        }
+        if (i < commonSize)
+        {
+            continue;
+        }
+        if (filter.size() <= path.size())
+        {
+            return PathMatch::SELECTED;
+        }
+        isAncestor = true;
+    }
+    return isAncestor ? PathMatch::ANCESTOR : PathMatch::NONE;
+}
+
+Json::Value *JSONValueBuilder::placeValue(Json::Value &&value)
+{
+    if (m_frames.empty())
+    {
+        *m_root = std::move(value);
+        return m_root;
+    }
+
+    Frame &parent = m_frames.back();
+    if (parent.isArray)
+    {
+        return &parent.container->append(std::move(value));
+    }
+
+    Json::Value &member = (*parent.container)[parent.key];
+    member = std::move(value);
+    return &member;
+}
+
+bool JSONValueBuilder::startContainer(bool isArray)
+{
+    PathMatch match = PathMatch::NONE;
+    if (m_frames.empty())
+    {
+        match = m_pathFilter.empty() ? PathMatch::SELECTED : matchPath();
+    }
+    else if (m_frames.back().container)
+    {
+        match = m_frames.back().selected ? PathMatch::SELECTED : matchPath();
+    }
+
+    Frame frame;
+    frame.isArray = isArray;
+    frame.selected = match == PathMatch::SELECTED;
+    if (match != PathMatch::NONE)
+    {
+        // (the JsonCpp objects/arrays are node based: the pointer remains valid while the container grows)
+        frame.container = placeValue(Json::Value(isArray ? Json::arrayValue : Json::objectValue));
+    }
+
+    if (!m_frames.empty() && m_frames.back().isArray)
+    {
+        m_frames.back().index++;
+    }
+    m_frames.push_back(std::move(frame));
+    return true;
+}
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <Mantids30/Helpers/json.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <list>
+#include <string>
+#include <vector>
+
+namespace Mantids30::Memory::Streams {
+
+/**
+ * @brief The JSONStreamParser class parses a JSON document incrementally (push/SAX style).
+ *
+ * The data can be delivered in pieces of any size (split anywhere), and the parser reports the structure to a handler
+ * as soon as each element is complete, so the document is never kept as a whole in memory.
+ * It accepts the same documents as the default JsonCpp reader (comments, trailing commas, UTF-8 BOM, and the data
+ * after the root value is ignored), and the limits are enforced while streaming.
+ */
+class JSONStreamParser
+{
+public:
+    /**
+     * @brief The Limits struct defines the security limits enforced while parsing.
+     */
+    struct Limits
+    {
+        size_t maxSize = std::numeric_limits<size_t>::max();         ///< Max bytes of the document.
+        size_t maxDepth = 1000;                                      ///< Max nesting level of objects/arrays.
+        size_t maxElementCount = std::numeric_limits<size_t>::max(); ///< Max values (objects, arrays and scalars).
+        size_t maxStringSize = std::numeric_limits<size_t>::max();   ///< Max decoded size of a string or key, and max characters of a number.
+    };
+
+    /**
+     * @brief The Handler class receives the parsing events. Returning false stops the parsing with an error.
+     */
+    class Handler
+    {
+    public:
+        virtual ~Handler() = default;
+
+        virtual bool onObjectStart() = 0;
+        virtual bool onObjectEnd() = 0;
+        virtual bool onArrayStart() = 0;
+        virtual bool onArrayEnd() = 0;
+        /**
+         * @brief onKey Object member name (followed by the member value events).
+         */
+        virtual bool onKey(std::string &key) = 0;
+        /**
+         * @brief onValue Scalar value (string, number, boolean or null).
+         */
+        virtual bool onValue(Json::Value &value) = 0;
+    };
+
+    JSONStreamParser(Handler *handler = nullptr);
+
+    /**
+     * @brief reset Prepare the parser for a new document (the limits are kept).
+     * @param handler handler receiving the events.
+     */
+    void reset(Handler *handler);
+
+    /**
+     * @brief parse Parse the next piece of the document.
+     * @return false if the document is invalid, exceeds a limit or the handler stopped the parsing.
+     */
+    bool parse(const char *data, size_t size);
+    /**
+     * @brief finish Notify the end of the document.
+     * @return true if a complete root value was parsed.
+     */
+    bool finish();
+
+    /**
+     * @brief isComplete Check if the root value was completely parsed (the remaining data is ignored).
+     */
+    bool isComplete() const { return m_state == State::DONE; }
+    bool hasFailed() const { return m_state == State::FAILED; }
+    const std::string &getErrorMessage() const { return m_errorMessage; }
+    size_t getParsedBytes() const { return m_parsedBytes; }
+
+    Limits limits;
+
+private:
+    enum class State
+    {
+        VALUE,
+        OBJECT_KEY_OR_END,
+        OBJECT_COLON,
+        OBJECT_COMMA_OR_END,
+        ARRAY_VALUE_OR_END,
+        ARRAY_COMMA_OR_END,
+        DONE,
+        FAILED
+    };
+
+    enum class Token
+    {
+        NONE,
+        BOM,
+        STRING,
+        STRING_ESCAPE,
+        STRING_UNICODE,
+        NUMBER,
+        LITERAL,
+        COMMENT_START,
+        LINE_COMMENT,
+        BLOCK_COMMENT,
+        BLOCK_COMMENT_STAR
+    };
+
+    bool parseChar(char c);
+    bool startToken(char c);
+    bool startValue();
+    bool completeValue();
+    bool completeString();
+    bool completeNumber();
+    bool completeLiteral();
+    bool completeUnicodeEscape();
+    bool appendToString(const char *data, size_t size);
+    bool fail(const std::string &message);
+
+    Handler *m_handler;
+
+    State m_state = State::VALUE;
+    Token m_token = Token::BOM;
+
+    // Open containers (true: array, false: object):
+    std::vector<bool> m_containers;
+
+    std::string m_string;
+    std::string m_tokenChars;
+    bool m_stringIsKey = false;
+    uint32_t m_unicodeCodePoint = 0;
+    uint32_t m_pendingHighSurrogate = 0;
+    size_t m_unicodeDigits = 0;
+    bool m_reprocessChar = false;
+
+    size_t m_parsedBytes = 0;
+    size_t m_elementCount = 0;
+    std::string m_errorMessage;
+};
+
+/**
+ * @brief The JSONValueBuilder class builds a Json::Value from the JSONStreamParser events.
+ *
+ * With a path filter, only the selected subtrees (and the objects/arrays containing them) are materialized, the
+ * rest of the document is discarded while it's parsed. Arrays keep the selected elements in order (compacted).
+ */
+class JSONValueBuilder : public JSONStreamParser::Handler
+{
+public:
+    JSONValueBuilder(Json::Value *root = nullptr);
+
+    /**
+     * @brief reset Prepare the builder for a new document (the path filter is kept).
+     * @param root value where the document will be built.
+     */
+    void reset(Json::Value *root);
+
+    /**
+     * @brief setPathFilter Set the subtrees to be materialized.
+     * @param paths JSON pointers (RFC 6901, eg. "/user/name", "/items/0"), "*" matches any member/element.
+     *              An empty list (default) or the "" pointer materializes the whole document.
+     */
+    void setPathFilter(const std::list<std::string> &paths);
+
+    bool onObjectStart() override;
+    bool onObjectEnd() override;
+    bool onArrayStart() override;
+    bool onArrayEnd() override;
+    bool onKey(std::string &key) override;
+    bool onValue(Json::Value &value) override;
+
+private:
+    enum class PathMatch
+    {
+        SELECTED,
+        ANCESTOR,
+        NONE
+    };
+
+    struct Frame
+    {
+        Json::Value *container = nullptr; ///< nullptr when the container is discarded.
+        bool isArray = false;
+        bool selected = false;            ///< Everything inside is materialized.
+        size_t index = 0;                 ///< Next array element index.
+        std::string key;                  ///< Current object member name.
+    };
+
+    PathMatch matchPath() const;
+    Json::Value *placeValue(Json::Value &&value);
+    bool startContainer(bool isArray);
+
+    Json::Value *m_root;
+    std::vector<Frame> m_frames;
+    std::vector<std::vector<std::string>> m_pathFilter;
+};
+
+} // namespace Mantids30::Memory::Streams
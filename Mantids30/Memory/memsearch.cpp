@@ -0,0 +1,432 @@
+#include "memsearch.h"
+
+#include <Mantids30/Helpers/mem.h>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define MEMSEARCH_X86_VECTORS 1
+#include <immintrin.h>
+#endif
+
+using namespace Mantids30::Memory::Search;
+
+namespace {
+
+// ASCII only (the containers don't know about locales):
+inline unsigned char toLowerASCII(unsigned char c)
+{
+    return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c + ('a' - 'A')) : c;
+}
+
+inline unsigned char toUpperASCII(unsigned char c)
+{
+    return (c >= 'a' && c <= 'z') ? static_cast<unsigned char>(c - ('a' - 'A')) : c;
+}
+
+inline bool equalsAt(const char *data, const char *needle, size_t needleSize, bool caseSensitive)
+{
+    return Mantids30::Helpers::Mem::memicmp2(data, needle, needleSize, caseSensitive) == 0;
+}
+
+#ifdef MEMSEARCH_X86_VECTORS
+
+bool isAVX2Available()
+{
+    static const bool avx2Available = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return avx2Available;
+}
+
+// Each vectorized function scans while the loads are inside the region, and reports where it stopped (the scalar code
+// continues from there).
+
+size_t findByte2SSE2(const char *data, size_t size, unsigned char a, unsigned char b, std::optional<size_t> *found)
+{
+    const __m128i va = _mm_set1_epi8(static_cast<char>(a)), vb = _mm_set1_epi8(static_cast<char>(b));
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, va), _mm_cmpeq_epi8(block, vb))));
+        if (mask)
+        {
+            *found = i + static_cast<size_t>(__builtin_ctz(mask));
+            return i;
+        }
+    }
+    return i;
+}
+
+__attribute__((target("avx2"))) size_t findByte2AVX2(const char *data, size_t size, unsigned char a, unsigned char b, std::optional<size_t> *found)
+{
+    const __m256i va = _mm256_set1_epi8(static_cast<char>(a)), vb = _mm256_set1_epi8(static_cast<char>(b));
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32)
+    {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(block, va), _mm256_cmpeq_epi8(block, vb))));
+        if (mask)
+        {
+            *found = i + static_cast<size_t>(__builtin_ctz(mask));
+            return i;
+        }
+    }
+    return i;
+}
+
+size_t findNeedleSSE2(const char *data, size_t size, const char *needle, size_t needleSize, bool caseSensitive, std::optional<size_t> *found)
+{
+    unsigned char first = static_cast<unsigned char>(needle[0]), last = static_cast<unsigned char>(needle[needleSize - 1]);
+    const __m128i firstA = _mm_set1_epi8(static_cast<char>(caseSensitive ? first : toLowerASCII(first)));
+    const __m128i firstB = _mm_set1_epi8(static_cast<char>(caseSensitive ? first : toUpperASCII(first)));
+    const __m128i lastA = _mm_set1_epi8(static_cast<char>(caseSensitive ? last : toLowerASCII(last)));
+    const __m128i lastB = _mm_set1_epi8(static_cast<char>(caseSensitive ? last : toUpperASCII(last)));
+
+    size_t i = 0;
+    for (; i + needleSize - 1 + 16 <= size; i += 16)
+    {
+        __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + needleSize - 1));
+        __m128i matchFirst = _mm_or_si128(_mm_cmpeq_epi8(blockFirst, firstA), _mm_cmpeq_epi8(blockFirst, firstB));
+        __m128i matchLast = _mm_or_si128(_mm_cmpeq_epi8(blockLast, lastA), _mm_cmpeq_epi8(blockLast, lastB));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(matchFirst, matchLast)));
+        while (mask)
+        {
+            size_t pos = i + static_cast<size_t>(__builtin_ctz(mask));
+            if (equalsAt(data + pos, needle, needleSize, caseSensitive))
+            {
+                *found = pos;
+                return i;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return i;
+}
+
+__attribute__((target("avx2"))) size_t findNeedleAVX2(const char *data, size_t size, const char *needle, size_t needleSize, bool caseSensitive, std::optional<size_t> *found)
+{
+    unsigned char first = static_cast<unsigned char>(needle[0]), last = static_cast<unsigned char>(needle[needleSize - 1]);
+    const __m256i firstA = _mm256_set1_epi8(static_cast<char>(caseSensitive ? first : toLowerASCII(first)));
+    const __m256i firstB = _mm256_set1_epi8(static_cast<char>(caseSensitive ? first : toUpperASCII(first)));
+    const __m256i lastA = _mm256_set1_epi8(static_cast<char>(caseSensitive ? last : toLowerASCII(last)));
+    const __m256i lastB = _mm256_set1_epi8(static_cast<char>(caseSensitive ? last : toUpperASCII(last)));
+
+    size_t i = 0;
+    for (; i + needleSize - 1 + 32 <= size; i += 32)
+    {
+        __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + needleSize - 1));
+        __m256i matchFirst = _mm256_or_si256(_mm256_cmpeq_epi8(blockFirst, firstA), _mm256_cmpeq_epi8(blockFirst, firstB));
+        __m256i matchLast = _mm256_or_si256(_mm256_cmpeq_epi8(blockLast, lastA), _mm256_cmpeq_epi8(blockLast, lastB));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(matchFirst, matchLast)));
+        while (mask)
+        {
+            size_t pos = i + static_cast<size_t>(__builtin_ctz(mask));
+            if (equalsAt(data + pos, needle, needleSize, caseSensitive))
+            {
+                *found = pos;
+                return i;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return i;
+}
+
+size_t findPrefixesSSE2(const char *data, size_t size, const MultiNeedle::Prefix *prefixes, size_t prefixesCount, bool useSecondByte, const MultiNeedle &needles,
+                        std::optional<size_t> *found, size_t *needleIndex)
+{
+    __m128i firstSets[MultiNeedle::MAX_VECTOR_PREFIXES], secondSets[MultiNeedle::MAX_VECTOR_PREFIXES];
+    for (size_t j = 0; j < prefixesCount; j++)
+    {
+        firstSets[j] = _mm_set1_epi8(static_cast<char>(prefixes[j].first));
+        secondSets[j] = _mm_set1_epi8(static_cast<char>(prefixes[j].second));
+    }
+
+    size_t i = 0;
+    for (; i + (useSecondByte ? 1 : 0) + 16 <= size; i += 16)
+    {
+        __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        __m128i match = _mm_setzero_si128();
+        if (useSecondByte)
+        {
+            __m128i blockSecond = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + 1));
+            for (size_t j = 0; j < prefixesCount; j++)
+            {
+                match = _mm_or_si128(match, _mm_and_si128(_mm_cmpeq_epi8(blockFirst, firstSets[j]), _mm_cmpeq_epi8(blockSecond, secondSets[j])));
+            }
+        }
+        else
+        {
+            for (size_t j = 0; j < prefixesCount; j++)
+            {
+                match = _mm_or_si128(match, _mm_cmpeq_epi8(blockFirst, firstSets[j]));
+            }
+        }
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(match));
+        while (mask)
+        {
+            size_t pos = i + static_cast<size_t>(__builtin_ctz(mask));
+            if (needles.matchAt(data, size, pos, needleIndex))
+            {
+                *found = pos;
+                return i;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return i;
+}
+
+__attribute__((target("avx2"))) size_t findPrefixesAVX2(const char *data, size_t size, const MultiNeedle::Prefix *prefixes, size_t prefixesCount, bool useSecondByte,
+                                                        const MultiNeedle &needles, std::optional<size_t> *found, size_t *needleIndex)
+{
+    __m256i firstSets[MultiNeedle::MAX_VECTOR_PREFIXES], secondSets[MultiNeedle::MAX_VECTOR_PREFIXES];
+    for (size_t j = 0; j < prefixesCount; j++)
+    {
+        firstSets[j] = _mm256_set1_epi8(static_cast<char>(prefixes[j].first));
+        secondSets[j] = _mm256_set1_epi8(static_cast<char>(prefixes[j].second));
+    }
+
+    size_t i = 0;
+    for (; i + (useSecondByte ? 1 : 0) + 32 <= size; i += 32)
+    {
+        __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        __m256i match = _mm256_setzero_si256();
+        if (useSecondByte)
+        {
+            __m256i blockSecond = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + 1));
+            for (size_t j = 0; j < prefixesCount; j++)
+            {
+                match = _mm256_or_si256(match, _mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, firstSets[j]), _mm256_cmpeq_epi8(blockSecond, secondSets[j])));
+            }
+        }
+        else
+        {
+            for (size_t j = 0; j < prefixesCount; j++)
+            {
+                match = _mm256_or_si256(match, _mm256_cmpeq_epi8(blockFirst, firstSets[j]));
+            }
+        }
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(match));
+        while (mask)
+        {
+            size_t pos = i + static_cast<size_t>(__builtin_ctz(mask));
+            if (needles.matchAt(data, size, pos, needleIndex))
+            {
+                *found = pos;
+                return i;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return i;
+}
+
+#endif
+
+} // namespace
+
+std::optional<size_t> Mantids30::Memory::Search::findByte(const char *data, size_t size, unsigned char c, bool caseSensitive)
+{
+    unsigned char lower = toLowerASCII(c), upper = toUpperASCII(c);
+
+    if (caseSensitive || lower == upper)
+    {
+        const char *pos = static_cast<const char *>(memchr(data, c, size));
+        if (!pos)
+        {
+            return std::nullopt;
+        }
+        return static_cast<size_t>(pos - data);
+    }
+
+    std::optional<size_t> found;
+    size_t i = 0;
+#ifdef MEMSEARCH_X86_VECTORS
+    i = isAVX2Available() ? findByte2AVX2(data, size, lower, upper, &found) : findByte2SSE2(data, size, lower, upper, &found);
+    if (found)
+    {
+        return found;
+    }
+#endif
+    for (; i < size; i++)
+    {
+        unsigned char current = static_cast<unsigned char>(data[i]);
+        if (current == lower || current == upper)
+        {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<size_t> Mantids30::Memory::Search::findNeedle(const char *data, size_t size, const char *needle, size_t needleSize, bool caseSensitive)
+{
+    if (needleSize == 0)
+    {
+        return 0;
+    }
+    if (needleSize > size)
+    {
+        return std::nullopt;
+    }
+    if (needleSize == 1)
+    {
+        return findByte(data, size, static_cast<unsigned char>(needle[0]), caseSensitive);
+    }
+
+    std::optional<size_t> found;
+    size_t i = 0;
+#ifdef MEMSEARCH_X86_VECTORS
+    i = isAVX2Available() ? findNeedleAVX2(data, size, needle, needleSize, caseSensitive, &found) : findNeedleSSE2(data, size, needle, needleSize, caseSensitive, &found);
+    if (found)
+    {
+        return found;
+    }
+#endif
+    // Scalar: first byte, then verify the candidate.
+    while (i + needleSize <= size)
+    {
+        std::optional<size_t> candidate = findByte(data + i, size - i - needleSize + 1, static_cast<unsigned char>(needle[0]), caseSensitive);
+        if (!candidate)
+        {
+            break;
+        }
+        i += *candidate;
+        if (equalsAt(data + i, needle, needleSize, caseSensitive))
+        {
+            return i;
+        }
+        i++;
+    }
+    return std::nullopt;
+}
+
+MultiNeedle::MultiNeedle(const std::list<std::string> &needles, bool caseSensitive)
+    : m_needles(needles.begin(), needles.end())
+    , m_caseSensitive(caseSensitive)
+{
+    for (const std::string &needle : m_needles)
+    {
+        m_maxNeedleSize = std::max(m_maxNeedleSize, needle.size());
+        if (needle.size() < 2)
+        {
+            m_hasEmptyNeedle = m_hasEmptyNeedle || needle.empty();
+            m_vectorPrefixesUseSecondByte = false;
+        }
+    }
+
+    // Distinct prefixes for the vectorized scan (with both cases when case insensitive):
+    bool prefixesFit = true;
+    auto addPrefix = [this, &prefixesFit](uint8_t first, uint8_t second) {
+        for (size_t j = 0; j < m_vectorPrefixesCount; j++)
+        {
+            if (m_vectorPrefixes[j].first == first && m_vectorPrefixes[j].second == second)
+            {
+                return;
+            }
+        }
+        if (m_vectorPrefixesCount == MAX_VECTOR_PREFIXES)
+        {
+            prefixesFit = false;
+            return;
+        }
+        m_vectorPrefixes[m_vectorPrefixesCount++] = {first, second};
+    };
+
+    for (const std::string &needle : m_needles)
+    {
+        if (needle.empty())
+        {
+            continue;
+        }
+
+        unsigned char first = static_cast<unsigned char>(needle[0]);
+        unsigned char second = m_vectorPrefixesUseSecondByte ? static_cast<unsigned char>(needle[1]) : 0;
+        uint8_t firstCases[2] = {caseSensitive ? first : toLowerASCII(first), caseSensitive ? first : toUpperASCII(first)};
+        uint8_t secondCases[2] = {caseSensitive ? second : toLowerASCII(second), caseSensitive ? second : toUpperASCII(second)};
+
+        m_isFirstByte[firstCases[0]] = true;
+        m_isFirstByte[firstCases[1]] = true;
+
+        for (uint8_t f : firstCases)
+        {
+            for (uint8_t s : secondCases)
+            {
+                addPrefix(f, s);
+            }
+        }
+    }
+
+    if (!prefixesFit)
+    {
+        // Too many, use the lookup table.
+        m_vectorPrefixesCount = 0;
+    }
+}
+
+bool MultiNeedle::matchAt(const char *data, size_t size, size_t pos, size_t *needleIndex) const
+{
+    for (size_t i = 0; i < m_needles.size(); i++)
+    {
+        const std::string &needle = m_needles[i];
+        if (pos + needle.size() > size)
+        {
+            continue;
+        }
+        // (check the first byte inline before comparing the whole needle)
+        if (!needle.empty())
+        {
+            unsigned char current = static_cast<unsigned char>(data[pos]), first = static_cast<unsigned char>(needle[0]);
+            if (m_caseSensitive ? current != first : toLowerASCII(current) != toLowerASCII(first))
+            {
+                continue;
+            }
+        }
+        if (equalsAt(data + pos, needle.data(), needle.size(), m_caseSensitive))
+        {
+            *needleIndex = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::optional<size_t> MultiNeedle::find(const char *data, size_t size, size_t *needleIndex) const
+{
+    if (m_hasEmptyNeedle)
+    {
+        // The empty needle is everywhere...
+        return matchAt(data, size, 0, needleIndex) ? std::optional<size_t>(0) : std::nullopt;
+    }
+    if (m_needles.empty())
+    {
+        return std::nullopt;
+    }
+
+    std::optional<size_t> found;
+    size_t i = 0;
+#ifdef MEMSEARCH_X86_VECTORS
+    if (m_vectorPrefixesCount)
+    {
+        i = isAVX2Available() ? findPrefixesAVX2(data, size, m_vectorPrefixes.data(), m_vectorPrefixesCount, m_vectorPrefixesUseSecondByte, *this, &found, needleIndex)
+                              : findPrefixesSSE2(data, size, m_vectorPrefixes.data(), m_vectorPrefixesCount, m_vectorPrefixesUseSecondByte, *this, &found, needleIndex);
+        if (found)
+        {
+            return found;
+        }
+    }
+#endif
+    for (; i < size; i++)
+    {
+        if (m_isFirstByte[static_cast<unsigned char>(data[i])] && matchAt(data, size, i, needleIndex))
+        {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Mantids30::Memory::Search {
+
+/**
+ * @brief findByte Find the first occurrence of a byte in a memory region.
+ * @param data memory region
+ * @param size memory region size in bytes
+ * @param c byte to find
+ * @param caseSensitive if false and the byte is a letter, both cases are matched in a single pass (SSE2/AVX2).
+ * @return position of the byte, or std::nullopt if not found.
+ */
+std::optional<size_t> findByte(const char *data, size_t size, unsigned char c, bool caseSensitive = true);
+
+/**
+ * @brief findNeedle Find the first occurrence of a needle fully contained in a memory region.
+ *                   The candidates are filtered by comparing the first and the last needle bytes for 16/32 positions
+ *                   at once (SSE2/AVX2, selected at runtime), and then verified.
+ * @param data memory region
+ * @param size memory region size in bytes
+ * @param needle needle to find
+ * @param needleSize needle size in bytes
+ * @param caseSensitive compare case sensitive.
+ * @return position of the needle, or std::nullopt if not found.
+ */
+std::optional<size_t> findNeedle(const char *data, size_t size, const char *needle, size_t needleSize, bool caseSensitive = true);
+
+/**
+ * @brief The MultiNeedle class finds the earliest occurrence of any needle of a set in a single pass.
+ *
+ * The candidate positions are filtered 16/32 positions at once by the first two bytes of the needles (or only by the first
+ * byte when a needle has one byte), when the set has up to MAX_VECTOR_PREFIXES distinct prefixes (counting both cases when
+ * case insensitive). Larger sets are filtered with a first byte lookup table. The candidates are then verified.
+ * When several needles match at the same position, the first one in the set is reported.
+ */
+class MultiNeedle
+{
+public:
+    MultiNeedle() = default;
+    MultiNeedle(const std::list<std::string> &needles, bool caseSensitive = true);
+
+    /**
+     * @brief find Find the earliest needle fully contained in a memory region.
+     * @param data memory region
+     * @param size memory region size in bytes
+     * @param needleIndex output: index of the needle found (in the set order)
+     * @return position of the needle, or std::nullopt if not found.
+     */
+    std::optional<size_t> find(const char *data, size_t size, size_t *needleIndex) const;
+
+    /**
+     * @brief matchAt Get the first needle (in the set order) fully matching at the position of a memory region.
+     * @return true if a needle matches (and needleIndex is filled).
+     */
+    bool matchAt(const char *data, size_t size, size_t pos, size_t *needleIndex) const;
+
+    const std::vector<std::string> &getNeedles() const { return m_needles; }
+    size_t getMaxNeedleSize() const { return m_maxNeedleSize; }
+    bool isCaseSensitive() const { return m_caseSensitive; }
+    bool isEmpty() const { return m_needles.empty(); }
+
+    static constexpr size_t MAX_VECTOR_PREFIXES = 8;
+
+    struct Prefix
+    {
+        uint8_t first;
+        uint8_t second;
+    };
+
+private:
+    std::vector<std::string> m_needles;
+    std::array<bool, 256> m_isFirstByte{};                    ///< Bytes starting any needle (both cases when case insensitive).
+    std::array<Prefix, MAX_VECTOR_PREFIXES> m_vectorPrefixes{}; ///< Distinct prefixes for the vectorized scan.
+    size_t m_vectorPrefixesCount = 0;                         ///< Distinct prefixes count (0: they don't fit, use the lookup table).
+    bool m_vectorPrefixesUseSecondByte = true;                ///< false when a needle has only one byte (filter by the first byte).
+    size_t m_maxNeedleSize = 0;
+    bool m_hasEmptyNeedle = false;
+    bool m_caseSensitive = true;
+};
+
+} // namespace Mantids30::Memory::Search
@@ -65,6 +65,69 @@ void Parser::parseObject(Parser::ParseResult *result)
     }
 }
 
+bool Parser::parseObjectStart(ParseResult *result)
+{
+    *result = ParseResult::SUCCEED;
+
+    this->writeStatus.finished = false;
+
+    m_initialized = initProtocol();
+    if (!m_initialized)
+    {
+        *result = ParseResult::ERR_INIT;
+        return false;
+    }
+
+    if (m_preStreamableObject && !m_preStreamableObject->streamTo(this))
+    {
+        *result = ParseResult::ERR_PARSING;
+        parseObjectEnd();
+        return false;
+    }
+
+    if (this->writeStatus.finished)
+    {
+        parseObjectEnd();
+        return false;
+    }
+
+    return true;
+}
+
+bool Parser::parseObjectAvailableData(ParseResult *result)
+{
+    *result = ParseResult::SUCCEED;
+
+    if (!m_initialized)
+    {
+        *result = ParseResult::ERR_INIT;
+        return false;
+    }
+
+    bool finished = true;
+    if (!m_streamableObject->streamAvailableTo(this, finished))
+    {
+        *result = ParseResult::ERR_PARSING;
+    }
+
+    if (finished || *result != ParseResult::SUCCEED)
+    {
+        parseObjectEnd();
+        return false;
+    }
+
+    return true;
+}
+
+void Parser::parseObjectEnd()
+{
+    if (m_initialized)
+    {
+        m_initialized = false;
+        endProtocol();
+    }
+}
+
 std::optional<size_t> Parser::write(const void *buf, const size_t &count)
 {
     // Parse this data...
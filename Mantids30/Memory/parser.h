@@ -49,6 +49,24 @@ public:
      */
     void parseObject(ParseResult *result);
 
+    /**
+     * @brief parseObjectStart Initialize the protocol for event-driven parsing, the data is then consumed by parseObjectAvailableData
+     *                         every time the streamable object becomes readable.
+     * @param result: (0:succeed, -1:failed to initialize, -2:failed to parse the pre-streamable object)
+     * @return true if the parser is ready to receive data, false otherwise (the protocol was already ended)
+     */
+    bool parseObjectStart(ParseResult *result);
+    /**
+     * @brief parseObjectAvailableData Parse the data that is available right now in the streamable object without waiting for more.
+     * @param result: (0:succeed, -2:failed to read/parse)
+     * @return true if the parser is waiting for more data, false if the parsing finished (the protocol was already ended)
+     */
+    bool parseObjectAvailableData(ParseResult *result);
+    /**
+     * @brief parseObjectEnd End an event-driven parsing before the stream finishes (eg. idle timeout or server shutdown)
+     */
+    void parseObjectEnd();
+
     //////////////////////////////////////////
     std::optional<size_t> write(const void *buf, const size_t &count) override;
 
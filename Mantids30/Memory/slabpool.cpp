@@ -0,0 +1,194 @@
+#include "slabpool.h"
+
+#include <array>
+#include <atomic>
+#include <new>
+#include <vector>
+
+using namespace Mantids30::Memory::Containers;
+
+namespace {
+
+constexpr size_t MIN_BLOCK_SIZE_BITS = 6;  // 64 bytes.
+constexpr size_t MAX_BLOCK_SIZE_BITS = 16; // 64Kb.
+constexpr size_t SIZE_CLASS_COUNT = MAX_BLOCK_SIZE_BITS - MIN_BLOCK_SIZE_BITS + 1;
+
+// Operations counted locally before publishing them to the global counters:
+constexpr uint64_t STATISTICS_PUBLISH_INTERVAL = 256;
+
+static_assert(SlabPool::MIN_BLOCK_SIZE == (size_t{1} << MIN_BLOCK_SIZE_BITS), "MIN_BLOCK_SIZE mismatch");
+static_assert(SlabPool::MAX_BLOCK_SIZE == (size_t{1} << MAX_BLOCK_SIZE_BITS), "MAX_BLOCK_SIZE mismatch");
+
+std::atomic<size_t> maxCachedBytesPerThread{4 * 1024 * 1024};
+
+std::atomic<uint64_t> pooledAllocations{0};
+std::atomic<uint64_t> heapAllocations{0};
+std::atomic<uint64_t> pooledReleases{0};
+std::atomic<uint64_t> heapReleases{0};
+
+// Set when the cache of the thread is destroyed (blocks released later by other thread_local objects go to the heap).
+thread_local bool threadCacheDestroyed = false;
+
+struct ThreadCache
+{
+    ~ThreadCache()
+    {
+        trim(0);
+        publishStatistics();
+        threadCacheDestroyed = true;
+    }
+
+    void trim(size_t maxBytes)
+    {
+        // Release the biggest blocks first:
+        for (size_t i = SIZE_CLASS_COUNT; i-- > 0 && cachedBytes > maxBytes;)
+        {
+            while (!freeBlocks[i].empty() && cachedBytes > maxBytes)
+            {
+                delete[] freeBlocks[i].back();
+                freeBlocks[i].pop_back();
+                cachedBytes -= size_t{1} << (i + MIN_BLOCK_SIZE_BITS);
+                statistics.heapReleases++;
+            }
+        }
+    }
+
+    void countOperation()
+    {
+        if (++pendingOperations >= STATISTICS_PUBLISH_INTERVAL)
+        {
+            publishStatistics();
+        }
+    }
+
+    void publishStatistics()
+    {
+        pooledAllocations.fetch_add(statistics.pooledAllocations, std::memory_order_relaxed);
+        heapAllocations.fetch_add(statistics.heapAllocations, std::memory_order_relaxed);
+        pooledReleases.fetch_add(statistics.pooledReleases, std::memory_order_relaxed);
+        heapReleases.fetch_add(statistics.heapReleases, std::memory_order_relaxed);
+        statistics = SlabPool::Statistics();
+        pendingOperations = 0;
+    }
+
+    std::array<std::vector<char *>, SIZE_CLASS_COUNT> freeBlocks;
+    size_t cachedBytes = 0;
+    SlabPool::Statistics statistics;
+    uint64_t pendingOperations = 0;
+};
+
+ThreadCache &getThreadCache()
+{
+    thread_local ThreadCache threadCache;
+    return threadCache;
+}
+
+size_t getSizeClass(size_t size)
+{
+    if (size <= SlabPool::MIN_BLOCK_SIZE)
+    {
+        return 0;
+    }
+    // ceil(log2(size)) - MIN_BLOCK_SIZE_BITS
+    return (64 - static_cast<size_t>(__builtin_clzll(static_cast<unsigned long long>(size - 1)))) - MIN_BLOCK_SIZE_BITS;
+}
+
+} // namespace
+
+char *SlabPool::allocate(size_t size, size_t *capacity)
+{
+    if (size > MAX_BLOCK_SIZE || threadCacheDestroyed)
+    {
+        heapAllocations.fetch_add(1, std::memory_order_relaxed);
+        *capacity = size;
+        return new (std::nothrow) char[size];
+    }
+
+    size_t sizeClass = getSizeClass(size);
+    size_t blockSize = size_t{1} << (sizeClass + MIN_BLOCK_SIZE_BITS);
+    ThreadCache &threadCache = getThreadCache();
+
+    char *block;
+    if (!threadCache.freeBlocks[sizeClass].empty())
+    {
+        block = threadCache.freeBlocks[sizeClass].back();
+        threadCache.freeBlocks[sizeClass].pop_back();
+        threadCache.cachedBytes -= blockSize;
+        threadCache.statistics.pooledAllocations++;
+    }
+    else
+    {
+        block = new (std::nothrow) char[blockSize];
+        threadCache.statistics.heapAllocations++;
+    }
+    threadCache.countOperation();
+
+    *capacity = block ? blockSize : 0;
+    return block;
+}
+
+void SlabPool::deallocate(char *block, size_t capacity)
+{
+    if (!block)
+    {
+        return;
+    }
+
+    // Only the exact size classes come from (and go to) the free lists:
+    if (capacity > MAX_BLOCK_SIZE || capacity < MIN_BLOCK_SIZE || (capacity & (capacity - 1)) != 0 || threadCacheDestroyed)
+    {
+        heapReleases.fetch_add(1, std::memory_order_relaxed);
+        delete[] block;
+        return;
+    }
+
+    ThreadCache &threadCache = getThreadCache();
+    if (threadCache.cachedBytes + capacity > maxCachedBytesPerThread.load(std::memory_order_relaxed))
+    {
+        delete[] block;
+        threadCache.statistics.heapReleases++;
+    }
+    else
+    {
+        threadCache.freeBlocks[getSizeClass(capacity)].push_back(block);
+        threadCache.cachedBytes += capacity;
+        threadCache.statistics.pooledReleases++;
+    }
+    threadCache.countOperation();
+}
+
+void SlabPool::trimThreadCache(size_t maxBytes)
+{
+    if (threadCacheDestroyed)
+    {
+        return;
+    }
+    ThreadCache &threadCache = getThreadCache();
+    threadCache.trim(maxBytes);
+    threadCache.publishStatistics();
+}
+
+size_t SlabPool::getThreadCachedBytes()
+{
+    return threadCacheDestroyed ? 0 : getThreadCache().cachedBytes;
+}
+
+void SlabPool::setMaxCachedBytesPerThread(size_t maxBytes)
+{
+    maxCachedBytesPerThread = maxBytes;
+}
+
+size_t SlabPool::getMaxCachedBytesPerThread()
+{
+    return maxCachedBytesPerThread;
+}
+
+SlabPool::Statistics SlabPool::getStatistics()
+{
+    Statistics statistics;
+    statistics.pooledAllocations = pooledAllocations;
+    statistics.heapAllocations = heapAllocations;
+    statistics.pooledReleases = pooledReleases;
+    statistics.heapReleases = heapReleases;
+    return statistics;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Mantids30::Memory::Containers {
+
+/**
+ * @brief The SlabPool class provides the memory blocks of the binary containers from thread-local free lists.
+ *
+ * The blocks are rounded up to power of two size classes (MIN_BLOCK_SIZE to MAX_BLOCK_SIZE). Released blocks are kept
+ * on a free list of the releasing thread (up to the max cached bytes per thread) and reused by the next allocations of
+ * the same class, so the containers created and destroyed on every request don't go to the heap allocator.
+ * Bigger blocks are allocated directly from the heap.
+ */
+class SlabPool
+{
+public:
+    /**
+     * @brief The Statistics struct holds the pool counters (aggregated from every thread).
+     */
+    struct Statistics
+    {
+        uint64_t pooledAllocations = 0; ///< Allocations served from the free lists (heap allocations avoided).
+        uint64_t heapAllocations = 0;   ///< Allocations served by the heap.
+        uint64_t pooledReleases = 0;    ///< Released blocks kept on the free lists.
+        uint64_t heapReleases = 0;      ///< Released blocks returned to the heap.
+    };
+
+    /**
+     * @brief allocate Get a memory block.
+     * @param size requested size in bytes.
+     * @param capacity output: usable size of the block (the size rounded up to its size class).
+     * @return the memory block, or nullptr if there is not enough memory.
+     */
+    static char *allocate(size_t size, size_t *capacity);
+    /**
+     * @brief deallocate Release a memory block obtained with allocate.
+     * @param block memory block (nullptr is ignored).
+     * @param capacity capacity reported by allocate.
+     */
+    static void deallocate(char *block, size_t capacity);
+
+    /**
+     * @brief trimThreadCache Release the free blocks of the current thread to the heap until they take at most maxBytes
+     *                        (eg. when a persistent connection goes idle).
+     * @param maxBytes bytes that can remain cached in the current thread.
+     */
+    static void trimThreadCache(size_t maxBytes = 0);
+    /**
+     * @brief getThreadCachedBytes Get the bytes kept on the free lists of the current thread.
+     */
+    static size_t getThreadCachedBytes();
+
+    /**
+     * @brief setMaxCachedBytesPerThread Set the max bytes kept on the free lists of each thread (0 disables the pool).
+     */
+    static void setMaxCachedBytesPerThread(size_t maxBytes);
+    static size_t getMaxCachedBytesPerThread();
+
+    /**
+     * @brief getStatistics Get the pool counters.
+     *        The threads publish their counters every few operations (and when trimmed/finished), so the result may
+     *        not include the latest operations.
+     */
+    static Statistics getStatistics();
+
+    static constexpr size_t MIN_BLOCK_SIZE = 64;
+    static constexpr size_t MAX_BLOCK_SIZE = 64 * 1024;
+};
+
+} // namespace Mantids30::Memory::Containers
@@ -24,7 +24,15 @@ bool StreamableJSON::streamTo(Memory::Streams::StreamableObject *out)
 
 std::optional<size_t> StreamableJSON::write(const void *buf, const size_t &count)
 {
-    ssize_t writtenBytes;
+    if (!m_isParsing)
+    {
+        // New document:
+        m_root = Json::Value();
+        m_builder.reset(&m_root);
+        m_parser.reset(&m_builder);
+        m_isFull = false;
+        m_isParsing = true;
+    }
 
     if (count == 0)
     {
@@ -38,26 +46,20 @@ std::optional<size_t> StreamableJSON::write(const void *buf, const size_t &count
         return 0;
     }
 
-    // ...
-    if (m_strValue.size() + count > m_maxSize)
+    // Parse the data as it arrives...
+    if (!m_parser.parse(static_cast<const char *>(buf), count))
     {
-        // Container Full! Can't process this information.
+        // Container Full or invalid JSON! Can't process this information.
         // There is no sense to process an incomplete JSON.
-        m_isFull = true;
+        m_isFull = m_parser.getParsedBytes() + count > m_parser.limits.maxSize;
         writeStatus += -1;
         return std::nullopt;
     }
-    else
-    {
-        writtenBytes = count;
-    }
-
-    m_strValue += std::string((static_cast<const char *>(buf)), writtenBytes); // Copy...
 
     // Append...
-    writeStatus += writtenBytes;
+    writeStatus += static_cast<ssize_t>(count);
 
-    return writtenBytes;
+    return count;
 }
 
 size_t StreamableJSON::size()
@@ -75,18 +77,22 @@ void StreamableJSON::clear()
     Json::Value x;
     m_root = x;
     m_strValue.clear();
+    m_builder.reset(&m_root);
+    m_parser.reset(&m_builder);
+    m_isParsing = false;
+    m_isFull = false;
 }
 
 Json::Value *StreamableJSON::processValue()
 {
+    m_isParsing = false;
+
     if (m_isFull)
     {
         return nullptr;
     }
 
-    Helpers::JSON::JSONReader2 reader;
-    bool parsingSuccessful = reader.parse(m_strValue, m_root);
-    if (!parsingSuccessful)
+    if (!m_parser.finish())
     {
         return nullptr;
     }
@@ -124,7 +130,22 @@ bool StreamableJSON::setValue(const std::string &value)
 
 void StreamableJSON::setMaxSize(const size_t &value)
 {
-    m_maxSize = value;
+    m_parser.limits.maxSize = value;
+}
+
+void StreamableJSON::setParserLimits(const JSONStreamParser::Limits &limits)
+{
+    m_parser.limits = limits;
+}
+
+void StreamableJSON::setPathFilter(const std::list<std::string> &paths)
+{
+    m_builder.setPathFilter(paths);
+}
+
+std::string StreamableJSON::getParserErrorMessage() const
+{
+    return m_parser.getErrorMessage();
 }
 
 bool StreamableJSON::getIsFormatted() const
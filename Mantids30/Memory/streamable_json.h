@@ -1,10 +1,17 @@
 #pragma once
 
 #include <Mantids30/Helpers/json.h>
+#include <Mantids30/Memory/json_streamparser.h>
 #include <Mantids30/Memory/streamable_object.h>
 
 namespace Mantids30::Memory::Streams {
 
+/**
+ * @brief The StreamableJSON class holds a JSON value that can be streamed out (serialized) or in.
+ *
+ * The written data is parsed incrementally as it arrives (the raw document is not accumulated), building the value
+ * progressively, and the parser limits (size, depth, element count) are enforced while streaming.
+ */
 class StreamableJSON : public StreamableObject
 {
 public:
@@ -17,7 +24,7 @@ public:
     void clear();
 
     /**
-     * @brief processValue Proccess current string into m_root and return the internal Json::Value pointer if parsing succeed, otherwise return nullptr.
+     * @brief processValue Finish the parsing of the written data into m_root and return the internal Json::Value pointer if parsing succeed, otherwise return nullptr.
      * @return
      */
     Json::Value *processValue();
@@ -36,13 +43,29 @@ public:
 
     void setMaxSize(const size_t &value);
 
+    /**
+     * @brief setParserLimits Set the limits enforced while parsing the written data (the max size is also set by setMaxSize).
+     */
+    void setParserLimits(const JSONStreamParser::Limits &limits);
+    /**
+     * @brief setPathFilter Materialize only the selected subtrees of the written data (see JSONValueBuilder::setPathFilter).
+     * @param paths JSON pointers (eg. "/user/name"), an empty list materializes the whole document.
+     */
+    void setPathFilter(const std::list<std::string> &paths);
+    /**
+     * @brief getParserErrorMessage Get the error of the last parsing (empty if succeed).
+     */
+    std::string getParserErrorMessage() const;
+
     bool getIsFormatted() const;
     void setIsFormatted(bool value);
 
 private:
-    size_t m_maxSize = std::numeric_limits<size_t>::max();
     std::string m_strValue;
     Json::Value m_root;
+    JSONValueBuilder m_builder;
+    JSONStreamParser m_parser;
+    bool m_isParsing = false;
     bool m_isFormatted = true;
     bool m_isFull = false;
 };
@@ -1,8 +1,10 @@
 #include "streamable_object.h"
 #include "streamable_string.h"
+#include <algorithm>
 #include <cstdarg>
 #include <cstdio>
 #include <optional>
+#include <vector>
 
 #ifdef _WIN32
 #include <cstdlib>
@@ -66,6 +68,57 @@ bool StreamableObject::writeFullStream(const void *buf, const size_t &count)
     return true;
 }
 
+std::optional<size_t> StreamableObject::writeV(const WriteSegment *segments, const size_t &count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (segments[i].size)
+        {
+            return write(segments[i].data, segments[i].size);
+        }
+    }
+    return 0;
+}
+
+bool StreamableObject::writeFullStreamV(const WriteSegment *segments, const size_t &count)
+{
+    // Copy the segments, the partially written ones are moved forward:
+    std::vector<WriteSegment> pending(segments, segments + count);
+    size_t firstPending = 0;
+
+    for (;;)
+    {
+        while (firstPending < pending.size() && pending[firstPending].size == 0)
+        {
+            firstPending++;
+        }
+        if (firstPending == pending.size())
+        {
+            return true;
+        }
+
+        std::optional<size_t> cur = writeV(pending.data() + firstPending, pending.size() - firstPending);
+        if (cur == std::nullopt || *cur == 0 || !writeStatus.succeed)
+        {
+            writeStatus.succeed += -1;
+            return false;
+        }
+
+        size_t writtenBytes = *cur;
+        while (writtenBytes > 0 && firstPending < pending.size())
+        {
+            size_t segmentBytes = std::min(writtenBytes, pending[firstPending].size);
+            pending[firstPending].data = static_cast<const char *>(pending[firstPending].data) + segmentBytes;
+            pending[firstPending].size -= segmentBytes;
+            writtenBytes -= segmentBytes;
+            if (pending[firstPending].size == 0)
+            {
+                firstPending++;
+            }
+        }
+    }
+}
+
 bool StreamableObject::writeString(const std::string &buf)
 {
     return writeFullStream(buf.c_str(), buf.size());
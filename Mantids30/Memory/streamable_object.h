@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Mantids30/Helpers/safeint.h>
+#include <cstdint>
 #include <cstdlib>
 #include <limits>
 #include <memory>
@@ -101,6 +102,15 @@ struct WriteStatus
     ssize_t writeError = 0;
 };
 
+/**
+ * @brief The WriteSegment struct references a memory region to be written by the vectored write functions (scatter-gather).
+ */
+struct WriteSegment
+{
+    const void *data = nullptr;
+    size_t size = 0;
+};
+
 /**
  * StreamableObject base class
  * This is a base class for streamable objects that can be retrieved or parsed trough read/write functions.
@@ -134,11 +144,62 @@ public:
      */
     virtual bool streamTo(Memory::Streams::StreamableObject *out) { return true; }
 
+    /**
+     * @brief streamAvailableTo Streams the data that is available right now to another streamable object without waiting for more (event-driven mode).
+     *                          The default implementation streams the whole object.
+     * @param out destination object
+     * @param finished set to true when the source ended or the destination finished, false if more data can arrive later.
+     * @return true if streamed, false otherwise
+     */
+    virtual bool streamAvailableTo(Memory::Streams::StreamableObject *out, bool &finished)
+    {
+        finished = true;
+        return streamTo(out);
+    }
+
     bool writeFullStreamWithEOF(const void *buf, const size_t &count);
     bool writeFullStream(const void *buf, const size_t &count);
 
     // Partial Write...
     virtual std::optional<size_t> write(const void *buf, const size_t &count) = 0;
+    /**
+     * @brief writeFromFileDescriptor Write a file region directly from its file descriptor (zero-copy path, eg. sendfile).
+     *                                Only the final destinations that can do this in kernel space implement it, any
+     *                                intermediate object (transformers, containers) keeps the default and the caller
+     *                                falls back to the regular write() chain.
+     * @param fd source file descriptor
+     * @param offset file offset where the data starts
+     * @param count bytes to be written
+     * @return std::nullopt if the zero-copy path is not available (nothing was written), otherwise the bytes written
+     *         (less than count means that the write failed).
+     */
+    virtual std::optional<size_t> writeFromFileDescriptor(int fd, const uint64_t &offset, const size_t &count) { return std::nullopt; }
+    /**
+     * @brief writeV Partial vectored write (scatter-gather), the segments are written in order as one contiguous stream.
+     *               The default implementation writes (part of) the first non-empty segment using write(), the final
+     *               destinations (eg. sockets) can write all the segments at once (eg. writev).
+     * @param segments segments to be written
+     * @param count segments count
+     * @return the bytes written (can be less than the total size), or std::nullopt on error.
+     */
+    virtual std::optional<size_t> writeV(const WriteSegment *segments, const size_t &count);
+    /**
+     * @brief writeFullStreamV Write all the segments (see writeV)
+     * @return true if succeed (all bytes written)
+     */
+    bool writeFullStreamV(const WriteSegment *segments, const size_t &count);
+
+    /**
+     * @brief cork Start holding the small writes to send them together on uncork (eg. the headers and the body of one
+     *             message), the calls can be nested. Only the final destinations (eg. sockets) implement it, the default
+     *             implementation writes immediately.
+     */
+    virtual void cork() {}
+    /**
+     * @brief uncork End the cork started with cork() and send the held data (when the last nested cork ends).
+     * @return false if the held data could not be written.
+     */
+    virtual bool uncork() { return true; }
     /**
      * @brief writeStream Write into stream using std::strings
      * @param buf data to be streamed.
@@ -157,4 +218,38 @@ private:
 #endif
 };
 
+/**
+ * @brief The StreamCork class corks the streamable object during its scope (see StreamableObject::cork).
+ */
+class StreamCork
+{
+public:
+    explicit StreamCork(StreamableObject *streamableObject)
+        : m_streamableObject(streamableObject)
+    {
+        if (m_streamableObject)
+        {
+            m_streamableObject->cork();
+        }
+    }
+    ~StreamCork() { uncork(); }
+
+    StreamCork(const StreamCork &) = delete;
+    StreamCork &operator=(const StreamCork &) = delete;
+
+    /**
+     * @brief uncork End the cork before the end of the scope
+     * @return false if the held data could not be written.
+     */
+    bool uncork()
+    {
+        StreamableObject *streamableObject = m_streamableObject;
+        m_streamableObject = nullptr;
+        return streamableObject ? streamableObject->uncork() : true;
+    }
+
+private:
+    StreamableObject *m_streamableObject;
+};
+
 } // namespace Mantids30::Memory::Streams
@@ -0,0 +1,37 @@
+#include "streamable_segments.h"
+
+using namespace Mantids30::Memory::Streams;
+
+void StreamableSegments::addSegment(const std::shared_ptr<const std::string> &segment)
+{
+    if (!segment || segment->empty())
+    {
+        return;
+    }
+    m_size += segment->size();
+    m_segments.push_back(segment);
+}
+
+void StreamableSegments::addSegment(std::string &&segment)
+{
+    addSegment(std::make_shared<const std::string>(std::move(segment)));
+}
+
+bool StreamableSegments::streamTo(Memory::Streams::StreamableObject *out)
+{
+    for (const auto &segment : m_segments)
+    {
+        if (!out->writeFullStream(segment->data(), segment->size()))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::optional<size_t> StreamableSegments::write(const void *buf, const size_t &count)
+{
+    addSegment(std::string(static_cast<const char *>(buf), count));
+    writeStatus += count;
+    return count;
+}
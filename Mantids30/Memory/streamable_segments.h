@@ -0,0 +1,46 @@
+#pragma once
+
+#include "streamable_object.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Mantids30::Memory::Streams {
+
+/**
+ * @brief The StreamableSegments class is an ordered list of string segments streamed one after the other (scatter-gather),
+ *        the segments can be shared (eg. the static parts of a template) so the content is never concatenated.
+ *        (NOTE: not thread-safe for R/W)
+ */
+class StreamableSegments : public Memory::Streams::StreamableObject
+{
+public:
+    StreamableSegments() = default;
+
+    /**
+     * @brief addSegment Add a shared (read-only) segment at the end
+     */
+    void addSegment(const std::shared_ptr<const std::string> &segment);
+    /**
+     * @brief addSegment Add a new segment at the end
+     */
+    void addSegment(std::string &&segment);
+
+    /**
+     * @brief getSegments Get the current segments
+     */
+    const std::vector<std::shared_ptr<const std::string>> &getSegments() const { return m_segments; }
+
+    bool streamTo(Memory::Streams::StreamableObject *out) override;
+    /**
+     * @brief write Append the data as a new segment
+     */
+    std::optional<size_t> write(const void *buf, const size_t &count) override;
+    size_t size() override { return m_size; }
+
+private:
+    std::vector<std::shared_ptr<const std::string>> m_segments;
+    size_t m_size = 0;
+};
+
+} // namespace Mantids30::Memory::Streams
@@ -26,6 +26,11 @@ std::optional<size_t> StreamableString::write(const void *buf, const size_t &cou
     }
 }
 
+size_t StreamableString::size()
+{
+    return m_value.size();
+}
+
 StreamableString &StreamableString::operator=(const std::string &str)
 {
     setValue(str);
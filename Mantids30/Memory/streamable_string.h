@@ -16,6 +16,7 @@ public:
     bool streamTo(Memory::Streams::StreamableObject *out) override;
 
     std::optional<size_t> write(const void *buf, const size_t &count) override;
+    size_t size() override;
 
     StreamableString &operator=(const std::string &str);
 
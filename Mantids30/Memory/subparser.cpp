@@ -93,6 +93,7 @@ void SubParser::setParseResult(const ParseResult &value)
 void SubParser::setParseDelimiter(const std::string &value)
 {
     m_parseDelimiter = value;
+    m_delimiterScanOffset = 0;
 }
 
 Mantids30::Memory::Containers::B_Base *SubParser::getParsedBuffer()
@@ -125,7 +126,7 @@ std::optional<size_t> SubParser::appendToUnparsedBuffer(const void *buf, size_t
         if (bytesAppended == std::nullopt || bytesAppended.value() != count)
         {
             // Failed to append this data (weird...)
-            m_unparsedBuffer.clear();
+            clearUnparsedBuffer();
             return std::nullopt;
         }
     }
@@ -133,6 +134,12 @@ std::optional<size_t> SubParser::appendToUnparsedBuffer(const void *buf, size_t
     return bytesAppended;
 }
 
+void SubParser::clearUnparsedBuffer()
+{
+    m_unparsedBuffer.clear();
+    m_delimiterScanOffset = 0;
+}
+
 std::optional<size_t> SubParser::parseByMultiDelimiter(const void *buf, size_t count)
 {
     size_t prevSize = m_unparsedBuffer.size(), bytesToDisplace = 0;
@@ -147,8 +154,17 @@ std::optional<size_t> SubParser::parseByMultiDelimiter(const void *buf, size_t c
     bytesToDisplace = bytesAppended.value();
     m_parsedBuffer.reference(&m_unparsedBuffer);
 
-    // Attempt to find the delimiter in the unparsed buffer
-    needlePos = m_unparsedBuffer.find(m_parseMultiDelimiter, m_delimiterFound);
+    // Attempt to find the delimiter in the unparsed buffer (from where the previous search left)
+    if (m_parseMultiDelimiter)
+    {
+        needlePos = m_unparsedBuffer.find(*m_parseMultiDelimiter, m_delimiterFound, m_delimiterScanOffset);
+    }
+    if (needlePos == std::nullopt && m_parseMultiDelimiter)
+    {
+        // Any delimiter starting before this point would have been found:
+        size_t unparsedSize = m_unparsedBuffer.size(), maxDelimiterSize = m_parseMultiDelimiter->getMaxNeedleSize();
+        m_delimiterScanOffset = unparsedSize >= maxDelimiterSize ? unparsedSize - maxDelimiterSize + 1 : 0;
+    }
     if (needlePos != std::nullopt)
     {
         // Delimiter found, update parsed buffer and status
@@ -160,7 +176,7 @@ std::optional<size_t> SubParser::parseByMultiDelimiter(const void *buf, size_t c
 #endif
 
         setParseResult(parse());
-        m_unparsedBuffer.clear();
+        clearUnparsedBuffer();
 
         // Calculate bytes to displace
         // We may have copied in the unparsed buffer more than we need to deliver. so
@@ -172,7 +188,7 @@ std::optional<size_t> SubParser::parseByMultiDelimiter(const void *buf, size_t c
         // No delimiter found but stream has ended, parse what's available
         m_parsedBuffer.reference(&m_unparsedBuffer);
         setParseResult(parse());
-        m_unparsedBuffer.clear();
+        clearUnparsedBuffer();
     }
     // else: delimiter not found yet, keep buffering
 
@@ -201,7 +217,14 @@ std::optional<size_t> SubParser::parseByDelimiter(const void *buf, size_t count)
     BIO_dump_fp(stdout, (char *) x.c_str(), x.size());
 #endif
 
-    needlePos = m_unparsedBuffer.find(m_parseDelimiter.c_str(), m_parseDelimiter.size());
+    // Find the delimiter (from where the previous search left)
+    needlePos = m_unparsedBuffer.find(m_parseDelimiter.c_str(), m_parseDelimiter.size(), true, m_delimiterScanOffset);
+    if (needlePos == std::nullopt)
+    {
+        // Any delimiter starting before this point would have been found:
+        size_t unparsedSize = m_unparsedBuffer.size();
+        m_delimiterScanOffset = unparsedSize >= m_parseDelimiter.size() ? unparsedSize - m_parseDelimiter.size() + 1 : 0;
+    }
     if (needlePos != std::nullopt)
     {
         // needle found.
@@ -212,7 +235,7 @@ std::optional<size_t> SubParser::parseByDelimiter(const void *buf, size_t count)
         fflush(stdout);
 #endif
         setParseResult(parse());
-        m_unparsedBuffer.clear();
+        clearUnparsedBuffer();
 
         // Bytes to displace:
         bytesToDisplace = (needlePos.value() - prevSize) + m_parseDelimiter.size();
@@ -229,7 +252,7 @@ std::optional<size_t> SubParser::parseByDelimiter(const void *buf, size_t count)
         fflush(stdout);
 #endif
         setParseResult(parse());
-        m_unparsedBuffer.clear();
+        clearUnparsedBuffer();
     }
 
 #ifdef DEBUG_PARSER
@@ -247,7 +270,7 @@ std::optional<size_t> SubParser::parseBySize(const void *buf, size_t count)
         // EOF.
         // Abort current subparser because we did not match the requested size.
         setParseResult(ParseResult::GOTO_NEXT_SUBPARSER);
-        m_unparsedBuffer.clear(); // Destroy the container data.
+        clearUnparsedBuffer(); // Destroy the container data.
         return 0;
     }
 
@@ -273,7 +296,7 @@ std::optional<size_t> SubParser::parseBySize(const void *buf, size_t count)
         fflush(stdout);
 #endif
         setParseResult(parse());
-        m_unparsedBuffer.clear(); // Destroy the container data.
+        clearUnparsedBuffer(); // Destroy the container data.
     }
 
     return bytesToDisplace;
@@ -329,7 +352,7 @@ std::optional<size_t> SubParser::parseByConnectionEnd(const void *buf, size_t co
 #endif
 
         setParseResult(parse());  // analyze on connection end.
-        m_unparsedBuffer.clear(); // Destroy the container data.
+        clearUnparsedBuffer(); // Destroy the container data.
         return 0;
     }
 
@@ -371,7 +394,7 @@ std::optional<size_t> SubParser::parseDirect(const void *buf, size_t count)
 
     // All the unparsed buffer was consumed by parsed buffer to the next parser...
     size_t curBufSize = m_unparsedBuffer.size();
-    m_unparsedBuffer.clear(); // Reset the container data for the next element.
+    clearUnparsedBuffer(); // Reset the container data for the next element.
     m_unparsedBuffer.reduceMaxSizeBy(curBufSize);
 
     return bytesToDisplace;
@@ -409,7 +432,7 @@ std::optional<size_t> SubParser::parseDirectDelimiter(const void *buf, size_t co
             //printf("Parsing direct delimiter (%llu, until size %llu): ", postParsedBuffer.size(), leftToParse); postParsedBuffer.print(); printf("\n"); fflush(stdout);
 #endif
             setParseResult(parse());
-            m_unparsedBuffer.clear(); // Reset the container data for the next element.
+            clearUnparsedBuffer(); // Reset the container data for the next element.
             break;
         default:
             // bytesOfPossibleDelim maybe belongs to the delimiter, need more data to continue and release the buffer...
@@ -420,10 +443,11 @@ std::optional<size_t> SubParser::parseDirectDelimiter(const void *buf, size_t co
             if (bytesOfPossibleDelim)
             {
                 m_unparsedBuffer.displace(m_unparsedBuffer.size() - bytesOfPossibleDelim); // Displace the parsed elements and leave the possible delimiter in the buffer...
+                m_delimiterScanOffset = 0;
             }
             else
             {
-                m_unparsedBuffer.clear(); // Reset the container data for the next element.
+                clearUnparsedBuffer(); // Reset the container data for the next element.
             }
             break;
         }
@@ -437,7 +461,7 @@ std::optional<size_t> SubParser::parseDirectDelimiter(const void *buf, size_t co
 
         if (delimPos.value() == 0)
         {
-            m_unparsedBuffer.clear(); // found on 0... give nothing to give
+            clearUnparsedBuffer(); // found on 0... give nothing to give
             m_parsedBuffer.reference(&m_unparsedBuffer);
         }
         else
@@ -446,7 +470,7 @@ std::optional<size_t> SubParser::parseDirectDelimiter(const void *buf, size_t co
         }
 
         setParseResult(parse());
-        m_unparsedBuffer.clear(); // Reset the container data for the next element.
+        clearUnparsedBuffer(); // Reset the container data for the next element.
 
         return (delimPos.value() - prevSize) + m_parseDelimiter.size();
     }
@@ -483,8 +507,14 @@ std::string SubParser::getFoundDelimiter() const
 }
 
 void SubParser::setParseMultiDelimiter(const std::list<std::string> &value)
+{
+    setParseMultiDelimiter(std::make_shared<const Mantids30::Memory::Search::MultiNeedle>(value));
+}
+
+void SubParser::setParseMultiDelimiter(const std::shared_ptr<const Memory::Search::MultiNeedle> &value)
 {
     m_parseMultiDelimiter = value;
+    m_delimiterScanOffset = 0;
 }
 
 size_t SubParser::getUnparsedDataSize()
@@ -499,7 +529,7 @@ void SubParser::setParseDataTargetSize(const size_t &value)
 
 void SubParser::clear()
 {
-    m_unparsedBuffer.clear();
+    clearUnparsedBuffer();
     m_parsedBuffer.clear();
 }
 
@@ -520,4 +550,5 @@ void SubParser::setParseStrategy(const ParseStrategy &value)
         setParseDataTargetSize(std::numeric_limits<size_t>::max());
     }
     m_parseMode = value;
+    m_delimiterScanOffset = 0;
 }
@@ -121,9 +121,16 @@ protected:
     void setParseDelimiter(const std::string &value);
     /**
      * @brief setParseMultiDelimiter Set Parse multi delimiter parameter (parse many delimiters)
+     *                               The search tables are built on each call, the parsers switching their delimiters on
+     *                               the hot path should build them once and share them (see the overload below).
      * @param value multiple delimiters
      */
     void setParseMultiDelimiter(const std::list<std::string> &value);
+    /**
+     * @brief setParseMultiDelimiter Set a prebuilt (immutable, shareable between parsers) multi delimiter set.
+     * @param value multiple delimiters
+     */
+    void setParseMultiDelimiter(const std::shared_ptr<const Memory::Search::MultiNeedle> &value);
     /**
      * @brief Get Parsed Data Pointer
      * @return parsed data pointer.
@@ -159,6 +166,7 @@ private:
     Mantids30::Memory::Containers::B_Ref referenceLastBytes(const size_t &bytes);
 
     std::optional<size_t> appendToUnparsedBuffer(const void *buf, size_t count);
+    void clearUnparsedBuffer();
 
     Mantids30::Memory::Containers::B_Ref m_parsedBuffer;
     Mantids30::Memory::Containers::B_Chunks m_unparsedBuffer;
@@ -166,7 +174,12 @@ private:
     std::string m_parseDelimiter = "\r\n";
     std::string m_delimiterFound;
 
-    std::list<std::string> m_parseMultiDelimiter;
+    std::shared_ptr<const Mantids30::Memory::Search::MultiNeedle> m_parseMultiDelimiter;
+
+    /**
+     * @brief m_delimiterScanOffset unparsed buffer bytes already scanned without finding the delimiter (the next search resumes from there).
+     */
+    size_t m_delimiterScanOffset = 0;
 
     ParseStrategy m_parseMode = ParseStrategy::DELIMITER;
     ParseResult m_parseStatus = ParseResult::GET_MORE_DATA;
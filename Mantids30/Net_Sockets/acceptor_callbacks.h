@@ -6,6 +6,8 @@ namespace Mantids30::Network::Sockets::Acceptors {
 
 using _callbackConnectionRV = void (*)(void *, const std::shared_ptr<Sockets::Socket_Stream> &);
 using _callbackConnectionLimit = void (*)(void *, const std::shared_ptr<Sockets::Socket_Stream> &);
+using _callbackConnectionEvent = bool (*)(void *, const std::shared_ptr<Sockets::Socket_Stream> &, std::shared_ptr<void> &);
+using _callbackConnectionEnd = void (*)(void *, const std::shared_ptr<Sockets::Socket_Stream> &, std::shared_ptr<void> &);
 
 class StreamAcceptorThreadCallbacks
 {
@@ -46,4 +48,32 @@ public:
     void *contextonClientConnectionLimitPerIPReached = nullptr;
 };
 
+class EventLoopCallbacks
+{
+public:
+    void setAllContexts(void *context)
+    {
+        contextOnConnect = contextOnDataAvailable = contextOnDisconnect = contextOnInitFail = contextOnTimedOut = contextonClientConnectionLimitPerIPReached = context;
+    }
+
+    // Connection events (the connection context is owned by the acceptor and kept between events):
+    // - onClientConnected/onClientDataAvailable return true to keep the connection parked waiting for more data.
+    // - onClientDisconnected is called when the acceptor drops a parked connection (idle timeout, shutdown, saturation).
+    _callbackConnectionEvent onClientConnected = nullptr;
+    _callbackConnectionEvent onClientDataAvailable = nullptr;
+    _callbackConnectionEnd onClientDisconnected = nullptr;
+
+    // Callbacks:
+    _callbackConnectionRV onProtocolInitializationFailure = nullptr;
+    _callbackConnectionRV onClientAcceptTimeoutOccurred = nullptr;
+    _callbackConnectionLimit onClientConnectionLimitPerIPReached = nullptr;
+
+    void *contextOnConnect = nullptr;
+    void *contextOnDataAvailable = nullptr;
+    void *contextOnDisconnect = nullptr;
+    void *contextOnInitFail = nullptr;
+    void *contextOnTimedOut = nullptr;
+    void *contextonClientConnectionLimitPerIPReached = nullptr;
+};
+
 } // namespace Mantids30::Network::Sockets::Acceptors
@@ -0,0 +1,482 @@
+#include "acceptor_eventloop.h"
+
+#ifdef __linux__
+
+#include <algorithm>
+#include <cerrno>
+#include <list>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+using namespace Mantids30::Network;
+using namespace Mantids30::Network::Sockets::Acceptors;
+
+EventLoop::Reactor::~Reactor()
+{
+    if (epollFD != -1)
+    {
+        close(epollFD);
+    }
+}
+
+EventLoop::EventLoop()
+{
+    setThreadRunner(runner, this);
+    setThreadStopper(stopper, this);
+}
+
+void EventLoop::run()
+{
+    std::unique_lock<std::mutex> lock(this->m_runMutex);
+
+    // Create pool as local variable (lifetime contained within run())
+    std::unique_ptr<Mantids30::Threads::Pool::ThreadPool> pool = std::make_unique<Mantids30::Threads::Pool::ThreadPool>(parameters.threadsCount, parameters.taskQueues);
+    pool->setName("Acceptor:EventLoop");
+    pool->start();
+    m_pool = pool.get();
+
+    m_running = true;
+
+    // Create the reactors (at least one):
+    for (uint32_t i = 0; i < std::max<uint32_t>(1, parameters.reactorThreads); i++)
+    {
+        std::unique_ptr<Reactor> reactor = std::make_unique<Reactor>();
+        reactor->epollFD = epoll_create1(EPOLL_CLOEXEC);
+        if (reactor->epollFD == -1)
+        {
+            continue;
+        }
+        m_reactors.push_back(std::move(reactor));
+    }
+
+    if (m_reactors.empty())
+    {
+        m_running = false;
+    }
+
+    for (std::unique_ptr<Reactor> &reactor : m_reactors)
+    {
+        reactor->thread = std::thread(&EventLoop::reactorLoop, this, reactor.get());
+    }
+
+    // One blocking acceptConnection() loop per acceptor socket:
+    for (std::shared_ptr<Sockets::Socket_Stream> &acceptorSocket : m_acceptorSocketList)
+    {
+        if (!acceptorSocket)
+        {
+            continue;
+        }
+        m_acceptorThreads.emplace_back(&EventLoop::acceptorLoop, this, acceptorSocket);
+    }
+
+    // Wait until stop is signaled (m_running set to false), then join all acceptor threads
+    for (std::thread &t : m_acceptorThreads)
+    {
+        if (t.joinable())
+        {
+            t.join();
+        }
+    }
+    m_running = false;
+
+    for (std::unique_ptr<Reactor> &reactor : m_reactors)
+    {
+        if (reactor->thread.joinable())
+        {
+            reactor->thread.join();
+        }
+    }
+
+    // Stop the pool and wait for the in-flight handlers (they will release their connections because we are not running anymore).
+    pool->stop();
+    pool.reset();
+    m_pool = nullptr;
+
+    // Release the parked connections:
+    for (std::unique_ptr<Reactor> &reactor : m_reactors)
+    {
+        std::list<std::shared_ptr<Connection>> parkedConnections;
+        {
+            std::unique_lock<std::mutex> lockReactor(reactor->mutex);
+            for (auto &i : reactor->connections)
+            {
+                parkedConnections.push_back(i.second);
+            }
+        }
+        for (std::shared_ptr<Connection> &connection : parkedConnections)
+        {
+            release(connection, true);
+        }
+    }
+
+    m_acceptorThreads.clear();
+    m_acceptorSocketList.clear();
+    m_reactors.clear();
+}
+
+void EventLoop::addAcceptorSocket(const std::shared_ptr<Sockets::Socket_Stream> &value)
+{
+    m_acceptorSocketList.push_back(value);
+}
+
+void EventLoop::_stop()
+{
+    m_running = false;
+
+    for (std::shared_ptr<Sockets::Socket_Stream> &sock : m_acceptorSocketList)
+    {
+        if (sock)
+        {
+            sock->shutdownSocket();
+        }
+    }
+}
+
+void EventLoop::runner(void *data)
+{
+    (static_cast<EventLoop *>(data))->run();
+}
+
+void EventLoop::stopper(void *data)
+{
+    (static_cast<EventLoop *>(data))->_stop();
+}
+
+void EventLoop::acceptorLoop(const std::shared_ptr<Sockets::Socket_Stream> &acceptorSocket)
+{
+#ifndef _WIN32
+    pthread_setname_np(pthread_self(), "evl:sck");
+#endif
+    while (m_running)
+    {
+        std::shared_ptr<Sockets::Socket_Stream> clientSocket = acceptorSocket->acceptConnection();
+        if (!clientSocket)
+        {
+            continue;
+        }
+
+        if (parameters.debugOptions.enabled)
+        {
+            uint32_t debugOptions = Socket::DebugOptions::PRINT_CLOSE | Socket::DebugOptions::PRINT_ERRORS;
+
+            if (parameters.debugOptions.printHex)
+            {
+                debugOptions |= Socket::DebugOptions::PRINT_WRITE_HEX | Socket::DebugOptions::PRINT_READ_HEX;
+            }
+
+            if (parameters.debugOptions.printPlainText)
+            {
+                debugOptions |= Socket::DebugOptions::PRINT_READ_PLAIN | Socket::DebugOptions::PRINT_WRITE_PLAIN;
+            }
+
+            clientSocket->setDebugOptions(debugOptions);
+            clientSocket->setDebugOutput(parameters.debugOptions.dir);
+        }
+
+        std::shared_ptr<Connection> connection = std::make_shared<Connection>();
+        connection->clientSocket = clientSocket;
+        connection->key = clientSocket->getRemotePairStr();
+
+        if (incrementIPUsage(connection->key) > parameters.maxConnectionsPerIP)
+        {
+            if (callbacks.onClientConnectionLimitPerIPReached)
+            {
+                callbacks.onClientConnectionLimitPerIPReached(callbacks.contextonClientConnectionLimitPerIPReached, clientSocket);
+            }
+            decrementIPUsage(connection->key);
+            continue;
+        }
+
+        if (!dispatch(&connectTask, connection))
+        {
+            if (callbacks.onClientAcceptTimeoutOccurred)
+            {
+                callbacks.onClientAcceptTimeoutOccurred(callbacks.contextOnTimedOut, clientSocket);
+            }
+            release(connection, false);
+        }
+    }
+}
+
+void EventLoop::reactorLoop(Reactor *reactor)
+{
+#ifndef _WIN32
+    pthread_setname_np(pthread_self(), "evl:reactor");
+#endif
+    epoll_event events[64];
+
+    while (m_running)
+    {
+        // Wake up for the next idle deadline (or at least every second to check if we are still running):
+        int count = epoll_wait(reactor->epollFD, events, 64, getIdleCheckTimeoutMS(reactor));
+        if (count < 0 && errno != EINTR)
+        {
+            break;
+        }
+
+        // Dispatch the readable connections into the pool:
+        for (int i = 0; i < count; i++)
+        {
+            std::shared_ptr<Connection> connection;
+            {
+                std::unique_lock<std::mutex> lock(reactor->mutex);
+                auto it = reactor->connections.find(events[i].data.fd);
+                if (it != reactor->connections.end() && !it->second->busy)
+                {
+                    connection = it->second;
+                    connection->busy = true;
+                }
+            }
+            if (connection && !dispatch(&dataAvailableTask, connection))
+            {
+                // The pool is saturated, drop the connection.
+                release(connection, true);
+            }
+        }
+
+        closeIdleConnections(reactor);
+    }
+}
+
+int EventLoop::getIdleCheckTimeoutMS(Reactor *reactor)
+{
+    std::unique_lock<std::mutex> lock(reactor->mutex);
+    if (reactor->idleDeadlines.empty())
+    {
+        return 1000;
+    }
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(reactor->idleDeadlines.top().deadline - std::chrono::steady_clock::now()).count();
+    return static_cast<int>(std::clamp<decltype(remaining)>(remaining + 1, 0, 1000));
+}
+
+void EventLoop::closeIdleConnections(Reactor *reactor)
+{
+    // Close the connections that stayed parked beyond the idle timeout (only the expired deadlines are visited):
+    std::list<std::shared_ptr<Connection>> idleConnections;
+    {
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        std::chrono::seconds idleTimeout(parameters.idleTimeoutInSeconds);
+        std::unique_lock<std::mutex> lock(reactor->mutex);
+        while (!reactor->idleDeadlines.empty() && reactor->idleDeadlines.top().deadline <= now)
+        {
+            Reactor::IdleDeadline entry = reactor->idleDeadlines.top();
+            reactor->idleDeadlines.pop();
+
+            std::shared_ptr<Connection> connection = entry.connection.lock();
+            if (!connection)
+            {
+                continue;
+            }
+            auto it = reactor->connections.find(connection->clientSocket->getSocketFD());
+            if (it == reactor->connections.end() || it->second != connection)
+            {
+                // Already released.
+                continue;
+            }
+
+            if (connection->busy)
+            {
+                // Being processed, check it again later (it will be parked with a new activity time):
+                entry.deadline = now + idleTimeout;
+            }
+            else if (connection->lastActivity + idleTimeout > now)
+            {
+                // Parked again since this deadline was set:
+                entry.deadline = connection->lastActivity + idleTimeout;
+            }
+            else
+            {
+                connection->busy = true;
+                idleConnections.push_back(connection);
+                continue;
+            }
+            reactor->idleDeadlines.push(std::move(entry));
+        }
+    }
+    for (std::shared_ptr<Connection> &connection : idleConnections)
+    {
+        release(connection, true);
+    }
+}
+
+bool EventLoop::dispatch(void (*task)(const std::shared_ptr<void> &), const std::shared_ptr<Connection> &connection)
+{
+    std::shared_ptr<EventTaskData> taskData = std::make_shared<EventTaskData>();
+    taskData->eventLoop = this;
+    taskData->connection = connection;
+    return m_pool->pushTask(task, taskData, parameters.timeoutMS, parameters.queuesKeyRatio, connection->key);
+}
+
+void EventLoop::park(const std::shared_ptr<Connection> &connection)
+{
+    if (!m_running || m_reactors.empty())
+    {
+        release(connection, true);
+        return;
+    }
+
+    bool registered = false;
+    Reactor *reactor = connection->reactor;
+    int fd = connection->clientSocket->getSocketFD();
+
+    if (!reactor)
+    {
+        reactor = m_reactors[(m_nextReactor++) % m_reactors.size()].get();
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(reactor->mutex);
+
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+        event.data.fd = fd;
+
+        connection->busy = false;
+        connection->lastActivity = std::chrono::steady_clock::now();
+
+        if (!connection->reactor)
+        {
+            connection->reactor = reactor;
+            reactor->connections[fd] = connection;
+            reactor->idleDeadlines.push({connection->lastActivity + std::chrono::seconds(parameters.idleTimeoutInSeconds), connection});
+            registered = (epoll_ctl(reactor->epollFD, EPOLL_CTL_ADD, fd, &event) == 0);
+        }
+        else
+        {
+            // Re-arm the one-shot event.
+            registered = (epoll_ctl(reactor->epollFD, EPOLL_CTL_MOD, fd, &event) == 0);
+        }
+
+        if (!registered)
+        {
+            connection->busy = true;
+        }
+    }
+
+    if (!registered)
+    {
+        release(connection, true);
+    }
+}
+
+void EventLoop::release(const std::shared_ptr<Connection> &connection, bool notifyDisconnection)
+{
+    if (connection->reactor)
+    {
+        int fd = connection->clientSocket->getSocketFD();
+        std::unique_lock<std::mutex> lock(connection->reactor->mutex);
+        auto it = connection->reactor->connections.find(fd);
+        if (it == connection->reactor->connections.end() || it->second != connection)
+        {
+            // Already released.
+            return;
+        }
+        connection->reactor->connections.erase(it);
+        epoll_ctl(connection->reactor->epollFD, EPOLL_CTL_DEL, fd, nullptr);
+    }
+
+    if (notifyDisconnection && callbacks.onClientDisconnected)
+    {
+        callbacks.onClientDisconnected(callbacks.contextOnDisconnect, connection->clientSocket, connection->connectionContext);
+    }
+
+    connection->connectionContext = nullptr;
+    connection->clientSocket->shutdownSocket();
+    decrementIPUsage(connection->key);
+}
+
+void EventLoop::connectTask(const std::shared_ptr<void> &data)
+{
+#ifndef _WIN32
+    pthread_setname_np(pthread_self(), "evl:sckacpt");
+#endif
+    EventTaskData *taskData = static_cast<EventTaskData *>(data.get());
+    EventLoop *eventLoop = taskData->eventLoop;
+    std::shared_ptr<Connection> connection = taskData->connection;
+
+    if (!connection->clientSocket->postAcceptSubInitialization())
+    {
+        if (eventLoop->callbacks.onProtocolInitializationFailure)
+        {
+            eventLoop->callbacks.onProtocolInitializationFailure(eventLoop->callbacks.contextOnInitFail, connection->clientSocket);
+        }
+        eventLoop->release(connection, false);
+        return;
+    }
+
+    bool keepConnection = eventLoop->callbacks.onClientConnected
+                              ? eventLoop->callbacks.onClientConnected(eventLoop->callbacks.contextOnConnect, connection->clientSocket, connection->connectionContext)
+                              : false;
+
+    // The protocol initialization may have already consumed application data from the kernel (eg. TLS), process it before parking.
+    while (keepConnection && connection->clientSocket->hasBufferedReadData() && eventLoop->callbacks.onClientDataAvailable)
+    {
+        keepConnection = eventLoop->callbacks.onClientDataAvailable(eventLoop->callbacks.contextOnDataAvailable, connection->clientSocket, connection->connectionContext);
+    }
+
+    if (keepConnection)
+    {
+        eventLoop->park(connection);
+    }
+    else
+    {
+        eventLoop->release(connection, false);
+    }
+}
+
+void EventLoop::dataAvailableTask(const std::shared_ptr<void> &data)
+{
+#ifndef _WIN32
+    pthread_setname_np(pthread_self(), "evl:sckdata");
+#endif
+    EventTaskData *taskData = static_cast<EventTaskData *>(data.get());
+    EventLoop *eventLoop = taskData->eventLoop;
+    std::shared_ptr<Connection> connection = taskData->connection;
+
+    bool keepConnection = eventLoop->callbacks.onClientDataAvailable
+                              ? eventLoop->callbacks.onClientDataAvailable(eventLoop->callbacks.contextOnDataAvailable, connection->clientSocket, connection->connectionContext)
+                              : false;
+
+    if (keepConnection)
+    {
+        eventLoop->park(connection);
+    }
+    else
+    {
+        eventLoop->release(connection, false);
+    }
+}
+
+uint32_t EventLoop::incrementIPUsage(const std::string &ipAddr)
+{
+    std::unique_lock<std::mutex> lock(m_mutexConnectionsPerIP);
+    if (m_connectionsPerIP.find(ipAddr) == m_connectionsPerIP.end())
+    {
+        m_connectionsPerIP[ipAddr] = 1;
+    }
+    else if (m_connectionsPerIP[ipAddr] != UINT32_MAX)
+    {
+        m_connectionsPerIP[ipAddr]++;
+    }
+    return m_connectionsPerIP[ipAddr];
+}
+
+void EventLoop::decrementIPUsage(const std::string &ipAddr)
+{
+    std::unique_lock<std::mutex> lock(m_mutexConnectionsPerIP);
+    auto it = m_connectionsPerIP.find(ipAddr);
+    if (it == m_connectionsPerIP.end())
+    {
+        return;
+    }
+    if (it->second <= 1)
+    {
+        m_connectionsPerIP.erase(it);
+    }
+    else
+    {
+        it->second--;
+    }
+}
+
+#endif
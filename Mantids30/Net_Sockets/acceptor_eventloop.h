@@ -0,0 +1,231 @@
+#pragma once
+
+#ifdef __linux__
+
+#include "acceptor_callbacks.h"
+#include "socket_stream.h"
+
+#include <Mantids30/Threads/threaded.h>
+#include <Mantids30/Threads/threadpool.h>
+#include <atomic>
+#include <boost/property_tree/ptree.hpp>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace Mantids30::Network::Sockets::Acceptors {
+
+/**
+ * @brief The EventLoop class accepts connections and parks them on epoll reactor threads.
+ *
+ * Idle connections (eg. keep-alive connections between requests) don't hold any thread, they are watched by a small
+ * number of reactor threads, and the connection handler is dispatched into the thread pool only when the connection
+ * has incoming data to be processed.
+ *
+ * Connection lifecycle:
+ *  - Accept -> per-IP limit check -> (pool) postAcceptSubInitialization + onClientConnected -> parked on a reactor.
+ *  - Readable -> (pool) onClientDataAvailable -> parked again if the callback returns true, released otherwise.
+ *  - Idle timeout / shutdown / pool saturation -> onClientDisconnected -> released.
+ *
+ * The handlers are expected to read only what the reactor reported as readable (eg. Socket_Stream::streamAvailableTo),
+ * so the accepted sockets should be plain sockets: the TLS handshake and the TLS records are read in blocking mode
+ * and a slow client would pin a worker thread.
+ */
+class EventLoop : public Mantids30::Threads::Threaded
+{
+public:
+    EventLoop();
+    ~EventLoop() override = default;
+
+    /**
+     * @brief run Don't call this function, call startInBackground(). This is a virtual
+     * function for the processor thread.
+     */
+    void run();
+
+    /////////////////////////////////////////////////////////////////////////
+    // TUNNING:
+
+    class Config
+    {
+    public:
+        /**
+         * @brief setConfig Set configuration from a Boost Property Tree.
+         * @param pt Boost Property Tree containing configuration.
+         */
+        void setConfig(const boost::property_tree::ptree &ptree)
+        {
+            try
+            {
+                reactorThreads = ptree.get<uint32_t>("ReactorThreads", reactorThreads);
+                idleTimeoutInSeconds = ptree.get<uint32_t>("IdleTimeoutInSeconds", idleTimeoutInSeconds);
+                maxConnectionsPerIP = ptree.get<uint32_t>("MaxConcurrentConnectionsPerIP", maxConnectionsPerIP);
+                timeoutMS = ptree.get<uint32_t>("TimeoutInMilliseconds", timeoutMS);
+                threadsCount = ptree.get<uint32_t>("ThreadsCount", threadsCount);
+                taskQueues = ptree.get<uint32_t>("TaskQueues", taskQueues);
+                queuesKeyRatio = ptree.get<float>("QueuesKeyRatio", queuesKeyRatio);
+
+                debugOptions.enabled = ptree.get<bool>("Debug.Enabled", debugOptions.enabled.load());
+                debugOptions.printPlainText = ptree.get<bool>("Debug.PrintPlainText", debugOptions.printPlainText.load());
+                debugOptions.printHex = ptree.get<bool>("Debug.PrintHex", debugOptions.printHex.load());
+                debugOptions.dir = ptree.get<std::string>("Debug.Dir", debugOptions.dir);
+            }
+            catch (const std::exception &e)
+            {
+                // Handle exceptions (e.g., invalid property tree format)
+                throw std::runtime_error("Failed to set configuration: " + std::string(e.what()));
+            }
+        }
+
+        /**
+         * @brief reactorThreads Number of epoll reactor threads watching the parked connections (must be set before start).
+         */
+        uint32_t reactorThreads = 2;
+
+        /**
+         * @brief idleTimeoutInSeconds Time a parked connection can stay without incoming data before being closed
+         *                             (the API servers use their HTTP keep-alive idle timeout instead).
+         */
+        uint32_t idleTimeoutInSeconds = 60;
+
+        /**
+         * @brief maxConnectionsPerIP Maximum number of concurrent connections allowed per unique client IP.
+         */
+        uint32_t maxConnectionsPerIP = 10;
+
+        /**
+         * @brief timeoutMS Timeout in milliseconds to cease trying to insert the task in a queue.
+         */
+        uint32_t timeoutMS = 5000;
+
+        /**
+         * @brief threadsCount Number of handler threads to be used (must be set before start).
+         */
+        uint32_t threadsCount = 52;
+
+        /**
+         * @brief taskQueues Number of queues to store tasks, each queue handles up to 100 tasks in wait mode.
+         */
+        uint32_t taskQueues = 36;
+
+        /**
+         * @brief queuesKeyRatio Defines how many queues can be used by a specific key (client address).
+         */
+        float queuesKeyRatio = 0.5;
+
+        struct DebugOptions
+        {
+            std::atomic<bool> enabled{false};
+            std::atomic<bool> printPlainText{false};
+            std::atomic<bool> printHex{true};
+            std::string dir = "/tmp";
+        };
+
+        DebugOptions debugOptions;
+    };
+
+    Config parameters;
+
+    /**
+     * @brief addAcceptorSocket Add an acceptor socket for accepting new clients from a distinct source.
+     * @param value acceptor socket
+     */
+    void addAcceptorSocket(const std::shared_ptr<Sockets::Socket_Stream> &value);
+    /**
+     * @brief getAcceptorSocketCount Get the number of acceptor sockets currently registered.
+     * @return number of acceptor sockets
+     */
+    size_t getAcceptorSocketCount() const { return m_acceptorSocketList.size(); }
+
+    EventLoopCallbacks callbacks;
+
+private:
+    struct Reactor;
+
+    struct Connection
+    {
+        ~Connection()
+        {
+            if (clientSocket)
+            {
+                clientSocket->shutdownSocket();
+            }
+        }
+
+        std::shared_ptr<Sockets::Socket_Stream> clientSocket;
+        std::shared_ptr<void> connectionContext;
+        std::string key;
+        Reactor *reactor = nullptr;
+        std::chrono::steady_clock::time_point lastActivity;
+        bool busy = true;
+    };
+
+    struct Reactor
+    {
+        struct IdleDeadline
+        {
+            bool operator>(const IdleDeadline &other) const { return deadline > other.deadline; }
+
+            std::chrono::steady_clock::time_point deadline;
+            std::weak_ptr<Connection> connection;
+        };
+
+        ~Reactor();
+
+        int epollFD = -1;
+        std::thread thread;
+        std::mutex mutex;
+        std::map<int, std::shared_ptr<Connection>> connections;
+        /**
+         * @brief idleDeadlines One entry per registered connection (earliest first), re-evaluated only when it expires.
+         */
+        std::priority_queue<IdleDeadline, std::vector<IdleDeadline>, std::greater<IdleDeadline>> idleDeadlines;
+    };
+
+    struct EventTaskData
+    {
+        EventLoop *eventLoop = nullptr;
+        std::shared_ptr<Connection> connection;
+    };
+
+    static void runner(void *data);
+    static void stopper(void *data);
+    static void connectTask(const std::shared_ptr<void> &data);
+    static void dataAvailableTask(const std::shared_ptr<void> &data);
+
+    void _stop();
+
+    void acceptorLoop(const std::shared_ptr<Sockets::Socket_Stream> &acceptorSocket);
+    void reactorLoop(Reactor *reactor);
+    int getIdleCheckTimeoutMS(Reactor *reactor);
+    void closeIdleConnections(Reactor *reactor);
+
+    bool dispatch(void (*task)(const std::shared_ptr<void> &), const std::shared_ptr<Connection> &connection);
+    void park(const std::shared_ptr<Connection> &connection);
+    void release(const std::shared_ptr<Connection> &connection, bool notifyDisconnection);
+
+    uint32_t incrementIPUsage(const std::string &ipAddr);
+    void decrementIPUsage(const std::string &ipAddr);
+
+    std::vector<std::shared_ptr<Sockets::Socket_Stream>> m_acceptorSocketList;
+    std::vector<std::thread> m_acceptorThreads;
+    std::vector<std::unique_ptr<Reactor>> m_reactors;
+    std::atomic<size_t> m_nextReactor{0};
+
+    Mantids30::Threads::Pool::ThreadPool *m_pool = nullptr;
+
+    std::map<std::string, uint32_t> m_connectionsPerIP;
+    std::mutex m_mutexConnectionsPerIP;
+
+    std::atomic<bool> m_running{false};
+    std::mutex m_runMutex;
+};
+
+} // namespace Mantids30::Network::Sockets::Acceptors
+
+#endif
@@ -21,6 +21,7 @@ void PoolThreaded::run()
 
     // Create pool as local variable (lifetime contained within run())
     std::unique_ptr<Mantids30::Threads::Pool::ThreadPool> pool = std::make_unique<Mantids30::Threads::Pool::ThreadPool>(parameters.threadsCount, parameters.taskQueues);
+    pool->setName("Acceptor:PoolThreaded");
     pool->start();
 
     m_running = true;
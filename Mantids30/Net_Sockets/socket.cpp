@@ -18,6 +18,7 @@
 
 #include <arpa/inet.h>
 #include <netdb.h>
+#include <poll.h>
 #include <sys/socket.h>
 
 #endif
@@ -267,6 +268,33 @@ bool Socket::isConnected()
     return false;
 }
 
+bool Socket::isReadReady()
+{
+    if (hasBufferedReadData())
+    {
+        return true;
+    }
+
+    if (!isActive())
+    {
+        return false;
+    }
+
+#ifdef _WIN32
+    WSAPOLLFD pfd;
+    pfd.fd = m_sockFD;
+    pfd.events = POLLRDNORM;
+    pfd.revents = 0;
+    return WSAPoll(&pfd, 1, 0) > 0;
+#else
+    struct pollfd pfd;
+    pfd.fd = m_sockFD;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    return poll(&pfd, 1, 0) > 0;
+#endif
+}
+
 bool Socket::connectTo(const char *remoteHost, const uint16_t &remotePort, const uint32_t &timeout)
 {
     return connectFrom(nullptr, remoteHost, remotePort, timeout);
@@ -61,6 +61,11 @@ public:
      * @param _timeout timeout in seconds
      */
     bool setReadTimeout(unsigned int _timeout);
+    /**
+     * Get the current read timeout.
+     * @return timeout in seconds
+     */
+    unsigned int getReadTimeout() const { return m_readTimeout; }
     /**
      * Set Write timeout.
      * @param _timeout timeout in seconds
@@ -93,6 +98,12 @@ public:
      */
     int adquireSocketFD();
 
+    /**
+     * Get Current Socket file descriptor (the socket object keeps the ownership).
+     * @return socket file descriptor
+     */
+    [[nodiscard]] int getSocketFD() const { return m_sockFD; }
+
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // Socket Status:
     /**
@@ -105,6 +116,16 @@ public:
      * @param true if is it connected
      */
     virtual bool isConnected();
+    /**
+     * @brief hasBufferedReadData Check if the protocol layer holds already received data that the kernel won't report as readable (eg. decrypted TLS records).
+     * @return true if the next read will return data without touching the socket.
+     */
+    virtual bool hasBufferedReadData() { return false; }
+    /**
+     * @brief isReadReady Check (without blocking) if the next read operation will return immediately.
+     * @return true if there is buffered data, incoming data or a pending EOF/error on the socket.
+     */
+    bool isReadReady();
 
     struct AddressAndPort
     {
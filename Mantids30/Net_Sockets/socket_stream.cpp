@@ -6,14 +6,17 @@
 
 #ifndef _WIN32
 #include <sys/socket.h>
+#include <sys/uio.h>
 #else
 #include "socket_tcp.h"
 #include <winsock2.h>
 #include <ws2tcpip.h>
 
 #endif
+#include <algorithm>
 #include <cstring>
 #include <unistd.h>
+#include <vector>
 
 #include <Mantids30/Helpers/random.h>
 
@@ -24,6 +27,22 @@ bool Socket_Stream::streamTo(Memory::Streams::StreamableObject *out)
 {
     char data[8192];
     memset(data, 0, 8192);
+
+    // Data already received in the read-ahead buffer:
+    if (m_readAheadLength > 0)
+    {
+        bool r = out->writeFullStream(m_readAheadBuffer.data() + m_readAheadOffset, m_readAheadLength);
+        m_readAheadOffset = m_readAheadLength = 0;
+        if (!r)
+        {
+            return false;
+        }
+        if (out->writeStatus.finished)
+        {
+            return true;
+        }
+    }
+
     for (;;)
     {
         ssize_t r = partialRead(data, sizeof(data));
@@ -49,15 +68,75 @@ bool Socket_Stream::streamTo(Memory::Streams::StreamableObject *out)
     }
 }
 
+bool Socket_Stream::streamAvailableTo(Memory::Streams::StreamableObject *out, bool &finished)
+{
+    char data[8192];
+    finished = false;
+
+    // Data already received in the read-ahead buffer:
+    if (m_readAheadLength > 0)
+    {
+        bool r = out->writeFullStream(m_readAheadBuffer.data() + m_readAheadOffset, m_readAheadLength);
+        m_readAheadOffset = m_readAheadLength = 0;
+        if (!r || out->writeStatus.finished)
+        {
+            finished = true;
+            return r;
+        }
+    }
+
+    do
+    {
+        ssize_t r = partialRead(data, sizeof(data));
+        switch (r)
+        {
+        case -1: // ERR.
+            finished = true;
+            return false;
+        case 0: // EOF.
+            finished = true;
+            return true;
+        default:
+            if (!out->writeFullStream(data, r))
+            {
+                finished = true;
+                return false;
+            }
+            break;
+        }
+
+        if (out->writeStatus.finished)
+        {
+            // Protocol finished. Stop writting into.
+            finished = true;
+            return true;
+        }
+    } while (isReadReady());
+
+    // Nothing else to read right now, the caller should wait for the next event.
+    return true;
+}
+
 std::optional<size_t> Socket_Stream::write(const void *buf, const size_t &count)
 {
     // EOF:
     if (count == 0)
     {
+        flushCorkBuffer();
         shutdownSocket(SHUT_RDWR);
         return 0;
     }
 
+    if (m_corkDepth)
+    {
+        Memory::Streams::WriteSegment segment{buf, count};
+        if (!corkedWriteV(&segment, 1))
+        {
+            return std::nullopt;
+        }
+        return count;
+    }
+
     // Write...
     ssize_t r = partialWrite(buf, count);
     if (r > 0)
@@ -121,6 +200,12 @@ bool Socket_Stream::writeFull(const void *data, const size_t &datalen)
         return false;
     }
 
+    if (m_corkDepth)
+    {
+        Memory::Streams::WriteSegment segment{data, datalen};
+        return corkedWriteV(&segment, 1);
+    }
+
     // Init control variables:
     size_t remaining = datalen;                            // data left to send
     const char *dataPtr = static_cast<const char *>(data); // data pointer.
@@ -152,6 +237,232 @@ bool Socket_Stream::writeFull(const void *data, const size_t &datalen)
     return true;
 }
 
+bool Socket_Stream::writeFullV(const Memory::Streams::WriteSegment *segments, const size_t &count)
+{
+    if (m_corkDepth)
+    {
+        return corkedWriteV(segments, count);
+    }
+    return sendSegments(segments, count);
+}
+
+ssize_t Socket_Stream::partialWriteV(const Memory::Streams::WriteSegment *segments, const size_t &count)
+{
+    size_t first = 0;
+    while (first < count && segments[first].size == 0)
+    {
+        first++;
+    }
+    if (first == count)
+    {
+        return 0;
+    }
+
+    // Big (or only) segment: write it directly without copying
+    if (segments[first].size >= MAX_COALESCED_WRITE_SIZE || first + 1 == count)
+    {
+        return partialWrite(segments[first].data, segments[first].size);
+    }
+
+    // Aggregate the segments in one buffer (eg. one SSL_write, one TLS record):
+    char buffer[MAX_COALESCED_WRITE_SIZE];
+    size_t bufferSize = 0;
+    for (size_t i = first; i < count && bufferSize < sizeof(buffer); i++)
+    {
+        size_t bytes = std::min(segments[i].size, sizeof(buffer) - bufferSize);
+        if (bytes)
+        {
+            memcpy(buffer + bufferSize, segments[i].data, bytes);
+            bufferSize += bytes;
+        }
+    }
+
+    return partialWrite(buffer, bufferSize);
+}
+
+std::optional<size_t> Socket_Stream::writeV(const Memory::Streams::WriteSegment *segments, const size_t &count)
+{
+    if (m_corkDepth)
+    {
+        size_t totalSize = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            totalSize += segments[i].size;
+        }
+        if (!corkedWriteV(segments, count))
+        {
+            return std::nullopt;
+        }
+        return totalSize;
+    }
+
+    ssize_t r = partialWriteV(segments, count);
+    if (r > 0)
+    {
+        return r;
+    }
+    return std::nullopt;
+}
+
+void Socket_Stream::cork()
+{
+    m_corkDepth++;
+}
+
+bool Socket_Stream::uncork()
+{
+    if (m_corkDepth == 0)
+    {
+        return true;
+    }
+    if (--m_corkDepth > 0)
+    {
+        return true;
+    }
+    return flushCorkBuffer();
+}
+
+ssize_t Socket_Stream::socketPartialWriteV(const Memory::Streams::WriteSegment *segments, const size_t &count)
+{
+#ifndef _WIN32
+    // Debugging needs to print each written block, use the regular write path.
+    if (debugOptions & (Socket::DebugOptions::PRINT_WRITE_HEX | Socket::DebugOptions::PRINT_WRITE_PLAIN))
+    {
+        return Socket_Stream::partialWriteV(segments, count);
+    }
+
+    if (!isActive())
+    {
+        return -1;
+    }
+
+    struct iovec iov[MAX_WRITE_SEGMENTS];
+    size_t iovCount = 0;
+    for (size_t i = 0; i < count && iovCount < MAX_WRITE_SEGMENTS; i++)
+    {
+        if (segments[i].size)
+        {
+            iov[iovCount].iov_base = const_cast<void *>(segments[i].data);
+            iov[iovCount].iov_len = segments[i].size;
+            iovCount++;
+        }
+    }
+    if (iovCount == 0)
+    {
+        return 0;
+    }
+
+    ssize_t sendLen;
+    if (!m_useWriteInsteadRecv)
+    {
+        struct msghdr msg{};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = iovCount;
+        sendLen = sendmsg(m_sockFD, &msg, MSG_NOSIGNAL);
+    }
+    else
+    {
+        sendLen = ::writev(m_sockFD, iov, static_cast<int>(iovCount));
+    }
+
+    if (sendLen <= 0)
+    {
+        if (debugOptions & Socket::DebugOptions::PRINT_ERRORS)
+        {
+            char errorBuffer[256];
+            strerror_r(errno, errorBuffer, sizeof(errorBuffer));
+            fprintf(debugFP, "--- [TCP ERROR] sendmsg failed: %s\n", errorBuffer);
+            fflush(debugFP);
+        }
+        return -1;
+    }
+    return sendLen;
+#else
+    return Socket_Stream::partialWriteV(segments, count);
+#endif
+}
+
+bool Socket_Stream::flushCorkBuffer()
+{
+    if (m_corkBuffer.empty())
+    {
+        return true;
+    }
+
+    Memory::Streams::WriteSegment segment{m_corkBuffer.data(), m_corkBuffer.size()};
+    bool r = sendSegments(&segment, 1);
+    m_corkBuffer.clear();
+    return r;
+}
+
+bool Socket_Stream::corkedWriteV(const Memory::Streams::WriteSegment *segments, const size_t &count)
+{
+    size_t totalSize = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        totalSize += segments[i].size;
+    }
+
+    if (m_corkBuffer.size() + totalSize <= MAX_CORK_BUFFER_SIZE)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            m_corkBuffer.append(static_cast<const char *>(segments[i].data), segments[i].size);
+        }
+        return true;
+    }
+
+    // Too big to be held: send the held data and the new segments together.
+    std::vector<Memory::Streams::WriteSegment> allSegments;
+    allSegments.reserve(count + 1);
+    allSegments.push_back({m_corkBuffer.data(), m_corkBuffer.size()});
+    allSegments.insert(allSegments.end(), segments, segments + count);
+
+    bool r = sendSegments(allSegments.data(), allSegments.size());
+    m_corkBuffer.clear();
+    return r;
+}
+
+bool Socket_Stream::sendSegments(const Memory::Streams::WriteSegment *segments, const size_t &count)
+{
+    // Copy the segments, the partially written ones are moved forward:
+    std::vector<Memory::Streams::WriteSegment> pending(segments, segments + count);
+    size_t firstPending = 0;
+
+    for (;;)
+    {
+        while (firstPending < pending.size() && pending[firstPending].size == 0)
+        {
+            firstPending++;
+        }
+        if (firstPending == pending.size())
+        {
+            return true;
+        }
+
+        ssize_t sentBytes = partialWriteV(pending.data() + firstPending, pending.size() - firstPending);
+        if (sentBytes <= 0)
+        {
+            shutdownSocket();
+            writeStatus += -1;
+            return false;
+        }
+
+        size_t remaining = static_cast<size_t>(sentBytes);
+        while (remaining > 0 && firstPending < pending.size())
+        {
+            size_t segmentBytes = std::min(remaining, pending[firstPending].size);
+            pending[firstPending].data = static_cast<const char *>(pending[firstPending].data) + segmentBytes;
+            pending[firstPending].size -= segmentBytes;
+            remaining -= segmentBytes;
+            if (pending[firstPending].size == 0)
+            {
+                firstPending++;
+            }
+        }
+    }
+}
+
 std::shared_ptr<Mantids30::Network::Sockets::Socket_Stream> Socket_Stream::acceptConnection()
 {
     return nullptr;
@@ -175,14 +486,33 @@ bool Socket_Stream::readFull(void *data, const size_t &expectedDataBytesCount, s
         return true;
     }
 
-    size_t curReceivedBytesCount = 0;
+    // Data already received in the read-ahead buffer:
+    size_t curReceivedBytesCount = readFromReadAheadBuffer(data, expectedDataBytesCount);
 
     while (curReceivedBytesCount < expectedDataBytesCount)
     {
-        // Calcular el tamaño máximo a leer en esta iteración
-        size_t bytesToRead = std::min<size_t>(mChunkSize, expectedDataBytesCount - curReceivedBytesCount);
+        size_t pendingBytesCount = expectedDataBytesCount - curReceivedBytesCount;
+        ssize_t partialReceivedBytesCount;
+
+        if (pendingBytesCount < m_readAheadBuffer.size())
+        {
+            // Small read: fill the read-ahead buffer with what is available and take the requested bytes from there.
+            partialReceivedBytesCount = partialRead(m_readAheadBuffer.data(), m_readAheadBuffer.size());
+            if (partialReceivedBytesCount > 0)
+            {
+                m_readAheadOffset = 0;
+                m_readAheadLength = static_cast<size_t>(partialReceivedBytesCount);
+                curReceivedBytesCount += readFromReadAheadBuffer(static_cast<char *>(data) + curReceivedBytesCount, pendingBytesCount);
+                continue;
+            }
+        }
+        else
+        {
+            // Calcular el tamaño máximo a leer en esta iteración
+            size_t bytesToRead = std::min<size_t>(mChunkSize, pendingBytesCount);
 
-        ssize_t partialReceivedBytesCount = partialRead(static_cast<char *>(data) + curReceivedBytesCount, static_cast<uint32_t>(bytesToRead));
+            partialReceivedBytesCount = partialRead(static_cast<char *>(data) + curReceivedBytesCount, static_cast<uint32_t>(bytesToRead));
+        }
 
         if (partialReceivedBytesCount < 0)
         {
@@ -216,6 +546,49 @@ bool Socket_Stream::readFull(void *data, const size_t &expectedDataBytesCount, s
     // We received complete:
     return true;
 }
+void Socket_Stream::setReadAheadSize(const size_t &readAheadSize)
+{
+    // Keep the data that is already buffered:
+    if (m_readAheadLength > 0)
+    {
+        std::vector<char> pendingData(m_readAheadBuffer.begin() + static_cast<std::ptrdiff_t>(m_readAheadOffset),
+                                      m_readAheadBuffer.begin() + static_cast<std::ptrdiff_t>(m_readAheadOffset + m_readAheadLength));
+        pendingData.resize(std::max(readAheadSize, m_readAheadLength));
+        m_readAheadBuffer.swap(pendingData);
+        m_readAheadOffset = 0;
+        return;
+    }
+
+    m_readAheadBuffer.resize(readAheadSize);
+    m_readAheadBuffer.shrink_to_fit();
+}
+
+size_t Socket_Stream::getReadAheadSize() const
+{
+    return m_readAheadBuffer.size();
+}
+
+bool Socket_Stream::hasBufferedReadData()
+{
+    return m_readAheadLength > 0;
+}
+
+size_t Socket_Stream::readFromReadAheadBuffer(void *data, const size_t &datalen)
+{
+    size_t bytes = std::min(datalen, m_readAheadLength);
+    if (bytes)
+    {
+        memcpy(data, m_readAheadBuffer.data() + m_readAheadOffset, bytes);
+        m_readAheadOffset += bytes;
+        m_readAheadLength -= bytes;
+        if (m_readAheadLength == 0)
+        {
+            m_readAheadOffset = 0;
+        }
+    }
+    return bytes;
+}
+
 void Socket_Stream::deriveConnectionName()
 {
     std::string rpcClientKey;
@@ -5,7 +5,9 @@
 #include "socket_stream_writer.h"
 #include <Mantids30/Memory/streamable_object.h>
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 namespace Mantids30::Network::Sockets {
 
@@ -66,6 +68,10 @@ public:
     ~Socket_Stream() override = default;
 
     bool streamTo(Memory::Streams::StreamableObject *out) override;
+    /**
+     * @brief streamAvailableTo Streams the data that can be read without waiting (see isReadReady) into another streamable object.
+     */
+    bool streamAvailableTo(Memory::Streams::StreamableObject *out, bool &finished) override;
 
     std::optional<size_t> write(const void *buf, const size_t &count) override;
 
@@ -118,6 +124,35 @@ public:
      * @return true if the data block was sucessfully sent.
      */
     bool writeFull(const void *data, const size_t &datalen) override;
+    /**
+     * @brief writeFullV Write all the segments as one contiguous stream with the less possible system calls (scatter-gather)
+     * @param segments segments to be written
+     * @param count segments count
+     * @return true if all the segments were sucessfully sent.
+     */
+    bool writeFullV(const Memory::Streams::WriteSegment *segments, const size_t &count);
+    /**
+     * @brief partialWriteV Write the segments (or part of them) in one operation.
+     *                      The default implementation aggregates the first segments in one buffer (up to MAX_COALESCED_WRITE_SIZE)
+     *                      and writes it using partialWrite, the file descriptor based sockets use writev.
+     * @return return the number of bytes written by the socket, zero for end of file and -1 for error.
+     */
+    virtual ssize_t partialWriteV(const Memory::Streams::WriteSegment *segments, const size_t &count);
+    std::optional<size_t> writeV(const Memory::Streams::WriteSegment *segments, const size_t &count) override;
+
+    /**
+     * @brief cork Hold the writes in memory until uncork (up to MAX_CORK_BUFFER_SIZE), so the headers and the content of
+     *             one message are sent together. The calls can be nested.
+     *             NOTE: the cork state is not synchronized, the threads sharing the socket have to hold their own write
+     *             lock from cork to uncork.
+     */
+    void cork() override;
+    /**
+     * @brief uncork Send the held writes when the last nested cork ends
+     * @return false if the held data could not be sent.
+     */
+    bool uncork() override;
+
     /**
      * @brief readBlock Read a data block from the socket
      *                  Receive the data block in 4k chunks (or less) until it ends or fail.
@@ -128,18 +163,62 @@ public:
      */
     bool readFull(void *data, const size_t &expectedDataBytesCount, size_t *receivedDataBytesCount = nullptr) override;
 
+    /**
+     * @brief setReadAheadSize Enable a read-ahead buffer for readFull (and the Socket_Stream_Reader primitives, eg. readU/readStringEx).
+     *                         The reads smaller than the buffer are served from memory (one partialRead fills the buffer with
+     *                         everything already received), bigger reads go directly into the destination.
+     *                         NOTE: partialRead is not buffered, don't mix it with readFull while read-ahead is enabled
+     *                         (streamTo and streamAvailableTo deliver the buffered data first).
+     * @param readAheadSize buffer size in bytes (0 disables it, the already buffered data is still delivered by readFull)
+     */
+    void setReadAheadSize(const size_t &readAheadSize);
+    size_t getReadAheadSize() const;
+    /**
+     * @brief hasBufferedReadData Check if the read-ahead buffer holds received data not consumed yet.
+     */
+    bool hasBufferedReadData() override;
+
     void deriveConnectionName();
 
     // Configurable chunk size for writeFull/readFull operations
     void setChunkSize(size_t chunkSize);
     size_t getChunkSize() const;
 
+    // Maximum data aggregated in one buffer by the default partialWriteV (the maximum TLS record plaintext size).
+    static constexpr size_t MAX_COALESCED_WRITE_SIZE = 16384;
+    // Maximum data held by cork(), bigger writes are sent with the held data in the same vectored write.
+    static constexpr size_t MAX_CORK_BUFFER_SIZE = 16384;
+    // Maximum segments written in one writev call.
+    static constexpr size_t MAX_WRITE_SEGMENTS = 64;
+
 protected:
     void writeDeSync() override;
     void readDeSync() override;
 
+    /**
+     * @brief socketPartialWriteV Write the segments directly into the socket file descriptor (writev)
+     */
+    ssize_t socketPartialWriteV(const Memory::Streams::WriteSegment *segments, const size_t &count);
+    /**
+     * @brief flushCorkBuffer Send the writes held by cork() (eg. before a zero-copy write)
+     * @return false if the held data could not be sent.
+     */
+    bool flushCorkBuffer();
+
 private:
+    size_t readFromReadAheadBuffer(void *data, const size_t &datalen);
+
+    bool corkedWriteV(const Memory::Streams::WriteSegment *segments, const size_t &count);
+    bool sendSegments(const Memory::Streams::WriteSegment *segments, const size_t &count);
+
     size_t mChunkSize = 8192;
+
+    uint32_t m_corkDepth = 0;
+    std::string m_corkBuffer;
+
+    std::vector<char> m_readAheadBuffer;
+    size_t m_readAheadOffset = 0;
+    size_t m_readAheadLength = 0;
 };
 
 typedef std::shared_ptr<Socket_Stream> Socket_Stream_SP;
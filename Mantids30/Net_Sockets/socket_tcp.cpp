@@ -1,5 +1,6 @@
 #include "socket_tcp.h"
 
+#include <limits>
 #include <memory>
 #include <sys/types.h>
 
@@ -16,6 +17,10 @@
 #include <netinet/tcp.h>
 #endif
 
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+
 #include <cerrno>
 #include <cstring>
 #include <unistd.h>
@@ -601,6 +606,62 @@ bool Socket_TCP::isSecure()
 {
     return false;
 }
+
+std::optional<size_t> Socket_TCP::writeFromFileDescriptor(int fd, const uint64_t &offset, const size_t &count)
+{
+#ifdef __linux__
+    // Debugging needs to see the written data, use the regular write path.
+    if (!isActive() || (debugOptions & (Socket::DebugOptions::PRINT_WRITE_HEX | Socket::DebugOptions::PRINT_WRITE_PLAIN)))
+    {
+        return std::nullopt;
+    }
+
+    if (offset > static_cast<uint64_t>(std::numeric_limits<off_t>::max()))
+    {
+        return std::nullopt;
+    }
+
+    // The corked data goes before the file content:
+    if (!flushCorkBuffer())
+    {
+        return 0;
+    }
+
+    off_t fileOffset = static_cast<off_t>(offset);
+    size_t sentBytes = 0;
+
+    while (sentBytes < count)
+    {
+        ssize_t r = sendfile(m_sockFD, fd, &fileOffset, count - sentBytes);
+        if (r < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (r < 0 && sentBytes == 0 && (errno == EINVAL || errno == ENOSYS))
+        {
+            // This file/socket combination can't be used with sendfile.
+            return std::nullopt;
+        }
+        if (r <= 0)
+        {
+            // Error, timeout or the file was truncated while being sent.
+            m_lastError = "sendfile failed";
+            break;
+        }
+        sentBytes += static_cast<size_t>(r);
+    }
+
+    return sentBytes;
+#else
+    return std::nullopt;
+#endif
+}
+
+ssize_t Socket_TCP::partialWriteV(const Memory::Streams::WriteSegment *segments, const size_t &count)
+{
+    return socketPartialWriteV(segments, count);
+}
+
 /*
 bool Socket_TCP::postConnectSubInitialization()
 {
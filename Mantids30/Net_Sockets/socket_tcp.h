@@ -50,6 +50,16 @@ public:
 
     bool isSecure() override;
 
+    /**
+     * @brief writeFromFileDescriptor Send a file region using sendfile (zero-copy, linux only).
+     * @return std::nullopt if not available (eg. write debugging is enabled), or the bytes sent.
+     */
+    std::optional<size_t> writeFromFileDescriptor(int fd, const uint64_t &offset, const size_t &count) override;
+    /**
+     * @brief partialWriteV Write the segments using writev (one system call).
+     */
+    ssize_t partialWriteV(const Memory::Streams::WriteSegment *segments, const size_t &count) override;
+
     int getTcpKeepIdle() const;
     void setTcpKeepIdle(int newTcpKeepIdle);
 
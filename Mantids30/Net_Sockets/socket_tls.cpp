@@ -45,6 +45,8 @@ Socket_TLS::Socket_TLS()
 
 Socket_TLS::~Socket_TLS()
 {
+    stopTLSKeysFileWatch();
+
     if (m_sslHandler)
     {
         SSL_free(m_sslHandler);
@@ -53,6 +55,10 @@ Socket_TLS::~Socket_TLS()
     {
         SSL_CTX_free(m_sslContext);
     }
+    if (m_sharedServerContext)
+    {
+        SSL_CTX_free(m_sharedServerContext);
+    }
 }
 
 void Socket_TLS::prepareTLS()
@@ -90,6 +96,20 @@ bool Socket_TLS::postConnectSubInitialization()
         return false;
     }
 
+    // Initialize TLS client certificates and keys
+    if (!tlsKeys.initTLSContext(m_sslContext, &m_sslErrorList))
+    {
+        parseErrors();
+        return false;
+    }
+
+    if (m_clientSessionCache)
+    {
+        // The new sessions (or TLSv1.3 tickets received after the handshake) are stored in the cache:
+        SSL_CTX_set_session_cache_mode(m_sslContext, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+        SSL_CTX_sess_set_new_cb(m_sslContext, cbNewClientSession);
+    }
+
     if (!(m_sslHandler = SSL_new(m_sslContext)))
     {
         m_sslErrorList.emplace_back("SSL_new failed.");
@@ -99,11 +119,17 @@ bool Socket_TLS::postConnectSubInitialization()
     // If there is any configured PSK, put the key in the static list here...
     bool usingPSK = tlsKeys.linkPSKWithTLSHandle(m_sslHandler);
 
-    // Initialize TLS client certificates and keys
-    if (!tlsKeys.initTLSKeys(m_sslContext, m_sslHandler, &m_sslErrorList))
+    if (m_clientSessionCache)
     {
-        parseErrors();
-        return false;
+        SSL_set_app_data(m_sslHandler, this);
+
+        // Try to resume the previous session with this server:
+        SSL_SESSION *previousSession = m_clientSessionCache->getSession(getClientSessionKey());
+        if (previousSession)
+        {
+            SSL_set_session(m_sslHandler, previousSession);
+            SSL_SESSION_free(previousSession);
+        }
     }
 
     if (!(tlsKeys.getCAPath().empty()) || tlsKeys.getUseSystemCertificates())
@@ -136,6 +162,10 @@ bool Socket_TLS::postConnectSubInitialization()
     if (SSL_get_error(m_sslHandler, SSL_connect(m_sslHandler)) != SSL_ERROR_NONE)
     {
         parseErrors();
+        if (m_clientSessionCache)
+        {
+            m_clientSessionCache->removeSession(getClientSessionKey());
+        }
         return false;
     }
 
@@ -143,7 +173,15 @@ bool Socket_TLS::postConnectSubInitialization()
     {
         // Using PKI, need to validate the certificate.
         // connected+validated!
-        return validateTLSConnection(usingPSK) || m_certValidationOptions == X509ValidationOption::CHECKANDPASS;
+        if (validateTLSConnection(usingPSK) || m_certValidationOptions == X509ValidationOption::CHECKANDPASS)
+        {
+            return true;
+        }
+        if (m_clientSessionCache)
+        {
+            m_clientSessionCache->removeSession(getClientSessionKey());
+        }
+        return false;
     }
     // no validate here...
     else
@@ -161,8 +199,16 @@ bool Socket_TLS::postAcceptSubInitialization()
 
     m_isServer = true;
 
-    if (!createTLSContext())
+    if (m_sslContext)
     {
+        throw std::runtime_error("Can't reuse the TLS socket. Create a new one.");
+    }
+
+    // in server mode, use the context (keys and sessions) shared by the parent...
+    bool verifyPeer = false;
+    if (!(m_sslContext = m_tlsParentConnection->getSharedServerContext(&m_sslErrorList, &verifyPeer)))
+    {
+        parseErrors();
         return false;
     }
 
@@ -183,14 +229,7 @@ bool Socket_TLS::postAcceptSubInitialization()
         tlsKeys.linkPSKWithTLSHandle(m_sslHandler);
     }
 
-    // in server mode, use the parent keys...
-    if (!m_tlsParentConnection->tlsKeys.initTLSKeys(m_sslContext, m_sslHandler, &m_sslErrorList))
-    {
-        parseErrors();
-        return false;
-    }
-
-    if (!m_tlsParentConnection->tlsKeys.getCAPath().empty() || m_tlsParentConnection->tlsKeys.getUseSystemCertificates())
+    if (verifyPeer)
     {
         SSL_set_verify(m_sslHandler, m_certValidationOptions == X509ValidationOption::NOVALIDATE ? SSL_VERIFY_NONE : (SSL_VERIFY_PEER | SSL_VERIFY_FAIL_IF_NO_PEER_CERT) , nullptr);
     }
@@ -227,6 +266,43 @@ bool Socket_TLS::postAcceptSubInitialization()
     }
 }
 
+SSL_CTX *Socket_TLS::getSharedServerContext(std::list<std::string> *keyErrors, bool *verifyPeer)
+{
+    std::unique_lock<std::mutex> lock(m_sharedServerContextMutex);
+
+    if (!m_sharedServerContext)
+    {
+        // Created once (on the first accepted connection), the keys, CA and ciphers are loaded here instead of on every handshake:
+        if (!(m_sharedServerContext = buildServerContext(keyErrors)))
+        {
+            return nullptr;
+        }
+        m_sharedServerContextVerifiesPeer = !tlsKeys.getCAPath().empty() || tlsKeys.getUseSystemCertificates();
+    }
+
+    *verifyPeer = m_sharedServerContextVerifiesPeer;
+    SSL_CTX_up_ref(m_sharedServerContext);
+    return m_sharedServerContext;
+}
+
+SSL_CTX *Socket_TLS::buildServerContext(std::list<std::string> *keyErrors)
+{
+    SSL_CTX *serverContext = createServerSSLContext();
+    if (!serverContext)
+    {
+        keyErrors->emplace_back("TLS_server_method() Failed.");
+        return nullptr;
+    }
+
+    if (!tlsKeys.initTLSContext(serverContext, keyErrors))
+    {
+        SSL_CTX_free(serverContext);
+        return nullptr;
+    }
+
+    return serverContext;
+}
+
 SSL_CTX *Socket_TLS::createServerSSLContext()
 {
 #if TLS_MAX_VERSION == TLS1_VERSION
@@ -467,6 +543,17 @@ bool Socket_TLS::isSecure()
     return true;
 }
 
+bool Socket_TLS::hasBufferedReadData()
+{
+    if (Socket_Stream::hasBufferedReadData())
+    {
+        return true;
+    }
+
+    std::unique_lock<std::mutex> lock(mutexRead);
+    return m_sslHandler != nullptr && SSL_pending(m_sslHandler) > 0;
+}
+
 void Socket_TLS::setServerMode(bool value)
 {
     m_isServer = value;
@@ -539,6 +626,67 @@ ssize_t Socket_TLS::partialWrite(const void *data, const size_t &datalen)
     return iPartialWrite(data, datalen);
 }
 
+ssize_t Socket_TLS::partialWriteV(const Memory::Streams::WriteSegment *segments, const size_t &count)
+{
+    // Not writev: the segments have to be encrypted together, aggregate them in one buffer.
+    return Socket_Stream::partialWriteV(segments, count);
+}
+
+std::optional<size_t> Socket_TLS::writeFromFileDescriptor(int fd, const uint64_t &offset, const size_t &count)
+{
+#if !defined(OPENSSL_NO_KTLS) && OPENSSL_VERSION_NUMBER >= 0x30000000L
+    std::unique_lock<std::mutex> lock(mutexWrite);
+
+    // Only when the TLS records are being encrypted by the kernel (kTLS), otherwise use the regular write path.
+    if (!m_sslHandler || !BIO_get_ktls_send(SSL_get_wbio(m_sslHandler))
+        || (debugOptions & (Socket::DebugOptions::PRINT_WRITE_HEX | Socket::DebugOptions::PRINT_WRITE_PLAIN)))
+    {
+        return std::nullopt;
+    }
+
+    if (offset > static_cast<uint64_t>(std::numeric_limits<off_t>::max()))
+    {
+        return std::nullopt;
+    }
+
+    // The corked data goes before the file content (written through partialWrite, which takes the write lock):
+    lock.unlock();
+    if (!flushCorkBuffer())
+    {
+        return 0;
+    }
+    lock.lock();
+
+    off_t fileOffset = static_cast<off_t>(offset);
+    size_t sentBytes = 0;
+    int ttl = 100;
+
+    while (sentBytes < count)
+    {
+        ossl_ssize_t r = SSL_sendfile(m_sslHandler, fd, fileOffset, count - sentBytes, 0);
+        if (r <= 0)
+        {
+            int sslErr = SSL_get_error(m_sslHandler, static_cast<int>(r));
+            if ((sslErr == SSL_ERROR_WANT_WRITE || sslErr == SSL_ERROR_WANT_READ) && --ttl > 0)
+            {
+                // Wait 10ms... and try again...
+                usleep(10000);
+                continue;
+            }
+            m_lastError = "SSL_sendfile failed";
+            parseErrors();
+            break;
+        }
+        sentBytes += static_cast<size_t>(r);
+        fileOffset += static_cast<off_t>(r);
+    }
+
+    return sentBytes;
+#else
+    return std::nullopt;
+#endif
+}
+
 ssize_t Socket_TLS::iPartialRead(void *data, const size_t &datalen, int ttl)
 {
     if (!m_sslHandler)
@@ -635,6 +783,12 @@ ssize_t Socket_TLS::iPartialRead(void *data, const size_t &datalen, int ttl)
             parseErrors();
             m_lastError = std::string("SSL Layer Error");
 
+            if (sslError == SSL_ERROR_SSL && m_clientSessionCache && !m_isServer)
+            {
+                // Don't resume a session terminated by a fatal error.
+                m_clientSessionCache->removeSession(getClientSessionKey());
+            }
+
             if (debugOptions & Socket::DebugOptions::PRINT_ERRORS)
             {
                 fprintf(debugFP, "--- [TLS ERROR] SSL Layer Error during read\n");
@@ -767,6 +921,12 @@ ssize_t Socket_TLS::iPartialWrite(const void *data, const size_t &datalen, int t
             parseErrors();
             Socket_TCP::iShutdown();
 
+            if (sslErr == SSL_ERROR_SSL && m_clientSessionCache && !m_isServer)
+            {
+                // Don't resume a session terminated by a fatal error.
+                m_clientSessionCache->removeSession(getClientSessionKey());
+            }
+
             // Debug: Print SSL error if enabled
             if (debugOptions & Socket::DebugOptions::PRINT_WRITE_HEX)
             {
@@ -1,14 +1,17 @@
 #pragma once
 
 #include "socket_tcp.h"
+#include <condition_variable>
 #include <list>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <unistd.h>
 
 #include <openssl/err.h>
+#include <openssl/hmac.h>
 #include <openssl/ssl.h>
 
 namespace Mantids30::Network::Sockets {
@@ -168,11 +171,12 @@ public:
         bool linkPSKWithTLSHandle(SSL *sslh);
 
         /**
-         * @brief prepareTLSContext Prepare the TLS context with the loaded keys
-         * @param sslContext TLS context
+         * @brief initTLSContext Prepare the TLS context with the loaded keys and parameters (inherited by every connection created from it)
+         * @param ctx TLS context
+         * @param keyErrors output errors
          * @return true if succeed, false otherwise
          */
-        bool initTLSKeys(SSL_CTX *ctx, SSL *sslh, std::list<std::string> *keyErrors);
+        bool initTLSContext(SSL_CTX *ctx, std::list<std::string> *keyErrors);
         // Private Key From PEM File:
         /**
          * @brief loadPrivateKeyFromPEMFileEP Load Private Key From encrypted PEM File
@@ -385,7 +389,78 @@ public:
         [[nodiscard]] bool getValidateServerHostname() const;
         void setValidateServerHostname(bool newValidateServerHostname);
 
+        /**
+         * @brief getUseKernelTLS Get if the kernel TLS offload (kTLS) is requested
+         * @return true if kTLS is requested
+         */
+        [[nodiscard]] bool getUseKernelTLS() const;
+        /**
+         * @brief setUseKernelTLS Request the kernel TLS offload (kTLS) when OpenSSL and the kernel supports it (default: false),
+         *                        when enabled, the files can be sent with SSL_sendfile (zero-copy)
+         * @param newUseKernelTLS true to request kTLS
+         */
+        void setUseKernelTLS(bool newUseKernelTLS);
+
+        /**
+         * @brief getSessionCacheSize Get the server side TLS session cache size
+         * @return max number of cached sessions (0: disabled)
+         */
+        [[nodiscard]] size_t getSessionCacheSize() const;
+        /**
+         * @brief setSessionCacheSize Set the server side TLS session cache size (default: 20480), resumed sessions skip the key exchange
+         *                            and the certificate validation (abbreviated handshake).
+         * @param newSessionCacheSize max number of cached sessions (0: disabled)
+         */
+        void setSessionCacheSize(size_t newSessionCacheSize);
+        /**
+         * @brief getSessionTimeout Get the TLS session (and session ticket) lifetime
+         * @return lifetime in seconds
+         */
+        [[nodiscard]] uint32_t getSessionTimeout() const;
+        /**
+         * @brief setSessionTimeout Set the TLS session (and session ticket) lifetime (default: 3600 seconds)
+         * @param newSessionTimeout lifetime in seconds
+         */
+        void setSessionTimeout(uint32_t newSessionTimeout);
+        /**
+         * @brief getUseSessionTickets Get if the server issues RFC 5077 session tickets
+         * @return true if the session tickets are enabled
+         */
+        [[nodiscard]] bool getUseSessionTickets() const;
+        /**
+         * @brief setUseSessionTickets Set if the server issues RFC 5077 session tickets (default: true), the ticket keys are generated
+         *                             in memory and rotated every ticket key rotation interval.
+         * @param newUseSessionTickets true to enable the session tickets
+         */
+        void setUseSessionTickets(bool newUseSessionTickets);
+        /**
+         * @brief getTicketKeyRotationInterval Get the session ticket key rotation interval
+         * @return interval in seconds
+         */
+        [[nodiscard]] uint32_t getTicketKeyRotationInterval() const;
+        /**
+         * @brief setTicketKeyRotationInterval Set the session ticket key rotation interval (default: 3600 seconds), tickets encrypted with
+         *                                     the previous key are still accepted (and renewed) during the next interval.
+         * @param newTicketKeyRotationInterval interval in seconds
+         */
+        void setTicketKeyRotationInterval(uint32_t newTicketKeyRotationInterval);
+
     private:
+        friend class Socket_TLS;
+        class TicketKeys;
+
+        /**
+         * @brief initSessionResumption Configure the session cache and the session tickets in the server TLS context
+         */
+        bool initSessionResumption(SSL_CTX *ctx, std::list<std::string> *keyErrors);
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+        static int cbTicketKey(SSL *ssl, unsigned char *keyName, unsigned char *iv, EVP_CIPHER_CTX *cipherCtx, EVP_MAC_CTX *macCtx, int enc);
+#else
+        static int cbTicketKey(SSL *ssl, unsigned char *keyName, unsigned char *iv, EVP_CIPHER_CTX *cipherCtx, HMAC_CTX *macCtx, int enc);
+#endif
+        static void cbFreeTicketKeys(void *parent, void *ptr, CRYPTO_EX_DATA *ad, int idx, long argl, void *argp);
+        static int getTicketKeysIndex();
+
         /**
          * @brief get_dh4096 Get the default configured Diffie Hellman 4096bit parameter
          * @return diffie hellman key.
@@ -438,6 +513,58 @@ public:
 
         bool m_useSystemCertificates = false;
         bool m_validateServerHostname = false;
+        bool m_useKernelTLS = false;
+
+        // Session resumption:
+        size_t m_sessionCacheSize = 20480;
+        uint32_t m_sessionTimeout = 3600;
+        bool m_useSessionTickets = true;
+        uint32_t m_ticketKeyRotationInterval = 3600;
+        // Kept between the server contexts of the same listener (the sessions and tickets survive the keys reload):
+        std::shared_ptr<TicketKeys> m_ticketKeys;
+        std::string m_sessionIdContext;
+    };
+
+    /**
+     * @brief The ClientSessionCache class keeps the TLS sessions negotiated by the clients (by remote host and port), so the next
+     *        connection to the same server can be resumed (abbreviated handshake).
+     *
+     * Share the same cache only between sockets that use the same credentials (the resumed session keeps the original authentication).
+     */
+    class ClientSessionCache
+    {
+    public:
+        /**
+         * @brief ClientSessionCache Create the cache
+         * @param maxSessions max number of cached servers
+         */
+        ClientSessionCache(size_t maxSessions = 64);
+        ~ClientSessionCache();
+
+        ClientSessionCache(const ClientSessionCache &) = delete;
+        ClientSessionCache &operator=(const ClientSessionCache &) = delete;
+
+        /**
+         * @brief getSession Get the cached session for the server
+         * @param serverKey server key (host:port)
+         * @return session copy (to be released with SSL_SESSION_free) or nullptr if there is no resumable session.
+         */
+        SSL_SESSION *getSession(const std::string &serverKey);
+        /**
+         * @brief setSession Replace the cached session for the server
+         * @param serverKey server key (host:port)
+         * @param session session (the cache takes the ownership)
+         */
+        void setSession(const std::string &serverKey, SSL_SESSION *session);
+        /**
+         * @brief removeSession Remove the cached session for the server (eg. the server rejected the connection)
+         */
+        void removeSession(const std::string &serverKey);
+
+    private:
+        std::map<std::string, SSL_SESSION *> m_sessionsByServer;
+        size_t m_maxSessions;
+        std::mutex m_mutex;
     };
 
     TLSKeyParameters tlsKeys;
@@ -487,6 +614,15 @@ public:
      * @return return the number of bytes read by the socket, zero for end of file and -1 for error.
      */
     ssize_t partialWrite(const void *data, const size_t &datalen) override;
+    /**
+     * @brief partialWriteV Write the segments aggregated in one SSL_write (one TLS record) instead of writev.
+     */
+    ssize_t partialWriteV(const Memory::Streams::WriteSegment *segments, const size_t &count) override;
+    /**
+     * @brief writeFromFileDescriptor Send a file region using SSL_sendfile (only when the kernel TLS offload is active on this connection)
+     * @return std::nullopt if kTLS is not active, or the bytes sent.
+     */
+    std::optional<size_t> writeFromFileDescriptor(int fd, const uint64_t &offset, const size_t &count) override;
 
     /////////////////////////
     // SSL functions:
@@ -511,6 +647,49 @@ public:
      * @param newTLSCipherList cipher list to configure before establishing the connection
      */
     void setTLSCipherList(const std::string &newTLSCipherList);
+    /**
+     * @brief setClientSessionCache Set the cache used to resume the client TLS sessions (eg. shared between the reconnections to the same server)
+     * @param newClientSessionCache session cache (nullptr: don't resume)
+     */
+    void setClientSessionCache(const std::shared_ptr<ClientSessionCache> &newClientSessionCache);
+
+    // Listening socket keys reload:
+    /**
+     * @brief reloadServerTLSKeys Replace the certificate/private key and/or the CA of this listening socket without closing it. A new shared TLS
+     *                            context is built and swapped atomically, the connections in progress keep the previous one.
+     * @param newKeys key parameters with the new keys loaded (eg. with loadPublicKeyFromPEMFile/loadPrivateKeyFromPEMFile/loadCAFromPEMFile),
+     *                only the loaded certificate/key pair and CA are taken (the previous ones are moved to newKeys).
+     * @param keyErrors output errors
+     * @return true if the new context is active, false otherwise (the previous keys and context remain active)
+     */
+    bool reloadServerTLSKeys(TLSKeyParameters &newKeys, std::list<std::string> *keyErrors);
+    /**
+     * @brief reloadServerTLSKeysFromPEMFiles Replace the certificate/private key (and CA) of this listening socket from PEM files (see reloadServerTLSKeys)
+     * @param certPath certificate file path
+     * @param keyPath private key file path
+     * @param caPath certificate authority file path (empty: keep the current one)
+     * @param keyErrors output errors
+     * @return true if the new context is active
+     */
+    bool reloadServerTLSKeysFromPEMFiles(const std::string &certPath, const std::string &keyPath, const std::string &caPath, std::list<std::string> *keyErrors);
+    /**
+     * @brief startTLSKeysFileWatch Watch the PEM files (modification time and size) and reload the keys when they change
+     * @param certPath certificate file path
+     * @param keyPath private key file path
+     * @param caPath certificate authority file path (empty: keep the current one)
+     * @param intervalInSeconds seconds between checks
+     * @return false if the watch was already started
+     */
+    bool startTLSKeysFileWatch(const std::string &certPath, const std::string &keyPath, const std::string &caPath = "", uint32_t intervalInSeconds = 30);
+    /**
+     * @brief stopTLSKeysFileWatch Stop the PEM files watch (called on destruction)
+     */
+    void stopTLSKeysFileWatch();
+    /**
+     * @brief getTLSKeysReloadErrorsAndClear Get the errors of the reloads triggered by the file watch
+     * @return List of errors.
+     */
+    std::list<std::string> getTLSKeysReloadErrorsAndClear();
 
     // Getters:
     /**
@@ -528,6 +707,11 @@ public:
      * @return cipher version string
      */
     std::string getTLSConnectionProtocolVersion();
+    /**
+     * @brief isTLSSessionReused Get if the current connection was resumed from a previous session (abbreviated handshake)
+     * @return true if the session was reused
+     */
+    bool isTLSSessionReused();
     /**
      * @brief getTLSAcceptInvalidServerCerts Get if accept invalid server certificates
      * @return true if accept (default false)
@@ -575,12 +759,24 @@ public:
     // Socket Overrides:
     int iShutdown(int mode) override;
     bool isSecure() override;
+    bool hasBufferedReadData() override;
 
 protected:
     ssize_t iPartialRead(void *data, const size_t &datalen, int ttl = 100);
     ssize_t iPartialWrite(const void *data, const size_t &datalen, int ttl = 100);
 
     bool createTLSContext();
+    /**
+     * @brief getSharedServerContext Get the TLS context shared by all the connections accepted by this listening socket (created
+     *                               and configured on the first call)
+     * @param keyErrors output errors
+     * @param verifyPeer output: true if the connections should verify the peer certificate (there is a CA configured)
+     * @return TLS context with a new reference (to be released with SSL_CTX_free) or nullptr on error
+     */
+    SSL_CTX *getSharedServerContext(std::list<std::string> *keyErrors, bool *verifyPeer);
+    SSL_CTX *buildServerContext(std::list<std::string> *keyErrors);
+    static int cbNewClientSession(SSL *ssl, SSL_SESSION *session);
+    std::string getClientSessionKey() const;
     void parseErrors();
     bool validateTLSConnection(const bool &usingPSK);
 
@@ -589,6 +785,19 @@ protected:
     X509ValidationOption m_certValidationOptions = X509ValidationOption::VALIDATE;
     SSL *m_sslHandler = nullptr;
     SSL_CTX *m_sslContext = nullptr;
+    // Listening sockets: context shared by the accepted connections.
+    SSL_CTX *m_sharedServerContext = nullptr;
+    bool m_sharedServerContextVerifiesPeer = false;
+    std::mutex m_sharedServerContextMutex;
+
+    // Listening sockets: PEM files watch.
+    void keysFileWatchLoop(std::string certPath, std::string keyPath, std::string caPath, uint32_t intervalInSeconds);
+    std::thread m_keysFileWatchThread;
+    std::condition_variable m_keysFileWatchCond;
+    std::mutex m_keysFileWatchMutex;
+    bool m_keysFileWatchStop = false;
+    std::list<std::string> m_keysReloadErrors;
+    std::shared_ptr<ClientSessionCache> m_clientSessionCache;
     SSL_CTX *createServerSSLContext();
     SSL_CTX *createClientSSLContext();
 
@@ -0,0 +1,199 @@
+#include "socket_tls.h"
+
+#include <chrono>
+#include <sys/stat.h>
+#include <utility>
+
+using namespace std;
+using namespace Mantids30::Network::Sockets;
+
+namespace {
+struct PEMFileState
+{
+    bool exists = false;
+    off_t fileSize = 0;
+    struct timespec modificationTime = {};
+
+    bool operator==(const PEMFileState &other) const
+    {
+        return exists == other.exists && fileSize == other.fileSize && modificationTime.tv_sec == other.modificationTime.tv_sec
+               && modificationTime.tv_nsec == other.modificationTime.tv_nsec;
+    }
+};
+
+PEMFileState getPEMFileState(const std::string &path)
+{
+    PEMFileState state;
+    struct stat fileStats;
+    if (!path.empty() && stat(path.c_str(), &fileStats) == 0)
+    {
+        state.exists = true;
+        state.fileSize = fileStats.st_size;
+#ifdef _WIN32
+        state.modificationTime.tv_sec = fileStats.st_mtime;
+#else
+        state.modificationTime = fileStats.st_mtim;
+#endif
+    }
+    return state;
+}
+} // namespace
+
+bool Socket_TLS::reloadServerTLSKeys(TLSKeyParameters &newKeys, std::list<std::string> *keyErrors)
+{
+    bool replaceKeyPair = newKeys.m_publicKey || newKeys.m_privateKey;
+    bool replaceCA = !newKeys.m_TLSCertificateAuthorityPath.empty();
+
+    if (!replaceKeyPair && !replaceCA)
+    {
+        keyErrors->emplace_back("There are no TLS keys to reload.");
+        return false;
+    }
+
+    if (replaceKeyPair && (!newKeys.m_publicKey || !newKeys.m_privateKey || X509_check_private_key(newKeys.m_publicKey, newKeys.m_privateKey) != 1))
+    {
+        ERR_clear_error();
+        keyErrors->emplace_back("The new X.509 certificate does not match the private key.");
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(m_sharedServerContextMutex);
+
+    // Move the new keys in (and the current ones out, to restore them on failure):
+    if (replaceKeyPair)
+    {
+        std::swap(tlsKeys.m_publicKey, newKeys.m_publicKey);
+        std::swap(tlsKeys.m_privateKey, newKeys.m_privateKey);
+    }
+    if (replaceCA)
+    {
+        std::swap(tlsKeys.m_TLSCertificateAuthorityPath, newKeys.m_TLSCertificateAuthorityPath);
+        std::swap(tlsKeys.m_TLSCertificateAuthorityMemory, newKeys.m_TLSCertificateAuthorityMemory);
+    }
+
+    // The sessions authenticated with the previous CA can't be resumed:
+    std::string previousSessionIdContext = tlsKeys.m_sessionIdContext;
+    if (replaceCA)
+    {
+        tlsKeys.m_sessionIdContext.clear();
+    }
+
+    SSL_CTX *newContext = buildServerContext(keyErrors);
+    if (!newContext)
+    {
+        // Restore the previous keys:
+        if (replaceKeyPair)
+        {
+            std::swap(tlsKeys.m_publicKey, newKeys.m_publicKey);
+            std::swap(tlsKeys.m_privateKey, newKeys.m_privateKey);
+        }
+        if (replaceCA)
+        {
+            std::swap(tlsKeys.m_TLSCertificateAuthorityPath, newKeys.m_TLSCertificateAuthorityPath);
+            std::swap(tlsKeys.m_TLSCertificateAuthorityMemory, newKeys.m_TLSCertificateAuthorityMemory);
+        }
+        tlsKeys.m_sessionIdContext = previousSessionIdContext;
+        ERR_clear_error();
+        return false;
+    }
+
+    // Swap the context, the handshakes in progress hold a reference to the previous one:
+    SSL_CTX *previousContext = m_sharedServerContext;
+    m_sharedServerContext = newContext;
+    m_sharedServerContextVerifiesPeer = !tlsKeys.getCAPath().empty() || tlsKeys.getUseSystemCertificates();
+    if (previousContext)
+    {
+        SSL_CTX_free(previousContext);
+    }
+
+    return true;
+}
+
+bool Socket_TLS::reloadServerTLSKeysFromPEMFiles(const std::string &certPath, const std::string &keyPath, const std::string &caPath, std::list<std::string> *keyErrors)
+{
+    bool isServerKey = true;
+    TLSKeyParameters newKeys(&isServerKey);
+
+    if (!newKeys.loadPublicKeyFromPEMFile(certPath.c_str()))
+    {
+        keyErrors->emplace_back("Bad TLS Public Key: " + certPath);
+        return false;
+    }
+    if (!newKeys.loadPrivateKeyFromPEMFile(keyPath.c_str()))
+    {
+        keyErrors->emplace_back("Bad TLS Private Key: " + keyPath);
+        return false;
+    }
+    if (!caPath.empty() && !newKeys.loadCAFromPEMFile(caPath))
+    {
+        keyErrors->emplace_back("Bad TLS Certificate Authority: " + caPath);
+        return false;
+    }
+
+    return reloadServerTLSKeys(newKeys, keyErrors);
+}
+
+bool Socket_TLS::startTLSKeysFileWatch(const std::string &certPath, const std::string &keyPath, const std::string &caPath, uint32_t intervalInSeconds)
+{
+    std::unique_lock<std::mutex> lock(m_keysFileWatchMutex);
+    if (m_keysFileWatchThread.joinable())
+    {
+        return false;
+    }
+
+    m_keysFileWatchStop = false;
+    m_keysFileWatchThread = std::thread(&Socket_TLS::keysFileWatchLoop, this, certPath, keyPath, caPath, intervalInSeconds == 0 ? 1 : intervalInSeconds);
+    return true;
+}
+
+void Socket_TLS::stopTLSKeysFileWatch()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_keysFileWatchMutex);
+        m_keysFileWatchStop = true;
+    }
+    m_keysFileWatchCond.notify_all();
+
+    if (m_keysFileWatchThread.joinable())
+    {
+        m_keysFileWatchThread.join();
+    }
+}
+
+std::list<std::string> Socket_TLS::getTLSKeysReloadErrorsAndClear()
+{
+    std::unique_lock<std::mutex> lock(m_keysFileWatchMutex);
+    std::list<std::string> r = m_keysReloadErrors;
+    m_keysReloadErrors.clear();
+    return r;
+}
+
+void Socket_TLS::keysFileWatchLoop(std::string certPath, std::string keyPath, std::string caPath, uint32_t intervalInSeconds)
+{
+    PEMFileState certState = getPEMFileState(certPath), keyState = getPEMFileState(keyPath), caState = getPEMFileState(caPath);
+
+    std::unique_lock<std::mutex> lock(m_keysFileWatchMutex);
+    while (!m_keysFileWatchCond.wait_for(lock, std::chrono::seconds(intervalInSeconds), [this] { return m_keysFileWatchStop; }))
+    {
+        PEMFileState newCertState = getPEMFileState(certPath), newKeyState = getPEMFileState(keyPath), newCAState = getPEMFileState(caPath);
+        if (newCertState == certState && newKeyState == keyState && newCAState == caState)
+        {
+            continue;
+        }
+
+        // Files changed, reload (a partially written pair fails and will be retried on the next change):
+        certState = newCertState;
+        keyState = newKeyState;
+        caState = newCAState;
+
+        lock.unlock();
+        std::list<std::string> keyErrors;
+        bool reloaded = reloadServerTLSKeysFromPEMFiles(certPath, keyPath, caPath, &keyErrors);
+        lock.lock();
+
+        if (!reloaded)
+        {
+            m_keysReloadErrors.insert(m_keysReloadErrors.end(), keyErrors.begin(), keyErrors.end());
+        }
+    }
+}
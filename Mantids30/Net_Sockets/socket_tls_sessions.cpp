@@ -0,0 +1,347 @@
+#include "socket_tls.h"
+
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <openssl/rand.h>
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/core_names.h>
+#include <openssl/params.h>
+#endif
+
+using namespace std;
+using namespace Mantids30::Network::Sockets;
+
+/**
+ * @brief The TicketKeys class keeps the in-memory session ticket keys of a server TLS context (the current one encrypts the new
+ *        tickets, the previous one only decrypts the tickets issued before the last rotation).
+ */
+class Socket_TLS::TLSKeyParameters::TicketKeys
+{
+public:
+    struct Key
+    {
+        unsigned char name[16];
+        unsigned char aesKey[32];
+        unsigned char hmacKey[32];
+        time_t creationTime;
+    };
+
+    TicketKeys(uint32_t rotationInterval)
+        : m_rotationInterval(rotationInterval == 0 ? 1 : rotationInterval)
+    {}
+
+    ~TicketKeys()
+    {
+        for (Key &key : m_keys)
+        {
+            OPENSSL_cleanse(&key, sizeof(Key));
+        }
+    }
+
+    bool getEncryptionKey(Key *key)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!rotateIfNeeded())
+        {
+            return false;
+        }
+        *key = m_keys.front();
+        return true;
+    }
+
+    bool getDecryptionKey(const unsigned char *keyName, Key *key, bool *renewTicket)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!rotateIfNeeded())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < m_keys.size(); i++)
+        {
+            if (memcmp(m_keys[i].name, keyName, sizeof(Key::name)) == 0)
+            {
+                *key = m_keys[i];
+                // Tickets encrypted with the previous key are renewed with the current one:
+                *renewTicket = (i != 0);
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    bool rotateIfNeeded()
+    {
+        time_t now = time(nullptr);
+        if (m_keys.empty() || now - m_keys.front().creationTime >= static_cast<time_t>(m_rotationInterval) || now < m_keys.front().creationTime)
+        {
+            Key newKey;
+            if (RAND_bytes(newKey.name, sizeof(newKey.name)) != 1 || RAND_bytes(newKey.aesKey, sizeof(newKey.aesKey)) != 1
+                || RAND_bytes(newKey.hmacKey, sizeof(newKey.hmacKey)) != 1)
+            {
+                OPENSSL_cleanse(&newKey, sizeof(Key));
+                return !m_keys.empty();
+            }
+            newKey.creationTime = now;
+            m_keys.push_front(newKey);
+            OPENSSL_cleanse(&newKey, sizeof(Key));
+        }
+
+        // Keep only the current and the previous key:
+        while (m_keys.size() > 2)
+        {
+            OPENSSL_cleanse(&m_keys.back(), sizeof(Key));
+            m_keys.pop_back();
+        }
+        return true;
+    }
+
+    std::deque<Key> m_keys;
+    uint32_t m_rotationInterval;
+    std::mutex m_mutex;
+};
+
+int Socket_TLS::TLSKeyParameters::getTicketKeysIndex()
+{
+    static const int ticketKeysIndex = SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, cbFreeTicketKeys);
+    return ticketKeysIndex;
+}
+
+void Socket_TLS::TLSKeyParameters::cbFreeTicketKeys(void *, void *ptr, CRYPTO_EX_DATA *, int, long, void *)
+{
+    delete static_cast<std::shared_ptr<TicketKeys> *>(ptr);
+}
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+int Socket_TLS::TLSKeyParameters::cbTicketKey(SSL *ssl, unsigned char *keyName, unsigned char *iv, EVP_CIPHER_CTX *cipherCtx, EVP_MAC_CTX *macCtx, int enc)
+#else
+int Socket_TLS::TLSKeyParameters::cbTicketKey(SSL *ssl, unsigned char *keyName, unsigned char *iv, EVP_CIPHER_CTX *cipherCtx, HMAC_CTX *macCtx, int enc)
+#endif
+{
+    std::shared_ptr<TicketKeys> *ticketKeysRef = static_cast<std::shared_ptr<TicketKeys> *>(SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), getTicketKeysIndex()));
+    if (!ticketKeysRef || !*ticketKeysRef)
+    {
+        return -1;
+    }
+    TicketKeys *ticketKeys = ticketKeysRef->get();
+
+    TicketKeys::Key key;
+    bool renewTicket = false;
+    int r = 1;
+
+    if (enc)
+    {
+        // New ticket:
+        if (!ticketKeys->getEncryptionKey(&key))
+        {
+            return -1;
+        }
+        if (RAND_bytes(iv, EVP_CIPHER_iv_length(EVP_aes_256_cbc())) != 1 || EVP_EncryptInit_ex(cipherCtx, EVP_aes_256_cbc(), nullptr, key.aesKey, iv) != 1)
+        {
+            r = -1;
+        }
+        memcpy(keyName, key.name, sizeof(key.name));
+    }
+    else
+    {
+        // Received ticket:
+        if (!ticketKeys->getDecryptionKey(keyName, &key, &renewTicket))
+        {
+            // Unknown/expired key, do the full handshake.
+            return 0;
+        }
+        if (EVP_DecryptInit_ex(cipherCtx, EVP_aes_256_cbc(), nullptr, key.aesKey, iv) != 1)
+        {
+            r = -1;
+        }
+        else if (renewTicket)
+        {
+            r = 2;
+        }
+    }
+
+    if (r != -1)
+    {
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+        OSSL_PARAM params[3];
+        params[0] = OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY, key.hmacKey, sizeof(key.hmacKey));
+        params[1] = OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, const_cast<char *>("SHA256"), 0);
+        params[2] = OSSL_PARAM_construct_end();
+        if (EVP_MAC_CTX_set_params(macCtx, params) != 1)
+        {
+            r = -1;
+        }
+#else
+        if (HMAC_Init_ex(macCtx, key.hmacKey, sizeof(key.hmacKey), EVP_sha256(), nullptr) != 1)
+        {
+            r = -1;
+        }
+#endif
+    }
+
+    OPENSSL_cleanse(&key, sizeof(key));
+    return r;
+}
+
+bool Socket_TLS::TLSKeyParameters::initSessionResumption(SSL_CTX *ctx, std::list<std::string> *keyErrors)
+{
+    // Session ID context (the sessions are only resumed in contexts with the same ID, required when the client certificate is verified)
+    if (m_sessionIdContext.empty())
+    {
+        unsigned char sessionIdContext[SSL_MAX_SID_CTX_LENGTH];
+        if (RAND_bytes(sessionIdContext, sizeof(sessionIdContext)) != 1)
+        {
+            keyErrors->emplace_back("RAND_bytes Failed for the session ID context.");
+            return false;
+        }
+        m_sessionIdContext.assign(reinterpret_cast<char *>(sessionIdContext), sizeof(sessionIdContext));
+    }
+    if (SSL_CTX_set_session_id_context(ctx, reinterpret_cast<const unsigned char *>(m_sessionIdContext.data()), static_cast<unsigned int>(m_sessionIdContext.size())) != 1)
+    {
+        keyErrors->emplace_back("SSL_CTX_set_session_id_context Failed.");
+        return false;
+    }
+
+    SSL_CTX_set_timeout(ctx, static_cast<long>(m_sessionTimeout));
+
+    if (m_sessionCacheSize > 0)
+    {
+        SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_SERVER);
+        SSL_CTX_sess_set_cache_size(ctx, static_cast<long>(m_sessionCacheSize));
+    }
+    else
+    {
+        SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF);
+    }
+
+    if (!m_useSessionTickets)
+    {
+        SSL_CTX_set_options(ctx, SSL_OP_NO_TICKET);
+        return true;
+    }
+
+    if (!m_ticketKeys)
+    {
+        m_ticketKeys = std::make_shared<TicketKeys>(m_ticketKeyRotationInterval);
+    }
+
+    // Each context keeps a reference to the ticket keys (released with the context):
+    std::shared_ptr<TicketKeys> *ticketKeys = new std::shared_ptr<TicketKeys>(m_ticketKeys);
+    if (SSL_CTX_set_ex_data(ctx, getTicketKeysIndex(), ticketKeys) != 1)
+    {
+        delete ticketKeys;
+        keyErrors->emplace_back("SSL_CTX_set_ex_data Failed for the session ticket keys.");
+        return false;
+    }
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    SSL_CTX_set_tlsext_ticket_key_evp_cb(ctx, cbTicketKey);
+#else
+    SSL_CTX_set_tlsext_ticket_key_cb(ctx, cbTicketKey);
+#endif
+    SSL_CTX_clear_options(ctx, SSL_OP_NO_TICKET);
+    return true;
+}
+
+Socket_TLS::ClientSessionCache::ClientSessionCache(size_t maxSessions)
+    : m_maxSessions(maxSessions == 0 ? 1 : maxSessions)
+{}
+
+Socket_TLS::ClientSessionCache::~ClientSessionCache()
+{
+    for (auto &i : m_sessionsByServer)
+    {
+        SSL_SESSION_free(i.second);
+    }
+}
+
+SSL_SESSION *Socket_TLS::ClientSessionCache::getSession(const std::string &serverKey)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = m_sessionsByServer.find(serverKey);
+    if (it == m_sessionsByServer.end())
+    {
+        return nullptr;
+    }
+
+    SSL_SESSION *session = it->second;
+    long sessionExpiration = SSL_SESSION_get_time(session) + SSL_SESSION_get_timeout(session);
+    if (!SSL_SESSION_is_resumable(session) || sessionExpiration <= static_cast<long>(time(nullptr)))
+    {
+        SSL_SESSION_free(session);
+        m_sessionsByServer.erase(it);
+        return nullptr;
+    }
+
+    // Return a copy (the cached session is never attached to a connection, so it stays resumable).
+    return SSL_SESSION_dup(session);
+}
+
+void Socket_TLS::ClientSessionCache::setSession(const std::string &serverKey, SSL_SESSION *session)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = m_sessionsByServer.find(serverKey);
+    if (it != m_sessionsByServer.end())
+    {
+        SSL_SESSION_free(it->second);
+        it->second = session;
+        return;
+    }
+
+    if (m_sessionsByServer.size() >= m_maxSessions)
+    {
+        SSL_SESSION_free(m_sessionsByServer.begin()->second);
+        m_sessionsByServer.erase(m_sessionsByServer.begin());
+    }
+    m_sessionsByServer[serverKey] = session;
+}
+
+void Socket_TLS::ClientSessionCache::removeSession(const std::string &serverKey)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = m_sessionsByServer.find(serverKey);
+    if (it != m_sessionsByServer.end())
+    {
+        SSL_SESSION_free(it->second);
+        m_sessionsByServer.erase(it);
+    }
+}
+
+int Socket_TLS::cbNewClientSession(SSL *ssl, SSL_SESSION *session)
+{
+    Socket_TLS *tlsSocket = static_cast<Socket_TLS *>(SSL_get_app_data(ssl));
+    if (!tlsSocket || !tlsSocket->m_clientSessionCache || !SSL_SESSION_is_resumable(session))
+    {
+        return 0;
+    }
+
+    // Cache a copy: OpenSSL marks the session as not resumable when the connection is released without the TLS shutdown (eg. the
+    // peer closed the TCP connection), the fatal TLS errors remove the cached session instead.
+    SSL_SESSION *sessionCopy = SSL_SESSION_dup(session);
+    if (sessionCopy)
+    {
+        tlsSocket->m_clientSessionCache->setSession(tlsSocket->getClientSessionKey(), sessionCopy);
+    }
+    return 0;
+}
+
+std::string Socket_TLS::getClientSessionKey() const
+{
+    return m_remoteServerHostname + ":" + std::to_string(m_remotePort);
+}
+
+void Socket_TLS::setClientSessionCache(const std::shared_ptr<ClientSessionCache> &newClientSessionCache)
+{
+    m_clientSessionCache = newClientSessionCache;
+}
+
+bool Socket_TLS::isTLSSessionReused()
+{
+    if (!m_sslHandler)
+    {
+        return false;
+    }
+    return SSL_session_reused(m_sslHandler) == 1;
+}
@@ -95,50 +95,58 @@ bool Socket_TLS::TLSKeyParameters::linkPSKWithTLSHandle(SSL *_sslh)
         } \
     }
 
-bool Socket_TLS::TLSKeyParameters::initTLSKeys(SSL_CTX *ctx, SSL *sslh, std::list<std::string> *keyErrors)
+bool Socket_TLS::TLSKeyParameters::initTLSContext(SSL_CTX *ctx, std::list<std::string> *keyErrors)
 {
 #if OPENSSL_VERSION_NUMBER >= 0x1010000fL
     if (m_securityLevel != -1)
     {
-        SSL_set_security_level(sslh, m_securityLevel);
+        SSL_CTX_set_security_level(ctx, m_securityLevel);
     }
     if (m_maxProtocolVersion != -1)
     {
-        SSL_set_max_proto_version(sslh, m_maxProtocolVersion);
+        SSL_CTX_set_max_proto_version(ctx, m_maxProtocolVersion);
     }
     if (m_minProtocolVersion != -1)
     {
-        SSL_set_min_proto_version(sslh, m_minProtocolVersion);
+        SSL_CTX_set_min_proto_version(ctx, m_minProtocolVersion);
     }
 
-    SSL_clear_options(sslh, SSL_OP_PRIORITIZE_CHACHA);
-    SSL_clear_options(sslh, SSL_OP_ALLOW_NO_DHE_KEX);
+    SSL_CTX_clear_options(ctx, SSL_OP_PRIORITIZE_CHACHA);
+    SSL_CTX_clear_options(ctx, SSL_OP_ALLOW_NO_DHE_KEX);
 
 #else
     if (minProtocolVersion >= TLS1_VERSION)
-        SSL_set_options(sslh, SSL_OP_NO_SSLv3);
+        SSL_CTX_set_options(ctx, SSL_OP_NO_SSLv3);
 
     if (minProtocolVersion >= TLS1_1_VERSION)
-        SSL_set_options(sslh, SSL_OP_NO_TLSv1);
+        SSL_CTX_set_options(ctx, SSL_OP_NO_TLSv1);
 
     if (minProtocolVersion >= TLS1_2_VERSION)
-        SSL_set_options(sslh, SSL_OP_NO_TLSv1_1);
+        SSL_CTX_set_options(ctx, SSL_OP_NO_TLSv1_1);
 
     if (maxProtocolVersion < TLS1_2_VERSION)
-        SSL_set_options(sslh, SSL_OP_NO_TLSv1_2);
+        SSL_CTX_set_options(ctx, SSL_OP_NO_TLSv1_2);
 
     if (maxProtocolVersion < TLS1_1_VERSION)
-        SSL_set_options(sslh, SSL_OP_NO_TLSv1_1);
+        SSL_CTX_set_options(ctx, SSL_OP_NO_TLSv1_1);
 
     if (maxProtocolVersion < TLS1_VERSION)
-        SSL_set_options(sslh, SSL_OP_NO_TLSv1);
+        SSL_CTX_set_options(ctx, SSL_OP_NO_TLSv1);
 #endif
 
     if (!*m_isServer)
     {
-        SSL_set_options(sslh, SSL_OP_CIPHER_SERVER_PREFERENCE);
+        SSL_CTX_set_options(ctx, SSL_OP_CIPHER_SERVER_PREFERENCE);
     }
 
+#ifdef SSL_OP_ENABLE_KTLS
+    if (m_useKernelTLS)
+    {
+        // OpenSSL falls back to the userspace TLS if the kernel or the negotiated cipher can't be offloaded.
+        SSL_CTX_set_options(ctx, SSL_OP_ENABLE_KTLS);
+    }
+#endif
+
     // Validate:
     if (m_publicKey && !m_privateKey)
     {
@@ -159,10 +167,10 @@ bool Socket_TLS::TLSKeyParameters::initTLSKeys(SSL_CTX *ctx, SSL *sslh, std::lis
         if (list != nullptr)
         {
             // It takes ownership. (list now belongs to sslContext, no need to free)
-            SSL_set_client_CA_list(sslh, list);
+            SSL_CTX_set_client_CA_list(ctx, list);
             if (m_maxVerifyDepth >= 0 - 1)
             {
-                SSL_set_verify_depth(sslh, m_maxVerifyDepth);
+                SSL_CTX_set_verify_depth(ctx, m_maxVerifyDepth);
             }
         }
         // TODO: warn if the list is zero.
@@ -174,18 +182,18 @@ bool Socket_TLS::TLSKeyParameters::initTLSKeys(SSL_CTX *ctx, SSL *sslh, std::lis
     }
 
     // Setup Diffie-Hellman
-    ERR_ON_ZERO(m_dhParameter && SSL_set_tmp_dh(sslh, m_dhParameter), "SSL_set_tmp_dh Failed for you temporary DH key.");
+    ERR_ON_ZERO(m_dhParameter && SSL_CTX_set_tmp_dh(ctx, m_dhParameter), "SSL_CTX_set_tmp_dh Failed for you temporary DH key.");
 
-    //SSL_set_dh_auto(sslh,1);
-    SSL_set_ecdh_auto(sslh, 1);
+    //SSL_CTX_set_dh_auto(ctx,1);
+    SSL_CTX_set_ecdh_auto(ctx, 1);
 
     // TLSv1.3 parameters:
 #if OPENSSL_VERSION_NUMBER >= 0x1010000fL
-    ERR_ON_ZERO(!m_TLSSharedGroups.empty() && SSL_set1_groups_list(sslh, m_TLSSharedGroups.c_str()), "SSL_set1_groups_list Failed for your shared groups.");
-    ERR_ON_ZERO(!m_TLSCipherSuites.empty() && SSL_set_ciphersuites(sslh, m_TLSCipherSuites.c_str()), "SSL_set_ciphersuites Failed for your cipher suites.");
+    ERR_ON_ZERO(!m_TLSSharedGroups.empty() && SSL_CTX_set1_groups_list(ctx, m_TLSSharedGroups.c_str()), "SSL_CTX_set1_groups_list Failed for your shared groups.");
+    ERR_ON_ZERO(!m_TLSCipherSuites.empty() && SSL_CTX_set_ciphersuites(ctx, m_TLSCipherSuites.c_str()), "SSL_CTX_set_ciphersuites Failed for your cipher suites.");
 #endif
     // TLSv1.2 Cipher List
-    ERR_ON_ZERO(!m_TLSCipherList.empty() && SSL_set_cipher_list(sslh, m_TLSCipherList.c_str()), "SSL_set_cipher_list Failed for your cipher list.");
+    ERR_ON_ZERO(!m_TLSCipherList.empty() && SSL_CTX_set_cipher_list(ctx, m_TLSCipherList.c_str()), "SSL_CTX_set_cipher_list Failed for your cipher list.");
 
     bool usingPSK = (m_pskClientValues.isUsingPSK || m_pskServerWallet.isUsingPSK);
 
@@ -195,8 +203,13 @@ bool Socket_TLS::TLSKeyParameters::initTLSKeys(SSL_CTX *ctx, SSL *sslh, std::lis
         // Setup CRT/KEY for file:
         if (m_publicKey || m_privateKey)
         {
-            ERR_ON_ZERO(m_publicKey && SSL_use_certificate(sslh, m_publicKey), "SSL_use_certificate Failed for local Certificate.");
-            ERR_ON_ZERO(m_privateKey && SSL_use_PrivateKey(sslh, m_privateKey), "SSL_use_PrivateKey Failed for private key.");
+            ERR_ON_ZERO(m_publicKey && SSL_CTX_use_certificate(ctx, m_publicKey), "SSL_CTX_use_certificate Failed for local Certificate.");
+            ERR_ON_ZERO(m_privateKey && SSL_CTX_use_PrivateKey(ctx, m_privateKey), "SSL_CTX_use_PrivateKey Failed for private key.");
+        }
+
+        if (*m_isServer && !initSessionResumption(ctx, keyErrors))
+        {
+            return false;
         }
     }
     else
@@ -204,11 +217,14 @@ bool Socket_TLS::TLSKeyParameters::initTLSKeys(SSL_CTX *ctx, SSL *sslh, std::lis
         // PSK Mode.
         if (!*m_isServer)
         { // Client identity is set up in the callback:
-            SSL_set_psk_client_callback(sslh, cbPSKClient);
+            SSL_CTX_set_psk_client_callback(ctx, cbPSKClient);
         }
         else
         { // Server receives the identity from client:
-            SSL_set_psk_server_callback(sslh, cbPSKServer);
+            SSL_CTX_set_psk_server_callback(ctx, cbPSKServer);
+            // The PSK identity is resolved per connection with the wallet (the resumption would skip it).
+            SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF);
+            SSL_CTX_set_options(ctx, SSL_OP_NO_TICKET);
         }
     }
 
@@ -563,3 +579,53 @@ void Socket_TLS::TLSKeyParameters::setSTLSCipherSuites(const std::string &newSTL
 {
     m_TLSCipherSuites = newSTLSCipherSuites;
 }
+
+bool Socket_TLS::TLSKeyParameters::getUseKernelTLS() const
+{
+    return m_useKernelTLS;
+}
+
+void Socket_TLS::TLSKeyParameters::setUseKernelTLS(bool newUseKernelTLS)
+{
+    m_useKernelTLS = newUseKernelTLS;
+}
+
+size_t Socket_TLS::TLSKeyParameters::getSessionCacheSize() const
+{
+    return m_sessionCacheSize;
+}
+
+void Socket_TLS::TLSKeyParameters::setSessionCacheSize(size_t newSessionCacheSize)
+{
+    m_sessionCacheSize = newSessionCacheSize;
+}
+
+uint32_t Socket_TLS::TLSKeyParameters::getSessionTimeout() const
+{
+    return m_sessionTimeout;
+}
+
+void Socket_TLS::TLSKeyParameters::setSessionTimeout(uint32_t newSessionTimeout)
+{
+    m_sessionTimeout = newSessionTimeout;
+}
+
+bool Socket_TLS::TLSKeyParameters::getUseSessionTickets() const
+{
+    return m_useSessionTickets;
+}
+
+void Socket_TLS::TLSKeyParameters::setUseSessionTickets(bool newUseSessionTickets)
+{
+    m_useSessionTickets = newUseSessionTickets;
+}
+
+uint32_t Socket_TLS::TLSKeyParameters::getTicketKeyRotationInterval() const
+{
+    return m_ticketKeyRotationInterval;
+}
+
+void Socket_TLS::TLSKeyParameters::setTicketKeyRotationInterval(uint32_t newTicketKeyRotationInterval)
+{
+    m_ticketKeyRotationInterval = newTicketKeyRotationInterval;
+}
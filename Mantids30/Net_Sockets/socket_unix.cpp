@@ -141,4 +141,9 @@ std::shared_ptr<Sockets::Socket_Stream> Socket_UNIX::acceptConnection()
     return cursocket;
 }
 
+ssize_t Socket_UNIX::partialWriteV(const Memory::Streams::WriteSegment *segments, const size_t &count)
+{
+    return socketPartialWriteV(segments, count);
+}
+
 #endif
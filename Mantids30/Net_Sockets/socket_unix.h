@@ -66,6 +66,11 @@ public:
      * @return A shared pointer to a new Socket_UNIX object if a connection is successfully accepted, or nullptr if an error occurs.
      */
     std::shared_ptr<Socket_Stream> acceptConnection() override;
+
+    /**
+     * @brief partialWriteV Write the segments using writev (one system call).
+     */
+    ssize_t partialWriteV(const Memory::Streams::WriteSegment *segments, const size_t &count) override;
 };
 
 /**
@@ -24,6 +24,7 @@ void fastRPCPingerThread(FastRPC1 *obj)
 FastRPC1::FastRPC1(uint32_t threadsCount, uint32_t taskQueues)
 {
     m_threadPool = new Mantids30::Threads::Pool::ThreadPool(threadsCount, taskQueues);
+    m_threadPool->setName("FastRPC1");
     m_threadPool->start();
     m_pinger = std::thread(fastRPCPingerThread, this);
 }
@@ -1,6 +1,7 @@
 #include "fastrpc3.h"
 #include <Mantids30/API_EndpointsAndSessions/api_monolith_endpoints.h>
 #include <Mantids30/Helpers/callbacks.h>
+#include <Mantids30/Helpers/cbor.h>
 #include <Mantids30/Helpers/json.h>
 #include <Mantids30/Helpers/random.h>
 #include <Mantids30/Net_Sockets/socket_stream.h>
@@ -10,6 +11,8 @@
 
 #include <boost/algorithm/string/predicate.hpp>
 #include <cstdint>
+#include <cstring>
+#include <list>
 #include <memory>
 
 using namespace Mantids30;
@@ -35,6 +38,17 @@ void vrsyncRPCPingerThread(FastRPC3 *obj)
     }
 }
 
+void fastRPC3TaskExpirationThread(FastRPC3 *obj)
+{
+#ifndef WIN32
+    pthread_setname_np(pthread_self(), "fRPC3:Expire");
+#endif
+
+    while (obj->expirePendingTasks())
+    {
+    }
+}
+
 FastRPC3::FastRPC3(const std::shared_ptr<DataFormat::JWT> &jwtValidator, uint32_t threadsCount, uint32_t taskQueues)
     : config(jwtValidator)
 {
@@ -42,9 +56,11 @@ FastRPC3::FastRPC3(const std::shared_ptr<DataFormat::JWT> &jwtValidator, uint32_
     config.setDefaultHandlers(m_defaultMethodsHandlers);
 
     m_threadPool = new Threads::Pool::ThreadPool(threadsCount, taskQueues);
+    m_threadPool->setName("FastRPC3");
     m_threadPool->start();
 
     m_pingerThread = thread(vrsyncRPCPingerThread, this);
+    m_taskExpirationThread = thread(fastRPC3TaskExpirationThread, this);
 }
 
 FastRPC3::FastRPC3(uint32_t threadsCount, uint32_t taskQueues)
@@ -54,9 +70,11 @@ FastRPC3::FastRPC3(uint32_t threadsCount, uint32_t taskQueues)
     config.setDefaultHandlers(m_defaultMethodsHandlers);
 
     m_threadPool = new Threads::Pool::ThreadPool(threadsCount, taskQueues);
+    m_threadPool->setName("FastRPC3");
     m_threadPool->start();
 
     m_pingerThread = thread(vrsyncRPCPingerThread, this);
+    m_taskExpirationThread = thread(fastRPC3TaskExpirationThread, this);
 }
 
 FastRPC3::~FastRPC3()
@@ -73,6 +91,12 @@ FastRPC3::~FastRPC3()
     // Wait until the loop ends...
     m_pingerThread.join();
 
+    {
+        unique_lock<mutex> lk(m_taskExpirationMutex);
+        m_taskExpirationCondition.notify_all();
+    }
+    m_taskExpirationThread.join();
+
     delete m_threadPool;
 }
 
@@ -103,6 +127,119 @@ bool FastRPC3::waitPingInterval()
     return m_pingCondition.wait_for(lk, S(config.pingIntervalInSeconds)) == cv_status::timeout;
 }
 
+bool FastRPC3::expirePendingTasks()
+{
+    std::list<TaskDeadline> expiredDeadlines;
+
+    {
+        unique_lock<mutex> lk(m_taskExpirationMutex);
+
+        // Sleep until the nearest deadline (or until a sooner one is scheduled):
+        while (!m_isFinished && (m_taskDeadlines.empty() || m_taskDeadlines.begin()->first > chrono::steady_clock::now()))
+        {
+            if (m_taskDeadlines.empty())
+            {
+                m_taskExpirationCondition.wait(lk);
+            }
+            else
+            {
+                m_taskExpirationCondition.wait_until(lk, m_taskDeadlines.begin()->first);
+            }
+        }
+
+        if (m_isFinished)
+        {
+            return false;
+        }
+
+        auto now = chrono::steady_clock::now();
+        while (!m_taskDeadlines.empty() && m_taskDeadlines.begin()->first <= now)
+        {
+            expiredDeadlines.push_back(std::move(m_taskDeadlines.begin()->second));
+            m_taskDeadlines.erase(m_taskDeadlines.begin());
+        }
+    }
+
+    for (const TaskDeadline &deadline : expiredDeadlines)
+    {
+        std::shared_ptr<PendingTask> task = deadline.task.lock();
+        if (!task)
+        {
+            // Already completed.
+            continue;
+        }
+
+        FastRPC3::Connection *connection = static_cast<FastRPC3::Connection *>(m_connectionMapById.openElement(deadline.connectionId));
+        if (!connection)
+        {
+            continue;
+        }
+
+        bool expired = false;
+        {
+            unique_lock<mutex> lk(connection->pendingTasksMutex);
+            auto i = connection->pendingTasks.find(deadline.requestId);
+            if (i != connection->pendingTasks.end() && i->second == task)
+            {
+                connection->pendingTasks.erase(i);
+                expired = true;
+            }
+        }
+        m_connectionMapById.releaseElement(deadline.connectionId);
+
+        if (expired)
+        {
+            CALLBACK(rpcCallbacks.onOutgoingTaskFailureTimeout)(deadline.connectionId, task->methodName, task->payload);
+
+            TaskResult result;
+            setTaskError(result.error, TaskExecutionError::ERR_TIMEOUT, "Remote Execution Timed Out: No Answer Received.");
+            completeTask(task, std::move(result));
+        }
+    }
+
+    return true;
+}
+
+void FastRPC3::scheduleTaskExpiration(const std::string &connectionId, const uint64_t &requestId, const std::shared_ptr<PendingTask> &task)
+{
+    unique_lock<mutex> lk(m_taskExpirationMutex);
+    auto i = m_taskDeadlines.emplace(task->deadline, TaskDeadline{connectionId, requestId, task});
+    if (i == m_taskDeadlines.begin())
+    {
+        // The expiration thread is sleeping until a later deadline:
+        m_taskExpirationCondition.notify_all();
+    }
+}
+
+void FastRPC3::completeTask(const std::shared_ptr<PendingTask> &task, TaskResult &&result)
+{
+    if (!result.error.isMember("succeed"))
+    {
+        setTaskError(result.error, TaskExecutionError::ERR_UNKNOWN, "Unknown Error.");
+    }
+
+    if (task->batchSize)
+    {
+        // Every call of the batch fails the same way:
+        task->batchPromise.set_value(std::vector<TaskResult>(task->batchSize, result));
+    }
+    else if (task->onCompletion)
+    {
+        task->onCompletion(result);
+    }
+    else
+    {
+        task->promise.set_value(std::move(result));
+    }
+}
+
+void FastRPC3::setTaskError(Json::Value &error, TaskExecutionError errorId, const std::string &errorMessage)
+{
+    error["succeed"] = errorId == TaskExecutionError::SUCCESS;
+    error["errorId"] = static_cast<uint8_t>(errorId);
+    error["errorMessage"] = errorMessage;
+}
+
 int FastRPC3::processIncomingAnswer(FastRPC3::Connection *connection)
 {
     RPC3CallbackDefinitions *callbacks = (static_cast<RPC3CallbackDefinitions *>(connection->callbacks));
@@ -123,6 +260,19 @@ int FastRPC3::processIncomingAnswer(FastRPC3::Connection *connection)
     // READ IF EXECUTED.
     executionStatus = connection->stream->readU<uint8_t>();
 
+    // The payload encoding and the peer capabilities are flagged in the status:
+    bool binaryPayload = (executionStatus & ANSWER_BINARY_PAYLOAD) != 0;
+    if ((executionStatus & ANSWER_BATCH_SUPPORTED) != 0)
+    {
+        connection->peerAcceptsBatches = true;
+    }
+    if ((executionStatus & ANSWER_STREAMS_SUPPORTED) != 0)
+    {
+        connection->peerAcceptsStreams = true;
+    }
+    bool streamFollows = (executionStatus & ANSWER_STREAM_FOLLOWS) != 0;
+    executionStatus &= static_cast<uint8_t>(~(ANSWER_BINARY_PAYLOAD | ANSWER_BATCH_SUPPORTED | ANSWER_STREAMS_SUPPORTED | ANSWER_STREAM_FOLLOWS));
+
     // READ THE PAYLOAD...
     payloadBytes = connection->stream->readBlockWAllocEx<uint32_t>(&maxAlloc);
     if (payloadBytes == nullptr)
@@ -131,39 +281,169 @@ int FastRPC3::processIncomingAnswer(FastRPC3::Connection *connection)
     }
 
     ////////////////////////////////////////////////////////////
+    // Take the completion slot of the request:
+    std::shared_ptr<PendingTask> task;
     {
-        unique_lock<mutex> lk(connection->answersMutex);
-        if (connection->pendingRequests.find(requestId) != connection->pendingRequests.end())
+        unique_lock<mutex> lk(connection->pendingTasksMutex);
+        auto i = connection->pendingTasks.find(requestId);
+        if (i != connection->pendingTasks.end())
         {
-            connection->executionStatus[requestId] = executionStatus;
+            task = i->second;
+            connection->pendingTasks.erase(i);
+        }
+    }
 
-            Helpers::JSON::JSONReader2 reader;
-            bool parsingSuccessful = reader.parse(payloadBytes, connection->answers[requestId]);
-            if (parsingSuccessful)
+    if (task)
+    {
+        TaskResult result;
+        if (task->batchSize)
+        {
+            // Batched queries are answered with a batched answer (only the errors are not):
+            setTaskResult(result, static_cast<uint8_t>(TaskExecutionStatus::ERR_GENERIC), nullptr, 0, false);
+        }
+        else
+        {
+            setTaskResult(result, executionStatus, payloadBytes, maxAlloc, binaryPayload);
+            if (binaryPayload && maxAlloc != 0)
             {
-                // Notify that there is a new answer... everyone have to check if it's for him.
-                connection->answersCondition.notify_all();
+                connection->peerAcceptsBinaryPayloads = true;
             }
-            else
+        }
+
+        if (streamFollows && task->acceptsOutputStream)
+        {
+            // The task is completed when the whole output stream is received:
+            IncomingStream incomingStream;
+            incomingStream.pendingTask = task;
+            incomingStream.result = std::move(result);
+            if (!acceptIncomingStream(connection, StreamDirection::OUTPUT, requestId, std::move(incomingStream)))
             {
-                // if not able to answer, please remove from answers...
-                // TODO: notify this malformed data...
-                connection->answers.erase(requestId);
-                connection->executionStatus.erase(requestId);
-                connection->pendingRequests.erase(requestId);
+                delete[] payloadBytes;
+                return -4;
             }
         }
         else
         {
-            CALLBACK(callbacks->onProtocolUnexpectedResponse)(connection, payloadBytes);
+            completeTask(task, std::move(result));
         }
     }
+    else
+    {
+        CALLBACK(callbacks->onProtocolUnexpectedResponse)(connection, payloadBytes);
+    }
+
+    if (streamFollows && !(task && task->acceptsOutputStream))
+    {
+        // Nobody will receive this output stream (eg. the task already timed out), don't let the sender wait for the window:
+        sendStreamWindow(connection, StreamDirection::OUTPUT, requestId, STREAM_WINDOW_REJECTED);
+    }
 
     delete[] payloadBytes;
     return 1;
 }
 
-int FastRPC3::processIncomingExecutionRequest(const std::shared_ptr<Socket_Stream> &stream, const string &key, const float &priority, std::shared_mutex *mtDone,
+int FastRPC3::processIncomingBatchAnswer(FastRPC3::Connection *connection)
+{
+    RPC3CallbackDefinitions *callbacks = (static_cast<RPC3CallbackDefinitions *>(connection->callbacks));
+
+    ////////////////////////////////////////////////////////////
+    // READ THE REQUEST ID AND THE ANSWERS COUNT.
+    uint64_t requestId = connection->stream->readU<uint64_t>();
+    if (!requestId)
+    {
+        return -1;
+    }
+    bool ok;
+    uint16_t answersCount = connection->stream->readU<uint16_t>(&ok);
+    if (!ok || answersCount == 0 || answersCount > config.maxBatchSize)
+    {
+        return -2;
+    }
+
+    std::vector<TaskResult> results(answersCount);
+    bool binaryPayloads = false;
+    uint32_t remainingSize = config.maxMessageSize;
+    for (TaskResult &result : results)
+    {
+        uint8_t executionStatus = connection->stream->readU<uint8_t>(&ok);
+        if (!ok)
+        {
+            return -2;
+        }
+        bool binaryPayload = (executionStatus & ANSWER_BINARY_PAYLOAD) != 0;
+        executionStatus &= static_cast<uint8_t>(~ANSWER_BINARY_PAYLOAD);
+
+        uint32_t maxAlloc = remainingSize;
+        char *payloadBytes = connection->stream->readBlockWAllocEx<uint32_t>(&maxAlloc);
+        if (payloadBytes == nullptr)
+        {
+            return -3;
+        }
+        remainingSize -= maxAlloc;
+
+        setTaskResult(result, executionStatus, payloadBytes, maxAlloc, binaryPayload);
+        binaryPayloads = binaryPayloads || (binaryPayload && maxAlloc != 0);
+        delete[] payloadBytes;
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Take the completion slot of the request:
+    std::shared_ptr<PendingTask> task;
+    {
+        unique_lock<mutex> lk(connection->pendingTasksMutex);
+        auto i = connection->pendingTasks.find(requestId);
+        if (i != connection->pendingTasks.end() && i->second->batchSize == answersCount)
+        {
+            task = i->second;
+            connection->pendingTasks.erase(i);
+        }
+    }
+
+    if (!task)
+    {
+        CALLBACK(callbacks->onProtocolUnexpectedResponse)(connection, "");
+        return 1;
+    }
+
+    if (binaryPayloads)
+    {
+        connection->peerAcceptsBinaryPayloads = true;
+    }
+    task->batchPromise.set_value(std::move(results));
+    return 1;
+}
+
+void FastRPC3::setTaskResult(TaskResult &result, uint8_t executionStatus, const char *payload, const uint32_t &payloadSize, const bool &binaryPayload)
+{
+    // Empty payloads (eg. queue overflow) are null answers, but a successful execution always carries a serialized answer:
+    if ((payloadSize == 0 && static_cast<TaskExecutionStatus>(executionStatus) == TaskExecutionStatus::SUCCESS)
+        || (payloadSize != 0 && !parsePayload(payload, payloadSize, binaryPayload, result.answer)))
+    {
+        result.answer = Json::nullValue;
+        setTaskError(result.error, TaskExecutionError::ERR_UNKNOWN, "Remote Execution Failed: Malformed Answer.");
+        return;
+    }
+
+    switch (static_cast<TaskExecutionStatus>(executionStatus))
+    {
+    case TaskExecutionStatus::SUCCESS:
+        setTaskError(result.error, TaskExecutionError::SUCCESS, "Execution OK.");
+        break;
+    case TaskExecutionStatus::ERR_REMOTE_QUEUE_OVERFLOW:
+        setTaskError(result.error, TaskExecutionError::ERR_REMOTE_QUEUE_OVERFLOW, "Remote Execution Failed: Full Queue.");
+        break;
+    case TaskExecutionStatus::ERR_METHOD_NOT_FOUND:
+        setTaskError(result.error, TaskExecutionError::ERR_METHOD_NOT_FOUND, "Remote Execution Failed: Method Not Found.");
+        break;
+    case TaskExecutionStatus::ERR_PAYLOAD_TOO_LARGE:
+        setTaskError(result.error, TaskExecutionError::ERR_PAYLOAD_TOO_LARGE, "Remote Execution Failed: Answer Too Large.");
+        break;
+    default:
+        setTaskError(result.error, TaskExecutionError::ERR_UNKNOWN, "Remote Execution Failed.");
+    }
+}
+
+int FastRPC3::processIncomingExecutionRequest(FastRPC3::Connection *connection, const std::shared_ptr<Socket_Stream> &stream, const string &key, const float &priority, std::shared_mutex *mtDone,
                                               std::mutex *mtSocket, FastRPC3::SessionPTR *sessionHolder)
 {
     uint32_t maxAlloc = config.maxMessageSize;
@@ -198,6 +478,8 @@ int FastRPC3::processIncomingExecutionRequest(const std::shared_ptr<Socket_Strea
     {
         return static_cast<int8_t>(ConnectionHandlerReturn::FAILED_READING_PAYLOAD);
     }
+    uint32_t payloadSize = maxAlloc;
+    maxAlloc = config.maxMessageSize;
 
     if ((flags & ExecutionFlag::EXTRAAUTH) != 0)
     {
@@ -209,30 +491,13 @@ int FastRPC3::processIncomingExecutionRequest(const std::shared_ptr<Socket_Strea
         }
     }
 
-    std::shared_ptr<Sessions::Session> session = sessionHolder->getSharedPointer();
-
     ////////////////////////////////////////////////////////////
     // Process / Inject task:
-    Helpers::JSON::JSONReader2 reader;
-    std::shared_ptr<FastRPC3::TaskParameters> params = std::make_shared<FastRPC3::TaskParameters>();
-    params->sessionHolder = sessionHolder;
-    params->methodsHandler = config.methodHandlers;
-    params->jwtValidator = config.jwtValidator;
-    params->requestId = requestId;
+    std::shared_ptr<FastRPC3::TaskParameters> params = createTaskParameters(connection, stream, mtDone, mtSocket, sessionHolder, requestId, flags);
     params->methodName = methodName;
     params->extraTokenAuth = extraAuthToken;
-    params->remotePeerIPAddress = stream->getRemotePairStr();
-    params->remotePeerTLSCommonName = stream->getPeerName();
-    params->doneSharedMutex = mtDone;
-    params->socketMutex = mtSocket;
-    params->streamBack = stream;
-    params->caller = this;
-    params->maxMessageSize = config.maxMessageSize;
-    params->callbacks = &rpcCallbacks;
-    params->userId = session ? session->getUser() : "";
-    params->domain = session ? session->getDomain() : "";
 
-    bool parsingSuccessful = reader.parse(payloadBytes, params->payload);
+    bool parsingSuccessful = parsePayload(payloadBytes, payloadSize, (flags & ExecutionFlag::BINARY_PAYLOAD) != 0, params->payload);
     delete[] payloadBytes;
 
     if (!parsingSuccessful)
@@ -240,34 +505,22 @@ int FastRPC3::processIncomingExecutionRequest(const std::shared_ptr<Socket_Strea
         // Bad Incoming JSON... Disconnect
         return static_cast<int8_t>(ConnectionHandlerReturn::FAILED_PARSING_PAYLOAD);
     }
-    else
-    {
-        params->doneSharedMutex->lock_shared();
-
-        void (*currentTask)(const std::shared_ptr<void> &) = LocalRPCTasks::executeLocalTask;
 
-        if (params->methodName == "SESSION.LOGIN")
-        {
-            currentTask = LocalRPCTasks::login;
-        }
-        else if (params->methodName == "SESSION.LOGOUT")
-        {
-            currentTask = LocalRPCTasks::logout;
-        }
-        else if (params->methodName == "SESSION.GETSSODATA")
-        {
-            currentTask = LocalRPCTasks::getSSOData;
-        }
+    params->acceptsOutputStream = (flags & ExecutionFlag::STREAM_OUTPUT) != 0;
 
-        if (!m_threadPool->pushTask(currentTask, params, config.queuePushTimeoutInMS, priority, key))
+    if ((flags & ExecutionFlag::STREAM_INPUT) != 0)
+    {
+        // The task will be executed when the whole input stream is received:
+        IncomingStream incomingStream;
+        incomingStream.task = params;
+        if (!acceptIncomingStream(connection, StreamDirection::INPUT, requestId, std::move(incomingStream)))
         {
-            // Can't push the task in the queue. Null answer.
-            CALLBACK(rpcCallbacks.onIncomingTaskDroppedQueueFull)(params.get());
-            sendRPCAnswer(params.get(), "", static_cast<uint8_t>(TaskExecutionStatus::ERR_REMOTE_QUEUE_OVERFLOW));
-            params->doneSharedMutex->unlock_shared();
-            //            delete params;
+            return static_cast<int8_t>(ConnectionHandlerReturn::FAILED_READING_STREAM);
         }
+        return static_cast<int8_t>(ConnectionHandlerReturn::CONTINUE);
     }
+
+    dispatchLocalTask(params, key, priority);
     return static_cast<int8_t>(ConnectionHandlerReturn::CONTINUE);
 }
 
@@ -333,6 +586,7 @@ int FastRPC3::handleConnection(const std::shared_ptr<Sockets::Socket_Stream> &st
 
     stream->setReadTimeout(config.rwTimeoutInSeconds);
     stream->setWriteTimeout(config.rwTimeoutInSeconds);
+    stream->setReadAheadSize(config.readAheadSize);
 
     FastRPC3::SessionPTR session;
 
@@ -349,7 +603,23 @@ int FastRPC3::handleConnection(const std::shared_ptr<Sockets::Socket_Stream> &st
             break;
         case 'Q':
             // Process Query, incoming query...
-            ret = processIncomingExecutionRequest(stream, connection->key, config.keyDistFactor, &mtDone, &mtSocket, &session);
+            ret = processIncomingExecutionRequest(connection, stream, connection->key, config.keyDistFactor, &mtDone, &mtSocket, &session);
+            break;
+        case 'R':
+            // Process Batched Answer, incoming answers for a batched query...
+            ret = processIncomingBatchAnswer(connection);
+            break;
+        case 'D':
+            // Process Stream Data, incoming byte stream chunk...
+            ret = processIncomingStreamData(connection);
+            break;
+        case 'W':
+            // Process Stream Window, the receiver of our byte stream granted more credit...
+            ret = processIncomingStreamWindow(connection);
+            break;
+        case 'B':
+            // Process Batched Query, incoming queries...
+            ret = processIncomingBatchRequest(connection, stream, connection->key, config.keyDistFactor, &mtDone, &mtSocket, &session);
             break;
         case 0:
             // Remote shutdown
@@ -368,17 +638,38 @@ int FastRPC3::handleConnection(const std::shared_ptr<Sockets::Socket_Stream> &st
             ret = static_cast<int8_t>(ConnectionHandlerReturn::INVALID_PROTOCOL);
             break;
         }
+
+        // The incoming streams that stopped receiving data are discarded (the peer pings keep this loop running):
+        if (ret == static_cast<int8_t>(ConnectionHandlerReturn::CONTINUE) && !connection->incomingStreams.empty())
+        {
+            expireIncomingStreams(connection);
+        }
         //        connection->lastReceivedData = time(nullptr);
     }
 
+    // Abort the streams being sent (tasks may be waiting for the window), and discard the ones being received:
+    abortStreams(connection);
+
     // Wait until all task are done.
     mtDone.lock();
     mtDone.unlock();
 
     stream->shutdownSocket();
 
-    connection->terminated = true;
-    connection->answersCondition.notify_all();
+    // Complete the outgoing tasks that are still waiting for an answer:
+    std::map<uint64_t, std::shared_ptr<PendingTask>> lostTasks;
+    {
+        unique_lock<mutex> lk(connection->pendingTasksMutex);
+        connection->terminated = true;
+        lostTasks.swap(connection->pendingTasks);
+    }
+    for (auto &i : lostTasks)
+    {
+        TaskResult result;
+        setTaskError(result.error, TaskExecutionError::ERR_CONNECTION_LOST, "Connection is terminated: No Answer Received.");
+        completeTask(i.second, std::move(result));
+    }
+
     m_connectionMapById.destroyElement(connection->key);
 
     return ret;
@@ -411,18 +702,536 @@ Sessions::Reason temporaryAuthentication(FastRPC3::TaskParameters *params, const
     return eReason;
 }*/
 
+int FastRPC3::processIncomingBatchRequest(FastRPC3::Connection *connection, const std::shared_ptr<Socket_Stream> &stream, const string &key, const float &priority, std::shared_mutex *mtDone,
+                                          std::mutex *mtSocket, FastRPC3::SessionPTR *sessionHolder)
+{
+    ////////////////////////////////////////////////////////////
+    // READ THE REQUEST ID, FLAGS AND CALLS COUNT.
+    uint64_t requestId = stream->readU<uint64_t>();
+    if (!requestId)
+    {
+        return static_cast<int8_t>(ConnectionHandlerReturn::FAILED_READING_REQUESTID);
+    }
+
+    uint8_t flags = stream->readU<uint8_t>();
+    if (flags == 0)
+    {
+        return static_cast<int8_t>(ConnectionHandlerReturn::FAILED_READING_FLAGS);
+    }
+
+    bool ok;
+    uint16_t callsCount = stream->readU<uint16_t>(&ok);
+    if (!ok || callsCount == 0 || callsCount > config.maxBatchSize)
+    {
+        return static_cast<int8_t>(ConnectionHandlerReturn::FAILED_READING_BATCH);
+    }
+
+    std::shared_ptr<BatchAnswer> batchAnswer = std::make_shared<BatchAnswer>();
+    batchAnswer->answers.resize(callsCount);
+    batchAnswer->pendingAnswers = callsCount;
+
+    // READ THE CALLS (the whole batch is limited to the max message size)...
+    std::vector<std::shared_ptr<FastRPC3::TaskParameters>> tasks;
+    tasks.reserve(callsCount);
+    uint32_t remainingSize = config.maxMessageSize;
+    for (uint16_t i = 0; i < callsCount; i++)
+    {
+        std::shared_ptr<FastRPC3::TaskParameters> params = createTaskParameters(connection, stream, mtDone, mtSocket, sessionHolder, requestId, flags);
+        params->batchAnswer = batchAnswer;
+        params->batchIndex = i;
+
+        params->methodName = stream->readStringEx<uint8_t>(&ok);
+        if (!ok)
+        {
+            return static_cast<int8_t>(ConnectionHandlerReturn::FAILED_READING_METHOD_NAME);
+        }
+
+        uint32_t payloadSize = remainingSize;
+        char *payloadBytes = stream->readBlockWAllocEx<uint32_t>(&payloadSize);
+        if (payloadBytes == nullptr)
+        {
+            return static_cast<int8_t>(ConnectionHandlerReturn::FAILED_READING_PAYLOAD);
+        }
+        remainingSize -= payloadSize;
+
+        bool parsingSuccessful = parsePayload(payloadBytes, payloadSize, (flags & ExecutionFlag::BINARY_PAYLOAD) != 0, params->payload);
+        delete[] payloadBytes;
+        if (!parsingSuccessful)
+        {
+            return static_cast<int8_t>(ConnectionHandlerReturn::FAILED_PARSING_PAYLOAD);
+        }
+
+        tasks.push_back(params);
+    }
+
+    if ((flags & ExecutionFlag::EXTRAAUTH) != 0)
+    {
+        uint32_t maxAlloc = config.maxMessageSize;
+        char *extraAuthToken = stream->readBlockWAllocEx<uint32_t>(&maxAlloc);
+        if (!extraAuthToken)
+        {
+            return static_cast<int8_t>(ConnectionHandlerReturn::FAILED_READING_EXTRAAUTH);
+        }
+
+        // Each task owns a copy of the token:
+        for (auto &params : tasks)
+        {
+            params->extraTokenAuth = new char[maxAlloc + 1];
+            memcpy(params->extraTokenAuth, extraAuthToken, maxAlloc + 1);
+        }
+        delete[] extraAuthToken;
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Fan out the calls in the thread pool (the last one to finish sends the batched answer):
+    for (auto &params : tasks)
+    {
+        dispatchLocalTask(params, key, priority);
+    }
+
+    return static_cast<int8_t>(ConnectionHandlerReturn::CONTINUE);
+}
+
+std::shared_ptr<FastRPC3::TaskParameters> FastRPC3::createTaskParameters(FastRPC3::Connection *connection, const std::shared_ptr<Socket_Stream> &stream, std::shared_mutex *mtDone, std::mutex *mtSocket,
+                                                                        FastRPC3::SessionPTR *sessionHolder, const uint64_t &requestId, const uint8_t &flags)
+{
+    std::shared_ptr<Sessions::Session> session = sessionHolder->getSharedPointer();
+
+    std::shared_ptr<FastRPC3::TaskParameters> params = std::make_shared<FastRPC3::TaskParameters>();
+    params->sessionHolder = sessionHolder;
+    params->methodsHandler = config.methodHandlers;
+    params->jwtValidator = config.jwtValidator;
+    params->requestId = requestId;
+    params->remotePeerIPAddress = stream->getRemotePairStr();
+    params->remotePeerTLSCommonName = stream->getPeerName();
+    params->doneSharedMutex = mtDone;
+    params->socketMutex = mtSocket;
+    params->streamBack = stream;
+    params->caller = this;
+    params->maxMessageSize = config.maxMessageSize;
+    params->callbacks = &rpcCallbacks;
+    params->userId = session ? session->getUser() : "";
+    params->domain = session ? session->getDomain() : "";
+    params->binaryAnswer = config.useBinaryPayloads && (flags & ExecutionFlag::BINARY_ANSWER) != 0;
+    params->capabilitiesAnswer = (flags & ExecutionFlag::CAPABILITIES) != 0;
+    params->connection = connection;
+    return params;
+}
+
+void FastRPC3::dispatchLocalTask(const std::shared_ptr<FastRPC3::TaskParameters> &params, const string &key, const float &priority)
+{
+    params->doneSharedMutex->lock_shared();
+
+    void (*currentTask)(const std::shared_ptr<void> &) = LocalRPCTasks::executeLocalTask;
+
+    if (params->methodName == "SESSION.LOGIN")
+    {
+        currentTask = LocalRPCTasks::login;
+    }
+    else if (params->methodName == "SESSION.LOGOUT")
+    {
+        currentTask = LocalRPCTasks::logout;
+    }
+    else if (params->methodName == "SESSION.GETSSODATA")
+    {
+        currentTask = LocalRPCTasks::getSSOData;
+    }
+
+    if (!m_threadPool->pushTask(currentTask, params, config.queuePushTimeoutInMS, priority, key))
+    {
+        // Can't push the task in the queue. Null answer.
+        CALLBACK(rpcCallbacks.onIncomingTaskDroppedQueueFull)(params.get());
+        sendRPCAnswer(params.get(), std::string(), static_cast<uint8_t>(TaskExecutionStatus::ERR_REMOTE_QUEUE_OVERFLOW));
+        params->doneSharedMutex->unlock_shared();
+    }
+}
+
 void FastRPC3::sendRPCAnswer(FastRPC3::TaskParameters *params, const string &answer, uint8_t executionStatus)
 {
+    if (params->batchAnswer)
+    {
+        sendRPCBatchAnswer(params, answer, executionStatus);
+        return;
+    }
+
+    bool answerTooLarge = answer.size() > params->maxMessageSize;
+    if (answerTooLarge)
+    {
+        // The answer is not sent, report it instead of an empty answer (only the stream flag is kept):
+        executionStatus = static_cast<uint8_t>((executionStatus & ANSWER_STREAM_FOLLOWS) | static_cast<uint8_t>(TaskExecutionStatus::ERR_PAYLOAD_TOO_LARGE));
+    }
+
+    if (params->capabilitiesAnswer)
+    {
+        executionStatus |= ANSWER_BATCH_SUPPORTED | ANSWER_STREAMS_SUPPORTED;
+    }
+
     // Send a block.
     params->socketMutex->lock();
+    params->streamBack->cork();
     if (params->streamBack->writeU<uint8_t>('A') && // ANSWER
         params->streamBack->writeU<uint64_t>(params->requestId) && params->streamBack->writeU<uint8_t>(executionStatus)
-        && params->streamBack->writeStringEx<uint32_t>(answer.size() <= params->maxMessageSize ? answer : "", params->maxMessageSize))
+        && params->streamBack->writeStringEx<uint32_t>(answerTooLarge ? "" : answer, params->maxMessageSize))
     {
     }
+    params->streamBack->uncork();
     params->socketMutex->unlock();
 }
 
+void FastRPC3::sendRPCBatchAnswer(FastRPC3::TaskParameters *params, const string &answer, uint8_t executionStatus)
+{
+    BatchAnswer *batchAnswer = params->batchAnswer.get();
+    {
+        std::unique_lock<std::mutex> lk(batchAnswer->mutex);
+        if (answer.size() <= params->maxMessageSize)
+        {
+            batchAnswer->answers[params->batchIndex] = std::make_pair(executionStatus, answer);
+        }
+        else
+        {
+            batchAnswer->answers[params->batchIndex] = std::make_pair(static_cast<uint8_t>(TaskExecutionStatus::ERR_PAYLOAD_TOO_LARGE), std::string());
+        }
+        if (--batchAnswer->pendingAnswers != 0)
+        {
+            return;
+        }
+    }
+
+    // This was the last answer of the batch, send all of them in one frame:
+    uint32_t remainingSize = params->maxMessageSize;
+    params->socketMutex->lock();
+    params->streamBack->cork();
+    if (params->streamBack->writeU<uint8_t>('R') && // BATCH ANSWER
+        params->streamBack->writeU<uint64_t>(params->requestId) && params->streamBack->writeU<uint16_t>(static_cast<uint16_t>(batchAnswer->answers.size())))
+    {
+        for (const auto &i : batchAnswer->answers)
+        {
+            // The whole batch answer is limited to the max message size (the answers that don't fit are reported as too large):
+            bool fits = i.second.size() <= remainingSize;
+            const std::string &payload = fits ? i.second : "";
+            uint8_t answerStatus = fits ? i.first : static_cast<uint8_t>(TaskExecutionStatus::ERR_PAYLOAD_TOO_LARGE);
+            remainingSize -= static_cast<uint32_t>(payload.size());
+            if (!params->streamBack->writeU<uint8_t>(answerStatus) || !params->streamBack->writeStringEx<uint32_t>(payload, params->maxMessageSize))
+            {
+                break;
+            }
+        }
+    }
+    params->streamBack->uncork();
+    params->socketMutex->unlock();
+}
+
+void FastRPC3::sendRPCAnswer(FastRPC3::TaskParameters *params, const Json::Value &answer, uint8_t executionStatus, const std::shared_ptr<Memory::Containers::B_Chunks> &outputStream)
+{
+    if (params->binaryAnswer)
+    {
+        executionStatus |= ANSWER_BINARY_PAYLOAD;
+    }
+
+    if (!outputStream || outputStream->size() == 0 || !params->acceptsOutputStream || params->batchAnswer)
+    {
+        sendRPCAnswer(params, serializePayload(answer, params->binaryAnswer), executionStatus);
+        return;
+    }
+
+    // The output stream follows the answer (the window is registered before the caller can grant it):
+    FastRPC3 *caller = static_cast<FastRPC3 *>(params->caller);
+    std::shared_ptr<StreamWindow> window = registerOutgoingStream(params->connection, StreamDirection::OUTPUT, params->requestId);
+    sendRPCAnswer(params, serializePayload(answer, params->binaryAnswer), executionStatus | ANSWER_STREAM_FOLLOWS);
+    sendStream(params->connection, StreamDirection::OUTPUT, params->requestId, outputStream.get(), window, caller->config.streamChunkSize, caller->config.rwTimeoutInSeconds);
+    unregisterOutgoingStream(params->connection, StreamDirection::OUTPUT, params->requestId);
+}
+
+std::string FastRPC3::serializePayload(const Json::Value &payload, const bool &binary)
+{
+    if (binary)
+    {
+        return Helpers::CBOR::encode(payload);
+    }
+
+    Json::StreamWriterBuilder builder;
+    builder.settings_["indentation"] = "";
+    return Json::writeString(builder, payload);
+}
+
+bool FastRPC3::parsePayload(const char *data, const size_t &size, const bool &binary, Json::Value &payload)
+{
+    if (binary)
+    {
+        return Helpers::CBOR::decode(data, size, payload);
+    }
+
+    Helpers::JSON::JSONReader2 reader;
+    return reader.parse(std::string(data, size), payload);
+}
+
+int FastRPC3::processIncomingStreamData(FastRPC3::Connection *connection)
+{
+    bool ok1, ok2, ok3;
+    StreamDirection direction = static_cast<StreamDirection>(connection->stream->readU<uint8_t>(&ok1));
+    uint64_t requestId = connection->stream->readU<uint64_t>(&ok2);
+    uint32_t chunkSize = connection->stream->readU<uint32_t>(&ok3);
+    if (!ok1 || !ok2 || !ok3 || (chunkSize != STREAM_CHUNK_ABORTED && chunkSize > config.streamWindowSize))
+    {
+        return static_cast<int8_t>(ConnectionHandlerReturn::FAILED_READING_STREAM);
+    }
+
+    auto i = connection->incomingStreams.find(std::make_pair(direction, requestId));
+
+    if (chunkSize != STREAM_CHUNK_END && chunkSize != STREAM_CHUNK_ABORTED)
+    {
+        connection->streamChunkBuffer.resize(chunkSize);
+        if (!connection->stream->readFull(connection->streamChunkBuffer.data(), chunkSize))
+        {
+            return static_cast<int8_t>(ConnectionHandlerReturn::FAILED_READING_STREAM);
+        }
+
+        if (i == connection->incomingStreams.end())
+        {
+            // Unknown (eg. timed out) stream, discard.
+            return static_cast<int8_t>(ConnectionHandlerReturn::CONTINUE);
+        }
+
+        IncomingStream &incomingStream = i->second;
+        if (incomingStream.data->size() + chunkSize > config.maxStreamSize || !incomingStream.data->append(connection->streamChunkBuffer.data(), chunkSize))
+        {
+            return static_cast<int8_t>(ConnectionHandlerReturn::FAILED_READING_STREAM);
+        }
+
+        incomingStream.deadline = chrono::steady_clock::now() + S(config.rwTimeoutInSeconds);
+
+        // Grant more credit once half of the window was consumed:
+        incomingStream.ungrantedBytes += chunkSize;
+        if (incomingStream.ungrantedBytes >= config.streamWindowSize / 2)
+        {
+            sendStreamWindow(connection, direction, requestId, static_cast<uint32_t>(incomingStream.ungrantedBytes));
+            incomingStream.ungrantedBytes = 0;
+        }
+        return static_cast<int8_t>(ConnectionHandlerReturn::CONTINUE);
+    }
+
+    if (i == connection->incomingStreams.end())
+    {
+        return static_cast<int8_t>(ConnectionHandlerReturn::CONTINUE);
+    }
+
+    // The stream is complete (or aborted by the sender):
+    IncomingStream incomingStream = std::move(i->second);
+    connection->incomingStreams.erase(i);
+
+    if (chunkSize == STREAM_CHUNK_ABORTED)
+    {
+        failIncomingStream(direction, std::move(incomingStream), TaskExecutionError::ERR_DATA_TRANSMISSION_FAILURE, "Output Stream Aborted.");
+    }
+    else if (direction == StreamDirection::INPUT)
+    {
+        incomingStream.task->inputStream = incomingStream.data;
+        dispatchLocalTask(incomingStream.task, connection->key, config.keyDistFactor);
+    }
+    else
+    {
+        incomingStream.result.outputStream = incomingStream.data;
+        completeTask(incomingStream.pendingTask, std::move(incomingStream.result));
+    }
+
+    return static_cast<int8_t>(ConnectionHandlerReturn::CONTINUE);
+}
+
+void FastRPC3::failIncomingStream(const StreamDirection &direction, IncomingStream &&incomingStream, TaskExecutionError errorId, const std::string &errorMessage)
+{
+    if (direction == StreamDirection::INPUT)
+    {
+        sendRPCAnswer(incomingStream.task.get(), std::string(), static_cast<uint8_t>(TaskExecutionStatus::ERR_GENERIC));
+    }
+    else
+    {
+        incomingStream.result.answer = Json::nullValue;
+        setTaskError(incomingStream.result.error, errorId, errorMessage);
+        completeTask(incomingStream.pendingTask, std::move(incomingStream.result));
+    }
+}
+
+void FastRPC3::expireIncomingStreams(FastRPC3::Connection *connection)
+{
+    auto now = chrono::steady_clock::now();
+    for (auto i = connection->incomingStreams.begin(); i != connection->incomingStreams.end();)
+    {
+        if (i->second.deadline > now)
+        {
+            ++i;
+            continue;
+        }
+
+        // The sender may still be waiting for credit:
+        sendStreamWindow(connection, i->first.first, i->first.second, STREAM_WINDOW_REJECTED);
+        failIncomingStream(i->first.first, std::move(i->second), TaskExecutionError::ERR_TIMEOUT, "Output Stream Timed Out.");
+        i = connection->incomingStreams.erase(i);
+    }
+}
+
+int FastRPC3::processIncomingStreamWindow(FastRPC3::Connection *connection)
+{
+    bool ok1, ok2, ok3;
+    StreamDirection direction = static_cast<StreamDirection>(connection->stream->readU<uint8_t>(&ok1));
+    uint64_t requestId = connection->stream->readU<uint64_t>(&ok2);
+    uint32_t bytes = connection->stream->readU<uint32_t>(&ok3);
+    if (!ok1 || !ok2 || !ok3)
+    {
+        return static_cast<int8_t>(ConnectionHandlerReturn::FAILED_READING_STREAM);
+    }
+
+    std::shared_ptr<StreamWindow> window;
+    {
+        unique_lock<mutex> lk(connection->outgoingStreamsMutex);
+        auto i = connection->outgoingStreams.find(std::make_pair(direction, requestId));
+        if (i != connection->outgoingStreams.end())
+        {
+            window = i->second;
+        }
+    }
+
+    if (window)
+    {
+        unique_lock<mutex> lk(window->mutex);
+        if (bytes == STREAM_WINDOW_REJECTED)
+        {
+            // The receiver discarded the stream:
+            window->aborted = true;
+        }
+        else
+        {
+            window->credit += bytes;
+        }
+        window->condition.notify_all();
+    }
+    return static_cast<int8_t>(ConnectionHandlerReturn::CONTINUE);
+}
+
+bool FastRPC3::acceptIncomingStream(FastRPC3::Connection *connection, const StreamDirection &direction, const uint64_t &requestId, IncomingStream &&incomingStream)
+{
+    if (connection->incomingStreams.size() >= config.maxIncomingStreams)
+    {
+        // Only this stream (and its request) is rejected, the connection continues:
+        failIncomingStream(direction, std::move(incomingStream), TaskExecutionError::ERR_DATA_TRANSMISSION_FAILURE, "Output Stream Rejected: Too Many Incoming Streams.");
+        return sendStreamWindow(connection, direction, requestId, STREAM_WINDOW_REJECTED);
+    }
+
+    incomingStream.data = std::make_shared<Memory::Containers::B_Chunks>();
+    incomingStream.data->setMaxSizeInMemoryBeforeMovingToDisk(config.streamMaxSizeInMemory);
+    incomingStream.deadline = chrono::steady_clock::now() + S(config.rwTimeoutInSeconds);
+    connection->incomingStreams[std::make_pair(direction, requestId)] = std::move(incomingStream);
+
+    // Initial window:
+    return sendStreamWindow(connection, direction, requestId, config.streamWindowSize);
+}
+
+void FastRPC3::abortStreams(FastRPC3::Connection *connection)
+{
+    {
+        unique_lock<mutex> lk(connection->outgoingStreamsMutex);
+        connection->outgoingStreamsAborted = true;
+        for (auto &i : connection->outgoingStreams)
+        {
+            unique_lock<mutex> lkWindow(i.second->mutex);
+            i.second->aborted = true;
+            i.second->condition.notify_all();
+        }
+    }
+
+    // The output streams being received belong to tasks that will never be completed otherwise:
+    for (auto &i : connection->incomingStreams)
+    {
+        if (i.second.pendingTask)
+        {
+            TaskResult result;
+            setTaskError(result.error, TaskExecutionError::ERR_CONNECTION_LOST, "Connection is terminated: Output Stream Not Received.");
+            completeTask(i.second.pendingTask, std::move(result));
+        }
+    }
+    connection->incomingStreams.clear();
+}
+
+bool FastRPC3::sendStream(FastRPC3::Connection *connection, const StreamDirection &direction, const uint64_t &requestId, Memory::Containers::B_Base *source,
+                          const std::shared_ptr<StreamWindow> &window, const uint32_t &chunkSize, const uint32_t &timeoutInSeconds)
+{
+    std::vector<char> chunk(chunkSize);
+    size_t offset = 0, sourceSize = source->size();
+
+    for (;;)
+    {
+        uint32_t bytes = STREAM_CHUNK_END;
+        if (offset < sourceSize)
+        {
+            // Wait for the receiver to grant more credit:
+            unique_lock<mutex> lk(window->mutex);
+            if (!window->condition.wait_for(lk, S(timeoutInSeconds), [&window] { return window->aborted || window->credit > 0; }) || window->aborted)
+            {
+                // Tell the receiver that the stream won't be completed:
+                bytes = STREAM_CHUNK_ABORTED;
+            }
+            else
+            {
+                bytes = static_cast<uint32_t>(std::min<uint64_t>({window->credit, chunkSize, sourceSize - offset}));
+                window->credit -= bytes;
+            }
+        }
+
+        if (bytes != STREAM_CHUNK_END && bytes != STREAM_CHUNK_ABORTED)
+        {
+            std::optional<size_t> copiedBytes = source->copyOut(chunk.data(), bytes, offset);
+            if (!copiedBytes || *copiedBytes != bytes)
+            {
+                // Tell the receiver that the stream won't be completed:
+                bytes = STREAM_CHUNK_ABORTED;
+            }
+        }
+
+        connection->socketMutex->lock();
+        connection->stream->cork();
+        bool ok = connection->stream->writeU<uint8_t>('D') && // STREAM DATA
+                  connection->stream->writeU<uint8_t>(static_cast<uint8_t>(direction)) && connection->stream->writeU<uint64_t>(requestId)
+                  && connection->stream->writeU<uint32_t>(bytes) && (bytes == STREAM_CHUNK_END || bytes == STREAM_CHUNK_ABORTED || connection->stream->writeFullStream(chunk.data(), bytes));
+        ok = connection->stream->uncork() && ok;
+        connection->socketMutex->unlock();
+
+        if (!ok || bytes == STREAM_CHUNK_ABORTED)
+        {
+            return false;
+        }
+        if (bytes == STREAM_CHUNK_END)
+        {
+            return true;
+        }
+        offset += bytes;
+    }
+}
+
+bool FastRPC3::sendStreamWindow(FastRPC3::Connection *connection, const StreamDirection &direction, const uint64_t &requestId, const uint32_t &bytes)
+{
+    connection->socketMutex->lock();
+    connection->stream->cork();
+    bool ok = connection->stream->writeU<uint8_t>('W') && // STREAM WINDOW
+              connection->stream->writeU<uint8_t>(static_cast<uint8_t>(direction)) && connection->stream->writeU<uint64_t>(requestId) && connection->stream->writeU<uint32_t>(bytes);
+    ok = connection->stream->uncork() && ok;
+    connection->socketMutex->unlock();
+    return ok;
+}
+
+std::shared_ptr<FastRPC3::StreamWindow> FastRPC3::registerOutgoingStream(FastRPC3::Connection *connection, const StreamDirection &direction, const uint64_t &requestId)
+{
+    std::shared_ptr<StreamWindow> window = std::make_shared<StreamWindow>();
+    unique_lock<mutex> lk(connection->outgoingStreamsMutex);
+    window->aborted = connection->outgoingStreamsAborted;
+    connection->outgoingStreams[std::make_pair(direction, requestId)] = window;
+    return window;
+}
+
+void FastRPC3::unregisterOutgoingStream(FastRPC3::Connection *connection, const StreamDirection &direction, const uint64_t &requestId)
+{
+    unique_lock<mutex> lk(connection->outgoingStreamsMutex);
+    connection->outgoingStreams.erase(std::make_pair(direction, requestId));
+}
+
 set<string> FastRPC3::listActiveConnectionIds()
 {
     return m_connectionMapById.getKeys();
@@ -14,9 +14,14 @@
 #include <Mantids30/Net_Sockets/listener.h>
 
 #include <Mantids30/DataFormat_JWT/jwt.h>
-#include <Mantids30/Threads/safe_map.h>
+#include <Mantids30/Memory/b_chunks.h>
+#include <Mantids30/Threads/safe_shardedmap.h>
+#include <chrono>
 #include <cstdint>
+#include <functional>
+#include <future>
 #include <memory>
+#include <vector>
 
 namespace Mantids30::Network::Protocol::FastRPC {
 
@@ -42,6 +47,8 @@ public:
         FAILED_READING_PAYLOAD = -4,
         FAILED_READING_EXTRAAUTH = -5,
         FAILED_PARSING_PAYLOAD = -6,
+        FAILED_READING_BATCH = -7,
+        FAILED_READING_STREAM = -8,
         CONTINUE = 1
     };
 
@@ -49,9 +56,53 @@ public:
     {
         EMPTY = 0,
         NORMAL = 1,
-        EXTRAAUTH = 2
+        EXTRAAUTH = 2,
+        BINARY_PAYLOAD = 4, // The query payload is encoded in CBOR (otherwise compact JSON)
+        BINARY_ANSWER = 8,  // The caller accepts the answer payload encoded in CBOR
+        CAPABILITIES = 16,  // The caller accepts the capability bits in the answer execution status
+        STREAM_INPUT = 32,  // An input byte stream follows the query
+        STREAM_OUTPUT = 64  // The caller accepts an output byte stream after the answer
     };
 
+    /**
+     * @brief The StreamDirection enum identifies a byte stream of a request in the stream frames: INPUT streams go from the caller to the
+     *        peer executing the method, OUTPUT streams go back from the executing peer to the caller.
+     */
+    enum class StreamDirection : uint8_t
+    {
+        INPUT = 0,
+        OUTPUT = 1
+    };
+
+    /**
+     * @brief ANSWER_BINARY_PAYLOAD bit set in the answer execution status when the answer payload is encoded in CBOR.
+     *        Only sent to the callers that flagged BINARY_ANSWER, and it tells them that this peer understands CBOR queries.
+     */
+    static constexpr uint8_t ANSWER_BINARY_PAYLOAD = 0x80;
+    /**
+     * @brief ANSWER_BATCH_SUPPORTED bit set in the answer execution status (for callers that flagged CAPABILITIES) when this peer
+     *        accepts batched queries.
+     */
+    static constexpr uint8_t ANSWER_BATCH_SUPPORTED = 0x40;
+    /**
+     * @brief ANSWER_STREAMS_SUPPORTED bit set in the answer execution status (for callers that flagged CAPABILITIES) when this peer
+     *        accepts byte streams.
+     */
+    static constexpr uint8_t ANSWER_STREAMS_SUPPORTED = 0x20;
+    /**
+     * @brief ANSWER_STREAM_FOLLOWS bit set in the answer execution status when the output byte stream follows the answer.
+     */
+    static constexpr uint8_t ANSWER_STREAM_FOLLOWS = 0x10;
+    /**
+     * @brief STREAM_CHUNK_END/STREAM_CHUNK_ABORTED special chunk sizes of the stream data frames.
+     */
+    static constexpr uint32_t STREAM_CHUNK_END = 0;
+    static constexpr uint32_t STREAM_CHUNK_ABORTED = 0xFFFFFFFF;
+    /**
+     * @brief STREAM_WINDOW_REJECTED special credit of the stream window frames: the receiver discards the stream, the sender should abort it.
+     */
+    static constexpr uint32_t STREAM_WINDOW_REJECTED = 0xFFFFFFFF;
+
     enum class TaskExecutionError : uint8_t
     {
         SUCCESS = 0,
@@ -62,6 +113,7 @@ public:
         ERR_REMOTE_QUEUE_OVERFLOW = 5,
         ERR_METHOD_NOT_FOUND = 6,
         ERR_CONNECTION_LOST = 7,
+        ERR_STREAMS_NOT_SUPPORTED = 8,
         ERR_UNKNOWN = 99,
     };
 
@@ -70,7 +122,8 @@ public:
         ERR_GENERIC = 1,
         SUCCESS = 2,
         ERR_REMOTE_QUEUE_OVERFLOW = 3,
-        ERR_METHOD_NOT_FOUND = 4
+        ERR_METHOD_NOT_FOUND = 4,
+        ERR_PAYLOAD_TOO_LARGE = 5
     };
 
     class SessionPTR
@@ -93,6 +146,18 @@ public:
         std::mutex mt;
     };
 
+    /**
+     * @brief The BatchAnswer struct collects the answers of the tasks of an incoming batch, the last one sends the batched answer.
+     */
+    struct BatchAnswer
+    {
+        std::mutex mutex;
+        std::vector<std::pair<uint8_t, std::string>> answers;
+        size_t pendingAnswers = 0;
+    };
+
+    class Connection;
+
     struct TaskParameters
     {
         ~TaskParameters() { delete[] extraTokenAuth; }
@@ -109,9 +174,91 @@ public:
         char *extraTokenAuth = nullptr;
         Json::Value payload;
         uint64_t requestId = 0;
+        bool binaryAnswer = false;
+        bool capabilitiesAnswer = false;
+        // Set when the task is part of a batch:
+        std::shared_ptr<BatchAnswer> batchAnswer;
+        size_t batchIndex = 0;
+        // Byte streams:
+        FastRPC3::Connection *connection = nullptr;
+        std::shared_ptr<Memory::Containers::B_Chunks> inputStream;
+        bool acceptsOutputStream = false;
         void *callbacks = nullptr;
     };
 
+    /**
+     * @brief The TaskResult struct contains the answer of a remote task and the error/status information
+     *        (same format as the error parameter of RemoteMethods::executeTask)
+     */
+    struct TaskResult
+    {
+        Json::Value answer;
+        Json::Value error;
+        // Output byte stream sent by the method (only for executeTaskWithStreams, nullptr if the method didn't produce any)
+        std::shared_ptr<Memory::Containers::B_Chunks> outputStream;
+    };
+
+    /**
+     * @brief TaskCompletionCallback function called once when the remote task is completed (answered, failed, timed out or disconnected).
+     *                               It runs in the connection/expiration thread, so it should not block or wait for other remote tasks.
+     */
+    using TaskCompletionCallback = std::function<void(const TaskResult &result)>;
+
+    /**
+     * @brief The PendingTask struct is the completion slot of an outgoing request.
+     */
+    struct PendingTask
+    {
+        std::string methodName;
+        // Only kept if there is an onOutgoingTaskFailureTimeout callback:
+        Json::Value payload;
+        std::chrono::steady_clock::time_point deadline;
+        // Completed through the callback if defined, otherwise through the promise:
+        TaskCompletionCallback onCompletion;
+        std::promise<TaskResult> promise;
+        // The caller accepts an output byte stream (executeTaskWithStreams):
+        bool acceptsOutputStream = false;
+        // Batched tasks (batchSize calls) complete through this promise:
+        size_t batchSize = 0;
+        std::promise<std::vector<TaskResult>> batchPromise;
+    };
+
+    /**
+     * @brief The BatchCall struct is one method invocation of a batch.
+     */
+    struct BatchCall
+    {
+        std::string methodName;
+        Json::Value payload;
+    };
+
+    /**
+     * @brief The StreamWindow struct is the flow control window of an outgoing byte stream (the receiver grants the credit).
+     */
+    struct StreamWindow
+    {
+        std::mutex mutex;
+        std::condition_variable condition;
+        uint64_t credit = 0;
+        bool aborted = false;
+    };
+
+    /**
+     * @brief The IncomingStream struct contains the byte stream being received for a request.
+     */
+    struct IncomingStream
+    {
+        std::shared_ptr<Memory::Containers::B_Chunks> data;
+        uint64_t ungrantedBytes = 0;
+        // INPUT: the task that will be executed when the stream is complete:
+        std::shared_ptr<TaskParameters> task;
+        // OUTPUT: the caller task/result completed when the stream is complete:
+        std::shared_ptr<PendingTask> pendingTask;
+        TaskResult result;
+        // The stream is discarded if no data is received before this time:
+        std::chrono::steady_clock::time_point deadline;
+    };
+
     class Connection : public Mantids30::Threads::Safe::MapItem
     {
     public:
@@ -128,16 +275,25 @@ public:
         uint64_t requestIdCounter = 1;
         std::mutex mtReqIdCt;
 
-        // Answers:
-        std::map<uint64_t, Json::Value> answers;
-        std::mutex answersMutex;
-        std::condition_variable answersCondition;
+        // Outgoing requests waiting for an answer (each one is completed once, by whoever removes it first):
+        std::map<uint64_t, std::shared_ptr<PendingTask>> pendingTasks;
+        std::mutex pendingTasksMutex;
 
-        // Execution Status:
-        std::map<uint64_t, uint8_t> executionStatus;
+        // The remote peer answered in CBOR, so the queries can be sent in CBOR too:
+        std::atomic<bool> peerAcceptsBinaryPayloads{false};
+        // The remote peer announced that it accepts batched queries:
+        std::atomic<bool> peerAcceptsBatches{false};
+        // The remote peer announced that it accepts byte streams:
+        std::atomic<bool> peerAcceptsStreams{false};
 
-        // Pending Requests:
-        std::set<uint64_t> pendingRequests{0};
+        // Byte streams being sent (by direction and request ID), aborted when the connection ends:
+        std::map<std::pair<StreamDirection, uint64_t>, std::shared_ptr<StreamWindow>> outgoingStreams;
+        std::mutex outgoingStreamsMutex;
+        bool outgoingStreamsAborted = false;
+
+        // Byte streams being received (only accessed from the connection thread):
+        std::map<std::pair<StreamDirection, uint64_t>, IncomingStream> incomingStreams;
+        std::vector<char> streamChunkBuffer;
 
         // Finalization:
         std::atomic<bool> terminated{false};
@@ -214,6 +370,39 @@ public:
                             just before having a network problem, the writes (including the ping one) may block the pinging process forever.
          */
         uint32_t rwTimeoutInSeconds = 40;
+        /**
+         * @brief readAheadSize Read-ahead buffer size (in bytes) set on handleConnection, the small message fields (type, request id,
+         *                      flags, method name) are served from the buffer instead of one read per field. 0 disables it.
+         */
+        uint32_t readAheadSize = 16384;
+        /**
+         * @brief useBinaryPayloads Negotiate CBOR payloads with the remote peer (falls back to compact JSON with peers that don't support it).
+         */
+        std::atomic<bool> useBinaryPayloads{true};
+        /**
+         * @brief maxBatchSize Max number of calls in a batched query (incoming and outgoing).
+         */
+        std::atomic<uint32_t> maxBatchSize{256};
+        /**
+         * @brief streamChunkSize Max size of each byte stream data frame (the frames are interleaved with the other RPC frames).
+         */
+        std::atomic<uint32_t> streamChunkSize{64 * 1024};
+        /**
+         * @brief streamWindowSize Bytes that the sender can send before the receiver grants more (flow control).
+         */
+        std::atomic<uint32_t> streamWindowSize{1024 * 1024};
+        /**
+         * @brief streamMaxSizeInMemory Received byte streams are moved to disk after this size (see B_Chunks).
+         */
+        std::atomic<uint64_t> streamMaxSizeInMemory{8 * 1024 * 1024};
+        /**
+         * @brief maxStreamSize Max size of a received byte stream.
+         */
+        std::atomic<uint64_t> maxStreamSize{4ULL * 1024 * 1024 * 1024};
+        /**
+         * @brief maxIncomingStreams Max number of byte streams being received at the same time per connection (the requests of the streams over it fail).
+         */
+        std::atomic<uint32_t> maxIncomingStreams{16};
         /**
          * @brief methodHandlers current Methods Manager
          */
@@ -324,6 +513,53 @@ public:
          * @note This function is thread-safe and can handle multiple connections simultaneously. It may return Json::nullValue due to network issues, timeouts, or other errors.
          */
         Json::Value executeTask(const std::string &methodName, const Json::Value &payload, Json::Value *error, bool retryIfDisconnected = true, bool passSessionCommands = false, const std::string &extraJWTTokenAuth = "");
+        /**
+         * @brief executeTaskAsync Send a remote task without waiting for the answer.
+         *
+         * Many calls can be outstanding on the same connection at the same time, each one is completed independently when its
+         * answer arrives, the connection is lost or remoteExecutionTimeoutInMS expires.
+         *
+         * @param retryIfDisconnected (Optional) Wait (blocking) for the remote peer to connect up to remoteExecutionDisconnectedTries seconds. Default: false.
+         * @return future with the answer and the error/status information (the same that executeTask returns/fills).
+         */
+        std::future<TaskResult> executeTaskAsync(const std::string &methodName, const Json::Value &payload, bool retryIfDisconnected = false, bool passSessionCommands = false,
+                                                 const std::string &extraJWTTokenAuth = "");
+        /**
+         * @brief executeTaskAsync Send a remote task and call onCompletion when it completes (see TaskCompletionCallback).
+         *                         If the task can't be sent, onCompletion is called before returning.
+         * @return true if the task was sent.
+         */
+        bool executeTaskAsync(const std::string &methodName, const Json::Value &payload, const TaskCompletionCallback &onCompletion, bool retryIfDisconnected = false,
+                              bool passSessionCommands = false, const std::string &extraJWTTokenAuth = "");
+        /**
+         * @brief executeBatch Execute many remote methods in a single query frame.
+         *
+         * The remote peer executes the calls in parallel in its thread pool and returns all the answers in a single frame. If the peer
+         * has not announced batch support yet (eg. older versions), the calls are sent as individual queries.
+         *
+         * @param calls method invocations (up to maxBatchSize, session commands are not allowed)
+         * @param retryIfDisconnected (Optional) Wait for the remote peer to connect up to remoteExecutionDisconnectedTries seconds. Default: true.
+         * @param extraJWTTokenAuth (Optional) Additional authentication token applied to every call.
+         * @return one result per call, in the same order (see executeTaskAsync).
+         */
+        std::vector<TaskResult> executeBatch(const std::vector<BatchCall> &calls, bool retryIfDisconnected = true, const std::string &extraJWTTokenAuth = "");
+        /**
+         * @brief executeBatchAsync Same as executeBatch without waiting for the answers.
+         * @param retryIfDisconnected (Optional) Wait (blocking) for the remote peer to connect. Default: false.
+         */
+        std::future<std::vector<TaskResult>> executeBatchAsync(const std::vector<BatchCall> &calls, bool retryIfDisconnected = false, const std::string &extraJWTTokenAuth = "");
+        /**
+         * @brief executeTaskWithStreams Execute a remote method that consumes and/or produces a byte stream (see streamEndpoint in
+         *                               API::Monolith::Endpoints), without the maxMessageSize limit.
+         *
+         * The streams are sent in bounded frames with flow control, interleaved with the other RPC frames of the connection.
+         * The received output stream is moved to disk when it exceeds streamMaxSizeInMemory.
+         *
+         * @param inputStream (Optional) byte stream sent to the method (nullptr for none).
+         * @return the answer/error (see executeTask) and the output stream (nullptr if the method didn't produce any).
+         */
+        TaskResult executeTaskWithStreams(const std::string &methodName, const Json::Value &payload, const std::shared_ptr<Memory::Containers::B_Base> &inputStream,
+                                          bool retryIfDisconnected = true, const std::string &extraJWTTokenAuth = "");
         /**
          * @brief runRemoteClose Run Remote Close Method
          * @param connectionId Connection ID (this class can thread-safe handle multiple connections at time)
@@ -332,6 +568,15 @@ public:
         bool close();
 
     private:
+        bool sendTask(const std::string &methodName, const Json::Value &payload, bool retryIfDisconnected, bool passSessionCommands, const std::string &extraJWTTokenAuth,
+                      const std::shared_ptr<PendingTask> &task, const std::shared_ptr<Memory::Containers::B_Base> &inputStream = nullptr);
+        bool isPeerAcceptingStreams();
+        bool sendBatch(const std::vector<BatchCall> &calls, bool retryIfDisconnected, const std::string &extraJWTTokenAuth, const std::shared_ptr<PendingTask> &task);
+        FastRPC3::Connection *openConnection(bool retryIfDisconnected);
+        uint64_t registerTask(FastRPC3::Connection *connection, const std::shared_ptr<PendingTask> &task);
+        void abortTask(FastRPC3::Connection *connection, const uint64_t &requestId, const std::shared_ptr<PendingTask> &task);
+        uint8_t getQueryFlags(const bool &binaryPayload, const std::string &extraJWTTokenAuth);
+
         FastRPC3 *parent;
         std::string connectionId;
     };
@@ -411,6 +656,11 @@ public:
      * @return true if ping interval completed, false if a signal closed the wait interval (eg. FastRPC3 destroyed)
      */
     bool waitPingInterval();
+    /**
+     * @brief expirePendingTasks Internal function to complete the remote tasks that timed out
+     * @return false if FastRPC3 is being destroyed
+     */
+    bool expirePendingTasks();
 
     /**
      * @brief callbacks This is where you define the callbacks before using this class...
@@ -494,10 +744,65 @@ private:
     };
 
     static void sendRPCAnswer(FastRPC3::TaskParameters *parameters, const std::string &answer, uint8_t executionStatus);
+    /**
+     * @brief sendRPCAnswer Serialize the answer payload (CBOR if the caller accepts it, otherwise compact JSON) and send it.
+     */
+    static void sendRPCAnswer(FastRPC3::TaskParameters *parameters, const Json::Value &answer, uint8_t executionStatus,
+                              const std::shared_ptr<Memory::Containers::B_Chunks> &outputStream = nullptr);
+    /**
+     * @brief serializePayload Serialize a payload as CBOR or compact JSON.
+     */
+    static std::string serializePayload(const Json::Value &payload, const bool &binary);
+    /**
+     * @brief parsePayload Parse a CBOR or JSON payload.
+     */
+    static bool parsePayload(const char *data, const size_t &size, const bool &binary, Json::Value &payload);
+
+    /**
+     * @brief completeTask Deliver the result of a pending task (through its callback or its promise).
+     */
+    static void completeTask(const std::shared_ptr<PendingTask> &task, TaskResult &&result);
+    static void setTaskResult(TaskResult &result, uint8_t executionStatus, const char *payload, const uint32_t &payloadSize, const bool &binaryPayload);
+    static void setTaskError(Json::Value &error, TaskExecutionError errorId, const std::string &errorMessage);
+    void scheduleTaskExpiration(const std::string &connectionId, const uint64_t &requestId, const std::shared_ptr<PendingTask> &task);
 
     int processIncomingAnswer(FastRPC3::Connection *connection);
-    int processIncomingExecutionRequest(const std::shared_ptr<Sockets::Socket_Stream> &stream, const std::string &key, const float &priority, std::shared_mutex *mtDone,
+    int processIncomingStreamData(FastRPC3::Connection *connection);
+    int processIncomingStreamWindow(FastRPC3::Connection *connection);
+    /**
+     * @brief acceptIncomingStream Start receiving a stream, or reject it (failing its request) when there are already maxIncomingStreams.
+     * @return false if the window frame could not be sent (the connection is broken).
+     */
+    bool acceptIncomingStream(FastRPC3::Connection *connection, const StreamDirection &direction, const uint64_t &requestId, IncomingStream &&incomingStream);
+    /**
+     * @brief failIncomingStream Fail the request of a stream that won't be completed (INPUT: answer the caller with an error, OUTPUT: complete the caller task with the error).
+     */
+    void failIncomingStream(const StreamDirection &direction, IncomingStream &&incomingStream, TaskExecutionError errorId, const std::string &errorMessage);
+    /**
+     * @brief expireIncomingStreams Discard the incoming streams that didn't receive data before their deadline (and ask the senders to abort them).
+     */
+    void expireIncomingStreams(FastRPC3::Connection *connection);
+    void abortStreams(FastRPC3::Connection *connection);
+
+    /**
+     * @brief sendStream Send the source content as a byte stream, waiting for the receiver window when it's exhausted.
+     *        A stream that is not completed (aborted, timed out or rejected by the receiver) ends with an aborted chunk.
+     * @return false if the stream was aborted, timed out or failed to be sent.
+     */
+    static bool sendStream(FastRPC3::Connection *connection, const StreamDirection &direction, const uint64_t &requestId, Memory::Containers::B_Base *source,
+                           const std::shared_ptr<StreamWindow> &window, const uint32_t &chunkSize, const uint32_t &timeoutInSeconds);
+    static bool sendStreamWindow(FastRPC3::Connection *connection, const StreamDirection &direction, const uint64_t &requestId, const uint32_t &bytes);
+    static std::shared_ptr<StreamWindow> registerOutgoingStream(FastRPC3::Connection *connection, const StreamDirection &direction, const uint64_t &requestId);
+    static void unregisterOutgoingStream(FastRPC3::Connection *connection, const StreamDirection &direction, const uint64_t &requestId);
+    int processIncomingBatchAnswer(FastRPC3::Connection *connection);
+    int processIncomingExecutionRequest(FastRPC3::Connection *connection, const std::shared_ptr<Sockets::Socket_Stream> &stream, const std::string &key, const float &priority, std::shared_mutex *mtDone,
                                         std::mutex *mtSocket, FastRPC3::SessionPTR *session);
+    int processIncomingBatchRequest(FastRPC3::Connection *connection, const std::shared_ptr<Sockets::Socket_Stream> &stream, const std::string &key, const float &priority, std::shared_mutex *mtDone,
+                                    std::mutex *mtSocket, FastRPC3::SessionPTR *session);
+    std::shared_ptr<FastRPC3::TaskParameters> createTaskParameters(FastRPC3::Connection *connection, const std::shared_ptr<Sockets::Socket_Stream> &stream, std::shared_mutex *mtDone, std::mutex *mtSocket,
+                                                                  FastRPC3::SessionPTR *sessionHolder, const uint64_t &requestId, const uint8_t &flags);
+    void dispatchLocalTask(const std::shared_ptr<FastRPC3::TaskParameters> &params, const std::string &key, const float &priority);
+    static void sendRPCBatchAnswer(FastRPC3::TaskParameters *parameters, const std::string &answer, uint8_t executionStatus);
 
     // TODO:
     /*    std::map<std::string,std::string> connectionIdToLogin;
@@ -515,7 +820,7 @@ private:
     /**
      * @brief Stores active connections indexed by a unique key identifier.
      */
-    Mantids30::Threads::Safe::Map<std::string> m_connectionMapById;
+    Mantids30::Threads::Safe::ShardedMap<std::string> m_connectionMapById;
 
     /**
      * @brief Thread pool for handling RPC method execution.
@@ -542,6 +847,29 @@ private:
      */
     std::condition_variable m_pingCondition;
 
+    /**
+     * @brief Background thread that completes the outgoing tasks that timed out.
+     */
+    std::thread m_taskExpirationThread;
+
+    /**
+     * @brief Mutex/condition for the task expiration thread, woken up when a task expires sooner than the next scheduled check.
+     */
+    std::mutex m_taskExpirationMutex;
+    std::condition_variable m_taskExpirationCondition;
+
+    struct TaskDeadline
+    {
+        std::string connectionId;
+        uint64_t requestId;
+        std::weak_ptr<PendingTask> task;
+    };
+
+    /**
+     * @brief Deadlines of the outgoing tasks (the entries of the tasks that were already completed are skipped when they expire).
+     */
+    std::multimap<std::chrono::steady_clock::time_point, TaskDeadline> m_taskDeadlines;
+
     /**
      * @brief Handler for default RPC methods.
      */
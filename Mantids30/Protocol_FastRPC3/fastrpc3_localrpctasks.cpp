@@ -30,6 +30,7 @@ void FastRPC3::LocalRPCTasks::executeLocalTask(const std::shared_ptr<void> &vTas
 
     Json::Value fullResponse;
     Json::Value responsePayload;
+    std::shared_ptr<Memory::Containers::B_Chunks> outputStream;
     fullResponse["statusCode"] = static_cast<uint16_t>(LocalTaskExecutionResult::SUCCESS);
 
     Helpers::JSON::JSONReader2 reader;
@@ -129,7 +130,13 @@ void FastRPC3::LocalRPCTasks::executeLocalTask(const std::shared_ptr<void> &vTas
                 chrono::high_resolution_clock::time_point finish = chrono::high_resolution_clock::now();
                 chrono::duration<double, milli> elapsed = finish - start;
 
-                switch (taskParams->methodsHandler->invoke(session, taskParams->methodName, taskParams->payload, &responsePayload))
+                if (taskParams->acceptsOutputStream)
+                {
+                    outputStream = std::make_shared<Memory::Containers::B_Chunks>();
+                    outputStream->setMaxSizeInMemoryBeforeMovingToDisk(static_cast<FastRPC3 *>(taskParams->caller)->config.streamMaxSizeInMemory);
+                }
+
+                switch (taskParams->methodsHandler->invoke(session, taskParams->methodName, taskParams->payload, &responsePayload, taskParams->inputStream, outputStream.get()))
                 {
                 case API::Monolith::Endpoints::StatusCode::SUCCESS:
 
@@ -182,7 +189,7 @@ void FastRPC3::LocalRPCTasks::executeLocalTask(const std::shared_ptr<void> &vTas
 
     //
     fullResponse["payload"] = responsePayload;
-    sendRPCAnswer(taskParams, fullResponse.toStyledString(), functionFound ?  static_cast<uint8_t>(TaskExecutionStatus::SUCCESS) :  static_cast<uint8_t>(TaskExecutionStatus::ERR_METHOD_NOT_FOUND));
+    sendRPCAnswer(taskParams, fullResponse, functionFound ?  static_cast<uint8_t>(TaskExecutionStatus::SUCCESS) :  static_cast<uint8_t>(TaskExecutionStatus::ERR_METHOD_NOT_FOUND), outputStream);
     taskParams->doneSharedMutex->unlock_shared();
 }
 
@@ -196,7 +203,7 @@ void FastRPC3::LocalRPCTasks::getSSOData(const std::shared_ptr<void> &taskData)
     data["returnURI"] = caller->config.returnURI;
     data["ignoreSSLCertForSSO"] = caller->config.ignoreSSLCertForSSO;
 
-    sendRPCAnswer(taskParams, data.toStyledString(),  static_cast<uint8_t>(TaskExecutionStatus::SUCCESS));
+    sendRPCAnswer(taskParams, data,  static_cast<uint8_t>(TaskExecutionStatus::SUCCESS));
     taskParams->doneSharedMutex->unlock_shared();
 }
 
@@ -247,7 +254,7 @@ void FastRPC3::LocalRPCTasks::login(const std::shared_ptr<void> &taskData)
     }
 
     response = loginAuthResult.toJSONResponse();
-    sendRPCAnswer(taskParams, response.toStyledString(),  static_cast<uint8_t>(TaskExecutionStatus::SUCCESS));
+    sendRPCAnswer(taskParams, response,  static_cast<uint8_t>(TaskExecutionStatus::SUCCESS));
     taskParams->doneSharedMutex->unlock_shared();
 }
 
@@ -256,6 +263,6 @@ void FastRPC3::LocalRPCTasks::logout(const std::shared_ptr<void> &taskData)
     FastRPC3::TaskParameters *params = static_cast<FastRPC3::TaskParameters *>(taskData.get());
     Json::Value response;
     response = params->sessionHolder->destroy();
-    sendRPCAnswer(params, response.toStyledString(),  static_cast<uint8_t>(TaskExecutionStatus::SUCCESS));
+    sendRPCAnswer(params, response,  static_cast<uint8_t>(TaskExecutionStatus::SUCCESS));
     params->doneSharedMutex->unlock_shared();
 }
@@ -27,70 +27,292 @@ Json::Value FastRPC3::RemoteMethods::loginViaJWTToken(const std::string &jwtToke
 
 Json::Value FastRPC3::RemoteMethods::executeTask(const string &methodName, const Json::Value &payload, Json::Value *error, bool retryIfDisconnected, bool passSessionCommands, const string &extraJWTTokenAuth)
 {
-    Json::Value r;
+    TaskResult result = executeTaskAsync(methodName, payload, retryIfDisconnected, passSessionCommands, extraJWTTokenAuth).get();
 
-    if (!passSessionCommands && boost::starts_with(methodName, "SESSION."))
+    if (error)
     {
+        *error = std::move(result.error);
+    }
+
+    return result.answer;
+}
+
+std::future<FastRPC3::TaskResult> FastRPC3::RemoteMethods::executeTaskAsync(const string &methodName, const Json::Value &payload, bool retryIfDisconnected, bool passSessionCommands,
+                                                                           const string &extraJWTTokenAuth)
+{
+    std::shared_ptr<PendingTask> task = std::make_shared<PendingTask>();
+    std::future<TaskResult> r = task->promise.get_future();
+    sendTask(methodName, payload, retryIfDisconnected, passSessionCommands, extraJWTTokenAuth, task);
+    return r;
+}
+
+bool FastRPC3::RemoteMethods::executeTaskAsync(const string &methodName, const Json::Value &payload, const TaskCompletionCallback &onCompletion, bool retryIfDisconnected,
+                                               bool passSessionCommands, const string &extraJWTTokenAuth)
+{
+    std::shared_ptr<PendingTask> task = std::make_shared<PendingTask>();
+    task->onCompletion = onCompletion;
+    return sendTask(methodName, payload, retryIfDisconnected, passSessionCommands, extraJWTTokenAuth, task);
+}
+
+std::vector<FastRPC3::TaskResult> FastRPC3::RemoteMethods::executeBatch(const std::vector<BatchCall> &calls, bool retryIfDisconnected, const string &extraJWTTokenAuth)
+{
+    return executeBatchAsync(calls, retryIfDisconnected, extraJWTTokenAuth).get();
+}
+
+std::future<std::vector<FastRPC3::TaskResult>> FastRPC3::RemoteMethods::executeBatchAsync(const std::vector<BatchCall> &calls, bool retryIfDisconnected, const string &extraJWTTokenAuth)
+{
+    std::shared_ptr<PendingTask> task = std::make_shared<PendingTask>();
+    task->batchSize = calls.size();
+    std::future<std::vector<TaskResult>> r = task->batchPromise.get_future();
+
+    if (calls.empty())
+    {
+        task->batchPromise.set_value({});
         return r;
     }
 
-    Json::StreamWriterBuilder builder;
-    builder.settings_["indentation"] = "";
-    string output = Json::writeString(builder, payload);
+    sendBatch(calls, retryIfDisconnected, extraJWTTokenAuth, task);
+    return r;
+}
 
-    if (output.size() > parent->config.maxMessageSize)
+namespace {
+// Collects the individual answers of a batch sent to a peer without batch support:
+struct BatchFallback
+{
+    std::mutex mutex;
+    std::vector<FastRPC3::TaskResult> results;
+    size_t pendingResults;
+    std::shared_ptr<FastRPC3::PendingTask> task;
+};
+} // namespace
+
+bool FastRPC3::RemoteMethods::sendBatch(const std::vector<BatchCall> &calls, bool retryIfDisconnected, const string &extraJWTTokenAuth, const std::shared_ptr<PendingTask> &task)
+{
+    TaskResult failure;
+
+    for (const BatchCall &call : calls)
     {
-        if (error)
+        if (boost::starts_with(call.methodName, "SESSION."))
         {
-            (*error)["succeed"] = false;
-            (*error)["errorId"] = static_cast<uint8_t>(TaskExecutionError::ERR_PAYLOAD_TOO_LARGE);
-            (*error)["errorMessage"] = "Payload exceed the Maximum Message Size.";
+            completeTask(task, std::move(failure));
+            return false;
         }
-        return r;
     }
 
-    FastRPC3::Connection *connection;
+    if (calls.size() > parent->config.maxBatchSize)
+    {
+        setTaskError(failure.error, TaskExecutionError::ERR_PAYLOAD_TOO_LARGE, "Too many calls in the batch.");
+        completeTask(task, std::move(failure));
+        return false;
+    }
 
-    uint32_t _tries = 0;
-    while ((connection = static_cast<FastRPC3::Connection *>(parent->m_connectionMapById.openElement(connectionId))) == nullptr)
+    FastRPC3::Connection *connection = openConnection(retryIfDisconnected);
+    if (!connection)
     {
-        _tries++;
-        if (_tries >= parent->config.remoteExecutionDisconnectedTries || !retryIfDisconnected)
+        for (const BatchCall &call : calls)
         {
-            CALLBACK(parent->rpcCallbacks.onOutgoingTaskFailureDisconnectedPeer)(connectionId, methodName, payload);
-            if (error)
-            {
-                (*error)["succeed"] = false;
-                (*error)["errorId"] = static_cast<uint8_t>(TaskExecutionError::ERR_PEER_NOT_FOUND);
-                (*error)["errorMessage"] = "Abort after remote peer not found/connected.";
-            }
-            return r;
+            CALLBACK(parent->rpcCallbacks.onOutgoingTaskFailureDisconnectedPeer)(connectionId, call.methodName, call.payload);
         }
-        sleep(1);
+        setTaskError(failure.error, TaskExecutionError::ERR_PEER_NOT_FOUND, "Abort after remote peer not found/connected.");
+        completeTask(task, std::move(failure));
+        return false;
     }
 
-    uint64_t requestId;
-    // Create a request ID.
-    connection->mtReqIdCt.lock();
-    requestId = connection->requestIdCounter++;
-    connection->mtReqIdCt.unlock();
+    if (!connection->peerAcceptsBatches)
+    {
+        parent->m_connectionMapById.releaseElement(connectionId);
+
+        // The peer didn't announce batch support (yet), send the calls one by one:
+        std::shared_ptr<BatchFallback> fallback = std::make_shared<BatchFallback>();
+        fallback->results.resize(calls.size());
+        fallback->pendingResults = calls.size();
+        fallback->task = task;
+
+        for (size_t i = 0; i < calls.size(); i++)
+        {
+            executeTaskAsync(calls[i].methodName, calls[i].payload, [fallback, i](const TaskResult &result) {
+                std::unique_lock<std::mutex> lk(fallback->mutex);
+                fallback->results[i] = result;
+                if (--fallback->pendingResults == 0)
+                {
+                    lk.unlock();
+                    fallback->task->batchPromise.set_value(std::move(fallback->results));
+                }
+            }, false, false, extraJWTTokenAuth);
+        }
+        return true;
+    }
 
+    // CBOR once the peer has shown that it supports it (answering in CBOR), otherwise compact JSON:
+    bool binaryPayload = parent->config.useBinaryPayloads && connection->peerAcceptsBinaryPayloads;
+    std::vector<string> outputs;
+    outputs.reserve(calls.size());
+    size_t outputsSize = 0;
+    for (const BatchCall &call : calls)
     {
-        unique_lock<mutex> lk(connection->answersMutex);
-        // Create authorization to be inserted:
-        connection->pendingRequests.insert(requestId);
+        outputs.push_back(serializePayload(call.payload, binaryPayload));
+        outputsSize += outputs.back().size();
     }
 
-    uint8_t flags = static_cast<uint8_t>(ExecutionFlag::NORMAL);
-    if (!extraJWTTokenAuth.empty())
+    if (outputsSize > parent->config.maxMessageSize)
     {
-        flags |= static_cast<uint8_t>(ExecutionFlag::EXTRAAUTH);
+        parent->m_connectionMapById.releaseElement(connectionId);
+        setTaskError(failure.error, TaskExecutionError::ERR_PAYLOAD_TOO_LARGE, "Payload exceed the Maximum Message Size.");
+        completeTask(task, std::move(failure));
+        return false;
+    }
+
+    task->methodName = "BATCH";
+    task->deadline = chrono::steady_clock::now() + Ms(parent->config.remoteExecutionTimeoutInMS);
+
+    uint64_t requestId = registerTask(connection, task);
+    if (!requestId)
+    {
+        return false;
+    }
+
+    uint8_t flags = getQueryFlags(binaryPayload, extraJWTTokenAuth);
+
+    connection->socketMutex->lock();
+
+    // The whole batch is sent at once:
+    connection->stream->cork();
+
+    bool dataTransmitOK = connection->stream->writeU<uint8_t>('B') && // BATCHED QUERY FOR ANSWERS
+                          connection->stream->writeU<uint64_t>(requestId) && connection->stream->writeU<uint8_t>(flags)
+                          && connection->stream->writeU<uint16_t>(static_cast<uint16_t>(calls.size()));
+
+    for (size_t i = 0; dataTransmitOK && i < calls.size(); i++)
+    {
+        dataTransmitOK = connection->stream->writeStringEx<uint8_t>(calls[i].methodName) && connection->stream->writeStringEx<uint32_t>(outputs[i], parent->config.maxMessageSize);
+    }
+
+    if (dataTransmitOK && (flags & static_cast<uint8_t>(ExecutionFlag::EXTRAAUTH)) != 0)
+    {
+        dataTransmitOK = connection->stream->writeStringEx<uint32_t>(extraJWTTokenAuth, extraJWTTokenAuth.size());
+    }
+
+    if (!connection->stream->uncork())
+    {
+        dataTransmitOK = false;
+    }
+
+    connection->socketMutex->unlock();
+
+    if (!dataTransmitOK)
+    {
+        abortTask(connection, requestId, task);
+        return false;
+    }
+
+    // Time to wait for the answers (or the timeout)...
+    parent->scheduleTaskExpiration(connectionId, requestId, task);
+
+    parent->m_connectionMapById.releaseElement(connectionId);
+    return true;
+}
+
+FastRPC3::TaskResult FastRPC3::RemoteMethods::executeTaskWithStreams(const string &methodName, const Json::Value &payload, const std::shared_ptr<Memory::Containers::B_Base> &inputStream,
+                                                                     bool retryIfDisconnected, const string &extraJWTTokenAuth)
+{
+    // The peer capabilities come in the answers, ask something if it didn't answer anything yet:
+    if (!isPeerAcceptingStreams())
+    {
+        executeTask("_pingNotFound_", {}, nullptr, retryIfDisconnected);
+    }
+
+    std::shared_ptr<PendingTask> task = std::make_shared<PendingTask>();
+    task->acceptsOutputStream = true;
+    std::future<TaskResult> r = task->promise.get_future();
+    sendTask(methodName, payload, retryIfDisconnected, false, extraJWTTokenAuth, task, inputStream);
+    return r.get();
+}
+
+bool FastRPC3::RemoteMethods::isPeerAcceptingStreams()
+{
+    FastRPC3::Connection *connection = static_cast<FastRPC3::Connection *>(parent->m_connectionMapById.openElement(connectionId));
+    if (!connection)
+    {
+        return false;
+    }
+    bool r = connection->peerAcceptsStreams;
+    parent->m_connectionMapById.releaseElement(connectionId);
+    return r;
+}
+
+bool FastRPC3::RemoteMethods::sendTask(const string &methodName, const Json::Value &payload, bool retryIfDisconnected, bool passSessionCommands, const string &extraJWTTokenAuth,
+                                       const std::shared_ptr<PendingTask> &task, const std::shared_ptr<Memory::Containers::B_Base> &inputStream)
+{
+    TaskResult failure;
+
+    if (!passSessionCommands && boost::starts_with(methodName, "SESSION."))
+    {
+        completeTask(task, std::move(failure));
+        return false;
+    }
+
+    FastRPC3::Connection *connection = openConnection(retryIfDisconnected);
+    if (!connection)
+    {
+        CALLBACK(parent->rpcCallbacks.onOutgoingTaskFailureDisconnectedPeer)(connectionId, methodName, payload);
+        setTaskError(failure.error, TaskExecutionError::ERR_PEER_NOT_FOUND, "Abort after remote peer not found/connected.");
+        completeTask(task, std::move(failure));
+        return false;
+    }
+
+    if ((inputStream || task->acceptsOutputStream) && !connection->peerAcceptsStreams)
+    {
+        parent->m_connectionMapById.releaseElement(connectionId);
+        setTaskError(failure.error, TaskExecutionError::ERR_STREAMS_NOT_SUPPORTED, "The remote peer does not support byte streams.");
+        completeTask(task, std::move(failure));
+        return false;
+    }
+
+    // CBOR once the peer has shown that it supports it (answering in CBOR), otherwise compact JSON:
+    bool binaryPayload = parent->config.useBinaryPayloads && connection->peerAcceptsBinaryPayloads;
+    string output = serializePayload(payload, binaryPayload);
+
+    if (output.size() > parent->config.maxMessageSize)
+    {
+        parent->m_connectionMapById.releaseElement(connectionId);
+        setTaskError(failure.error, TaskExecutionError::ERR_PAYLOAD_TOO_LARGE, "Payload exceed the Maximum Message Size.");
+        completeTask(task, std::move(failure));
+        return false;
+    }
+
+    task->methodName = methodName;
+    if (parent->rpcCallbacks.onOutgoingTaskFailureTimeout)
+    {
+        task->payload = payload;
+    }
+    task->deadline = chrono::steady_clock::now() + Ms(parent->config.remoteExecutionTimeoutInMS);
+
+    uint64_t requestId = registerTask(connection, task);
+    if (!requestId)
+    {
+        return false;
+    }
+
+    uint8_t flags = getQueryFlags(binaryPayload, extraJWTTokenAuth);
+
+    std::shared_ptr<StreamWindow> inputWindow;
+    if (inputStream)
+    {
+        flags |= static_cast<uint8_t>(ExecutionFlag::STREAM_INPUT);
+        inputWindow = registerOutgoingStream(connection, StreamDirection::INPUT, requestId);
+    }
+    if (task->acceptsOutputStream)
+    {
+        flags |= static_cast<uint8_t>(ExecutionFlag::STREAM_OUTPUT);
     }
 
     connection->socketMutex->lock();
 
     bool dataTransmitOK = true;
 
+    // The whole query is sent at once:
+    connection->stream->cork();
+
     if (connection->stream->writeU<uint8_t>('Q') && // QUERY FOR ANSWER
         connection->stream->writeU<uint64_t>(requestId) && connection->stream->writeU<uint8_t>(flags) && connection->stream->writeStringEx<uint8_t>(methodName)
         && connection->stream->writeStringEx<uint32_t>(output, parent->config.maxMessageSize))
@@ -112,106 +334,115 @@ Json::Value FastRPC3::RemoteMethods::executeTask(const string &methodName, const
         }
     }
 
-    if (!dataTransmitOK)
+    if (!connection->stream->uncork())
     {
-        if (error)
-        {
-            (*error)["succeed"] = false;
-            (*error)["errorId"] = static_cast<uint8_t>(TaskExecutionError::ERR_DATA_TRANSMISSION_FAILURE);
-            (*error)["errorMessage"] = "Connection Failed.";
-        }
-        return r;
+        dataTransmitOK = false;
     }
 
     connection->socketMutex->unlock();
 
-    // Time to wait for answers...
-    for (;;)
+    if (inputStream)
     {
-        unique_lock<mutex> lk(connection->answersMutex);
-
-        // Process multiple signals until our answer comes...
-
-        if (connection->answersCondition.wait_for(lk, Ms(parent->config.remoteExecutionTimeoutInMS)) == cv_status::timeout)
+        // Send the input stream (interleaved with the other frames), the execution timeout starts after it:
+        if (dataTransmitOK)
         {
-            // break by timeout. (no answer)
-            CALLBACK(parent->rpcCallbacks.onOutgoingTaskFailureTimeout)(connectionId, methodName, payload);
-
-            if (error)
-            {
-                (*error)["succeed"] = false;
-                (*error)["errorId"] = static_cast<uint8_t>(TaskExecutionError::ERR_TIMEOUT);
-                (*error)["errorMessage"] = "Remote Execution Timed Out: No Answer Received.";
-            }
-            break;
+            dataTransmitOK = sendStream(connection, StreamDirection::INPUT, requestId, inputStream.get(), inputWindow, parent->config.streamChunkSize, parent->config.rwTimeoutInSeconds);
+            task->deadline = chrono::steady_clock::now() + Ms(parent->config.remoteExecutionTimeoutInMS);
         }
+        unregisterOutgoingStream(connection, StreamDirection::INPUT, requestId);
+    }
 
-        if (lk.owns_lock() && connection->answers.find(requestId) != connection->answers.end())
-        {
-            // break by element found. (answer)
-            uint8_t executionStatus = connection->executionStatus[requestId];
+    if (!dataTransmitOK)
+    {
+        abortTask(connection, requestId, task);
+        return false;
+    }
 
-            r = connection->answers[requestId];
+    // Time to wait for the answer (or the timeout)...
+    parent->scheduleTaskExpiration(connectionId, requestId, task);
 
-            if (error)
-            {
-                switch (static_cast<TaskExecutionStatus>(executionStatus))
-                {
-                case TaskExecutionStatus::SUCCESS:
-                    (*error)["succeed"] = true;
-                    (*error)["errorId"] = static_cast<uint8_t>(TaskExecutionError::SUCCESS);
-                    (*error)["errorMessage"] = "Execution OK.";
-                    break;
-                case TaskExecutionStatus::ERR_REMOTE_QUEUE_OVERFLOW:
-                    (*error)["succeed"] = false;
-                    (*error)["errorId"] = static_cast<uint8_t>(TaskExecutionError::ERR_REMOTE_QUEUE_OVERFLOW);
-                    (*error)["errorMessage"] = "Remote Execution Failed: Full Queue.";
-                    break;
-                case TaskExecutionStatus::ERR_METHOD_NOT_FOUND:
-                    (*error)["succeed"] = false;
-                    (*error)["errorId"] = static_cast<uint8_t>(TaskExecutionError::ERR_METHOD_NOT_FOUND);
-                    (*error)["errorMessage"] = "Remote Execution Failed: Method Not Found.";
-                    break;
-                default:
-                    (*error)["succeed"] = false;
-                }
-            }
-            break;
-        }
+    parent->m_connectionMapById.releaseElement(connectionId);
+    return true;
+}
+
+FastRPC3::Connection *FastRPC3::RemoteMethods::openConnection(bool retryIfDisconnected)
+{
+    FastRPC3::Connection *connection;
 
-        if (lk.owns_lock() && connection->terminated)
+    uint32_t _tries = 0;
+    while ((connection = static_cast<FastRPC3::Connection *>(parent->m_connectionMapById.openElement(connectionId))) == nullptr)
+    {
+        _tries++;
+        if (_tries >= parent->config.remoteExecutionDisconnectedTries || !retryIfDisconnected)
         {
-            if (error)
-            {
-                (*error)["succeed"] = false;
-                (*error)["errorId"] = static_cast<uint8_t>(TaskExecutionError::ERR_CONNECTION_LOST);
-                (*error)["errorMessage"] = "Connection is terminated: No Answer Received.";
-            }
-            break;
+            return nullptr;
         }
+        sleep(1);
     }
 
+    return connection;
+}
+
+uint64_t FastRPC3::RemoteMethods::registerTask(FastRPC3::Connection *connection, const std::shared_ptr<PendingTask> &task)
+{
+    uint64_t requestId;
+    // Create a request ID.
+    connection->mtReqIdCt.lock();
+    requestId = connection->requestIdCounter++;
+    connection->mtReqIdCt.unlock();
+
     {
-        unique_lock<mutex> lk(connection->answersMutex);
-        // Revoke authorization to be inserted, clean results...
-        connection->answers.erase(requestId);
-        connection->executionStatus.erase(requestId);
-        connection->pendingRequests.erase(requestId);
+        unique_lock<mutex> lk(connection->pendingTasksMutex);
+        if (!connection->terminated)
+        {
+            // Register the completion slot before the answer can arrive:
+            connection->pendingTasks[requestId] = task;
+            return requestId;
+        }
     }
 
     parent->m_connectionMapById.releaseElement(connectionId);
 
-    if (error)
+    TaskResult failure;
+    setTaskError(failure.error, TaskExecutionError::ERR_CONNECTION_LOST, "Connection is terminated: No Answer Received.");
+    completeTask(task, std::move(failure));
+    return 0;
+}
+
+void FastRPC3::RemoteMethods::abortTask(FastRPC3::Connection *connection, const uint64_t &requestId, const std::shared_ptr<PendingTask> &task)
+{
+    bool taskRemoved;
     {
-        if (!error->isMember("succeed"))
-        {
-            (*error)["succeed"] = false;
-            (*error)["errorId"] = 99;
-            (*error)["errorMessage"] = "Unknown Error.";
-        }
+        unique_lock<mutex> lk(connection->pendingTasksMutex);
+        taskRemoved = connection->pendingTasks.erase(requestId) != 0;
     }
+    parent->m_connectionMapById.releaseElement(connectionId);
 
-    return r;
+    // (otherwise it was already completed by the connection termination)
+    if (taskRemoved)
+    {
+        TaskResult failure;
+        setTaskError(failure.error, TaskExecutionError::ERR_DATA_TRANSMISSION_FAILURE, "Connection Failed.");
+        completeTask(task, std::move(failure));
+    }
+}
+
+uint8_t FastRPC3::RemoteMethods::getQueryFlags(const bool &binaryPayload, const string &extraJWTTokenAuth)
+{
+    uint8_t flags = static_cast<uint8_t>(ExecutionFlag::NORMAL) | static_cast<uint8_t>(ExecutionFlag::CAPABILITIES);
+    if (!extraJWTTokenAuth.empty())
+    {
+        flags |= static_cast<uint8_t>(ExecutionFlag::EXTRAAUTH);
+    }
+    if (binaryPayload)
+    {
+        flags |= static_cast<uint8_t>(ExecutionFlag::BINARY_PAYLOAD);
+    }
+    if (parent->config.useBinaryPayloads)
+    {
+        flags |= static_cast<uint8_t>(ExecutionFlag::BINARY_ANSWER);
+    }
+    return flags;
 }
 
 bool FastRPC3::RemoteMethods::logout(Json::Value *error)
@@ -0,0 +1,226 @@
+#include "common_byteranges.h"
+
+#include <Mantids30/Helpers/random.h>
+
+#include <algorithm>
+#include <boost/algorithm/string.hpp>
+#include <limits>
+
+using namespace Mantids30::Network::Protocol;
+using namespace Mantids30;
+
+// Parse a non-negative decimal number (saturated to the max size_t value), false if it's not a number.
+static bool parseRangePosition(const std::string &str, size_t &value)
+{
+    if (str.empty())
+    {
+        return false;
+    }
+
+    value = 0;
+    for (const char &c : str)
+    {
+        if (c < '0' || c > '9')
+        {
+            return false;
+        }
+        size_t digit = static_cast<size_t>(c - '0');
+        if (value > (std::numeric_limits<size_t>::max() - digit) / 10)
+        {
+            value = std::numeric_limits<size_t>::max();
+        }
+        else
+        {
+            value = value * 10 + digit;
+        }
+    }
+    return true;
+}
+
+HTTP::ByteRangesStreamer::ByteRangesStreamer(const std::shared_ptr<Memory::Containers::B_Base> &source, const std::vector<Range> &ranges, const std::string &contentType)
+    : m_source(source)
+    , m_ranges(ranges)
+{
+    if (!isMultipart())
+    {
+        return;
+    }
+
+    size_t representationSize = m_source->size();
+    m_boundary = Helpers::Random::createRandomHexString(16);
+
+    for (const Range &range : m_ranges)
+    {
+        std::string partHeader = "\r\n--" + m_boundary + "\r\n";
+        if (!contentType.empty())
+        {
+            partHeader += "Content-Type: " + contentType + "\r\n";
+        }
+        partHeader += "Content-Range: " + getContentRange(range, representationSize) + "\r\n\r\n";
+        m_partHeaders.push_back(partHeader);
+    }
+    m_trailer = "\r\n--" + m_boundary + "--\r\n";
+}
+
+std::optional<std::vector<HTTP::ByteRangesStreamer::Range>> HTTP::ByteRangesStreamer::parseRangeHeader(const std::string &rangeHeader, const size_t &representationSize, const size_t &maxRanges)
+{
+    std::string header = boost::trim_copy(rangeHeader);
+    if (!boost::istarts_with(header, "bytes="))
+    {
+        // Unknown range unit.
+        return std::nullopt;
+    }
+
+    std::vector<std::string> rangeSpecs;
+    boost::split(rangeSpecs, header.substr(6), boost::is_any_of(","));
+
+    std::vector<Range> ranges;
+    size_t specsCount = 0;
+
+    for (std::string &rangeSpec : rangeSpecs)
+    {
+        boost::trim(rangeSpec);
+        if (rangeSpec.empty())
+        {
+            // Empty list elements are allowed.
+            continue;
+        }
+
+        if (++specsCount > maxRanges)
+        {
+            // Too many ranges (eg. an amplification attempt), serve the whole representation.
+            return std::nullopt;
+        }
+
+        size_t dashPos = rangeSpec.find('-');
+        if (dashPos == std::string::npos)
+        {
+            return std::nullopt;
+        }
+
+        std::string firstStr = boost::trim_copy(rangeSpec.substr(0, dashPos));
+        std::string lastStr = boost::trim_copy(rangeSpec.substr(dashPos + 1));
+        size_t first = 0, last = 0;
+
+        if (firstStr.empty())
+        {
+            // Suffix range (the last N bytes):
+            size_t suffixLength;
+            if (!parseRangePosition(lastStr, suffixLength))
+            {
+                return std::nullopt;
+            }
+            if (suffixLength == 0 || representationSize == 0)
+            {
+                // Unsatisfiable.
+                continue;
+            }
+            first = representationSize - std::min(suffixLength, representationSize);
+            last = representationSize - 1;
+        }
+        else
+        {
+            if (!parseRangePosition(firstStr, first))
+            {
+                return std::nullopt;
+            }
+            if (lastStr.empty())
+            {
+                last = std::numeric_limits<size_t>::max();
+            }
+            else if (!parseRangePosition(lastStr, last) || last < first)
+            {
+                return std::nullopt;
+            }
+            if (first >= representationSize)
+            {
+                // Unsatisfiable.
+                continue;
+            }
+            last = std::min(last, representationSize - 1);
+        }
+
+        ranges.push_back({first, last});
+    }
+
+    if (specsCount == 0)
+    {
+        // "bytes=" without any range.
+        return std::nullopt;
+    }
+
+    // Sort and coalesce the overlapping/adjacent ranges:
+    std::sort(ranges.begin(), ranges.end(), [](const Range &a, const Range &b) { return a.first < b.first; });
+
+    std::vector<Range> coalescedRanges;
+    for (const Range &range : ranges)
+    {
+        if (!coalescedRanges.empty() && range.first <= coalescedRanges.back().last + 1)
+        {
+            coalescedRanges.back().last = std::max(coalescedRanges.back().last, range.last);
+        }
+        else
+        {
+            coalescedRanges.push_back(range);
+        }
+    }
+
+    return coalescedRanges;
+}
+
+std::string HTTP::ByteRangesStreamer::getContentRange(const Range &range, const size_t &representationSize)
+{
+    return "bytes " + std::to_string(range.first) + "-" + std::to_string(range.last) + "/" + std::to_string(representationSize);
+}
+
+std::string HTTP::ByteRangesStreamer::getMultipartContentType() const
+{
+    return "multipart/byteranges; boundary=" + m_boundary;
+}
+
+size_t HTTP::ByteRangesStreamer::size()
+{
+    size_t r = m_trailer.size();
+    for (const std::string &partHeader : m_partHeaders)
+    {
+        r += partHeader.size();
+    }
+    for (const Range &range : m_ranges)
+    {
+        r += range.length();
+    }
+    return r;
+}
+
+bool HTTP::ByteRangesStreamer::streamTo(Memory::Streams::StreamableObject *out)
+{
+    for (size_t i = 0; i < m_ranges.size(); i++)
+    {
+        if (i < m_partHeaders.size() && !out->writeFullStream(m_partHeaders[i].data(), m_partHeaders[i].size()))
+        {
+            writeStatus += -1;
+            return false;
+        }
+
+        std::optional<size_t> bytesCopied = m_source->appendTo(*out, m_ranges[i].length(), m_ranges[i].first);
+        if (bytesCopied != m_ranges[i].length() || !out->writeStatus.succeed)
+        {
+            writeStatus += -1;
+            return false;
+        }
+    }
+
+    if (!m_trailer.empty() && !out->writeFullStream(m_trailer.data(), m_trailer.size()))
+    {
+        writeStatus += -1;
+        return false;
+    }
+
+    return true;
+}
+
+std::optional<size_t> HTTP::ByteRangesStreamer::write(const void *, const size_t &)
+{
+    writeStatus += -1;
+    return std::nullopt;
+}
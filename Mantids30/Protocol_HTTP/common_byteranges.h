@@ -0,0 +1,81 @@
+#pragma once
+
+#include <Mantids30/Memory/b_base.h>
+#include <Mantids30/Memory/streamable_object.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Mantids30::Network::Protocol::HTTP {
+
+/**
+ * @brief The ByteRangesStreamer class streams some byte ranges of a binary container as the 206 (Partial Content) body.
+ *
+ * A single range is streamed as is (the Content-Range goes in the response headers), multiple ranges are streamed as
+ * a multipart/byteranges body. The data is copied with the container offset/size primitives, so memory mapped files
+ * keep the zero-copy path.
+ */
+class ByteRangesStreamer : public Memory::Streams::StreamableObject
+{
+public:
+    /**
+     * @brief The Range struct byte range with inclusive positions (as in the HTTP Range/Content-Range headers)
+     */
+    struct Range
+    {
+        size_t first = 0;
+        size_t last = 0;
+
+        [[nodiscard]] size_t length() const { return last - first + 1; }
+    };
+
+    /**
+     * @brief ByteRangesStreamer Create the streamer
+     * @param source container with the whole representation
+     * @param ranges satisfiable ranges (from parseRangeHeader)
+     * @param contentType representation content type (used in the multipart headers)
+     */
+    ByteRangesStreamer(const std::shared_ptr<Memory::Containers::B_Base> &source, const std::vector<Range> &ranges, const std::string &contentType);
+
+    /**
+     * @brief parseRangeHeader Parse the Range header value (eg. "bytes=0-499, -500") for a representation
+     * @param rangeHeader Range header value
+     * @param representationSize size of the whole representation
+     * @param maxRanges max number of ranges accepted (more than this and the header is ignored)
+     * @return std::nullopt if the header should be ignored (invalid syntax, unknown unit or too many ranges), an empty list if
+     *         there is no satisfiable range (416), otherwise the satisfiable ranges sorted and with the overlapping ones coalesced.
+     */
+    static std::optional<std::vector<Range>> parseRangeHeader(const std::string &rangeHeader, const size_t &representationSize, const size_t &maxRanges = 16);
+    /**
+     * @brief getContentRange Get the Content-Range header value for a range (eg. "bytes 0-499/1234")
+     */
+    static std::string getContentRange(const Range &range, const size_t &representationSize);
+
+    /**
+     * @brief isMultipart Check if the content will be a multipart/byteranges body (more than one range)
+     */
+    [[nodiscard]] bool isMultipart() const { return m_ranges.size() > 1; }
+    /**
+     * @brief getMultipartContentType Get the response content type for the multipart body (with the boundary)
+     */
+    [[nodiscard]] std::string getMultipartContentType() const;
+
+    size_t size() override;
+    bool streamTo(Memory::Streams::StreamableObject *out) override;
+    /**
+     * @brief write This streamer is read-only, any write fails.
+     */
+    std::optional<size_t> write(const void *buf, const size_t &count) override;
+
+private:
+    std::shared_ptr<Memory::Containers::B_Base> m_source;
+    std::vector<Range> m_ranges;
+    // Multipart headers (one per range) and final boundary:
+    std::vector<std::string> m_partHeaders;
+    std::string m_trailer;
+    std::string m_boundary;
+};
+
+} // namespace Mantids30::Network::Protocol::HTTP
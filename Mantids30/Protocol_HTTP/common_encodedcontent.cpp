@@ -0,0 +1,36 @@
+#include "common_encodedcontent.h"
+
+using namespace Mantids30::Network::Protocol;
+using namespace Mantids30;
+
+HTTP::EncodedContentStreamer::EncodedContentStreamer(const std::shared_ptr<Memory::Streams::StreamableObject> &source, std::unique_ptr<Memory::Streams::StreamableTransformer> encoder)
+    : m_source(source)
+    , m_encoder(std::move(encoder))
+{
+}
+
+bool HTTP::EncodedContentStreamer::streamTo(Memory::Streams::StreamableObject *out)
+{
+    if (!m_encoder)
+    {
+        // The encoder state can't be reused.
+        writeStatus += -1;
+        return false;
+    }
+
+    m_encoder->transform(m_source.get(), out);
+    m_encoder = nullptr;
+
+    if (!out->writeStatus.succeed || !m_source->writeStatus.succeed)
+    {
+        writeStatus += -1;
+        return false;
+    }
+    return true;
+}
+
+std::optional<size_t> HTTP::EncodedContentStreamer::write(const void *, const size_t &)
+{
+    writeStatus += -1;
+    return std::nullopt;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <Mantids30/Memory/streamable_object.h>
+#include <Mantids30/Memory/streamable_transformer.h>
+
+#include <memory>
+
+namespace Mantids30::Network::Protocol::HTTP {
+
+/**
+ * @brief The EncodedContentStreamer class streams a content through an encoder (eg. gzip) while it's being sent.
+ *
+ * The encoded size is unknown until the whole content is streamed, so this is used with chunked (or connection close) transmission.
+ */
+class EncodedContentStreamer : public Memory::Streams::StreamableObject
+{
+public:
+    /**
+     * @brief EncodedContentStreamer Create the streamer
+     * @param source original content
+     * @param encoder content encoder (one use, owned by this streamer)
+     */
+    EncodedContentStreamer(const std::shared_ptr<Memory::Streams::StreamableObject> &source, std::unique_ptr<Memory::Streams::StreamableTransformer> encoder);
+
+    bool streamTo(Memory::Streams::StreamableObject *out) override;
+    /**
+     * @brief write This streamer is read-only, any write fails.
+     */
+    std::optional<size_t> write(const void *buf, const size_t &count) override;
+
+private:
+    std::shared_ptr<Memory::Streams::StreamableObject> m_source;
+    std::unique_ptr<Memory::Streams::StreamableTransformer> m_encoder;
+};
+
+} // namespace Mantids30::Network::Protocol::HTTP
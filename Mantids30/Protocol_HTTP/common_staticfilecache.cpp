@@ -0,0 +1,487 @@
+#include "common_staticfilecache.h"
+
+#include "streamencoder_brotli.h"
+#include "streamencoder_deflate.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#endif
+
+using namespace Mantids30::Network::Protocol;
+using namespace Mantids30;
+
+HTTP::StaticFileCache::StaticFileCache()
+    : StaticFileCache(Config())
+{
+}
+
+HTTP::StaticFileCache::StaticFileCache(const Config &config)
+    : config(config)
+{
+#ifdef __linux__
+    m_inotifyFD = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    m_wakeupFD = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    // Without inotify, every hit is validated with stat.
+    m_validateWithStat = (m_inotifyFD == -1 || m_wakeupFD == -1);
+#endif
+}
+
+HTTP::StaticFileCache::~StaticFileCache()
+{
+#ifdef __linux__
+    if (m_watcherThread.joinable())
+    {
+        // Wake up the watcher thread:
+        uint64_t one = 1;
+        [[maybe_unused]] ssize_t r = write(m_wakeupFD, &one, sizeof(one));
+        m_watcherThread.join();
+    }
+    if (m_inotifyFD != -1)
+    {
+        close(m_inotifyFD);
+    }
+    if (m_wakeupFD != -1)
+    {
+        close(m_wakeupFD);
+    }
+#endif
+}
+
+std::shared_ptr<const HTTP::StaticFileCache::Entry> HTTP::StaticFileCache::get(const std::string &realPath)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    auto it = m_entries.find(realPath);
+    if (it == m_entries.end())
+    {
+        m_misses++;
+        return nullptr;
+    }
+
+    std::shared_ptr<Entry> entry = it->second.entry;
+
+    if (m_validateWithStat)
+    {
+        struct stat fileStats{};
+        if (stat(realPath.c_str(), &fileStats) != 0 || fileStats.st_dev != entry->device || fileStats.st_ino != entry->inode || fileStats.st_size != entry->fileSize
+#ifdef _WIN32
+            || fileStats.st_mtime != entry->modificationTime.tv_sec
+#else
+            || fileStats.st_mtim.tv_sec != entry->modificationTime.tv_sec || fileStats.st_mtim.tv_nsec != entry->modificationTime.tv_nsec
+#endif
+        )
+        {
+            removeLocked(it);
+            m_misses++;
+            return nullptr;
+        }
+    }
+
+    // Most recently used:
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lruPosition);
+    m_hits++;
+    return entry;
+}
+
+std::shared_ptr<const HTTP::StaticFileCache::Entry> HTTP::StaticFileCache::load(const std::string &realPath, bool precompress)
+{
+    std::promise<std::shared_ptr<const Entry>> loadResult;
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        auto loading = m_loading.find(realPath);
+        if (loading != m_loading.end())
+        {
+            // Another thread is reading (and compressing) the same file, use its result:
+            std::shared_future<std::shared_ptr<const Entry>> pendingLoad = loading->second;
+            lock.unlock();
+            return pendingLoad.get();
+        }
+        m_loading[realPath] = loadResult.get_future().share();
+    }
+
+    std::shared_ptr<const Entry> entry = loadFromDisk(realPath, precompress);
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_loading.erase(realPath);
+    }
+    loadResult.set_value(entry);
+    return entry;
+}
+
+std::shared_ptr<const HTTP::StaticFileCache::Entry> HTTP::StaticFileCache::loadFromDisk(const std::string &realPath, bool precompress)
+{
+    std::string directory = getParentDirectory(realPath);
+    uint64_t invalidationsBeforeLoad;
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        // Watch before reading, so a modification during the load is not lost.
+        if (!m_validateWithStat && !acquireWatchLocked(directory))
+        {
+            return nullptr;
+        }
+        invalidationsBeforeLoad = m_invalidations;
+    }
+
+    std::shared_ptr<Entry> entry = std::make_shared<Entry>();
+    entry->realPath = realPath;
+
+    bool loaded = false;
+    int fd = open(realPath.c_str(), O_RDONLY
+#ifdef O_CLOEXEC
+                                        | O_CLOEXEC
+#endif
+    );
+    if (fd != -1)
+    {
+        struct stat fileStats{};
+        if (fstat(fd, &fileStats) == 0 && S_ISREG(fileStats.st_mode) && static_cast<uint64_t>(fileStats.st_size) <= config.maxFileSize)
+        {
+            std::shared_ptr<std::string> content = std::make_shared<std::string>();
+            content->resize(static_cast<size_t>(fileStats.st_size));
+
+            size_t readBytes = 0;
+            while (readBytes < content->size())
+            {
+                ssize_t r = read(fd, content->data() + readBytes, content->size() - readBytes);
+                if (r <= 0)
+                {
+                    break;
+                }
+                readBytes += static_cast<size_t>(r);
+            }
+
+            if (readBytes == content->size())
+            {
+                loaded = true;
+
+                entry->device = fileStats.st_dev;
+                entry->inode = fileStats.st_ino;
+                entry->fileSize = fileStats.st_size;
+                entry->lastModified = fileStats.st_mtime;
+#ifdef _WIN32
+                entry->modificationTime.tv_sec = fileStats.st_mtime;
+#else
+                entry->modificationTime = fileStats.st_mtim;
+                entry->isExecutable = !access(realPath.c_str(), X_OK);
+#endif
+                std::string baseETag = computeETag(*content);
+                entry->identity.eTag = "\"" + baseETag + "\"";
+                entry->identity.data = content;
+
+                if (precompress && config.precompress && content->size() >= config.minCompressSize)
+                {
+                    // Only keep the representations that really save bytes:
+                    std::optional<std::string> compressed = Memory::Streams::Encoders::Deflate::compressString(*content, Memory::Streams::Encoders::Deflate::Format::GZIP,
+                                                                                                                config.gzipLevel);
+                    if (compressed && compressed->size() < content->size() - content->size() / 10)
+                    {
+                        entry->gzip.data = std::make_shared<std::string>(std::move(*compressed));
+                        entry->gzip.eTag = "\"" + baseETag + "-gz\"";
+                    }
+
+                    compressed = Memory::Streams::Encoders::Brotli::compressString(*content, config.brotliQuality);
+                    if (compressed && compressed->size() < content->size() - content->size() / 10)
+                    {
+                        entry->brotli.data = std::make_shared<std::string>(std::move(*compressed));
+                        entry->brotli.eTag = "\"" + baseETag + "-br\"";
+                    }
+                }
+            }
+        }
+        close(fd);
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    // Don't insert entries that could be modified while being loaded, or that can't fit:
+    if (!loaded || invalidationsBeforeLoad != m_invalidations || entry->getMemoryUsage() > config.maxTotalSize)
+    {
+        if (!m_validateWithStat)
+        {
+            releaseWatchLocked(directory);
+        }
+        return loaded ? entry : nullptr;
+    }
+
+    auto existing = m_entries.find(realPath);
+    if (existing != m_entries.end())
+    {
+        // Another thread loaded the same file.
+        removeLocked(existing);
+    }
+
+    m_lru.push_front(realPath);
+    m_entries[realPath] = {entry, m_lru.begin()};
+    m_totalSize += entry->getMemoryUsage();
+
+    // Evict the least recently used entries:
+    while (m_totalSize > config.maxTotalSize && !m_lru.empty())
+    {
+        removeLocked(m_entries.find(m_lru.back()));
+        m_evictions++;
+    }
+
+    return entry;
+}
+
+void HTTP::StaticFileCache::invalidate(const std::string &realPath)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    invalidateLocked(realPath);
+}
+
+void HTTP::StaticFileCache::clear()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_invalidations++;
+    while (!m_entries.empty())
+    {
+        removeLocked(m_entries.begin());
+    }
+}
+
+Json::Value HTTP::StaticFileCache::getStatisticsSnapshot()
+{
+    Json::Value snapshot;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    snapshot["entries"] = static_cast<Json::UInt64>(m_entries.size());
+    snapshot["memoryUsage"] = static_cast<Json::UInt64>(m_totalSize);
+    snapshot["maxMemoryUsage"] = static_cast<Json::UInt64>(config.maxTotalSize);
+    snapshot["hits"] = static_cast<Json::UInt64>(m_hits.load(std::memory_order_relaxed));
+    snapshot["misses"] = static_cast<Json::UInt64>(m_misses.load(std::memory_order_relaxed));
+    snapshot["evictions"] = static_cast<Json::UInt64>(m_evictions.load(std::memory_order_relaxed));
+    snapshot["invalidations"] = static_cast<Json::UInt64>(m_invalidations);
+    snapshot["watchedDirectories"] = static_cast<Json::UInt64>(m_watchedDirectories.size());
+    snapshot["validateWithStat"] = m_validateWithStat;
+    return snapshot;
+}
+
+std::string HTTP::StaticFileCache::getParentDirectory(const std::string &path)
+{
+    size_t pos = path.find_last_of("/\\");
+    if (pos == std::string::npos)
+    {
+        return ".";
+    }
+    return pos == 0 ? "/" : path.substr(0, pos);
+}
+
+std::string HTTP::StaticFileCache::computeETag(const std::string &data)
+{
+    // FNV-1a (64 bit), stable between processes/servers serving the same content.
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : data)
+    {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+
+    char eTag[64];
+    snprintf(eTag, sizeof(eTag), "%zx-%016llx", data.size(), static_cast<unsigned long long>(hash));
+    return eTag;
+}
+
+void HTTP::StaticFileCache::removeLocked(std::map<std::string, Slot>::iterator it)
+{
+    if (it == m_entries.end())
+    {
+        return;
+    }
+
+    m_totalSize -= it->second.entry->getMemoryUsage();
+    m_lru.erase(it->second.lruPosition);
+
+    if (!m_validateWithStat)
+    {
+        releaseWatchLocked(getParentDirectory(it->first));
+    }
+
+    m_entries.erase(it);
+}
+
+void HTTP::StaticFileCache::invalidateLocked(const std::string &realPath)
+{
+    m_invalidations++;
+
+    // The path itself:
+    removeLocked(m_entries.find(realPath));
+
+    // And everything under it (when it's a directory):
+    std::string prefix = realPath + "/";
+    for (auto it = m_entries.lower_bound(prefix); it != m_entries.end() && it->first.compare(0, prefix.size(), prefix) == 0;)
+    {
+        auto next = std::next(it);
+        removeLocked(it);
+        it = next;
+    }
+}
+
+bool HTTP::StaticFileCache::acquireWatchLocked(const std::string &directory)
+{
+#ifdef __linux__
+    auto it = m_watchedDirectories.find(directory);
+    if (it != m_watchedDirectories.end())
+    {
+        it->second.entries++;
+        return true;
+    }
+
+    int wd = inotify_add_watch(m_inotifyFD, directory.c_str(),
+                               IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR);
+    if (wd == -1)
+    {
+        return false;
+    }
+
+    m_watchedDirectories[directory] = {wd, 1};
+    m_watchDescriptors[wd] = directory;
+
+    if (!m_watcherThread.joinable())
+    {
+        m_watcherThread = std::thread(&StaticFileCache::watcherLoop, this);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void HTTP::StaticFileCache::releaseWatchLocked(const std::string &directory)
+{
+#ifdef __linux__
+    auto it = m_watchedDirectories.find(directory);
+    if (it == m_watchedDirectories.end())
+    {
+        return;
+    }
+
+    if (--it->second.entries == 0)
+    {
+        inotify_rm_watch(m_inotifyFD, it->second.watchDescriptor);
+        m_watchDescriptors.erase(it->second.watchDescriptor);
+        m_watchedDirectories.erase(it);
+    }
+#endif
+}
+
+void HTTP::StaticFileCache::watcherLoop()
+{
+#ifdef __linux__
+    alignas(struct inotify_event) char buffer[16384];
+
+    for (;;)
+    {
+        struct pollfd fds[2] = {{m_inotifyFD, POLLIN, 0}, {m_wakeupFD, POLLIN, 0}};
+        if (poll(fds, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+
+        if (fds[1].revents)
+        {
+            // Destroying the cache.
+            break;
+        }
+
+        ssize_t len = read(m_inotifyFD, buffer, sizeof(buffer));
+        if (len <= 0)
+        {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (char *ptr = buffer; ptr < buffer + len;)
+        {
+            const struct inotify_event *event = reinterpret_cast<const struct inotify_event *>(ptr);
+            ptr += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                // Events were lost, nothing can be trusted.
+                m_invalidations++;
+                while (!m_entries.empty())
+                {
+                    removeLocked(m_entries.begin());
+                }
+                continue;
+            }
+
+            auto wdIt = m_watchDescriptors.find(event->wd);
+            if (wdIt == m_watchDescriptors.end())
+            {
+                continue;
+            }
+            // Copy, the watch can be removed during the invalidation:
+            std::string directory = wdIt->second;
+
+            if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED))
+            {
+                invalidateLocked(directory);
+            }
+            else if (event->len)
+            {
+                invalidateLocked(directory == "/" ? (directory + event->name) : (directory + "/" + event->name));
+            }
+        }
+    }
+#endif
+}
+
+const HTTP::StaticFileCache::Representation &HTTP::StaticFileCache::Entry::getRepresentation(const Encoding &encoding) const
+{
+    switch (encoding)
+    {
+    case Encoding::GZIP:
+        return gzip.data ? gzip : identity;
+    case Encoding::BROTLI:
+        return brotli.data ? brotli : identity;
+    case Encoding::IDENTITY:
+    default:
+        return identity;
+    }
+}
+
+bool HTTP::StaticFileCache::Entry::hasRepresentation(const Encoding &encoding) const
+{
+    switch (encoding)
+    {
+    case Encoding::GZIP:
+        return gzip.data != nullptr;
+    case Encoding::BROTLI:
+        return brotli.data != nullptr;
+    case Encoding::IDENTITY:
+    default:
+        return identity.data != nullptr;
+    }
+}
+
+std::shared_ptr<Memory::Containers::B_MEM> HTTP::StaticFileCache::Entry::createStreamer(const Encoding &encoding) const
+{
+    std::shared_ptr<const std::string> data = getRepresentation(encoding).data;
+    if (!data)
+    {
+        return nullptr;
+    }
+
+    // The container references the cached data, the deleter keeps the data alive until the container is destroyed.
+    return std::shared_ptr<Memory::Containers::B_MEM>(new Memory::Containers::B_MEM(data->data(), static_cast<uint32_t>(data->size())),
+                                                      [data](Memory::Containers::B_MEM *container) { delete container; });
+}
+
+size_t HTTP::StaticFileCache::Entry::getMemoryUsage() const
+{
+    return (identity.data ? identity.data->size() : 0) + (gzip.data ? gzip.data->size() : 0) + (brotli.data ? brotli.data->size() : 0);
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <Mantids30/Memory/b_mem.h>
+
+#include <atomic>
+#include <ctime>
+#include <future>
+#include <json/json.h>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+
+namespace Mantids30::Network::Protocol::HTTP {
+
+/**
+ * @brief The StaticFileCache class keeps the content of the small static files in memory (shared between connections).
+ *
+ * Entries are keyed by the file real path and hold the raw bytes, the precompressed gzip/brotli representations, their
+ * strong ETags and the Last-Modified time, so cached files are served (or answered with 304) without touching the disk.
+ *
+ * The cache is bounded (LRU eviction by memory usage). On linux, the directories of the cached files are watched with
+ * inotify and any change invalidates the affected entries, elsewhere the entries are validated with stat on every hit.
+ *
+ * Concurrent loads of the same file are done once: the other threads wait for the result instead of reading and
+ * compressing the file again.
+ */
+class StaticFileCache
+{
+public:
+    enum class Encoding : uint8_t
+    {
+        IDENTITY,
+        GZIP,
+        BROTLI
+    };
+
+    struct Config
+    {
+        /**
+         * @brief maxTotalSize Max memory used by the cached entries (all the representations included).
+         */
+        size_t maxTotalSize = 64 * 1024 * 1024;
+        /**
+         * @brief maxFileSize Files bigger than this are not cached (they are memory mapped and sent from the disk).
+         */
+        size_t maxFileSize = 1024 * 1024;
+        /**
+         * @brief precompress Create the gzip/brotli representations for the compressible files (CPU intensive at load time).
+         */
+        bool precompress = false;
+        /**
+         * @brief minCompressSize Smaller files are not precompressed.
+         */
+        size_t minCompressSize = 256;
+        /**
+         * @brief gzipLevel gzip compression level (1-9).
+         */
+        int gzipLevel = 9;
+        /**
+         * @brief brotliQuality brotli compression quality (0-11).
+         */
+        int brotliQuality = 9;
+    };
+
+    struct Representation
+    {
+        std::shared_ptr<const std::string> data;
+        std::string eTag;
+    };
+
+    struct Entry
+    {
+        /**
+         * @brief getRepresentation Get the representation for the encoding (the identity one if not available)
+         */
+        [[nodiscard]] const Representation &getRepresentation(const Encoding &encoding) const;
+        /**
+         * @brief hasRepresentation Check if the encoding representation is available
+         */
+        [[nodiscard]] bool hasRepresentation(const Encoding &encoding) const;
+        /**
+         * @brief createStreamer Create a new memory container referencing the representation (keeps the data alive while it's being streamed)
+         */
+        [[nodiscard]] std::shared_ptr<Memory::Containers::B_MEM> createStreamer(const Encoding &encoding = Encoding::IDENTITY) const;
+        /**
+         * @brief getMemoryUsage Get the bytes used by all the representations
+         */
+        [[nodiscard]] size_t getMemoryUsage() const;
+
+        std::string realPath;
+        Representation identity, gzip, brotli;
+        time_t lastModified = 0;
+        bool isExecutable = false;
+
+        // Used to validate the entry when inotify is not available:
+        dev_t device = 0;
+        ino_t inode = 0;
+        off_t fileSize = 0;
+        struct timespec modificationTime = {};
+    };
+
+    StaticFileCache();
+    explicit StaticFileCache(const Config &config);
+    ~StaticFileCache();
+
+    StaticFileCache(const StaticFileCache &) = delete;
+    StaticFileCache &operator=(const StaticFileCache &) = delete;
+
+    /**
+     * @brief get Get the cached entry for the file.
+     * @param realPath file real path (already resolved)
+     * @return entry or nullptr if not cached
+     */
+    std::shared_ptr<const Entry> get(const std::string &realPath);
+    /**
+     * @brief load Read the file and put it in the cache (if the file is already being loaded, wait for that load).
+     * @param realPath file real path (already resolved)
+     * @param precompress create the compressed representations (should be true only for compressible content types)
+     * @return entry or nullptr if the file can't be cached (eg. too big, not a regular file or unreadable)
+     */
+    std::shared_ptr<const Entry> load(const std::string &realPath, bool precompress);
+    /**
+     * @brief invalidate Remove the file from the cache (and everything under it if it's a directory path)
+     */
+    void invalidate(const std::string &realPath);
+    /**
+     * @brief clear Remove all the entries
+     */
+    void clear();
+
+    /**
+     * @brief getStatisticsSnapshot Get the cache counters (entries, memory usage, hits, misses, evictions, invalidations)
+     */
+    [[nodiscard]] Json::Value getStatisticsSnapshot();
+
+    /**
+     * @brief config Cache limits (set before use)
+     */
+    Config config;
+
+private:
+    struct Slot
+    {
+        std::shared_ptr<Entry> entry;
+        std::list<std::string>::iterator lruPosition;
+    };
+
+    struct WatchedDirectory
+    {
+        int watchDescriptor = -1;
+        size_t entries = 0;
+    };
+
+    static std::string getParentDirectory(const std::string &path);
+    static std::string computeETag(const std::string &data);
+
+    std::shared_ptr<const Entry> loadFromDisk(const std::string &realPath, bool precompress);
+
+    void removeLocked(std::map<std::string, Slot>::iterator it);
+    void invalidateLocked(const std::string &realPath);
+
+    bool acquireWatchLocked(const std::string &directory);
+    void releaseWatchLocked(const std::string &directory);
+    void watcherLoop();
+
+    std::mutex m_mutex;
+    std::map<std::string, Slot> m_entries;
+    std::list<std::string> m_lru;
+    size_t m_totalSize = 0;
+
+    // Loads in progress (by file real path):
+    std::map<std::string, std::shared_future<std::shared_ptr<const Entry>>> m_loading;
+
+    // Invalidation events counter (to discard the entries loaded during a modification):
+    uint64_t m_invalidations = 0;
+
+    // Statistics:
+    std::atomic<uint64_t> m_hits{0};
+    std::atomic<uint64_t> m_misses{0};
+    std::atomic<uint64_t> m_evictions{0};
+
+    // Watcher:
+    bool m_validateWithStat = true;
+    int m_inotifyFD = -1;
+    int m_wakeupFD = -1;
+    std::thread m_watcherThread;
+    std::map<std::string, WatchedDirectory> m_watchedDirectories;
+    std::map<int, std::string> m_watchDescriptors;
+};
+
+} // namespace Mantids30::Network::Protocol::HTTP
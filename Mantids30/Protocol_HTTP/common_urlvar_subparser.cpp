@@ -8,10 +8,27 @@ using namespace Mantids30::Network::Protocol;
 
 using namespace Mantids30;
 
+namespace {
+
+// The delimiters are switched for every variable, their search tables are built once:
+const std::shared_ptr<const Memory::Search::MultiNeedle> &getNameDelimiters()
+{
+    static const std::shared_ptr<const Memory::Search::MultiNeedle> delimiters = std::make_shared<const Memory::Search::MultiNeedle>(std::list<std::string>{"=", "&"});
+    return delimiters;
+}
+
+const std::shared_ptr<const Memory::Search::MultiNeedle> &getValueDelimiters()
+{
+    static const std::shared_ptr<const Memory::Search::MultiNeedle> delimiters = std::make_shared<const Memory::Search::MultiNeedle>(std::list<std::string>{"&"});
+    return delimiters;
+}
+
+} // namespace
+
 HTTP::URLVarContent::URLVarContent()
 {
     setParseStrategy(Memory::Streams::SubParser::ParseStrategy::MULTIDELIMITER);
-    setParseMultiDelimiter({"=", "&"});
+    setParseMultiDelimiter(getNameDelimiters());
     setMaxObjectSize(4096);
     m_pData = std::make_shared<Memory::Containers::B_Chunks>();
     m_subParserName = "URLVarContent";
@@ -23,11 +40,11 @@ void HTTP::URLVarContent::setVarType(bool varName)
 {
     if (varName)
     {
-        setParseMultiDelimiter({"=", "&"}); // Parsing name...
+        setParseMultiDelimiter(getNameDelimiters()); // Parsing name...
     }
     else
     {
-        setParseMultiDelimiter({"&"}); // Parsing value...
+        setParseMultiDelimiter(getValueDelimiters()); // Parsing value...
     }
 }
 
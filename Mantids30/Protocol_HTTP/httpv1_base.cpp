@@ -1,5 +1,10 @@
 #include "httpv1_base.h"
 
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/trim.hpp>
+
 using namespace Mantids30::Network::Protocol;
 using namespace Mantids30;
 
@@ -31,3 +36,46 @@ void HTTP::HTTPv1_Base::setInternalProductVersion(const std::string &prodName, c
 {
     serverResponse.headers.replace("Server", prodName + "/" + std::to_string(versionMajor) + "." + std::to_string(versionMinor) + (!extraInfo.empty() ? (" " + extraInfo) : ""));
 }
+
+bool HTTP::HTTPv1_Base::Request::isContentEncodingAccepted(const std::string &coding) const
+{
+    std::string acceptEncoding = boost::to_lower_copy(getHeaderOption("Accept-Encoding"));
+    if (acceptEncoding.empty())
+    {
+        return false;
+    }
+
+    // eg. Accept-Encoding: gzip;q=0.8, br, *;q=0
+    std::optional<bool> codingAccepted, wildcardAccepted;
+
+    std::vector<std::string> elements;
+    boost::split(elements, acceptEncoding, boost::is_any_of(","));
+    for (std::string &element : elements)
+    {
+        std::string name = element.substr(0, element.find(';'));
+        boost::trim(name);
+
+        double qValue = 1.0;
+        size_t qPos = element.find("q=", name.size());
+        if (qPos != std::string::npos)
+        {
+            qValue = strtod(element.c_str() + qPos + 2, nullptr);
+        }
+
+        if (name == coding)
+        {
+            codingAccepted = qValue > 0;
+        }
+        else if (name == "*")
+        {
+            wildcardAccepted = qValue > 0;
+        }
+    }
+
+    if (codingAccepted)
+    {
+        return *codingAccepted;
+    }
+    return wildcardAccepted.value_or(false);
+}
+
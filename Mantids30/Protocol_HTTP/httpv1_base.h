@@ -185,6 +185,13 @@ public:
 
         std::string getReferer() const { return getHeaderOption("Referer"); }
 
+        /**
+         * @brief isContentEncodingAccepted Check if the client accepts a content coding in the Accept-Encoding header (q-values and * are considered)
+         * @param coding content coding in lowercase (eg. gzip, br, deflate)
+         * @return true if accepted (false if there is no Accept-Encoding header)
+         */
+        bool isContentEncodingAccepted(const std::string &coding) const;
+
         /**
          * @brief getCookie Get Cookie
          * @param sCookieName
@@ -313,6 +320,8 @@ public:
             {
                 // Set default headers (lost previous ones):
                 headers.remove("Last-Modified");
+                headers.remove("ETag");
+                headers.remove("Content-Encoding");
                 cacheControl = Headers::CacheControl();
                 cacheControl.optionNoCache = true;
                 cacheControl.optionNoStore = true;
@@ -450,6 +459,11 @@ public:
          * Useful for server logging, cache management, and debugging.
          */
         bool includeDate = true;
+
+        /**
+         * @brief allowCompression Allow the server to compress this response content (set to false for live streams or already optimized content)
+         */
+        bool allowCompression = true;
     };
 
     HTTPv1_Base(bool clientMode, const std::shared_ptr<Memory::Streams::StreamableObject> &sobject);
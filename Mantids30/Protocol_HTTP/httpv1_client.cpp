@@ -25,6 +25,9 @@ HTTP::HTTPv1_Client::HTTPv1_Client(const std::shared_ptr<Memory::Streams::Stream
 
 bool HTTP::HTTPv1_Client::initProtocol()
 {
+    // Send the request line, headers and content together:
+    Memory::Streams::StreamCork requestCork(m_streamableObject.get());
+
     if (!clientRequest.requestLine.streamToUpstream())
     {
         return false;
@@ -33,13 +36,18 @@ bool HTTP::HTTPv1_Client::initProtocol()
     {
         return false;
     }
+    // Content without a known size can be a live stream, don't hold it:
+    if (clientRequest.content.getStreamSize() == std::numeric_limits<size_t>::max() && !requestCork.uncork())
+    {
+        return false;
+    }
     if (!clientRequest.content.streamToUpstream())
     {
         return false;
     }
 
     // Succesfully initialized...
-    return true;
+    return requestCork.uncork();
 }
 
 bool HTTP::HTTPv1_Client::changeToNextParser()
@@ -106,7 +114,7 @@ void HTTP::HTTPv1_Client::parseHeaders2ServerCookies()
     std::list<std::shared_ptr<MIME::MIME_HeaderOption>> setCookies = serverResponse.headers.getOptionsByName("");
     for (const std::shared_ptr<MIME::MIME_HeaderOption> &serverCookie : setCookies)
     {
-        serverResponse.cookies.parseCookie(serverCookie->getOrigValue());
+        serverResponse.cookies.parseCookie(std::string(serverCookie->getOrigValue()));
     }
 }
 
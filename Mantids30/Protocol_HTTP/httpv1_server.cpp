@@ -73,7 +73,16 @@ bool HTTP::HTTPv1_Server::changeToNextParser()
 void HTTP::HTTPv1_Server::reset()
 {
     // Reset all components except for connection-related information, which should remain static.
+    std::string preservedServerName = serverResponse.headers.getOptionRawStringByName("Server");
     serverResponse = Response();
+    if (!preservedServerName.empty())
+    {
+        serverResponse.setServerName(preservedServerName);
+    }
+    serverResponse.cacheControl.optionNoCache = true;
+    serverResponse.cacheControl.optionNoStore = true;
+    serverResponse.cacheControl.optionMustRevalidate = true;
+
     HTTPv1_Base::Request::NetworkClientInfo preservedClientInfo = clientRequest.networkClientInfo;
     clientRequest = Request();
     clientRequest.networkClientInfo = preservedClientInfo;
@@ -101,10 +110,10 @@ bool HTTP::HTTPv1_Server::changeToNextParserFromClientHeaders()
         return sendFullHTTPResponse();
     }
 
-    size_t headerIncommingContentLength;
+    bool expectsContent;
 
     // Gets the content length and create the container that will receive the data.
-    if (!setupContentHandling(headerIncommingContentLength))
+    if (!setupContentHandling(expectsContent))
     {
         connectionContinue = false;
         return sendFullHTTPResponse();
@@ -135,7 +144,7 @@ bool HTTP::HTTPv1_Server::changeToNextParserFromClientHeaders()
             return true;
         }
 
-        if (headerIncommingContentLength == 0)
+        if (!expectsContent)
         {
             // No body expected, pass to the next phase.
             return changeToNextParserFromClientContentData();
@@ -196,6 +205,12 @@ bool HTTP::HTTPv1_Server::changeToNextParserFromClientHeaders()
  */
 bool HTTP::HTTPv1_Server::changeToNextParserFromClientRequestLine()
 {
+    if (m_servedRequestsCount > 0)
+    {
+        // A new request arrived on the persistent connection, it's not idle anymore.
+        onHTTPKeepAliveIdleStateChanged(false);
+    }
+
     // Request-line parsed; validate URI and HTTP version before reading headers.
     if (!prepareServerVersionOnURI())
     {
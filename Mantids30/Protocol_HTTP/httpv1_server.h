@@ -1,5 +1,6 @@
 #pragma once
 
+#include "common_staticfilecache.h"
 #include "httpv1_base.h"
 
 #include "websocket_framecontent.h"
@@ -8,6 +9,7 @@
 #include <atomic>
 #include <json/value.h>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #ifdef _WIN32
@@ -48,6 +50,33 @@ public:
         bool isExecutable = false;
         bool isTransversal = false;
         bool exists = false;
+        /**
+         * @brief cachedFile The file entry when it's served from the static file cache (nullptr otherwise).
+         */
+        std::shared_ptr<const StaticFileCache::Entry> cachedFile;
+    };
+
+    /**
+     * @brief HTTP/1.1 persistent connection (keep-alive) parameters.
+     */
+    struct KeepAliveParameters
+    {
+        bool enabled = true;                      ///< Whether the connection can be reused for further requests.
+        uint32_t idleTimeoutInSeconds = 15;       ///< Max time waiting for the next request after a response (0: use the socket read timeout).
+        uint32_t maxRequestsPerConnection = 100;  ///< Max requests served over the same connection (0: unlimited).
+        size_t maxIdleCachedBufferBytes = 256 * 1024; ///< Container buffers kept by the connection thread for the next request (Memory::Containers::SlabPool), the rest is released when the connection goes idle.
+    };
+
+    /**
+     * @brief HTTP response compression (Content-Encoding) parameters.
+     */
+    struct CompressionParameters
+    {
+        bool enabled = true;                      ///< Compress the compressible responses when the client accepts it (Accept-Encoding).
+        size_t minSize = 1024;                    ///< Smaller responses are sent uncompressed.
+        size_t maxBufferedSize = 1024 * 1024;     ///< Responses up to this size are compressed before sending (Content-Length), bigger/undefined ones are compressed while streaming (chunked).
+        int gzipLevel = 6;                        ///< gzip/deflate compression level (1-9).
+        int brotliQuality = 4;                    ///< brotli compression quality (0-11).
     };
 
     HTTPv1_Server(const std::shared_ptr<Memory::Streams::StreamableObject> &connectionStream);
@@ -100,11 +129,37 @@ public:
      */
     static std::string htmlEncode(const std::string &rawStr);
 
+    /**
+     * @brief isCompressibleContentType Check if the content type is worth to be compressed (text, json, xml, svg, etc.)
+     * @param contentType content type (eg. text/html; charset=utf-8)
+     * @return true if compressible (false for already compressed formats like images, audio, video or archives)
+     */
+    static bool isCompressibleContentType(const std::string &contentType);
+
+    /**
+     * @brief setStaticFileCache Set the (shared) cache used to serve the files resolved by resolveLocalFilePathFromURI2
+     * @param cache static file cache, or nullptr to map the files from the disk on every request.
+     */
+    void setStaticFileCache(const std::shared_ptr<StaticFileCache> &cache) { m_staticFileCache = cache; }
+    /**
+     * @brief getStaticFileCache Get the static file cache (can be nullptr)
+     */
+    std::shared_ptr<StaticFileCache> getStaticFileCache() const { return m_staticFileCache; }
+
     bool sendWebSocketText(const std::string &data);
     bool sendWebSocketText(const char *data, const size_t &len);
     bool sendWebSocketBinaryData(const char *data, const size_t &len);
     bool sendWebSocketPing(const char *data, size_t len);
 
+    /**
+     * @brief keepAlive Persistent connection parameters (set before parsing the connection).
+     */
+    KeepAliveParameters keepAlive;
+    /**
+     * @brief compression Response compression parameters (set before parsing the connection).
+     */
+    CompressionParameters compression;
+
 protected:
     virtual void log(Json::Value &jWebLog) {}
 
@@ -134,6 +189,21 @@ protected:
     * @return HTTP Status Code (will be delivered in the HTTP Response Header)
     */
     virtual Mantids30::Network::Protocol::HTTP::Status::Code onHTTPClientContentReceived() { return HTTP::Status::Code::S_200_OK; }
+    /**
+    * @brief onHTTPKeepAliveIdleStateChanged Virtual function called when the persistent connection enters or leaves the idle
+    *                             state (waiting for the next request). Override it to apply keepAlive.idleTimeoutInSeconds
+    *                             to the underlying connection.
+    * @param idle true when the response was sent and the next request line is awaited, false when the next request arrived.
+    */
+    virtual void onHTTPKeepAliveIdleStateChanged(bool idle) {}
+    /**
+    * @brief isStaticContentTypeRendered Virtual function called when a local file is loaded into the static file cache, to know
+    *                             if the files of this content type are rendered by the server (eg. templates) instead of being
+    *                             sent as they are (their compressed representations would never be used).
+    * @param contentType content type of the resolved file
+    * @return true if the file content is processed before being sent.
+    */
+    virtual bool isStaticContentTypeRendered(const std::string &contentType) { return false; }
 
     void *getThis() override { return this; }
     bool changeToNextParser() override;
@@ -151,6 +221,35 @@ protected:
     bool resolveLocalFilePathFromURI2(std::string defaultWebRootWithEndingSlash, const std::list<std::pair<std::string, std::string>> &overlappedDirectories, LocalRequestedFileInfo *info,
                                       const std::string &defaultFileToAppend = "", const bool &preventMappingExecutables = false);
 
+    /**
+     * @brief prepareCachedFileResponse Select the cached file representation (gzip/brotli/identity) accepted by the client, set the ETag, and
+     *                                  evaluate the conditional request headers (If-None-Match / If-Modified-Since) without touching the disk.
+     * @param info resolved file information (with the cachedFile entry)
+     * @return S_304_NOT_MODIFIED if the client copy is still valid (no content will be sent), S_200_OK otherwise
+     */
+    Status::Code prepareCachedFileResponse(const LocalRequestedFileInfo &info);
+
+    /**
+     * @brief prepareRangeResponse Evaluate the Range/If-Range request headers over the current (fixed size) response content, and
+     *                             replace it by the requested byte ranges (single range or multipart/byteranges).
+     *                             Ranges are only served (and advertised) when the content is not going to be compressed.
+     * @return S_206_PARTIAL_CONTENT if the content was replaced by the ranges, S_416_RANGE_NOT_SATISFIABLE if no range can be served,
+     *         S_200_OK to serve the whole content.
+     */
+    Status::Code prepareRangeResponse();
+
+    /**
+     * @brief prepareCompressedResponse Compress the response content with the best encoding accepted by the client (br, gzip or deflate),
+     *                                  only for successful responses with compressible content types and above the minimum size.
+     * @return true if the response content was replaced by the compressed one.
+     */
+    bool prepareCompressedResponse();
+    /**
+     * @brief selectResponseContentCoding Get the content coding (br, gzip or deflate) that will compress the current response content.
+     * @return the content coding, or an empty string if the content will be sent as is.
+     */
+    std::string selectResponseContentCoding();
+
     /**
      * @brief resolveLocalFilePathFromURI0NE Only Get the local and relative path from the URL for non-existent file, it also checks for transversal escape attempts
      * @param sServerDir URI
@@ -256,6 +355,8 @@ private:
 
     bool sendHTTPHeadersResponse();
     bool prepareServerVersionOnURI();
+    bool isKeepAliveRequestedByClient();
+    bool prepareKeepAliveResponseHeaders();
     bool sendFullHTTPResponse();
 
     // WebSocket:
@@ -271,18 +372,23 @@ private:
     void parseAuthenticationHeaders();
     bool parseBasicAuth(const std::string &authHeader);
     void parseUserAgent();
-    bool setupContentHandling(size_t &contentLength);
+    bool setupContentHandling(bool &expectsContent);
 
     void fillLogInformation(Json::Value &logValues);
 
     /////
     std::map<std::string, std::shared_ptr<Mantids30::Memory::Containers::B_MEM>> m_staticContentElements;
+    std::shared_ptr<StaticFileCache> m_staticFileCache;
 
     std::string m_currentFileExtension;
     std::map<std::string, std::string> m_mimeTypes;
     void loadDefaultMIMETypes();
 
     bool connectionContinue = true, prohibitConnectionUpgrade = false;
+    uint32_t m_servedRequestsCount = 0;
+
+    // Serializes the WebSocket frames (and the socket cork) between the threads sending to this connection:
+    std::mutex m_webSocketWriteMutex;
 };
 
 } // namespace Mantids30::Network::Protocol::HTTP
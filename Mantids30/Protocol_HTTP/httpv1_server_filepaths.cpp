@@ -1,4 +1,5 @@
 #include "httpv1_server.h"
+#include "common_byteranges.h"
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -143,8 +144,16 @@ bool HTTP::HTTPv1_Server::resolveLocalFilePathFromURI2(string defaultWebRootWith
                     selectedOverlap.fileSystemRealPath = cFullPath;
                     free(cFullPath);
 
-                    // Check file properties...
-                    stat(selectedOverlap.fileSystemRealPath.c_str(), &selectedOverlap.fileStats);
+                    // Check file properties (cached files are known regular files, no need to stat them again)...
+                    if (m_staticFileCache && (info->cachedFile = m_staticFileCache->get(selectedOverlap.fileSystemRealPath)) != nullptr)
+                    {
+                        selectedOverlap.fileStats = {};
+                        selectedOverlap.fileStats.st_mode = S_IFREG;
+                    }
+                    else
+                    {
+                        stat(selectedOverlap.fileSystemRealPath.c_str(), &selectedOverlap.fileStats);
+                    }
 
                     // Put a slash at the end of the computed dir resource (when dir)...
                     if ((info->isDirectory = S_ISDIR(selectedOverlap.fileStats.st_mode)) == true)
@@ -199,7 +208,7 @@ bool HTTP::HTTPv1_Server::resolveLocalFilePathFromURI2(string defaultWebRootWith
 
         if (preventMappingExecutables &&
 #ifndef _WIN32
-            !access(selectedOverlap.fileSystemRealPath.c_str(), X_OK)
+            (info->cachedFile ? info->cachedFile->isExecutable : !access(selectedOverlap.fileSystemRealPath.c_str(), X_OK))
 #else
             (boost::iends_with(requestedPathInfo.fsPath, ".exe") || boost::iends_with(requestedPathInfo.fsPath, ".bat") || boost::iends_with(requestedPathInfo.fsPath, ".com"))
 #endif
@@ -215,34 +224,50 @@ bool HTTP::HTTPv1_Server::resolveLocalFilePathFromURI2(string defaultWebRootWith
         }
         else
         {
-            std::shared_ptr<Mantids30::Memory::Containers::B_MMAP> fileMemoryMap = std::make_shared<Mantids30::Memory::Containers::B_MMAP>();
-            if (fileMemoryMap->referenceFile(selectedOverlap.fileSystemRealPath.c_str(), true, false))
+            info->fullPath = selectedOverlap.fileSystemRealPath;
+            info->relativePath = selectedOverlap.getRelativePath();
+            detectContentTypeFromFilePath(info->relativePath);
+
+            // Small files are kept in memory (with their precompressed representations):
+            if (!info->cachedFile && m_staticFileCache)
+            {
+                info->cachedFile = m_staticFileCache->load(selectedOverlap.fileSystemRealPath,
+                                                           isCompressibleContentType(serverResponse.contentType) && !isStaticContentTypeRendered(serverResponse.contentType));
+            }
+
+            HTTP::Date fileModificationDate;
+            if (info->cachedFile)
+            {
+                serverResponse.setDataStreamer(info->cachedFile->createStreamer());
+                fileModificationDate.setUnixTime(info->cachedFile->lastModified);
+            }
+            else
             {
+                std::shared_ptr<Mantids30::Memory::Containers::B_MMAP> fileMemoryMap = std::make_shared<Mantids30::Memory::Containers::B_MMAP>();
+                if (!fileMemoryMap->referenceFile(selectedOverlap.fileSystemRealPath.c_str(), true, false))
+                {
+                    return false;
+                }
                 // File Found / Readable.
-                info->fullPath = selectedOverlap.fileSystemRealPath;
-                info->relativePath = selectedOverlap.getRelativePath();
                 serverResponse.setDataStreamer(fileMemoryMap);
-                detectContentTypeFromFilePath(info->relativePath);
-
-                HTTP::Date fileModificationDate;
 #ifdef _WIN32
                 fileModificationDate.setUnixTime(selectedPathInfo.fileStats.st_mtime);
 #else
                 fileModificationDate.setUnixTime(selectedOverlap.fileStats.st_mtim.tv_sec);
 #endif
-                if (serverResponse.includeDate)
-                {
-                    serverResponse.headers.add("Last-Modified", fileModificationDate.toString());
-                }
+            }
 
-                serverResponse.cacheControl.optionNoCache = false;
-                serverResponse.cacheControl.optionNoStore = false;
-                serverResponse.cacheControl.optionMustRevalidate = false;
-                serverResponse.cacheControl.maxAge = 3600;
-                serverResponse.cacheControl.optionImmutable = true;
-                return true;
+            if (serverResponse.includeDate)
+            {
+                serverResponse.headers.add("Last-Modified", fileModificationDate.toString());
             }
-            return false;
+
+            serverResponse.cacheControl.optionNoCache = false;
+            serverResponse.cacheControl.optionNoStore = false;
+            serverResponse.cacheControl.optionMustRevalidate = false;
+            serverResponse.cacheControl.maxAge = 3600;
+            serverResponse.cacheControl.optionImmutable = true;
+            return true;
         }
     }
     else
@@ -386,3 +411,164 @@ bool HTTP::HTTPv1_Server::resolveLocalFilePathFromURI0E(const std::string &uri,
 
     return true;
 }
+
+HTTP::Status::Code HTTP::HTTPv1_Server::prepareCachedFileResponse(const LocalRequestedFileInfo &info)
+{
+    if (!info.cachedFile)
+    {
+        return HTTP::Status::Code::S_200_OK;
+    }
+
+    const StaticFileCache::Entry &entry = *info.cachedFile;
+
+    // Select the smallest representation accepted by the client:
+    StaticFileCache::Encoding encoding = StaticFileCache::Encoding::IDENTITY;
+    if (entry.hasRepresentation(StaticFileCache::Encoding::BROTLI) && clientRequest.isContentEncodingAccepted("br"))
+    {
+        encoding = StaticFileCache::Encoding::BROTLI;
+    }
+    else if (entry.hasRepresentation(StaticFileCache::Encoding::GZIP) && clientRequest.isContentEncodingAccepted("gzip"))
+    {
+        encoding = StaticFileCache::Encoding::GZIP;
+    }
+
+    if (entry.hasRepresentation(StaticFileCache::Encoding::BROTLI) || entry.hasRepresentation(StaticFileCache::Encoding::GZIP))
+    {
+        // Caches should not mix the representations:
+        serverResponse.headers.replace("Vary", "Accept-Encoding");
+    }
+
+    switch (encoding)
+    {
+    case StaticFileCache::Encoding::BROTLI:
+        serverResponse.headers.replace("Content-Encoding", "br");
+        break;
+    case StaticFileCache::Encoding::GZIP:
+        serverResponse.headers.replace("Content-Encoding", "gzip");
+        break;
+    case StaticFileCache::Encoding::IDENTITY:
+        serverResponse.headers.remove("Content-Encoding");
+        break;
+    }
+
+    // The compressible representations were already compressed (if it was worth it):
+    if (m_staticFileCache && m_staticFileCache->config.precompress)
+    {
+        serverResponse.allowCompression = false;
+    }
+
+    const StaticFileCache::Representation &representation = entry.getRepresentation(encoding);
+    serverResponse.headers.replace("ETag", representation.eTag);
+    serverResponse.setDataStreamer(entry.createStreamer(encoding));
+
+    // Conditional request (If-None-Match has precedence over If-Modified-Since):
+    bool notModified = false;
+    if (clientRequest.headers.exist("If-None-Match"))
+    {
+        std::vector<std::string> eTags;
+        boost::split(eTags, clientRequest.getHeaderOption("If-None-Match"), boost::is_any_of(","));
+        for (std::string &eTag : eTags)
+        {
+            boost::trim(eTag);
+            // Weak comparison (RFC 9110 13.1.2):
+            if (boost::starts_with(eTag, "W/"))
+            {
+                eTag = eTag.substr(2);
+            }
+            if (eTag == "*" || eTag == representation.eTag)
+            {
+                notModified = true;
+                break;
+            }
+        }
+    }
+    else if (clientRequest.headers.exist("If-Modified-Since"))
+    {
+        HTTP::Date modifiedSince;
+        notModified = modifiedSince.fromString(clientRequest.getHeaderOption("If-Modified-Since")) && entry.lastModified <= modifiedSince.getUnixTime();
+    }
+
+    if (notModified)
+    {
+        // Keep the headers, discard the content:
+        serverResponse.content.setStreamableObj(nullptr);
+        return HTTP::Status::Code::S_304_NOT_MODIFIED;
+    }
+
+    return HTTP::Status::Code::S_200_OK;
+}
+
+HTTP::Status::Code HTTP::HTTPv1_Server::prepareRangeResponse()
+{
+    // Ranges can only be served over fixed size containers:
+    std::shared_ptr<Memory::Containers::B_Base> source = std::dynamic_pointer_cast<Memory::Containers::B_Base>(serverResponse.content.getStreamableObject());
+    if (!source)
+    {
+        return HTTP::Status::Code::S_200_OK;
+    }
+
+    // The compressed responses can't be served by ranges (they would be over the identity content), only the identity ones
+    // advertise them:
+    if (!selectResponseContentCoding().empty())
+    {
+        return HTTP::Status::Code::S_200_OK;
+    }
+
+    serverResponse.headers.replace("Accept-Ranges", "bytes");
+
+    if (clientRequest.requestLine.getHTTPMethod() != "GET" || !clientRequest.headers.exist("Range"))
+    {
+        return HTTP::Status::Code::S_200_OK;
+    }
+
+    if (clientRequest.headers.exist("If-Range"))
+    {
+        // The ranges are only served if the client copy is the current one, otherwise the whole content is sent.
+        std::string ifRange = boost::trim_copy(clientRequest.getHeaderOption("If-Range"));
+        bool isCurrent = false;
+        if (boost::starts_with(ifRange, "\""))
+        {
+            // Strong comparison (weak tags never match):
+            isCurrent = ifRange == serverResponse.headers.getOptionRawStringByName("ETag");
+        }
+        else if (!boost::starts_with(ifRange, "W/"))
+        {
+            HTTP::Date ifRangeDate, lastModifiedDate;
+            isCurrent = ifRangeDate.fromString(ifRange) && lastModifiedDate.fromString(serverResponse.headers.getOptionRawStringByName("Last-Modified"))
+                        && ifRangeDate.getUnixTime() == lastModifiedDate.getUnixTime();
+        }
+
+        if (!isCurrent)
+        {
+            return HTTP::Status::Code::S_200_OK;
+        }
+    }
+
+    size_t representationSize = source->size();
+    std::optional<std::vector<ByteRangesStreamer::Range>> ranges = ByteRangesStreamer::parseRangeHeader(clientRequest.getHeaderOption("Range"), representationSize);
+    if (!ranges)
+    {
+        // Invalid/unsupported range header, ignored.
+        return HTTP::Status::Code::S_200_OK;
+    }
+
+    if (ranges->empty())
+    {
+        serverResponse.content.setStreamableObj(nullptr);
+        serverResponse.headers.replace("Content-Range", "bytes */" + std::to_string(representationSize));
+        return HTTP::Status::Code::S_416_RANGE_NOT_SATISFIABLE;
+    }
+
+    std::shared_ptr<ByteRangesStreamer> rangesStreamer = std::make_shared<ByteRangesStreamer>(source, *ranges, serverResponse.contentType);
+    if (rangesStreamer->isMultipart())
+    {
+        serverResponse.setContentType(rangesStreamer->getMultipartContentType(), serverResponse.security.disableNoSniffContentType);
+    }
+    else
+    {
+        serverResponse.headers.replace("Content-Range", ByteRangesStreamer::getContentRange(ranges->front(), representationSize));
+    }
+    serverResponse.setDataStreamer(rangesStreamer);
+
+    return HTTP::Status::Code::S_206_PARTIAL_CONTENT;
+}
@@ -103,16 +103,24 @@ void HTTP::HTTPv1_Server::parseUserAgent()
     }
 }
 
-// Parse Content-Length and Content-Type headers
-bool HTTP::HTTPv1_Server::setupContentHandling(size_t &contentLength)
+// Parse Content-Length, Transfer-Encoding and Content-Type headers
+bool HTTP::HTTPv1_Server::setupContentHandling(bool &expectsContent)
 {
     // Initialize in zero:
     clientRequest.content.setCurrentSize(0);
+    expectsContent = false;
 
     // Extract payload size and content type hints from headers.
-    contentLength = clientRequest.headers.getOptionAsUINT64("Content-Length");
+    size_t contentLength = clientRequest.headers.getOptionAsUINT64("Content-Length");
     string contentType = clientRequest.headers.getOptionValueStringByName("Content-Type");
-    if (contentLength)
+
+    if (boost::icontains(clientRequest.headers.getOptionValueStringByName("Transfer-Encoding"), "chunked"))
+    {
+        // Chunked bodies end with the last (zero-sized) chunk, so the connection can be reused after them.
+        // (Transfer-Encoding overrides Content-Length)
+        clientRequest.content.setTransmissionMode(HTTP::Content::TransmissionMode::CHUNKS);
+    }
+    else if (contentLength)
     {
         clientRequest.content.setTransmissionMode(HTTP::Content::TransmissionMode::CONTENT_LENGTH);
         if (!clientRequest.content.setCurrentSize(contentLength))
@@ -121,24 +129,31 @@ bool HTTP::HTTPv1_Server::setupContentHandling(size_t &contentLength)
             serverResponse.status.setCode(HTTP::Status::Code::S_413_PAYLOAD_TOO_LARGE);
             return false;
         }
-        if (boost::icontains(contentType, "multipart/form-data"))
-        {
-            clientRequest.content.setContainerType(HTTP::Content::ContainerType::MIME);
-            clientRequest.content.getMultiPartVars()->setMultiPartBoundary(clientRequest.headers.getOptionByName("Content-Type")->getSubVar("boundary"));
-        }
-        else if (boost::icontains(contentType, "application/x-www-form-urlencoded"))
-        {
-            clientRequest.content.setContainerType(HTTP::Content::ContainerType::URL);
-        }
-        else if (boost::icontains(contentType, "application/json"))
-        {
-            clientRequest.content.setContainerType(HTTP::Content::ContainerType::JSON);
-        }
-        else
-        {
-            clientRequest.content.setContainerType(HTTP::Content::ContainerType::BIN);
-        }
-        /////////////////////////////////////////////////////////////////////////////////////
+    }
+    else
+    {
+        // No content.
+        return true;
+    }
+
+    expectsContent = true;
+
+    if (boost::icontains(contentType, "multipart/form-data"))
+    {
+        clientRequest.content.setContainerType(HTTP::Content::ContainerType::MIME);
+        clientRequest.content.getMultiPartVars()->setMultiPartBoundary(clientRequest.headers.getOptionByName("Content-Type")->getSubVar("boundary"));
+    }
+    else if (boost::icontains(contentType, "application/x-www-form-urlencoded"))
+    {
+        clientRequest.content.setContainerType(HTTP::Content::ContainerType::URL);
+    }
+    else if (boost::icontains(contentType, "application/json"))
+    {
+        clientRequest.content.setContainerType(HTTP::Content::ContainerType::JSON);
+    }
+    else
+    {
+        clientRequest.content.setContainerType(HTTP::Content::ContainerType::BIN);
     }
     return true;
 }
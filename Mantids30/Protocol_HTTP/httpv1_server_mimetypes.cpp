@@ -1,5 +1,8 @@
 #include "httpv1_server.h"
 #include <boost/algorithm/string/case_conv.hpp>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <set>
 
 using namespace Mantids30::Network::Protocol;
 using namespace Mantids30::Network;
@@ -32,6 +35,21 @@ bool HTTP::HTTPv1_Server::detectContentTypeFromFilePath(const string &sFilePath)
     return false;
 }
 
+bool HTTP::HTTPv1_Server::isCompressibleContentType(const std::string &contentType)
+{
+    // Without parameters (eg. text/html; charset=utf-8)
+    std::string mediaType = boost::to_lower_copy(contentType.substr(0, contentType.find(';')));
+    boost::trim(mediaType);
+
+    // Already compressed formats (images, audio, video, archives, woff fonts) are not worth to be compressed again.
+    static const std::set<std::string> compressibleTypes = {"application/javascript", "application/json", "application/xml", "application/wasm", "application/rtf", "application/x-sh",
+                                                            "application/x-csh", "application/vnd.ms-fontobject", "font/ttf", "font/otf", "image/svg+xml", "image/bmp", "image/x-icon",
+                                                            "image/vnd.microsoft.icon"};
+
+    return boost::starts_with(mediaType, "text/") || boost::ends_with(mediaType, "+json") || boost::ends_with(mediaType, "+xml")
+           || compressibleTypes.find(mediaType) != compressibleTypes.end();
+}
+
 std::string HTTP::HTTPv1_Server::getCurrentFileExtension() const
 {
     return m_currentFileExtension;
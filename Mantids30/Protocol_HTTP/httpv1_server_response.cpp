@@ -1,4 +1,11 @@
 #include "httpv1_server.h"
+#include "common_encodedcontent.h"
+#include "streamencoder_brotli.h"
+#include "streamencoder_deflate.h"
+
+#include <Mantids30/Memory/slabpool.h>
+#include <Mantids30/Memory/streamable_string.h>
+#include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/predicate.hpp>
 
 using namespace Mantids30::Network::Protocol;
@@ -25,22 +32,29 @@ void HTTP::HTTPv1_Server::fillLogInformation(Json::Value &jWebLog)
 
 bool HTTP::HTTPv1_Server::sendFullHTTPResponse()
 {
+    prepareCompressedResponse();
+
     Json::Value jWebLog;
     fillLogInformation(jWebLog);
     log(jWebLog);
 
+    m_servedRequestsCount++;
+
     // The answer is the last thing... we move to the start or we drop the connection...
-    if (connectionContinue && clientRequest.getHeaderOption("Connection") != "close")
+    if (prepareKeepAliveResponseHeaders())
     {
         m_currentSubParser = &clientRequest.requestLine;
         prohibitConnectionUpgrade = true;
     }
     else
     {
+        connectionContinue = false;
         m_currentSubParser = nullptr;
-        serverResponse.headers.replace("Connection", "close");
     }
 
+    // Send the status, headers and content together (fewer system calls/segments):
+    Memory::Streams::StreamCork responseCork(m_streamableObject.get());
+
     if (!serverResponse.status.streamToUpstream())
     {
         // Bye... upstream failed.
@@ -56,8 +70,16 @@ bool HTTP::HTTPv1_Server::sendFullHTTPResponse()
         return false;
     }
 
+    // Content without a known size can be a live stream, don't hold it:
+    if (serverResponse.content.getStreamSize() == std::numeric_limits<size_t>::max() && !responseCork.uncork())
+    {
+        m_currentSubParser = nullptr;
+        return false;
+    }
+
     // Stream content:
     bool streamedOK = serverResponse.content.streamToUpstream();
+    streamedOK = responseCork.uncork() && streamedOK;
 
     // Destroy the binary content container here:
     serverResponse.content.setStreamableObj(nullptr);
@@ -69,15 +91,175 @@ bool HTTP::HTTPv1_Server::sendFullHTTPResponse()
     }
 
     // Prepare the HTTP server for the next request...
-    if (connectionContinue)
+    if (connectionContinue && streamedOK)
     {
         // Here we reset everything to the default values...
         reset();
+        // The request containers are gone, keep only a bounded amount of their buffers for the next request.
+        Memory::Containers::SlabPool::trimThreadCache(keepAlive.maxIdleCachedBufferBytes);
+        // Now we are waiting for the next request in the same connection.
+        onHTTPKeepAliveIdleStateChanged(true);
     }
 
     return streamedOK;
 }
 
+std::string HTTP::HTTPv1_Server::selectResponseContentCoding()
+{
+    if (!compression.enabled || !serverResponse.allowCompression || clientRequest.requestLine.getHTTPMethod() == "HEAD" || serverResponse.headers.exist("Content-Encoding")
+        || !isCompressibleContentType(serverResponse.contentType) || boost::istarts_with(serverResponse.contentType, "text/event-stream"))
+    {
+        return "";
+    }
+
+    std::shared_ptr<Memory::Streams::StreamableObject> source = serverResponse.content.getStreamableObject();
+    if (!source || source->size() < compression.minSize)
+    {
+        return "";
+    }
+
+    if (Memory::Streams::Encoders::Brotli::isAvailable() && clientRequest.isContentEncodingAccepted("br"))
+    {
+        return "br";
+    }
+    if (clientRequest.isContentEncodingAccepted("gzip"))
+    {
+        return "gzip";
+    }
+    if (clientRequest.isContentEncodingAccepted("deflate"))
+    {
+        return "deflate";
+    }
+    return "";
+}
+
+bool HTTP::HTTPv1_Server::prepareCompressedResponse()
+{
+    uint16_t statusCode = static_cast<uint16_t>(serverResponse.status.getCode());
+
+    if (statusCode < 200 || statusCode >= 300 || serverResponse.status.getCode() == HTTP::Status::Code::S_204_NO_CONTENT
+        || serverResponse.status.getCode() == HTTP::Status::Code::S_206_PARTIAL_CONTENT)
+    {
+        return false;
+    }
+
+    std::string contentCoding = selectResponseContentCoding();
+    if (contentCoding.empty())
+    {
+        return false;
+    }
+
+    std::shared_ptr<Memory::Streams::StreamableObject> source = serverResponse.content.getStreamableObject();
+    size_t contentSize = source->size();
+
+    std::unique_ptr<Memory::Streams::StreamableTransformer> encoder;
+    if (contentCoding == "br")
+    {
+        encoder = std::make_unique<Memory::Streams::Encoders::Brotli>(compression.brotliQuality);
+    }
+    else
+    {
+        encoder = std::make_unique<Memory::Streams::Encoders::Deflate>(contentCoding == "gzip" ? Memory::Streams::Encoders::Deflate::Format::GZIP : Memory::Streams::Encoders::Deflate::Format::ZLIB,
+                                                                       compression.gzipLevel);
+    }
+
+    if (contentSize <= compression.maxBufferedSize)
+    {
+        // Compress it now, so the size is known (Content-Length):
+        std::shared_ptr<Memory::Streams::StreamableString> compressedContent = std::make_shared<Memory::Streams::StreamableString>();
+        encoder->transform(source.get(), compressedContent.get());
+        if (!compressedContent->writeStatus.succeed || compressedContent->size() >= contentSize)
+        {
+            // Failed or not worth it, send the original content.
+            return false;
+        }
+        serverResponse.setDataStreamer(compressedContent);
+    }
+    else
+    {
+        // Big or undefined size content, compress it while streaming:
+        serverResponse.setDataStreamer(std::make_shared<HTTP::EncodedContentStreamer>(source, std::move(encoder)));
+        if (clientRequest.requestLine.getHTTPVersion()->getMinor() >= 1)
+        {
+            serverResponse.content.setTransmissionMode(HTTP::Content::TransmissionMode::CHUNKS);
+        }
+    }
+
+    serverResponse.headers.replace("Content-Encoding", contentCoding);
+    // From here, the response depends on the Accept-Encoding header:
+    serverResponse.headers.replace("Vary", "Accept-Encoding");
+
+    // The strong validator belongs to the uncompressed representation:
+    std::string eTag = serverResponse.headers.getOptionRawStringByName("ETag");
+    if (!eTag.empty() && !boost::starts_with(eTag, "W/"))
+    {
+        serverResponse.headers.replace("ETag", "W/" + eTag);
+    }
+
+    return true;
+}
+
+bool HTTP::HTTPv1_Server::isKeepAliveRequestedByClient()
+{
+    bool requestsClose = false, requestsKeepAlive = false;
+
+    // Connection header may contain multiple comma separated tokens (eg. "keep-alive, Upgrade")
+    std::vector<std::string> connectionTokens;
+    boost::split(connectionTokens, clientRequest.getHeaderOption("Connection"), boost::is_any_of(","));
+    for (std::string &token : connectionTokens)
+    {
+        boost::trim(token);
+        requestsClose = requestsClose || boost::iequals(token, "close");
+        requestsKeepAlive = requestsKeepAlive || boost::iequals(token, "keep-alive");
+    }
+
+    if (requestsClose)
+    {
+        return false;
+    }
+
+    // HTTP/1.1 connections are persistent by default, HTTP/1.0 ones only if the client asks for it.
+    return clientRequest.requestLine.getHTTPVersion()->getMinor() >= 1 || requestsKeepAlive;
+}
+
+bool HTTP::HTTPv1_Server::prepareKeepAliveResponseHeaders()
+{
+    bool maxRequestsReached = keepAlive.maxRequestsPerConnection != 0 && m_servedRequestsCount >= keepAlive.maxRequestsPerConnection;
+
+    // The next request can only be delimited if the client knows where this response ends (content-length or chunked).
+    bool isResponseDelimited = serverResponse.content.getStreamSize() != std::numeric_limits<size_t>::max()
+                               || (serverResponse.content.getTransmissionMode() == HTTP::Content::TransmissionMode::CHUNKS && clientRequest.requestLine.getHTTPVersion()->getMinor() >= 1);
+
+    if (!connectionContinue || !keepAlive.enabled || maxRequestsReached || !isResponseDelimited || !isKeepAliveRequestedByClient())
+    {
+        serverResponse.headers.replace("Connection", "close");
+        serverResponse.headers.remove("Keep-Alive");
+        return false;
+    }
+
+    if (clientRequest.requestLine.getHTTPVersion()->getMinor() == 0)
+    {
+        // HTTP/1.0 clients need the explicit confirmation.
+        serverResponse.headers.replace("Connection", "keep-alive");
+    }
+
+    std::string keepAliveValue;
+    if (keepAlive.idleTimeoutInSeconds)
+    {
+        keepAliveValue = "timeout=" + std::to_string(keepAlive.idleTimeoutInSeconds);
+    }
+    if (keepAlive.maxRequestsPerConnection)
+    {
+        keepAliveValue += (keepAliveValue.empty() ? "" : ", ") + std::string("max=") + std::to_string(keepAlive.maxRequestsPerConnection - m_servedRequestsCount);
+    }
+    if (!keepAliveValue.empty())
+    {
+        serverResponse.headers.replace("Keep-Alive", keepAliveValue);
+    }
+
+    return true;
+}
+
 bool HTTP::HTTPv1_Server::sendHTTPHeadersResponse()
 {
     // Act as a server. Send data from here.
@@ -87,17 +269,25 @@ bool HTTP::HTTPv1_Server::sendHTTPHeadersResponse()
     fillLogInformation(jWebLog);
     log(jWebLog);
 
-    // TODO: connection keep alive.
-    if ((strsize = serverResponse.content.getStreamSize()) == std::numeric_limits<size_t>::max())
+    if (serverResponse.status.getCode() == HTTP::Status::Code::S_304_NOT_MODIFIED)
+    {
+        // 304 has no content, and the Content-Length (if any) should be the one of the (not sent) representation.
+        serverResponse.headers.remove("Content-Length");
+    }
+    else if ((strsize = serverResponse.content.getStreamSize()) == std::numeric_limits<size_t>::max())
     {
         // Undefined size. (eg. dynamic stream)
-        serverResponse.headers.replace("Connection", "close");
         serverResponse.headers.remove("Content-Length");
         /////////////////////
         if (serverResponse.content.getTransmissionMode() == HTTP::Content::TransmissionMode::CHUNKS)
         {
             serverResponse.headers.replace("Transfer-Encoding", "Chunked");
         }
+        else
+        {
+            // The end of the content will be the end of the connection.
+            serverResponse.headers.replace("Connection", "close");
+        }
     }
     else
     {
@@ -96,6 +96,9 @@ bool HTTP::HTTPv1_Server::sendWebSocketData(const char *data, const size_t &len,
     bool isFinal = false;
     size_t bytesSent = 0;
 
+    // Keep the frames of this message together (other threads may send to the same connection):
+    std::lock_guard<std::mutex> lock(m_webSocketWriteMutex);
+
     do
     {
         size_t remaining = len - bytesSent;
@@ -107,6 +110,9 @@ bool HTTP::HTTPv1_Server::sendWebSocketData(const char *data, const size_t &len,
         // Determine opcode: first frame is TEXT, continuation frames are CONTINUATION
         WebSocket::FrameHeader::OpCode opcode = (bytesSent == 0) ? mode : WebSocket::FrameHeader::OPCODE_CONTINUATION;
 
+        // Send the frame header and content together:
+        Memory::Streams::StreamCork frameCork(m_streamableObject.get());
+
         // Create and send frame header
         WebSocket::FrameHeader frmhdr;
         frmhdr.initElemParser(m_streamableObject.get(), false);
@@ -120,7 +126,7 @@ bool HTTP::HTTPv1_Server::sendWebSocketData(const char *data, const size_t &len,
         WebSocket::FrameContent frmcontent;
         frmcontent.initElemParser(m_streamableObject.get(), false);
         frmcontent.getContent().get()->append(data + bytesSent, frameSize);
-        if (!frmcontent.streamToUpstream())
+        if (!frmcontent.streamToUpstream() || !frameCork.uncork())
         {
             return false;
         }
@@ -210,6 +216,7 @@ bool HTTP::HTTPv1_Server::callOnFinalFragmentReceived()
     case WebSocket::FrameHeader::OPCODE_CLOSE:
     {
         onWebSocketConnectionFinished();
+        std::lock_guard<std::mutex> lock(m_webSocketWriteMutex);
         WebSocket::FrameHeader closeHeader;
         closeHeader.initElemParser(m_streamableObject.get(), false);
         closeHeader.prepareCloseFrame(0);
@@ -222,10 +229,13 @@ bool HTTP::HTTPv1_Server::callOnFinalFragmentReceived()
     break;
     case WebSocket::FrameHeader::OPCODE_PING:
     {
+        std::unique_lock<std::mutex> lock(m_webSocketWriteMutex);
         WebSocket::FrameHeader pongHeader;
         pongHeader.initElemParser(m_streamableObject.get(), false);
         pongHeader.preparePongFrame(0);
-        if (!pongHeader.streamToUpstream())
+        bool pongSent = pongHeader.streamToUpstream();
+        lock.unlock();
+        if (!pongSent)
         {
             // Pong failed! bye and close.
             webSocketCurrentFrame.content.reset();
@@ -268,6 +278,9 @@ bool HTTP::HTTPv1_Server::sendWebSocketPing(const char *data, size_t len)
         len = 125;
     }
 
+    std::lock_guard<std::mutex> lock(m_webSocketWriteMutex);
+    Memory::Streams::StreamCork frameCork(m_streamableObject.get());
+
     WebSocket::FrameHeader pingHeader;
     pingHeader.initElemParser(m_streamableObject.get(), false);
     pingHeader.preparePingFrame(len);
@@ -280,7 +293,7 @@ bool HTTP::HTTPv1_Server::sendWebSocketPing(const char *data, size_t len)
     frmcontent.initElemParser(m_streamableObject.get(), false);
     frmcontent.getContent().get()->append(data, len);
 
-    return frmcontent.streamToUpstream();
+    return frmcontent.streamToUpstream() && frameCork.uncork();
 }
 
 bool HTTP::HTTPv1_Server::sendWebSocketText(const std::string &data)
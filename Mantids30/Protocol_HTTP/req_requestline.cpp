@@ -49,6 +49,12 @@ Memory::Streams::SubParser::ParseResult RequestLine::parse()
 {
     std::string clientRequest = getParsedBuffer()->toStringEx();
 
+    if (clientRequest.empty() && !m_streamEnded)
+    {
+        // Ignore empty lines preceding the request line (eg. extra CRLF between keep-alive requests, RFC 7230 3.5)
+        return Memory::Streams::SubParser::ParseResult::GET_MORE_DATA;
+    }
+
     vector<string> requestParts;
     split(requestParts, clientRequest, is_any_of("\t "), token_compress_on);
 
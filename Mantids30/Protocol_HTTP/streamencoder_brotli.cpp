@@ -0,0 +1,121 @@
+#include "streamencoder_brotli.h"
+
+#include <Mantids30/Memory/b_mem.h>
+#include <Mantids30/Memory/streamable_string.h>
+#include <limits>
+
+#ifdef HAVE_BROTLI
+#include <brotli/encode.h>
+#endif
+
+using namespace Mantids30::Memory::Streams;
+using namespace Mantids30::Memory::Streams::Encoders;
+
+Brotli::Brotli(int quality)
+{
+#ifdef HAVE_BROTLI
+    BrotliEncoderState *state = BrotliEncoderCreateInstance(nullptr, nullptr, nullptr);
+    if (state)
+    {
+        BrotliEncoderSetParameter(state, BROTLI_PARAM_QUALITY, static_cast<uint32_t>(quality));
+        m_encoderState = state;
+    }
+#endif
+}
+
+Brotli::~Brotli()
+{
+#ifdef HAVE_BROTLI
+    if (m_encoderState)
+    {
+        BrotliEncoderDestroyInstance(static_cast<BrotliEncoderState *>(m_encoderState));
+    }
+#endif
+}
+
+bool Brotli::isAvailable()
+{
+#ifdef HAVE_BROTLI
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::optional<std::string> Brotli::compressString(const std::string &input, int quality)
+{
+    if (!isAvailable() || input.size() > std::numeric_limits<uint32_t>::max())
+    {
+        return std::nullopt;
+    }
+
+    Memory::Containers::B_MEM in(input.data(), static_cast<uint32_t>(input.size()));
+    StreamableString out;
+    Brotli compressor(quality);
+    compressor.transform(&in, &out);
+
+    if (!out.writeStatus.succeed || !compressor.m_encoderState)
+    {
+        return std::nullopt;
+    }
+    return out.getValue();
+}
+
+size_t Brotli::writeTo(Memory::Streams::StreamableObject *dst, const void *buf, const size_t &count)
+{
+    if (!compressToDestination(dst, buf, count, false))
+    {
+        return 0;
+    }
+    return count;
+}
+
+size_t Brotli::writeTransformerEOF(Memory::Streams::StreamableObject *dst)
+{
+    compressToDestination(dst, nullptr, 0, true);
+    return 0;
+}
+
+bool Brotli::compressToDestination(Memory::Streams::StreamableObject *dst, const void *buf, size_t count, bool finish)
+{
+#ifdef HAVE_BROTLI
+    BrotliEncoderState *state = static_cast<BrotliEncoderState *>(m_encoderState);
+    if (!state)
+    {
+        dst->writeStatus += -1;
+        return false;
+    }
+
+    const uint8_t *nextIn = static_cast<const uint8_t *>(buf);
+    size_t availableIn = count;
+
+    for (;;)
+    {
+        size_t availableOut = 0;
+        if (!BrotliEncoderCompressStream(state, finish ? BROTLI_OPERATION_FINISH : BROTLI_OPERATION_PROCESS, &availableIn, &nextIn, &availableOut, nullptr, nullptr))
+        {
+            dst->writeStatus += -1;
+            return false;
+        }
+
+        // Take the output directly from the encoder internal buffer:
+        while (BrotliEncoderHasMoreOutput(state))
+        {
+            size_t outputBytes = 0;
+            const uint8_t *output = BrotliEncoderTakeOutput(state, &outputBytes);
+            if (outputBytes && !dst->writeFullStream(output, outputBytes))
+            {
+                return false;
+            }
+        }
+
+        if (finish ? BrotliEncoderIsFinished(state) : (availableIn == 0))
+        {
+            return true;
+        }
+    }
+#else
+    dst->writeStatus += -1;
+    return false;
+#endif
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Mantids30/Memory/streamable_object.h>
+#include <Mantids30/Memory/streamable_transformer.h>
+
+namespace Mantids30::Memory::Streams::Encoders {
+
+/**
+ * @brief The Brotli class compresses the stream using brotli (HTTP "br" content coding).
+ */
+class Brotli : public Memory::Streams::StreamableTransformer
+{
+public:
+    /**
+     * @brief Brotli Create the compressor
+     * @param quality compression quality (0-11), higher is slower and smaller
+     */
+    Brotli(int quality = 5);
+    ~Brotli() override;
+
+    /**
+     * @brief isAvailable Check if the library was built with brotli support
+     */
+    static bool isAvailable();
+
+    /**
+     * @brief compressString Compress a whole string
+     * @return compressed string, or std::nullopt on failure (or when brotli is not available)
+     */
+    static std::optional<std::string> compressString(const std::string &input, int quality = 5);
+
+protected:
+    size_t writeTo(Memory::Streams::StreamableObject *dst, const void *buf, const size_t &count) override;
+    size_t writeTransformerEOF(Memory::Streams::StreamableObject *dst) override;
+
+private:
+    bool compressToDestination(Memory::Streams::StreamableObject *dst, const void *buf, size_t count, bool finish);
+
+    void *m_encoderState = nullptr;
+};
+
+} // namespace Mantids30::Memory::Streams::Encoders
@@ -0,0 +1,113 @@
+#include "streamencoder_deflate.h"
+
+#include <Mantids30/Memory/b_mem.h>
+#include <Mantids30/Memory/streamable_string.h>
+#include <limits>
+#include <zlib.h>
+
+using namespace Mantids30::Memory::Streams;
+using namespace Mantids30::Memory::Streams::Encoders;
+
+struct Deflate::ZStream
+{
+    z_stream stream{};
+};
+
+Deflate::Deflate(const Format &format, int level)
+    : m_zStream(std::make_unique<ZStream>())
+{
+    // windowBits+16 produces the gzip wrapper, the plain windowBits produces the zlib wrapper.
+    int windowBits = format == Format::GZIP ? (MAX_WBITS + 16) : MAX_WBITS;
+    m_initialized = (deflateInit2(&m_zStream->stream, level, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY) == Z_OK);
+}
+
+Deflate::~Deflate()
+{
+    if (m_initialized)
+    {
+        deflateEnd(&m_zStream->stream);
+    }
+}
+
+std::optional<std::string> Deflate::compressString(const std::string &input, const Format &format, int level)
+{
+    if (input.size() > std::numeric_limits<uint32_t>::max())
+    {
+        return std::nullopt;
+    }
+
+    Memory::Containers::B_MEM in(input.data(), static_cast<uint32_t>(input.size()));
+    StreamableString out;
+    Deflate compressor(format, level);
+    compressor.transform(&in, &out);
+
+    if (!out.writeStatus.succeed || !compressor.m_initialized)
+    {
+        return std::nullopt;
+    }
+    return out.getValue();
+}
+
+size_t Deflate::writeTo(Memory::Streams::StreamableObject *dst, const void *buf, const size_t &count)
+{
+    if (!m_initialized || count > std::numeric_limits<uInt>::max())
+    {
+        dst->writeStatus += -1;
+        return 0;
+    }
+
+    m_zStream->stream.next_in = static_cast<Bytef *>(const_cast<void *>(buf));
+    m_zStream->stream.avail_in = static_cast<uInt>(count);
+
+    if (!deflateToDestination(dst, Z_NO_FLUSH))
+    {
+        return 0;
+    }
+
+    return count;
+}
+
+size_t Deflate::writeTransformerEOF(Memory::Streams::StreamableObject *dst)
+{
+    if (!m_initialized)
+    {
+        dst->writeStatus += -1;
+        return 0;
+    }
+
+    m_zStream->stream.next_in = nullptr;
+    m_zStream->stream.avail_in = 0;
+
+    deflateToDestination(dst, Z_FINISH);
+    return 0;
+}
+
+bool Deflate::deflateToDestination(Memory::Streams::StreamableObject *dst, int flushMode)
+{
+    unsigned char outputBuffer[16384];
+
+    for (;;)
+    {
+        m_zStream->stream.next_out = outputBuffer;
+        m_zStream->stream.avail_out = sizeof(outputBuffer);
+
+        int r = deflate(&m_zStream->stream, flushMode);
+        if (r == Z_STREAM_ERROR)
+        {
+            dst->writeStatus += -1;
+            return false;
+        }
+
+        size_t outputBytes = sizeof(outputBuffer) - m_zStream->stream.avail_out;
+        if (outputBytes && !dst->writeFullStream(outputBuffer, outputBytes))
+        {
+            return false;
+        }
+
+        // Finished when the output buffer was not filled (NO_FLUSH) or when the stream ended (FINISH)
+        if ((flushMode == Z_FINISH && r == Z_STREAM_END) || (flushMode != Z_FINISH && m_zStream->stream.avail_out != 0))
+        {
+            return true;
+        }
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <Mantids30/Memory/streamable_object.h>
+#include <Mantids30/Memory/streamable_transformer.h>
+#include <memory>
+
+namespace Mantids30::Memory::Streams::Encoders {
+
+/**
+ * @brief The Deflate class compresses the stream using zlib (HTTP "gzip" and "deflate" content codings).
+ */
+class Deflate : public Memory::Streams::StreamableTransformer
+{
+public:
+    enum class Format
+    {
+        GZIP, ///< gzip wrapper (RFC 1952), "gzip" content coding.
+        ZLIB  ///< zlib wrapper (RFC 1950), "deflate" content coding.
+    };
+
+    /**
+     * @brief Deflate Create the compressor
+     * @param format output wrapper format
+     * @param level compression level (1-9, -1 for the zlib default)
+     */
+    Deflate(const Format &format = Format::GZIP, int level = -1);
+    ~Deflate() override;
+
+    /**
+     * @brief compressString Compress a whole string
+     * @return compressed string, or std::nullopt on failure
+     */
+    static std::optional<std::string> compressString(const std::string &input, const Format &format = Format::GZIP, int level = -1);
+
+protected:
+    size_t writeTo(Memory::Streams::StreamableObject *dst, const void *buf, const size_t &count) override;
+    size_t writeTransformerEOF(Memory::Streams::StreamableObject *dst) override;
+
+private:
+    bool deflateToDestination(Memory::Streams::StreamableObject *dst, int flushMode);
+
+    struct ZStream;
+    std::unique_ptr<ZStream> m_zStream;
+    bool m_initialized = false;
+};
+
+} // namespace Mantids30::Memory::Streams::Encoders
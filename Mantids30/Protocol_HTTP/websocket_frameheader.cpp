@@ -76,7 +76,9 @@ bool FrameHeader::streamToUpstream()
         secondByte |= 0x80;
     }
 
-    char bytes[2];
+    // The whole header is written at once (2 + 8 extended length + 4 masking key bytes max):
+    char bytes[14];
+    size_t headerSize = 2;
     bytes[0] = static_cast<char>(firstByte);
 
     // Handle payload length encoding
@@ -97,42 +99,30 @@ bool FrameHeader::streamToUpstream()
     secondByte |= (payloadLenField & 0x7F);
     bytes[1] = static_cast<char>(secondByte);
 
-    // Send first 2 bytes
-    if (!m_upStream->writeFullStream(bytes, 2))
-    {
-        return false;
-    }
-
-    // Send extended payload length if needed
+    // Extended payload length if needed
     if (payloadLenField == 126)
     {
         // 16-bit extended length (network byte order)
         uint16_t extendedLen = htons(static_cast<uint16_t>(m_payloadLength));
-        if (!m_upStream->writeFullStream(reinterpret_cast<char *>(&extendedLen), 2))
-        {
-            return false;
-        }
+        memcpy(bytes + headerSize, &extendedLen, 2);
+        headerSize += 2;
     }
     else if (payloadLenField == 127)
     {
         // 64-bit extended length (network byte order)
         uint64_t extendedLen = htobe64(m_payloadLength);
-        if (!m_upStream->writeFullStream(reinterpret_cast<char *>(&extendedLen), 8))
-        {
-            return false;
-        }
+        memcpy(bytes + headerSize, &extendedLen, 8);
+        headerSize += 8;
     }
 
-    // Send masking key if masked
+    // Masking key if masked
     if (m_masked)
     {
-        if (!m_upStream->writeFullStream(reinterpret_cast<const char *>(m_maskingKey.data()), 4))
-        {
-            return false;
-        }
+        memcpy(bytes + headerSize, m_maskingKey.data(), 4);
+        headerSize += 4;
     }
 
-    return true;
+    return m_upStream->writeFullStream(bytes, headerSize);
 }
 
 void FrameHeader::prepareCloseFrame(uint64_t payloadLength)
@@ -6,7 +6,8 @@ using namespace Mantids30;
 LineRecv_SubParser::LineRecv_SubParser()
 {
     setParseStrategy(Memory::Streams::SubParser::ParseStrategy::MULTIDELIMITER);
-    setParseMultiDelimiter({"\x0a", "\x0d"});
+    // (the earliest delimiter is taken, and CRLF is preferred over CR at the same position)
+    setParseMultiDelimiter({"\x0d\x0a", "\x0a", "\x0d"});
     setMaxObjectSize(65536);
     m_subParserName = "LineRecv_SubParser";
 }
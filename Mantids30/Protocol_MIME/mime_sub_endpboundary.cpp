@@ -3,6 +3,16 @@
 using namespace Mantids30::Network::Protocol::MIME;
 using namespace Mantids30;
 
+namespace {
+
+const std::shared_ptr<const Memory::Search::MultiNeedle> &getEndPBoundaryDelimiters()
+{
+    static const std::shared_ptr<const Memory::Search::MultiNeedle> delimiters = std::make_shared<const Memory::Search::MultiNeedle>(std::list<std::string>{"--\r\n", "\r\n"});
+    return delimiters;
+}
+
+} // namespace
+
 MIME_Sub_EndPBoundary::MIME_Sub_EndPBoundary()
 {
     setParseStrategy(Memory::Streams::SubParser::ParseStrategy::MULTIDELIMITER);
@@ -13,7 +23,7 @@ MIME_Sub_EndPBoundary::MIME_Sub_EndPBoundary()
 void MIME_Sub_EndPBoundary::reset()
 {
     m_status = ENDP_STAT_UNINITIALIZED;
-    setParseMultiDelimiter({"--\r\n", "\r\n"});
+    setParseMultiDelimiter(getEndPBoundaryDelimiters());
     setParseDataTargetSize(16);
     clear();
 }
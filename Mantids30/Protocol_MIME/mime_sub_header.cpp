@@ -1,10 +1,10 @@
 #include "mime_sub_header.h"
+#include <Mantids30/Memory/slabpool.h>
 #include <boost/algorithm/string.hpp>
-#include <boost/algorithm/string/replace.hpp>
-#include <boost/algorithm/string/split.hpp>
-#include <boost/regex.hpp>
 
-#include <Mantids30/Helpers/random.h>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
 #include <memory>
 
 using namespace boost;
@@ -13,6 +13,105 @@ using namespace Mantids30::Network::Protocol::MIME;
 using namespace Mantids30;
 using namespace std;
 
+namespace {
+
+bool isOptionName(const std::shared_ptr<MIME_HeaderOption> &opt, const std::string &optionName)
+{
+    return boost::iequals(opt->getOrigName(), optionName);
+}
+
+std::string_view trimView(std::string_view v)
+{
+    while (!v.empty() && std::isspace(static_cast<unsigned char>(v.front())))
+    {
+        v.remove_prefix(1);
+    }
+    while (!v.empty() && std::isspace(static_cast<unsigned char>(v.back())))
+    {
+        v.remove_suffix(1);
+    }
+    return v;
+}
+
+/**
+ * @brief skipQuotedText Get the position after the quoted text starting at pos ("..."), or pos+1 if the quote is not closed.
+ */
+size_t skipQuotedText(std::string_view v, size_t pos)
+{
+    size_t closingQuote = v.find('"', pos + 1);
+    return closingQuote == std::string_view::npos ? pos + 1 : closingQuote + 1;
+}
+
+/**
+ * @brief findUnquoted Find a character outside of the quoted texts.
+ */
+size_t findUnquoted(std::string_view v, char c)
+{
+    for (size_t i = 0; i < v.size();)
+    {
+        if (v[i] == c)
+        {
+            return i;
+        }
+        i = v[i] == '"' ? skipQuotedText(v, i) : i + 1;
+    }
+    return std::string_view::npos;
+}
+
+/**
+ * @brief unquote Trim the text and remove the quotes of the quoted texts (the quoted content is kept as is).
+ */
+std::string unquote(std::string_view v)
+{
+    v = trimView(v);
+    std::string r;
+    r.reserve(v.size());
+    for (size_t i = 0; i < v.size();)
+    {
+        size_t next = v[i] == '"' ? skipQuotedText(v, i) : i + 1;
+        if (next > i + 1)
+        {
+            r.append(v.substr(i + 1, next - i - 2));
+        }
+        else
+        {
+            r.push_back(v[i]);
+        }
+        i = next;
+    }
+    return r;
+}
+
+/**
+ * @brief forEachSubValue Call the function for each ';' separated sub-value (hello weo; doaie; fa = "hello world;" hehe; asd=399; aik="")
+ *                        Empty sub-values between separators are skipped. The function returns false to stop.
+ */
+template<typename Function>
+void forEachSubValue(std::string_view v, Function &&function)
+{
+    v = trimView(v);
+    bool first = true;
+    while (true)
+    {
+        size_t separator = findUnquoted(v, ';');
+        std::string_view subValue = v.substr(0, separator);
+        bool last = separator == std::string_view::npos;
+
+        if ((first || last || !trimView(subValue).empty()) && !function(subValue))
+        {
+            return;
+        }
+        if (last)
+        {
+            return;
+        }
+        v.remove_prefix(separator + 1);
+        first = false;
+    }
+}
+
+} // namespace
+
 MIME_Sub_Header::MIME_Sub_Header()
 {
     setParseStrategy(Memory::Streams::SubParser::ParseStrategy::DELIMITER);
@@ -26,9 +125,9 @@ bool MIME_Sub_Header::streamToUpstream()
     Memory::Streams::WriteStatus cur;
 
     // Write out the header option values...
-    for (std::multimap<std::string, std::shared_ptr<MIME_HeaderOption>>::reference &i : m_headers)
+    for (const std::shared_ptr<MIME_HeaderOption> &i : m_headers)
     {
-        std::string x = i.second->toString() + std::string("\r\n");
+        std::string x = i->toString() + std::string("\r\n");
 
         m_upStream->writeString(x);
 
@@ -44,6 +143,9 @@ bool MIME_Sub_Header::streamToUpstream()
 void MIME_Sub_Header::clear()
 {
     m_headers.clear();
+    m_lastOpt = nullptr;
+    // The options still referenced elsewhere keep their own lines:
+    m_receivedLines = nullptr;
 }
 
 bool MIME_Sub_Header::exist(const std::string &optionName) const
@@ -53,14 +155,8 @@ bool MIME_Sub_Header::exist(const std::string &optionName) const
 
 void MIME_Sub_Header::remove(const std::string &optionName)
 {
-    std::pair<std::multimap<std::string, std::shared_ptr<MIME_HeaderOption>>::iterator, std::multimap<std::string, std::shared_ptr<MIME_HeaderOption>>::iterator> range = m_headers.equal_range(
-        boost::to_upper_copy(optionName));
-
-    for (std::multimap<std::string, std::shared_ptr<MIME_HeaderOption>>::iterator it = range.first; it != range.second;)
-    {
-        //delete it->second;
-        it = m_headers.erase(it);
-    }
+    m_headers.erase(std::remove_if(m_headers.begin(), m_headers.end(), [&optionName](const std::shared_ptr<MIME_HeaderOption> &opt) { return isOptionName(opt, optionName); }),
+                    m_headers.end());
 }
 
 void MIME_Sub_Header::replace(const std::string &optionName, const std::string &optionValue)
@@ -82,7 +178,7 @@ bool MIME_Sub_Header::add(const std::string &optionName, const std::string &opti
         }
 
         optP->setOrigName(optionName);
-        parseSubValues(optP, optionValue);
+        optP->setOrigValue(optionValue);
 
         if (!addHeaderOption(optP))
         {
@@ -93,7 +189,7 @@ bool MIME_Sub_Header::add(const std::string &optionName, const std::string &opti
     else if (state == 1 && m_lastOpt)
     {
         optP = m_lastOpt;
-        parseSubValues(optP, optionValue);
+        optP->setOrigValue(optionValue);
     }
     return true;
 }
@@ -109,35 +205,39 @@ bool MIME_Sub_Header::addHeaderOption(const std::shared_ptr<MIME_HeaderOption> &
     {
         return false; // Can't exceed.
     }
-    m_headers.insert(std::pair<std::string, std::shared_ptr<MIME_HeaderOption>>(opt->getUpperName(), opt));
+    m_headers.push_back(opt);
     return true;
 }
 
 std::list<std::shared_ptr<MIME_HeaderOption>> MIME_Sub_Header::getOptionsByName(const std::string &varName) const
 {
     std::list<std::shared_ptr<MIME_HeaderOption>> values;
-    std::pair<std::multimap<std::string, std::shared_ptr<MIME_HeaderOption>>::const_iterator, std::multimap<std::string, std::shared_ptr<MIME_HeaderOption>>::const_iterator> range
-        = m_headers.equal_range(boost::to_upper_copy(varName));
-    for (std::multimap<std::string, std::shared_ptr<MIME_HeaderOption>>::const_iterator i = range.first; i != range.second; ++i)
+    for (const std::shared_ptr<MIME_HeaderOption> &opt : m_headers)
     {
-        values.push_back(i->second);
+        if (isOptionName(opt, varName))
+        {
+            values.push_back(opt);
+        }
     }
     return values;
 }
 
 std::shared_ptr<MIME_HeaderOption> MIME_Sub_Header::getOptionByName(const std::string &varName) const
 {
-    if (m_headers.find(boost::to_upper_copy(varName)) == m_headers.end())
+    for (const std::shared_ptr<MIME_HeaderOption> &opt : m_headers)
     {
-        return nullptr;
+        if (isOptionName(opt, varName))
+        {
+            return opt;
+        }
     }
-    return m_headers.find(boost::to_upper_copy(varName))->second;
+    return nullptr;
 }
 
 std::string MIME_Sub_Header::getOptionRawStringByName(const std::string &varName) const
 {
     std::shared_ptr<MIME_HeaderOption> opt = getOptionByName(varName);
-    return opt ? opt->getOrigValue() : "";
+    return opt ? std::string(opt->getOrigValue()) : "";
 }
 
 std::string MIME_Sub_Header::getOptionValueStringByName(const std::string &varName) const
@@ -187,131 +287,56 @@ Memory::Streams::SubParser::ParseResult MIME_Sub_Header::parse()
     printf("Parsing MIME header (line).\n");
     fflush(stdout);
 #endif
-    parseOptionValue(getParsedBuffer()->toStringEx());
+    // Parse the line from the received bytes when they are contiguous (otherwise, from a copy)
+    size_t segmentSize = 0;
+    const char *segment = getParsedBuffer()->getContiguousSegment(0, &segmentSize);
+    if (segment && segmentSize >= getParsedBuffer()->size())
+    {
+        parseOptionValue(std::string_view(segment, getParsedBuffer()->size()));
+    }
+    else
+    {
+        parseOptionValue(getParsedBuffer()->toStringEx());
+    }
     return Memory::Streams::SubParser::ParseResult::GET_MORE_DATA;
 }
 
 
-void MIME_Sub_Header::parseSubValues(const std::shared_ptr<MIME_HeaderOption> &opt, const std::string &strName)
+void MIME_Sub_Header::parseOptionValue(std::string_view optionValue)
 {
-    // hello weo; doaie; fa = "hello world;" hehe; asd=399; aik=""
-    std::vector<std::string> vStaticTexts;
-    std::string sVarValues = strName;
-    // TODO: find a way to do this easier...
-    std::string secureReplace = Mantids30::Helpers::Random::createRandomString(16);
-    opt->setOrigValue(sVarValues);
-
-    boost::trim(sVarValues);
-
-    boost::match_flag_type flags = boost::match_default;
-
-    // PRECOMPILE _STATIC_TEXT
-    boost::regex exStaticText("\"(?<STATIC_TEXT>[^\"]*)\"");
-    boost::match_results<string::const_iterator> whatStaticText;
-    for (string::const_iterator start = sVarValues.begin(), end = sVarValues.end(); boost::regex_search(start, end, whatStaticText, exStaticText, flags);
-         start = sVarValues.begin(), end = sVarValues.end())
+    if (!m_receivedLines)
     {
-        uint64_t pos = vStaticTexts.size();
-        char _staticmsg[128];
-
-#ifdef _WIN32
-        snprintf(_staticmsg, sizeof(_staticmsg), "_STATIC_%s_%llu", secureReplace.c_str(), pos);
-#else
-        snprintf(_staticmsg, sizeof(_staticmsg), "_STATIC_%s_%lu", secureReplace.c_str(), pos);
-#endif
-
-        vStaticTexts.emplace_back(whatStaticText[1].first, whatStaticText[1].second);
-        boost::replace_all(sVarValues, "\"" + string(whatStaticText[1].first, whatStaticText[1].second) + "\"", _staticmsg);
+        m_receivedLines = std::make_shared<MIME_HeaderLines>();
     }
 
-    vector<string> vValues;
-    split(vValues, sVarValues, is_any_of(";"), token_compress_on);
-
-    bool first = true;
-
-    for (const std::string &value : vValues)
+    if (!optionValue.empty() && (optionValue.front() == ' ' || optionValue.front() == '\t'))
     {
-        if (boost::contains(value, "="))
-        {
-            std::string sVarName = value.substr(0, value.find('='));
-            std::string sVarValue = value.substr(value.find('=') + 1);
-
-            boost::trim(sVarName);
-            boost::trim(sVarValue);
-
-            // replace back...
-            for (uint64_t i = 0; i < vStaticTexts.size(); i++)
-            {
-                char _staticmsg[128];
-#ifdef _WIN32
-                snprintf(_staticmsg, sizeof(_staticmsg), "_STATIC_%s_%llu", secureReplace.c_str(), i);
-#else
-                snprintf(_staticmsg, sizeof(_staticmsg), "_STATIC_%s_%lu", secureReplace.c_str(), i);
-#endif
-                boost::replace_all(sVarName, _staticmsg, vStaticTexts[i]);
-                boost::replace_all(sVarValue, _staticmsg, vStaticTexts[i]);
-            }
-
-            opt->addSubVar(sVarName, sVarValue);
-        }
-        else
+        // Continue on the last option...
+        if (m_lastOpt)
         {
-            std::string sv = boost::trim_copy(value);
-
-            // replace back...
-            for (uint64_t i = 0; i < vStaticTexts.size(); i++)
-            {
-                char _staticmsg[128];
-#ifdef _WIN32
-                snprintf(_staticmsg, sizeof(_staticmsg), "_STATIC_%s_%llu", secureReplace.c_str(), i);
-#else
-                snprintf(_staticmsg, sizeof(_staticmsg), "_STATIC_%s_%lu", secureReplace.c_str(), i);
-#endif
-                boost::replace_all(sv, _staticmsg, vStaticTexts[i]);
-            }
-
-            opt->addSubVar(sv, "");
+            m_lastOpt->setReceivedValue(m_receivedLines->store(optionValue), m_receivedLines);
         }
-
-        if (first)
-        {
-            std::string sv = boost::trim_copy(value);
-
-            // replace back...
-            for (uint64_t i = 0; i < vStaticTexts.size(); i++)
-            {
-                char _staticmsg[128];
-#ifdef _WIN32
-                snprintf(_staticmsg, sizeof(_staticmsg), "_STATIC_%s_%llu", secureReplace.c_str(), i);
-#else
-                snprintf(_staticmsg, sizeof(_staticmsg), "_STATIC_%s_%lu", secureReplace.c_str(), i);
-#endif
-                boost::replace_all(sv, _staticmsg, vStaticTexts[i]);
-            }
-
-            opt->setValue(sv);
-            first = false;
-        }
-    }
-}
-
-void MIME_Sub_Header::parseOptionValue(std::string optionValue)
-{
-    if (*(optionValue.c_str()) == ' ' || *(optionValue.c_str()) == '\t')
-    {
-        // Continue on the last option...
-        add("", optionValue, 1);
     }
     else
     {
         size_t found = optionValue.find(": ");
 
-        if (found != std::string::npos)
+        if (found != std::string_view::npos)
         {
-            // We have parameters..
-            std::string optionValue2 = optionValue.c_str() + found + 2;
-            optionValue.resize(found);
-            add(optionValue, optionValue2, 0);
+            if (m_headers.size() == m_maxOptions)
+            {
+                return; // Can't exceed.
+            }
+
+            // We have parameters.. (the option refers to the stored line)
+            std::string_view line = m_receivedLines->store(optionValue);
+            std::shared_ptr<MIME_HeaderOption> optP = std::make_shared<MIME_HeaderOption>();
+            optP->setReceivedName(line.substr(0, found), m_receivedLines);
+            optP->setReceivedValue(line.substr(found + 2), m_receivedLines);
+            if (addHeaderOption(optP))
+            {
+                m_lastOpt = optP;
+            }
         }
         else
         {
@@ -344,7 +369,8 @@ std::string MIME_HeaderOption::toString()
 {
     std::string r;
 
-    r = m_origName + ": " + m_origValue;
+    r.reserve(m_origName.size() + 2 + m_origValue.size());
+    r.append(m_origName).append(": ").append(m_origValue);
 
     return r;
 }
@@ -362,7 +388,20 @@ bool MIME_HeaderOption::isPermited7bitCharset(const std::string &varX)
     return true;
 }
 
+const std::multimap<std::string, std::string> &MIME_HeaderOption::getAllSubVars() const
+{
+    parseSubVars();
+    return m_subVar;
+}
+
 void MIME_HeaderOption::addSubVar(const std::string &varName, const std::string &varValue)
+{
+    // Keep the order: the sub-vars of the raw value go first.
+    parseSubVars();
+    insertSubVar(varName, varValue);
+}
+
+void MIME_HeaderOption::insertSubVar(const std::string &varName, const std::string &varValue) const
 {
     if (varName.empty() && varValue.empty())
     {
@@ -391,40 +430,111 @@ void MIME_HeaderOption::addSubVar(const std::string &varName, const std::string
     m_subVar.insert(std::make_pair(varName, varValue));
 }
 
+void MIME_HeaderOption::parseSubVars() const
+{
+    if (m_subVarsParsed.load(std::memory_order_acquire))
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_lazyParseMutex);
+    if (m_subVarsParsed.load(std::memory_order_relaxed))
+    {
+        // Parsed by other reader.
+        return;
+    }
+
+    // Sub-values are separated by ';' (outside of the quoted texts), and may be name=value pairs:
+    forEachSubValue(m_origValue, [this](std::string_view subValue) {
+        size_t equalPos = findUnquoted(subValue, '=');
+        if (equalPos != std::string_view::npos)
+        {
+            insertSubVar(unquote(subValue.substr(0, equalPos)), unquote(subValue.substr(equalPos + 1)));
+        }
+        else
+        {
+            insertSubVar(unquote(subValue), "");
+        }
+        return true;
+    });
+    m_subVarsParsed.store(true, std::memory_order_release);
+}
+
 std::string MIME_HeaderOption::getUpperName() const
 {
-    return boost::to_upper_copy(m_origName);
+    return boost::to_upper_copy(std::string(m_origName));
 }
 
-std::string MIME_HeaderOption::getOrigName() const
+std::string_view MIME_HeaderOption::getOrigName() const
 {
     return m_origName;
 }
 
 void MIME_HeaderOption::setOrigName(const std::string &value)
 {
+    m_ownedName = value;
+    m_origName = m_ownedName;
+    m_nameLines = nullptr;
+}
+
+void MIME_HeaderOption::setReceivedName(std::string_view value, const std::shared_ptr<MIME_HeaderLines> &lines)
+{
+    m_ownedName.clear();
     m_origName = value;
+    m_nameLines = lines;
 }
 
-std::string MIME_HeaderOption::getValue() const
+const std::string &MIME_HeaderOption::getValue() const
 {
+    if (!m_valueParsed.load(std::memory_order_acquire))
+    {
+        std::lock_guard<std::mutex> lock(m_lazyParseMutex);
+        if (!m_valueParsed.load(std::memory_order_relaxed))
+        {
+            // The value is the first sub-value:
+            m_value.clear();
+            forEachSubValue(m_origValue, [this](std::string_view subValue) {
+                m_value = unquote(subValue);
+                return false;
+            });
+            m_valueParsed.store(true, std::memory_order_release);
+        }
+    }
     return m_value;
 }
 
 void MIME_HeaderOption::setValue(const std::string &value)
 {
-    this->m_value = value;
-    boost::trim(this->m_value);
+    m_value = boost::trim_copy(value);
+    m_valueParsed = true;
 }
 
-std::string MIME_HeaderOption::getOrigValue() const
+std::string_view MIME_HeaderOption::getOrigValue() const
 {
     return m_origValue;
 }
 
 void MIME_HeaderOption::setOrigValue(const std::string &value)
 {
+    resetParsedValue();
+    m_ownedValue = value;
+    m_origValue = m_ownedValue;
+    m_valueLines = nullptr;
+}
+
+void MIME_HeaderOption::setReceivedValue(std::string_view value, const std::shared_ptr<MIME_HeaderLines> &lines)
+{
+    resetParsedValue();
+    m_ownedValue.clear();
     m_origValue = value;
+    m_valueLines = lines;
+}
+
+void MIME_HeaderOption::resetParsedValue()
+{
+    // Parse the pending sub-vars of the previous raw value (folded lines).
+    parseSubVars();
+    m_valueParsed = false;
+    m_subVarsParsed = false;
 }
 
 uint64_t MIME_HeaderOption::getMaxSubOptions() const
@@ -436,3 +546,36 @@ void MIME_HeaderOption::setMaxSubOptions(const uint64_t &value)
 {
     m_maxSubOptionsCount = value;
 }
+
+MIME_HeaderLines::~MIME_HeaderLines()
+{
+    for (const std::pair<char *, size_t> &block : m_blocks)
+    {
+        Memory::Containers::SlabPool::deallocate(block.first, block.second);
+    }
+}
+
+std::string_view MIME_HeaderLines::store(std::string_view line)
+{
+    if (line.empty())
+    {
+        return {};
+    }
+
+    if (m_blocks.empty() || line.size() > m_blocks.back().second - m_lastBlockUsed)
+    {
+        size_t capacity;
+        char *block = Memory::Containers::SlabPool::allocate(std::max(BLOCK_SIZE, line.size()), &capacity);
+        if (!block)
+        {
+            throw std::bad_alloc();
+        }
+        m_blocks.emplace_back(block, capacity);
+        m_lastBlockUsed = 0;
+    }
+
+    char *storedLine = m_blocks.back().first + m_lastBlockUsed;
+    memcpy(storedLine, line.data(), line.size());
+    m_lastBlockUsed += line.size();
+    return {storedLine, line.size()};
+}
@@ -3,19 +3,56 @@
 #include <Mantids30/Helpers/json.h>
 #include <Mantids30/Memory/subparser.h>
 
+#include <atomic>
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 /*
  * TODO: Security: check if other servers can handle the MIME properly...
  */
 
 namespace Mantids30::Network::Protocol::MIME {
+
+/**
+ * @brief The MIME_HeaderLines class keeps the received header lines in stable memory blocks, so the header options refer
+ *        to their names and values (views) instead of copying them.
+ */
+class MIME_HeaderLines
+{
+public:
+    MIME_HeaderLines() = default;
+    ~MIME_HeaderLines();
+
+    MIME_HeaderLines(const MIME_HeaderLines &) = delete;
+    MIME_HeaderLines &operator=(const MIME_HeaderLines &) = delete;
+
+    /**
+     * @brief store Copy the line into the blocks.
+     * @return view of the stored line (valid while this object lives).
+     */
+    std::string_view store(std::string_view line);
+
+private:
+    static constexpr size_t BLOCK_SIZE = 4096;
+
+    // Blocks (memory, capacity):
+    std::vector<std::pair<char *, size_t>> m_blocks;
+    size_t m_lastBlockUsed = 0;
+};
+
 // ??
 /**
  * @brief The HeaderOption struct
+ *
+ * The option refers to the name and the raw value as received (see MIME_HeaderLines). The value (first sub-value) and
+ * the sub-vars (eg. cookies) are parsed from it only when they are accessed, the const getters can be called from
+ * concurrent threads (the setters can't).
  */
 class MIME_HeaderOption
 {
@@ -27,27 +64,29 @@ public:
         m_maxSubOptionsCount = 16;
     }
 
-    std::string getSubVar(const std::string &subVarName)
+    std::string getSubVar(const std::string &subVarName) const
     {
-        if (m_subVar.find(subVarName) == m_subVar.end())
+        const std::multimap<std::string, std::string> &subVars = getAllSubVars();
+        auto it = subVars.find(subVarName);
+        if (it == subVars.end())
         {
             return "";
         }
-        return m_subVar.find(subVarName)->second;
+        return it->second;
     }
 
-    std::list<std::string> getSubVars(const std::string &subVarName)
+    std::list<std::string> getSubVars(const std::string &subVarName) const
     {
         std::list<std::string> r;
-        auto ret = m_subVar.equal_range(subVarName);
-        for (std::multimap<std::string, std::string>::iterator it = ret.first; it != ret.second; ++it)
+        auto ret = getAllSubVars().equal_range(subVarName);
+        for (auto it = ret.first; it != ret.second; ++it)
         {
             r.push_back(it->second);
         }
         return r;
     }
 
-    std::multimap<std::string, std::string> getAllSubVars() { return m_subVar; }
+    const std::multimap<std::string, std::string> &getAllSubVars() const;
 
     std::string toString();
 
@@ -55,29 +94,59 @@ public:
 
     [[nodiscard]] std::string getUpperName() const;
 
-    [[nodiscard]] std::string getOrigName() const;
+    /**
+     * @brief getOrigName Get the option name (valid while the option lives and is not modified).
+     */
+    [[nodiscard]] std::string_view getOrigName() const;
     void setOrigName(const std::string &value);
+    /**
+     * @brief setReceivedName Refer to the option name stored in the received lines (no copy).
+     */
+    void setReceivedName(std::string_view value, const std::shared_ptr<MIME_HeaderLines> &lines);
 
-    [[nodiscard]] std::string getValue() const;
+    [[nodiscard]] const std::string &getValue() const;
     void setValue(const std::string &value);
 
-    [[nodiscard]] std::string getOrigValue() const;
+    /**
+     * @brief getOrigValue Get the raw value (valid while the option lives and is not modified).
+     */
+    [[nodiscard]] std::string_view getOrigValue() const;
+    /**
+     * @brief setOrigValue Set the raw value (the value and the sub-vars will be parsed from it on access).
+     *                     Sub-vars from the previous raw value (eg. folded lines) are kept.
+     * @param value raw value.
+     */
     void setOrigValue(const std::string &value);
+    /**
+     * @brief setReceivedValue Refer to the raw value stored in the received lines (no copy), as setOrigValue.
+     */
+    void setReceivedValue(std::string_view value, const std::shared_ptr<MIME_HeaderLines> &lines);
 
     [[nodiscard]] uint64_t getMaxSubOptions() const;
     void setMaxSubOptions(const uint64_t &value);
 
 private:
-    bool isPermited7bitCharset(const std::string &varX);
+    static bool isPermited7bitCharset(const std::string &varX);
+    void insertSubVar(const std::string &varName, const std::string &varValue) const;
+    void parseSubVars() const;
+    void resetParsedValue();
 
     uint64_t m_maxSubOptionsCount;
     uint64_t m_maxHeaderOptSize;
-    uint64_t m_curHeaderOptSize;
-
-    std::string m_origName;
-    std::string m_origValue;
-    std::string m_value;
-    std::multimap<std::string, std::string> m_subVar;
+    mutable uint64_t m_curHeaderOptSize;
+
+    // Views into the received lines (kept alive by m_*Lines), or into the owned strings:
+    std::string_view m_origName;
+    std::string_view m_origValue;
+    std::shared_ptr<MIME_HeaderLines> m_nameLines, m_valueLines;
+    std::string m_ownedName, m_ownedValue;
+
+    // Lazily parsed from m_origValue (filled once under the mutex by the first reader):
+    mutable std::mutex m_lazyParseMutex;
+    mutable std::atomic<bool> m_valueParsed{false};
+    mutable std::string m_value;
+    mutable std::atomic<bool> m_subVarsParsed{true};
+    mutable std::multimap<std::string, std::string> m_subVar;
 };
 
 class MIME_Sub_Header : public Memory::Streams::SubParser
@@ -169,12 +238,16 @@ protected:
     Memory::Streams::SubParser::ParseResult parse() override;
 
 private:
-    void parseSubValues(const std::shared_ptr<MIME_HeaderOption> &opt, const std::string &strName);
-
     std::shared_ptr<MIME_HeaderOption> m_lastOpt;
-    void parseOptionValue(std::string optionValue);
+    void parseOptionValue(std::string_view optionValue);
 
-    std::multimap<std::string, std::shared_ptr<MIME_HeaderOption>> m_headers;
+    // Received header lines, referred by the parsed options:
+    std::shared_ptr<MIME_HeaderLines> m_receivedLines;
+
+    /**
+     * @brief m_headers options in the received/added order (few options: searched linearly, case insensitive).
+     */
+    std::vector<std::shared_ptr<MIME_HeaderOption>> m_headers;
     size_t m_maxOptions = 32; // 32 Max options
     size_t m_maxSubOptionCount = 100, m_maxSubOptionSize = 2 * KB_MULT;
 };
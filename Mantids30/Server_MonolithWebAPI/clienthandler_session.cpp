@@ -11,6 +11,11 @@ using namespace std;
 // This function is called at the beggining.
 HTTP::Status::Code ClientHandler::sessionStart()
 {
+    // The connection may be persistent (keep-alive), so the previous request session should not be inherited.
+    m_currentWebSession = nullptr;
+    m_destroySession = false;
+    currentSessionInfo = Sessions::SessionInfo();
+
     m_sessionID = clientRequest.getCookie(CURRENT_SESSIONID_COOKIENAME);
     m_impersonatorSessionID = clientRequest.getCookie(IMPERSONATOR_SESSIONID_COOKIENAME);
 
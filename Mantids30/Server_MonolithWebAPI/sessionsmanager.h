@@ -4,7 +4,7 @@
 #include <Mantids30/Helpers/json.h>
 #include <Mantids30/Helpers/random.h>
 #include <Mantids30/Threads/garbagecollector.h>
-#include <Mantids30/Threads/safe_map.h>
+#include <Mantids30/Threads/safe_shardedmap.h>
 #include <memory>
 #include <mutex>
 
@@ -115,7 +115,7 @@ public:
     Json::Value getUserSessionsInfo(const std::string &effectiveUserName);
 
 private:
-    Threads::Safe::Map<std::string> m_sessions;
+    Threads::Safe::ShardedMap<std::string> m_sessions;
     std::mutex m_mutex;
     std::map<std::string, std::map<std::string, Json::Value> > m_sessionClientInfo;
 
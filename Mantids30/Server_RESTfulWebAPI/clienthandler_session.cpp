@@ -11,6 +11,13 @@ using namespace std;
 
 Network::Protocol::HTTP::Status::Code ClientHandler::sessionStart()
 {
+    // The connection may be persistent (keep-alive), so the previous request authentication should not be inherited.
+    m_isAuthorizationHeaderJWTVerified = false;
+    m_isAccessTokenCookieJWTVerified = false;
+    m_destroySession = false;
+    jwtToken = DataFormat::JWT::Token();
+    currentSessionInfo = Sessions::SessionInfo();
+
     // Check for the authorization bearer token...
     string headerBearerToken = clientRequest.getAuthorizationBearer();
 
@@ -7,6 +7,7 @@
 #include <Mantids30/Helpers/json.h>
 #include <Mantids30/Memory/b_mmap.h>
 #include <Mantids30/Memory/streamable_string.h>
+#include <Mantids30/Net_Sockets/socket_stream.h>
 #include <Mantids30/Protocol_HTTP/httpv1_base.h>
 #include <Mantids30/Protocol_HTTP/rsp_status.h>
 
@@ -110,7 +111,7 @@ HTTP::Status::Code APIServer_ClientHandler::onHTTPClientContentReceived()
         {
             std::string apiUrlWithoutBase = requestURI.substr(baseApiUrl.size());
 
-            std::regex apiVersionResourcePattern("/v(\\d+)/(.+)"); // regex to match "/vN/resource" pattern
+            static const std::regex apiVersionResourcePattern("/v(\\d+)/(.+)"); // regex to match "/vN/resource" pattern
             std::smatch pathMatch;
             if (std::regex_match(apiUrlWithoutBase, pathMatch, apiVersionResourcePattern))
             {
@@ -287,6 +288,38 @@ HTTP::Status::Code APIServer_ClientHandler::onHTTPClientContentReceived()
     return ret;
 }
 
+bool APIServer_ClientHandler::isStaticContentTypeRendered(const std::string &contentType)
+{
+    return config->useHTMLIEngine && (contentType == "text/html" || contentType == "application/javascript");
+}
+
+void APIServer_ClientHandler::onHTTPKeepAliveIdleStateChanged(bool idle)
+{
+    if (!keepAlive.idleTimeoutInSeconds)
+    {
+        // Keep the socket read timeout.
+        return;
+    }
+
+    std::shared_ptr<Sockets::Socket_Stream> sock = std::dynamic_pointer_cast<Sockets::Socket_Stream>(m_streamableObject);
+    if (!sock)
+    {
+        return;
+    }
+
+    if (idle)
+    {
+        // Waiting for the next request, don't hold the connection more than the idle timeout.
+        m_activeReadTimeout = sock->getReadTimeout();
+        sock->setReadTimeout(keepAlive.idleTimeoutInSeconds);
+    }
+    else
+    {
+        // Request in progress, restore the regular timeout.
+        sock->setReadTimeout(m_activeReadTimeout);
+    }
+}
+
 void APIServer_ClientHandler::fillSessionInfo(Json::Value &jVars)
 {
     if (currentSessionInfo.authSession)
@@ -369,10 +402,23 @@ HTTP::Status::Code APIServer_ClientHandler::handleRegularFileRequest()
 
     // If the URL is going to process the Interactive HTML Engine,
     // and the document content is text/html, then, process it as HTMLIEngine:
-    if (config->useHTMLIEngine && (serverResponse.contentType == "text/html" || serverResponse.contentType == "application/javascript")) // The content type has changed during the map.
+    if (isStaticContentTypeRendered(serverResponse.contentType)) // The content type has changed during the map.
     {
         ret = HTMLIEngine::processResourceFile(this, fileInfo.fullPath);
     }
+    else if (ret == HTTP::Status::Code::S_200_OK)
+    {
+        if (fileInfo.cachedFile)
+        {
+            // Static file served from memory: select the encoding and answer the conditional requests (ETag/304)
+            ret = prepareCachedFileResponse(fileInfo);
+        }
+        if (ret == HTTP::Status::Code::S_200_OK)
+        {
+            // Partial content (Range requests):
+            ret = prepareRangeResponse();
+        }
+    }
 
     // And if the file is not found and there are redirections, set the redirection:
     if (ret == HTTP::Status::Code::S_404_NOT_FOUND && !config->redirectPathOn404.empty())
@@ -73,6 +73,17 @@ protected:
      * @return http response code.
      */
     Protocol::HTTP::Status::Code onHTTPClientContentReceived() override;
+    /**
+     * @brief onHTTPKeepAliveIdleStateChanged Apply the keep-alive idle timeout to the client socket while waiting for the next request.
+     * @param idle true when waiting for the next request, false when the request arrived.
+     */
+    void onHTTPKeepAliveIdleStateChanged(bool idle) override;
+    /**
+     * @brief isStaticContentTypeRendered Check if the files of this content type are processed by the HTMLIEngine.
+     * @param contentType content type of the resolved file
+     * @return true if config->useHTMLIEngine is set and the content type is text/html or application/javascript.
+     */
+    bool isStaticContentTypeRendered(const std::string &contentType) override;
     /**
      * @brief sessionStart Retrieve/Start the session
      * @return S_200_OK for everything ok, any other value will return with that code immediately.
@@ -207,6 +218,7 @@ protected:
 
 private:
     std::string logUsername;
+    unsigned int m_activeReadTimeout = 0;
     Protocol::HTTP::Status::Code handleRegularFileRequest();
     bool versionIsSupported(const std::string &versionStr, int minVersion);
     bool isSupportedUserAgent(const std::string &userAgent);
@@ -8,6 +8,7 @@
 #include <Mantids30/Program_Logs/rpclog.h>
 #include <Mantids30/Program_Logs/weblog.h>
 #include <Mantids30/Protocol_HTTP/httpv1_base.h>
+#include <Mantids30/Protocol_HTTP/httpv1_server.h>
 #include <Mantids30/Protocol_HTTP/rsp_status.h>
 
 #include "resourcesfilter.h"
@@ -112,6 +113,21 @@ public:
 
     API::WebSocket::Config webSockets;
 
+    /**
+     * @brief keepAlive HTTP/1.1 persistent connections parameters (idle timeout, max requests per connection)
+     */
+    Protocol::HTTP::HTTPv1_Server::KeepAliveParameters keepAlive;
+
+    /**
+     * @brief compression HTTP response compression parameters (gzip/deflate/brotli negotiated with Accept-Encoding)
+     */
+    Protocol::HTTP::HTTPv1_Server::CompressionParameters compression;
+
+    /**
+     * @brief staticFileCache In-memory cache (shared by all the connections) for the small static files, with their precompressed representations and ETags (nullptr: disabled)
+     */
+    std::shared_ptr<Protocol::HTTP::StaticFileCache> staticFileCache;
+
     /**
      * @brief useJSTokenCookie for RESTful server, JS Token cookie means that the JS will receive the JWT token that can be used for Header authentication via Cookie
      */
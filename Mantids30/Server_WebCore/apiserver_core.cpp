@@ -53,6 +53,42 @@ void APIServerCore::setAcceptMultiThreaded(const std::list<std::shared_ptr<Socke
     m_acceptorType = AcceptorType::MULTI_THREADED;
 }
 
+#ifdef __linux__
+void APIServerCore::setAcceptEventLoop(const std::list<std::shared_ptr<Sockets::Socket_Stream>> &listenerSockets, const boost::property_tree::ptree &ptree)
+{
+    // The TLS handshake and records are read in blocking mode, a slow client would pin an event loop worker:
+    for (const std::shared_ptr<Sockets::Socket_Stream> &socket : listenerSockets)
+    {
+        if (socket && socket->isSecure())
+        {
+            setAcceptPoolThreaded(listenerSockets, ptree);
+            return;
+        }
+    }
+
+    m_eventLoopAcceptor = std::make_shared<Network::Sockets::Acceptors::EventLoop>();
+
+    for (const std::shared_ptr<Sockets::Socket_Stream> &socket : listenerSockets)
+    {
+        m_eventLoopAcceptor->addAcceptorSocket(socket);
+    }
+    this->m_listenerSockets = listenerSockets;
+
+    m_eventLoopAcceptor->callbacks.setAllContexts(this);
+    m_eventLoopAcceptor->callbacks.onClientConnected = handleEventLoopConnect;
+    m_eventLoopAcceptor->callbacks.onClientDataAvailable = handleEventLoopDataAvailable;
+    m_eventLoopAcceptor->callbacks.onClientDisconnected = handleEventLoopDisconnect;
+    m_eventLoopAcceptor->callbacks.onProtocolInitializationFailure = handleInitFailed;
+    m_eventLoopAcceptor->callbacks.onClientAcceptTimeoutOccurred = handleTimeOut;
+    m_eventLoopAcceptor->callbacks.onClientConnectionLimitPerIPReached = handleConnectionLimit;
+
+    m_eventLoopAcceptor->parameters.setConfig(ptree);
+
+    // Set acceptor type
+    m_acceptorType = AcceptorType::EVENT_LOOP;
+}
+#endif
+
 void APIServerCore::startInBackground()
 {
     checkEngineStatus();
@@ -66,6 +102,16 @@ void APIServerCore::startInBackground()
     case AcceptorType::POOL_THREADED:
         m_poolThreadedAcceptor->startInBackground();
         break;
+    case AcceptorType::EVENT_LOOP:
+#ifdef __linux__
+        // The parked connections are waiting for the next request, close them as the threaded acceptors do:
+        if (config.keepAlive.idleTimeoutInSeconds)
+        {
+            m_eventLoopAcceptor->parameters.idleTimeoutInSeconds = config.keepAlive.idleTimeoutInSeconds;
+        }
+        m_eventLoopAcceptor->startInBackground();
+#endif
+        break;
     case AcceptorType::NONE:
         throw std::runtime_error("Acceptor type not defined in API Web Engine Core.");
         break;
@@ -88,10 +134,8 @@ void APIServerCore::handleVirtualConnection(const std::shared_ptr<Sockets::Socke
     handleConnect(this, virtualConnection);
 }
 
-void APIServerCore::handleConnect(void *context, const std::shared_ptr<Sockets::Socket_Stream> &sock)
+std::shared_ptr<APIServer_ClientHandler> APIServerCore::createClientHandler(const std::shared_ptr<Sockets::Socket_Stream> &sock)
 {
-    APIServerCore *webserver = static_cast<APIServerCore *>(context);
-
     std::string tlsCN;
     if (sock->isSecure())
     {
@@ -101,16 +145,31 @@ void APIServerCore::handleConnect(void *context, const std::shared_ptr<Sockets::
 
     // Use Nagle:
     std::shared_ptr<Network::Sockets::Socket_TCP> tcpSock = std::dynamic_pointer_cast<Network::Sockets::Socket_TCP>(sock);
-    tcpSock->setTcpNoDelayOption(false);
+    if (tcpSock)
+    {
+        tcpSock->setTcpNoDelayOption(false);
+    }
 
     // Prepare the web services handler.
-    std::shared_ptr<APIServer_ClientHandler> apiWebServerClientHandler = webserver->createNewAPIServer_ClientHandler(webserver, sock);
+    std::shared_ptr<APIServer_ClientHandler> apiWebServerClientHandler = createNewAPIServer_ClientHandler(this, sock);
     // Assign endpoints:
-    apiWebServerClientHandler->m_websocketEndpoints = webserver->m_websocketEndpoints;
+    apiWebServerClientHandler->m_websocketEndpoints = m_websocketEndpoints;
     // Set client information:
     apiWebServerClientHandler->clientRequest.networkClientInfo.setClientInformation(sock->getRemotePairStr(), sock->isSecure(), tlsCN);
     // Set the configuration:
-    apiWebServerClientHandler->config = &(webserver->config);
+    apiWebServerClientHandler->config = &config;
+    apiWebServerClientHandler->keepAlive = config.keepAlive;
+    apiWebServerClientHandler->compression = config.compression;
+    apiWebServerClientHandler->setStaticFileCache(config.staticFileCache);
+
+    return apiWebServerClientHandler;
+}
+
+void APIServerCore::handleConnect(void *context, const std::shared_ptr<Sockets::Socket_Stream> &sock)
+{
+    APIServerCore *webserver = static_cast<APIServerCore *>(context);
+
+    std::shared_ptr<APIServer_ClientHandler> apiWebServerClientHandler = webserver->createClientHandler(sock);
 
     // Callback on client connected.
     if (webserver->callbacks.onClientConnected.call(webserver, sock))
@@ -121,6 +180,50 @@ void APIServerCore::handleConnect(void *context, const std::shared_ptr<Sockets::
     }
 }
 
+bool APIServerCore::handleEventLoopConnect(void *context, const std::shared_ptr<Sockets::Socket_Stream> &sock, std::shared_ptr<void> &connectionContext)
+{
+    APIServerCore *webserver = static_cast<APIServerCore *>(context);
+
+    std::shared_ptr<APIServer_ClientHandler> apiWebServerClientHandler = webserver->createClientHandler(sock);
+
+    // Callback on client connected.
+    if (!webserver->callbacks.onClientConnected.call(webserver, sock))
+    {
+        return false;
+    }
+
+    // Initialize the parser, the data will be parsed when available.
+    Memory::Streams::Parser::ParseResult err;
+    if (!apiWebServerClientHandler->parseObjectStart(&err))
+    {
+        return false;
+    }
+
+    connectionContext = apiWebServerClientHandler;
+    return true;
+}
+
+bool APIServerCore::handleEventLoopDataAvailable(void *, const std::shared_ptr<Sockets::Socket_Stream> &, std::shared_ptr<void> &connectionContext)
+{
+    std::shared_ptr<APIServer_ClientHandler> apiWebServerClientHandler = std::static_pointer_cast<APIServer_ClientHandler>(connectionContext);
+    if (!apiWebServerClientHandler)
+    {
+        return false;
+    }
+
+    Memory::Streams::Parser::ParseResult err;
+    return apiWebServerClientHandler->parseObjectAvailableData(&err);
+}
+
+void APIServerCore::handleEventLoopDisconnect(void *, const std::shared_ptr<Sockets::Socket_Stream> &, std::shared_ptr<void> &connectionContext)
+{
+    std::shared_ptr<APIServer_ClientHandler> apiWebServerClientHandler = std::static_pointer_cast<APIServer_ClientHandler>(connectionContext);
+    if (apiWebServerClientHandler)
+    {
+        apiWebServerClientHandler->parseObjectEnd();
+    }
+}
+
 void APIServerCore::handleInitFailed(void *context, const std::shared_ptr<Sockets::Socket_Stream> &s)
 {
     APIServerCore *webserver = static_cast<APIServerCore *>(context);
@@ -143,7 +246,7 @@ void APIServerCore::handleTimeOut(void *context, const std::shared_ptr<Sockets::
 void APIServerCore::handleConnectionLimit(void *context, const std::shared_ptr<Sockets::Socket_Stream> &s)
 {
     APIServerCore *webserver = static_cast<APIServerCore *>(context);
-    if (webserver->callbacks.onClientAcceptTimeoutOccurred.call(webserver, s))
+    if (webserver->callbacks.onClientConnectionLimitPerIPReached.call(webserver, s))
     {
         s->writeString("HTTP/1.1 503 Service Temporarily Unavailable\r\n");
         s->writeString("Content-Type: text/html; charset=UTF-8\r\n");
@@ -4,6 +4,7 @@
 #include "apiserver_config.h"
 #include <Mantids30/API_EndpointsAndSessions/api_websocket_endpoints.h>
 #include <Mantids30/Memory/b_mem.h>
+#include <Mantids30/Net_Sockets/acceptor_eventloop.h>
 #include <Mantids30/Net_Sockets/acceptor_multithreaded.h>
 #include <Mantids30/Net_Sockets/acceptor_poolthreaded.h>
 #include <Mantids30/Net_Sockets/socket_stream.h>
@@ -92,10 +93,28 @@ public:
      */
     void setAcceptPoolThreaded(const std::list<std::shared_ptr<Network::Sockets::Socket_Stream>> &listenerSockets, const boost::property_tree::ptree &ptree = {});
 
+#ifdef __linux__
+    /**
+     * @brief setAcceptEventLoop Configures the server to start in event-driven mode using epoll reactors and a fixed pool of worker threads.
+     *
+     * In this mode, idle connections (eg. keep-alive connections between requests) are watched by a few reactor threads and the HTTP
+     * parser is only executed in the worker pool when there is incoming data, so the number of open connections is not bounded by the thread count.
+     *
+     * Only plain sockets are served by the event loop: if any listener socket is secure (TLS), the server is configured in pool-threaded
+     * mode instead (see setAcceptPoolThreaded), because the TLS handshake and records are read in blocking mode.
+     *
+     * The idle timeout of the parked connections is config.keepAlive.idleTimeoutInSeconds (the event loop IdleTimeoutInSeconds
+     * parameter is only used when it is 0).
+     *
+     * @param listenerSockets A list of prepared listener sockets (e.g., TCP) that will be used to accept incoming connections.
+     */
+    void setAcceptEventLoop(const std::list<std::shared_ptr<Network::Sockets::Socket_Stream>> &listenerSockets, const boost::property_tree::ptree &ptree = {});
+#endif
+
     /**
      * @brief startInBackground Starts the server in the background.
      *
-     * This method will initiate the server's operation based on the configuration set by either `setAcceptMultiThreaded` or `setAcceptPoolThreaded`.
+     * This method will initiate the server's operation based on the configuration set by `setAcceptMultiThreaded`, `setAcceptPoolThreaded` or `setAcceptEventLoop`.
      */
     void startInBackground();
 
@@ -131,6 +150,7 @@ private:
         NONE,
         POOL_THREADED,
         MULTI_THREADED,
+        EVENT_LOOP,
     };
 
     AcceptorType m_acceptorType = AcceptorType::NONE;
@@ -138,6 +158,14 @@ private:
 
     std::shared_ptr<Network::Sockets::Acceptors::MultiThreaded> m_multiThreadedAcceptor;
     std::shared_ptr<Network::Sockets::Acceptors::PoolThreaded> m_poolThreadedAcceptor;
+#ifdef __linux__
+    std::shared_ptr<Network::Sockets::Acceptors::EventLoop> m_eventLoopAcceptor;
+#endif
+
+    /**
+     * @brief createClientHandler Create and configure the API client handler for an incoming connection.
+     */
+    std::shared_ptr<APIServer_ClientHandler> createClientHandler(const std::shared_ptr<Sockets::Socket_Stream> &sock);
 
     /**
      * callback when connection is fully established (if the callback returns false, connection socket won't be automatically closed/deleted)
@@ -156,6 +184,19 @@ private:
      * @brief _onConnectionLimit
      */
     static void handleConnectionLimit(void *, const std::shared_ptr<Sockets::Socket_Stream> &);
+
+    /**
+     * event-driven callback when the connection is fully established, the client handler is kept as the connection context (returns true to wait for data)
+     */
+    static bool handleEventLoopConnect(void *, const std::shared_ptr<Sockets::Socket_Stream> &, std::shared_ptr<void> &);
+    /**
+     * event-driven callback when the connection has incoming data, parse what is available (returns true to wait for more data)
+     */
+    static bool handleEventLoopDataAvailable(void *, const std::shared_ptr<Sockets::Socket_Stream> &, std::shared_ptr<void> &);
+    /**
+     * event-driven callback when the acceptor drops a waiting connection (idle timeout, shutdown)
+     */
+    static void handleEventLoopDisconnect(void *, const std::shared_ptr<Sockets::Socket_Stream> &, std::shared_ptr<void> &);
 };
 
 } // namespace Mantids30::Network::Servers::Web
@@ -1,6 +1,7 @@
 #include "htmliengine.h"
 #include <Mantids30/Helpers/encoders.h>
 #include <Mantids30/Memory/streamable_json.h>
+#include <Mantids30/Memory/streamable_segments.h>
 #include <Mantids30/Program_Logs/rpclog.h>
 #include <Mantids30/Protocol_HTTP/api_return.h>
 #include <Mantids30/Protocol_HTTP/httpv1_base.h>
@@ -48,112 +49,134 @@ string HTMLIEngine::replaceByJVar(const Json::Value &value, const std::string &s
     return str;
 }
 
+std::mutex HTMLIEngine::m_templatesMutex;
+std::map<std::pair<std::string, std::string>, std::shared_ptr<const HTMLIEngineTemplate>> HTMLIEngine::m_templates;
+
 HTTP::Status::Code HTMLIEngine::processResourceFile(APIServer_ClientHandler *clientHandler, const std::string &sRealFullPath)
 {
-    // Drop the MMAP container:
-    std::string fileContent;
-
-    if (boost::starts_with(sRealFullPath, "MEM:"))
+    std::shared_ptr<const HTMLIEngineTemplate> compiledTemplate = getCompiledTemplate(clientHandler, sRealFullPath);
+    if (!compiledTemplate)
     {
-        // Mem-Static resource.
-        fileContent = (static_cast<Mantids30::Memory::Containers::B_MEM *>(clientHandler->getResponseContentStreamableObject().get()))->toStringEx();
-        clientHandler->serverResponse.setDataStreamer(nullptr);
+        return HTTP::Status::Code::S_404_NOT_FOUND;
     }
-    else
+
+    // Render the template: static segments are shared with the compiled template, only the directives are evaluated per request.
+    std::shared_ptr<Memory::Streams::StreamableSegments> output = std::make_shared<Memory::Streams::StreamableSegments>();
+    for (const HTMLIEngineTemplate::Segment &segment : compiledTemplate->segments)
     {
-        // the server response will be the default data chunk (reset):
-        clientHandler->serverResponse.setDataStreamer(nullptr);
-        // Local resource.
-        std::ifstream fileStream(sRealFullPath);
-        if (!fileStream.is_open())
+        if (segment.staticText)
         {
-            clientHandler->log(LogLevel::ERROR, "fileServer", 2048, "file not found: %s", sRealFullPath.c_str());
-            return HTTP::Status::Code::S_404_NOT_FOUND;
+            output->addSegment(segment.staticText);
+        }
+        else
+        {
+            output->addSegment(procResource_Directive(segment.directive, sRealFullPath, clientHandler));
         }
-        // Pass the file to a string.
-        fileContent = std::string((std::istreambuf_iterator<char>(fileStream)), std::istreambuf_iterator<char>());
-        fileStream.close();
     }
 
-    // CINC PROCESSOR:
-    procResource_HTMLIEngineInclude(sRealFullPath, clientHandler->serverResponse.contentType, fileContent, clientHandler);
-    procResource_JProcessor(sRealFullPath, fileContent, clientHandler);
-
     // Stream the generated content...
-    clientHandler->getResponseContentStreamableObject()->writeString(fileContent);
+    clientHandler->serverResponse.setDataStreamer(output);
     return HTTP::Status::Code::S_200_OK;
 }
 
-void HTMLIEngine::iProcResource_JProcessor(string &input, const std::regex &re, const string &sRealFullPath, APIServer_ClientHandler *clientHandler, bool useHTMLFrame)
+std::shared_ptr<const HTMLIEngineTemplate> HTMLIEngine::getCompiledTemplate(APIServer_ClientHandler *clientHandler, const std::string &sRealFullPath)
 {
-    size_t pos = 0;
+    std::string fileContent;
+    bool isMemoryResource = boost::starts_with(sRealFullPath, "MEM:");
+    std::pair<std::string, std::string> templateKey(clientHandler->config->getDocumentRootPath(), sRealFullPath);
 
-    // Search every J processor in one big loop and replace in place and continue... so won't be a chance to re-ingest anything...
-    for (;;)
+    if (isMemoryResource)
     {
-        std::smatch match;
-        std::string::const_iterator start_it = input.begin() + pos;
-        std::string::const_iterator end_it = input.end();
+        // Mem-Static resource.
+        fileContent = (static_cast<Mantids30::Memory::Containers::B_MEM *>(clientHandler->getResponseContentStreamableObject().get()))->toStringEx();
+    }
+    // the server response will be the default data chunk (reset):
+    clientHandler->serverResponse.setDataStreamer(nullptr);
 
-        if (!std::regex_search(start_it, end_it, match, re))
+    {
+        std::lock_guard<std::mutex> lock(m_templatesMutex);
+        auto it = m_templates.find(templateKey);
+        if (it != m_templates.end() && (isMemoryResource ? it->second->memorySource == fileContent : it->second->isCurrent()))
         {
-            break;
+            return it->second;
         }
+    }
 
-        int absolute_pos = static_cast<int>(std::distance(input.cbegin(), match[0].first));
-        int length = match.length();
+    // Not compiled or outdated, (re)compile it (stat before reading, so any change while reading is detected on the next request):
+    std::vector<HTMLIEngineTemplate::Dependency> dependencies;
+    if (!isMemoryResource)
+    {
+        dependencies.push_back(HTMLIEngineTemplate::getDependency(sRealFullPath));
 
-        if (match.size() >= 3)
+        std::shared_ptr<HTTP::StaticFileCache> staticFileCache = clientHandler->getStaticFileCache();
+        std::shared_ptr<const HTTP::StaticFileCache::Entry> cachedFile = staticFileCache ? staticFileCache->get(sRealFullPath) : nullptr;
+        if (cachedFile)
         {
-            std::string command = match[1];
-            std::string value = match[2];
-            std::string replacedBy = "null";
-            std::string scriptVarName = "varName";
-
-            if (boost::istarts_with(command, "VAR/"))
-            {
-                scriptVarName = command.c_str() + 3 + 1;
-                // %JVAR PROCESSOR:
-                replacedBy = procResource_HTMLIEngineJVAR(scriptVarName, value, sRealFullPath, clientHandler, useHTMLFrame);
-            }
-            if (boost::istarts_with(command, "GETVAR/"))
-            {
-                scriptVarName = command.c_str() + 6 + 1;
-                // %JGETVAR PROCESSOR:
-                replacedBy = procResource_HTMLIEngineJGETVAR(scriptVarName, value, sRealFullPath, clientHandler, useHTMLFrame);
-            }
-            if (boost::istarts_with(command, "POSTVAR/"))
-            {
-                scriptVarName = command.c_str() + 7 + 1;
-                // %JPOSTVAR PROCESSOR:
-                replacedBy = procResource_HTMLIEngineJPOSTVAR(scriptVarName, value, sRealFullPath, clientHandler, useHTMLFrame);
-            }
-            if (boost::istarts_with(command, "FUNC/"))
-            {
-                scriptVarName = command.c_str() + 4 + 1;
-                // %JFUNC PROCESSOR:
-                replacedBy = procResource_HTMLIEngineJFUNC(sRealFullPath, scriptVarName, value, clientHandler, useHTMLFrame);
-            }
-            if (boost::istarts_with(command, "SESS/"))
+            // Local resource already in memory.
+            fileContent = *cachedFile->identity.data;
+        }
+        else
+        {
+            // Local resource.
+            std::ifstream fileStream(sRealFullPath);
+            if (!fileStream.is_open())
             {
-                scriptVarName = command.c_str() + 4 + 1;
-                // %JSESSVAR PROCESSOR:
-                replacedBy = procResource_HTMLIEngineJSESSVAR(scriptVarName, value, sRealFullPath, clientHandler, useHTMLFrame);
+                clientHandler->log(LogLevel::ERROR, "fileServer", 2048, "file not found: %s", sRealFullPath.c_str());
+                return nullptr;
             }
-
-            input.replace(absolute_pos, length, replacedBy);
-            pos = absolute_pos + replacedBy.size();
+            // Pass the file to a string.
+            fileContent = std::string((std::istreambuf_iterator<char>(fileStream)), std::istreambuf_iterator<char>());
+            fileStream.close();
         }
     }
+
+    std::string memorySource = isMemoryResource ? fileContent : "";
+
+    // CINC PROCESSOR:
+    std::set<std::string> includedFiles;
+    procResource_HTMLIEngineInclude(sRealFullPath, clientHandler->serverResponse.contentType, fileContent, clientHandler, includedFiles);
+    for (const std::string &includedFile : includedFiles)
+    {
+        dependencies.push_back(HTMLIEngineTemplate::getDependency(includedFile));
+    }
+
+    std::shared_ptr<HTMLIEngineTemplate> compiledTemplate = HTMLIEngineTemplate::compile(fileContent);
+    compiledTemplate->dependencies = dependencies;
+    compiledTemplate->memorySource = memorySource;
+
+    std::lock_guard<std::mutex> lock(m_templatesMutex);
+    if (m_templates.size() >= 4096 && m_templates.find(templateKey) == m_templates.end())
+    {
+        // Keep the cache bounded (eg. MEM: resources generated on the fly)
+        m_templates.clear();
+    }
+    m_templates[templateKey] = compiledTemplate;
+    return compiledTemplate;
 }
 
-void HTMLIEngine::procResource_JProcessor(const std::string &sRealFullPath, std::string &input, APIServer_ClientHandler *clientHandler)
+std::string HTMLIEngine::procResource_Directive(const HTMLIEngineTemplate::Directive &directive, const std::string &sRealFullPath, APIServer_ClientHandler *clientHandler)
 {
-    std::regex reHTML("<!--<%[jJ]([a-zA-Z0-9_\\/]+):[ ]*([^%]*)[ ]*%>-->");
-    std::regex reJS(R"(\/\/<%[jJ]([a-zA-Z0-9_\/]+):[ ]*([^%]*)[ ]*%>\/\/)");
-
-    iProcResource_JProcessor(input, reJS, sRealFullPath, clientHandler, false);
-    iProcResource_JProcessor(input, reHTML, sRealFullPath, clientHandler, true);
+    switch (directive.type)
+    {
+    case HTMLIEngineTemplate::Directive::Type::VAR:
+        // %JVAR PROCESSOR:
+        return procResource_HTMLIEngineJVAR(directive.scriptVarName, directive.value, sRealFullPath, clientHandler, directive.useHTMLFrame);
+    case HTMLIEngineTemplate::Directive::Type::GETVAR:
+        // %JGETVAR PROCESSOR:
+        return procResource_HTMLIEngineJGETVAR(directive.scriptVarName, directive.value, sRealFullPath, clientHandler, directive.useHTMLFrame);
+    case HTMLIEngineTemplate::Directive::Type::POSTVAR:
+        // %JPOSTVAR PROCESSOR:
+        return procResource_HTMLIEngineJPOSTVAR(directive.scriptVarName, directive.value, sRealFullPath, clientHandler, directive.useHTMLFrame);
+    case HTMLIEngineTemplate::Directive::Type::JFUNC:
+        // %JFUNC PROCESSOR:
+        return procResource_HTMLIEngineJFUNC(sRealFullPath, directive.scriptVarName, directive.value, clientHandler, directive.useHTMLFrame);
+    case HTMLIEngineTemplate::Directive::Type::SESSVAR:
+        // %JSESSVAR PROCESSOR:
+        return procResource_HTMLIEngineJSESSVAR(directive.scriptVarName, directive.value, sRealFullPath, clientHandler, directive.useHTMLFrame);
+    case HTMLIEngineTemplate::Directive::Type::UNKNOWN:
+        break;
+    }
+    return "null";
 }
 
 std::string HTMLIEngine::procResource_HTMLIEngineJSESSVAR(const std::string &scriptVarName, const std::string &varName, const std::string &sRealFullPath, APIServer_ClientHandler *clientHandler,
@@ -263,7 +286,7 @@ Json::Value HTMLIEngine::procJAPI_Exec(const std::string &sRealFullPath, APIServ
     }
 
     // Regular expression to split the components (eg. //<%jfunc/loginMode:GET/v1/getLoginMode({})%>//)
-    std::regex exFunctionNameSplit(R"(^([^/]+)/v([^/]+)/(.+)$)");
+    static const std::regex exFunctionNameSplit(R"(^([^/]+)/v([^/]+)/(.+)$)");
     std::smatch matches;
     if (std::regex_match(functionName, matches, exFunctionNameSplit))
     {
@@ -287,7 +310,7 @@ std::string HTMLIEngine::procResource_HTMLIEngineJFUNC(const std::string &sRealF
                                                        bool useHTMLFrame)
 {
     // TODO: como revisar que realmente termine en ) y no haya un ) dentro del json
-    std::regex exStaticJsonFunction(R"(([^\(]+)\(([^\)]*)\))");
+    static const std::regex exStaticJsonFunction(R"(([^\(]+)\(([^\)]*)\))");
 
     std::smatch whatStaticText;
     std::string::const_iterator start = functionDef.begin();
@@ -312,7 +335,8 @@ std::string HTMLIEngine::procResource_HTMLIEngineJFUNC(const std::string &sRealF
     return replaceByJVar(Json::Value::null, scriptVarName, useHTMLFrame);
 }
 
-void HTMLIEngine::iProcResource_HTMLIEngineInclude(const std::string &sRealFullPath, std::string &fileContent, APIServer_ClientHandler *clientHandler, const boost::regex &exStaticText)
+void HTMLIEngine::iProcResource_HTMLIEngineInclude(const std::string &sRealFullPath, std::string &fileContent, APIServer_ClientHandler *clientHandler, const boost::regex &exStaticText,
+                                                   std::set<std::string> &includedFiles)
 {
     // PRECOMPILE _STATIC_TEXT
     boost::match_flag_type flags = boost::match_default;
@@ -330,6 +354,7 @@ void HTMLIEngine::iProcResource_HTMLIEngineInclude(const std::string &sRealFullP
         // GET THE TAG DATA HERE...
         // The path is relative to documentRootPath (beware: admits transversal)
         std::string streamFilePath = clientHandler->config->getDocumentRootPath() + includePath;
+        includedFiles.insert(streamFilePath);
         std::ifstream fileIncludeStream(streamFilePath);
 
         if (fileIncludeStream.is_open())
@@ -358,18 +383,19 @@ void HTMLIEngine::iProcResource_HTMLIEngineInclude(const std::string &sRealFullP
 }
 
 // Function to process the HTMLI include tags within the file content
-void HTMLIEngine::procResource_HTMLIEngineInclude(const std::string &sRealFullPath, const std::string &contentType, std::string &fileContent, APIServer_ClientHandler *clientHandler)
+void HTMLIEngine::procResource_HTMLIEngineInclude(const std::string &sRealFullPath, const std::string &contentType, std::string &fileContent, APIServer_ClientHandler *clientHandler,
+                                                  std::set<std::string> &includedFiles)
 {
     // CINC PROCESSOR:
-    boost::regex reIncludeHTML(R"(<!--<\%?include(?<SCRIPT_TAG_NAME>[^\:]*):[ ]*(?<PATH>[^\%]+)[ ]*\%>-->)", boost::regex::icase);
-    boost::regex reIncludeJS(R"(//<\%?include(?<SCRIPT_TAG_NAME>[^\:]*):[ ]*(?<PATH>[^\%]+)[ ]*\%>//)", boost::regex::icase);
+    static const boost::regex reIncludeHTML(R"(<!--<\%?include(?<SCRIPT_TAG_NAME>[^\:]*):[ ]*(?<PATH>[^\%]+)[ ]*\%>-->)", boost::regex::icase);
+    static const boost::regex reIncludeJS(R"(//<\%?include(?<SCRIPT_TAG_NAME>[^\:]*):[ ]*(?<PATH>[^\%]+)[ ]*\%>//)", boost::regex::icase);
 
     if (contentType == "application/javacript")
     {
-        iProcResource_HTMLIEngineInclude(sRealFullPath, fileContent, clientHandler, reIncludeJS);
+        iProcResource_HTMLIEngineInclude(sRealFullPath, fileContent, clientHandler, reIncludeJS, includedFiles);
     }
     else
     {
-        iProcResource_HTMLIEngineInclude(sRealFullPath, fileContent, clientHandler, reIncludeHTML);
+        iProcResource_HTMLIEngineInclude(sRealFullPath, fileContent, clientHandler, reIncludeHTML, includedFiles);
     }
 }
@@ -2,9 +2,12 @@
 
 #include <Mantids30/Helpers/json.h>
 #include <Mantids30/Protocol_HTTP/httpv1_base.h>
-#include <regex>
+#include <map>
+#include <mutex>
+#include <set>
 
 #include "apiserver_clienthandler.h"
+#include "htmliengine_template.h"
 
 namespace Mantids30::Network::Servers::Web {
 
@@ -16,8 +19,11 @@ public:
 private:
     static Json::Value procJAPI_Exec(const std::string &sRealFullPath, APIServer_ClientHandler *clientHandler, const std::string &functionName, const std::string &functionInput);
 
-    static void procResource_HTMLIEngineInclude(const std::string &sRealFullPath, const std::string &contentType, std::string &fileContent, APIServer_ClientHandler *clientHandler);
-    static void procResource_JProcessor(const std::string &sRealFullPath, std::string &input, APIServer_ClientHandler *clientHandler);
+    static std::shared_ptr<const HTMLIEngineTemplate> getCompiledTemplate(APIServer_ClientHandler *clientHandler, const std::string &sRealFullPath);
+
+    static void procResource_HTMLIEngineInclude(const std::string &sRealFullPath, const std::string &contentType, std::string &fileContent, APIServer_ClientHandler *clientHandler,
+                                                std::set<std::string> &includedFiles);
+    static std::string procResource_Directive(const HTMLIEngineTemplate::Directive &directive, const std::string &sRealFullPath, APIServer_ClientHandler *clientHandler);
 
     static std::string procResource_HTMLIEngineJFUNC(const std::string &sRealFullPath, const std::string &scriptVarName, const std::string &functionDef, APIServer_ClientHandler *clientHandler,
                                                      bool useHTMLFrame);
@@ -31,9 +37,12 @@ private:
                                                     bool useHTMLFrame);
     static std::string replaceByJVar(const Json::Value &value, const std::string &scriptVarName, bool useHTMLFrame);
 
-    static void iProcResource_JProcessor(std::string &input, const std::regex &re, const std::string &sRealFullPath, APIServer_ClientHandler *clientHandler, bool useHTMLFrame);
+    static void iProcResource_HTMLIEngineInclude(const std::string &sRealFullPath, std::string &fileContent, APIServer_ClientHandler *clientHandler, const boost::regex &exStaticText,
+                                                 std::set<std::string> &includedFiles);
 
-    static void iProcResource_HTMLIEngineInclude(const std::string &sRealFullPath, std::string &fileContent, APIServer_ClientHandler *clientHandler, const boost::regex &exStaticText);
+    // Compiled templates (by document root and resource path, the includes are resolved from the document root):
+    static std::mutex m_templatesMutex;
+    static std::map<std::pair<std::string, std::string>, std::shared_ptr<const HTMLIEngineTemplate>> m_templates;
 };
 
 } // namespace Mantids30::Network::Servers::Web
@@ -0,0 +1,140 @@
+#include "htmliengine_template.h"
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <sys/stat.h>
+
+using namespace Mantids30::Network::Servers::Web;
+
+std::shared_ptr<HTMLIEngineTemplate> HTMLIEngineTemplate::compile(const std::string &content)
+{
+    std::shared_ptr<HTMLIEngineTemplate> compiledTemplate = std::make_shared<HTMLIEngineTemplate>();
+
+    // Tags: //<%jCOMMAND: VALUE%>// (javascript) and <!--<%jCOMMAND: VALUE%>--> (html)
+    size_t staticStart = 0, searchPos = 0;
+    while ((searchPos = content.find("<%", searchPos)) != std::string::npos)
+    {
+        size_t tagStart = 0, tagEnd = 0;
+        Directive directive;
+        bool found = false;
+
+        if (searchPos >= staticStart + 2 && content.compare(searchPos - 2, 2, "//") == 0 && parseDirectiveAt(content, searchPos, false, tagEnd, directive))
+        {
+            tagStart = searchPos - 2;
+            found = true;
+        }
+        else if (searchPos >= staticStart + 4 && content.compare(searchPos - 4, 4, "<!--") == 0 && parseDirectiveAt(content, searchPos, true, tagEnd, directive))
+        {
+            tagStart = searchPos - 4;
+            found = true;
+        }
+
+        if (!found)
+        {
+            searchPos += 2;
+            continue;
+        }
+
+        if (tagStart > staticStart)
+        {
+            compiledTemplate->segments.push_back({std::make_shared<const std::string>(content.substr(staticStart, tagStart - staticStart)), Directive()});
+        }
+        compiledTemplate->segments.push_back({nullptr, directive});
+
+        staticStart = searchPos = tagEnd;
+    }
+
+    if (staticStart < content.size())
+    {
+        compiledTemplate->segments.push_back({std::make_shared<const std::string>(content.substr(staticStart)), Directive()});
+    }
+
+    return compiledTemplate;
+}
+
+bool HTMLIEngineTemplate::parseDirectiveAt(const std::string &content, size_t tagStart, bool useHTMLFrame, size_t &tagEnd, Directive &directive)
+{
+    // tagStart points to "<%", followed by: [jJ]([a-zA-Z0-9_/]+):[ ]*([^%]*)%> and the closing comment.
+    size_t pos = tagStart + 2;
+    if (pos >= content.size() || (content[pos] != 'j' && content[pos] != 'J'))
+    {
+        return false;
+    }
+    pos++;
+
+    size_t commandStart = pos;
+    while (pos < content.size() && (isalnum(static_cast<unsigned char>(content[pos])) || content[pos] == '_' || content[pos] == '/'))
+    {
+        pos++;
+    }
+    if (pos == commandStart || pos >= content.size() || content[pos] != ':')
+    {
+        return false;
+    }
+    std::string command = content.substr(commandStart, pos - commandStart);
+    pos++;
+
+    while (pos < content.size() && content[pos] == ' ')
+    {
+        pos++;
+    }
+
+    size_t valueEnd = content.find('%', pos);
+    const std::string closingTag = useHTMLFrame ? "%>-->" : "%>//";
+    if (valueEnd == std::string::npos || content.compare(valueEnd, closingTag.size(), closingTag) != 0)
+    {
+        return false;
+    }
+
+    directive = Directive();
+    directive.value = content.substr(pos, valueEnd - pos);
+    directive.useHTMLFrame = useHTMLFrame;
+
+    static const std::vector<std::pair<std::string, Directive::Type>> commandPrefixes = {{"VAR/", Directive::Type::VAR},         {"GETVAR/", Directive::Type::GETVAR},
+                                                                                        {"POSTVAR/", Directive::Type::POSTVAR}, {"FUNC/", Directive::Type::JFUNC},
+                                                                                        {"SESS/", Directive::Type::SESSVAR}};
+    for (const auto &commandPrefix : commandPrefixes)
+    {
+        if (boost::istarts_with(command, commandPrefix.first))
+        {
+            directive.type = commandPrefix.second;
+            directive.scriptVarName = command.substr(commandPrefix.first.size());
+            break;
+        }
+    }
+
+    tagEnd = valueEnd + closingTag.size();
+    return true;
+}
+
+HTMLIEngineTemplate::Dependency HTMLIEngineTemplate::getDependency(const std::string &path)
+{
+    Dependency dependency;
+    dependency.path = path;
+
+    struct stat fileStats;
+    if (stat(path.c_str(), &fileStats) == 0)
+    {
+        dependency.exists = true;
+        dependency.fileSize = fileStats.st_size;
+#ifdef _WIN32
+        dependency.modificationTime.tv_sec = fileStats.st_mtime;
+#else
+        dependency.modificationTime = fileStats.st_mtim;
+#endif
+    }
+    return dependency;
+}
+
+bool HTMLIEngineTemplate::isCurrent() const
+{
+    for (const Dependency &dependency : dependencies)
+    {
+        Dependency current = getDependency(dependency.path);
+        if (current.exists != dependency.exists || current.fileSize != dependency.fileSize || current.modificationTime.tv_sec != dependency.modificationTime.tv_sec
+            || current.modificationTime.tv_nsec != dependency.modificationTime.tv_nsec)
+        {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <ctime>
+#include <memory>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+namespace Mantids30::Network::Servers::Web {
+
+/**
+ * @brief The HTMLIEngineTemplate class is an HTMLI resource parsed once: a list of static text segments and the
+ *        directives (JVAR, JGETVAR, JPOSTVAR, JSESS, JFUNC) to be evaluated on every request.
+ *
+ * Includes are expanded before parsing (their content does not depend on the request), and every file used to build
+ * the template is recorded so the template can be validated (and recompiled) when any of them changes.
+ */
+class HTMLIEngineTemplate
+{
+public:
+    struct Directive
+    {
+        enum class Type
+        {
+            UNKNOWN,
+            VAR,
+            GETVAR,
+            POSTVAR,
+            SESSVAR,
+            JFUNC
+        };
+
+        Type type = Type::UNKNOWN;
+        std::string scriptVarName;
+        std::string value;
+        /**
+         * @brief useHTMLFrame true for the HTML comment tags (<!--<%j...%>-->), false for the javascript ones (//<%j...%>//)
+         */
+        bool useHTMLFrame = false;
+    };
+
+    struct Segment
+    {
+        /**
+         * @brief staticText Static text (nullptr when this segment is a directive)
+         */
+        std::shared_ptr<const std::string> staticText;
+        Directive directive;
+    };
+
+    struct Dependency
+    {
+        std::string path;
+        bool exists = false;
+        off_t fileSize = 0;
+        struct timespec modificationTime = {};
+    };
+
+    /**
+     * @brief compile Parse the (include expanded) content into segments
+     * @param content resource content
+     * @return compiled template (without dependencies)
+     */
+    static std::shared_ptr<HTMLIEngineTemplate> compile(const std::string &content);
+
+    /**
+     * @brief getDependency Get the current file information for the path
+     */
+    static Dependency getDependency(const std::string &path);
+
+    /**
+     * @brief isCurrent Check if the files used to build the template remain unchanged (uses stat)
+     */
+    [[nodiscard]] bool isCurrent() const;
+
+    std::vector<Segment> segments;
+    /**
+     * @brief dependencies Files used to build this template (the resource and its includes)
+     */
+    std::vector<Dependency> dependencies;
+    /**
+     * @brief memorySource Source content for the in-memory (MEM:) resources (used to validate the template)
+     */
+    std::string memorySource;
+
+private:
+    static bool parseDirectiveAt(const std::string &content, size_t tagStart, bool useHTMLFrame, size_t &tagEnd, Directive &directive);
+};
+
+} // namespace Mantids30::Network::Servers::Web
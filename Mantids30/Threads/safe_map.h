@@ -19,6 +19,7 @@ namespace Mantids30::Threads::Safe {
  * This class uses std::map as the underlying data structure for key-value pairs.
  * The class provides functions for adding, checking, and removing elements from the map.
  * The class also provides functions for waiting until the map is empty.
+ * For maps accessed from many threads at once, see ShardedMap (safe_shardedmap.h).
  *
  * @tparam T The type of the keys in the map.
  */
@@ -142,11 +143,11 @@ template<class T>
 MapItem *Map<T>::openElement(const T &key)
 {
     std::unique_lock<std::mutex> lock(m_keyValueMapMutex);
-    if (m_keyValueMap.find(key) != m_keyValueMap.end() && m_keyValueMap[key].item)
+    auto i = m_keyValueMap.find(key);
+    if (i != m_keyValueMap.end() && i->second.item)
     {
-        m_keyValueMap[key].numReaders++;
-        return m_keyValueMap[key].item;
-        ;
+        i->second.numReaders++;
+        return i->second.item;
     }
     return nullptr;
 }
@@ -157,18 +158,18 @@ bool Map<T>::releaseElement(const T &key)
 {
     std::unique_lock<std::mutex> lock(m_keyValueMapMutex);
 
-    if (m_keyValueMap.find(key) != m_keyValueMap.end())
+    auto i = m_keyValueMap.find(key);
+    if (i != m_keyValueMap.end())
     {
-        if (m_keyValueMap[key].numReaders == 0)
+        if (i->second.numReaders == 0)
         {
             throw std::runtime_error("Invalid close on Mutex MAP");
         }
 
-        m_keyValueMap[key].numReaders--;
         // if no more readers... emit the signal to notify it:
-        if (m_keyValueMap[key].numReaders == 0)
+        if (--i->second.numReaders == 0)
         {
-            m_keyValueMap[key].noReadersCondition.notify_one();
+            i->second.noReadersCondition.notify_one();
         }
         return true;
     }
@@ -0,0 +1,251 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+
+#include <stdexcept>
+
+#include "safe_mapitem.h"
+
+namespace Mantids30::Threads::Safe {
+
+/**
+ * @brief The ShardedMap class provides a thread-safe hash map split in independently locked shards.
+ *
+ * It has the same semantics as Safe::Map (elements are opened/released by readers, and destroyElement waits
+ * for the readers to finish), but the keys are spread by hash across ShardCount shards, each one with its own
+ * mutex, so operations over different keys seldom contend for the same lock.
+ *
+ * @tparam T The type of the keys in the map.
+ * @tparam Hash The hash function for the keys.
+ * @tparam ShardCount The number of shards (power of two).
+ */
+template<class T, class Hash = std::hash<T>, size_t ShardCount = 32>
+class ShardedMap
+{
+    static_assert(ShardCount > 0 && (ShardCount & (ShardCount - 1)) == 0, "ShardCount must be a power of two");
+
+public:
+    /**
+     * @brief Constructs a new ShardedMap object.
+     */
+    ShardedMap() = default;
+
+    /**
+     * @brief Gets the set of keys in the map.
+     *
+     * The shards are visited one by one, so elements added/removed during the call may or may not be listed.
+     *
+     * @return A set containing all the keys in the map.
+     */
+    std::set<T> getKeys();
+
+    /**
+     * @brief Checks if the given key exists in the map.
+     *
+     * @param key The key to check.
+     * @return true if the key exists in the map, false otherwise.
+     */
+    bool isMember(const T &key);
+
+    /**
+     * @brief Adds an element with the given key to the map.
+     *
+     * @param key The key for the element.
+     * @param element The element to add.
+     * @return true if the element was added successfully, false otherwise.
+     */
+    bool addElement(const T &key, MapItem *element);
+
+    /**
+     * @brief Opens the element with the given key for reading.
+     *
+     * Multiple readers can read the element simultaneously.
+     *
+     * @param key The key for the element.
+     * @return A pointer to the MapItem object associated with the key, or nullptr if the key is not found.
+     */
+    MapItem *openElement(const T &key);
+
+    /**
+     * @brief Releases the element with the given key after reading.
+     *
+     * @param key The key for the element.
+     * @return true if the element was released successfully, false otherwise.
+     */
+    bool releaseElement(const T &key);
+
+    /**
+     * @brief Destroys the element with the given key.
+     *
+     * @param key The key for the element.
+     * @return true if the element was destroyed successfully, false otherwise.
+     */
+    bool destroyElement(const T key);
+
+    /**
+     * @brief Waits until the map is empty.
+     */
+    void waitForEmptyMap();
+
+    /**
+     * @brief Gets the number of elements in the map.
+     */
+    size_t size() const { return m_elementCount; }
+
+private:
+    /**
+     * @brief The MapElement struct stores information about a map element (same as Safe::Map).
+     */
+    struct MapElement
+    {
+        MapItem *item = nullptr;
+        std::atomic<uint32_t> numReaders{0};
+        std::condition_variable noReadersCondition;
+    };
+
+    /**
+     * @brief The Shard struct holds a part of the keys and its lock (aligned to avoid false sharing between shards).
+     */
+    struct alignas(64) Shard
+    {
+        std::unordered_map<T, MapElement, Hash> keyValueMap; ///< The elements of this shard (node based: elements don't move on rehash).
+        std::mutex mutex;                                    ///< The mutex protecting this shard.
+    };
+
+    Shard &getShard(const T &key) { return m_shards[Hash{}(key) & (ShardCount - 1)]; }
+
+    std::array<Shard, ShardCount> m_shards;
+
+    std::atomic<size_t> m_elementCount{0};           ///< The total number of elements in all the shards.
+    std::condition_variable m_noItemsOnMapCondition; ///< The condition variable to wait for the map to become empty.
+    std::mutex m_noItemsOnMapMutex;                  ///< The mutex for m_noItemsOnMapCondition.
+};
+
+template<class T, class Hash, size_t ShardCount>
+std::set<T> ShardedMap<T, Hash, ShardCount>::getKeys()
+{
+    std::set<T> ret;
+    for (auto &shard : m_shards)
+    {
+        std::unique_lock<std::mutex> lock(shard.mutex);
+        for (const auto &i : shard.keyValueMap)
+        {
+            ret.insert(i.first);
+        }
+    }
+    return ret;
+}
+
+template<class T, class Hash, size_t ShardCount>
+bool ShardedMap<T, Hash, ShardCount>::isMember(const T &key)
+{
+    Shard &shard = getShard(key);
+    std::unique_lock<std::mutex> lock(shard.mutex);
+    return (shard.keyValueMap.find(key) != shard.keyValueMap.end());
+}
+
+template<class T, class Hash, size_t ShardCount>
+bool ShardedMap<T, Hash, ShardCount>::addElement(const T &key, MapItem *element)
+{
+    Shard &shard = getShard(key);
+    std::unique_lock<std::mutex> lock(shard.mutex);
+    auto inserted = shard.keyValueMap.try_emplace(key);
+    if (!inserted.second)
+    {
+        return false;
+    }
+    inserted.first->second.item = element;
+    m_elementCount++;
+    return true;
+}
+
+template<class T, class Hash, size_t ShardCount>
+MapItem *ShardedMap<T, Hash, ShardCount>::openElement(const T &key)
+{
+    Shard &shard = getShard(key);
+    std::unique_lock<std::mutex> lock(shard.mutex);
+    auto i = shard.keyValueMap.find(key);
+    if (i != shard.keyValueMap.end() && i->second.item)
+    {
+        i->second.numReaders++;
+        return i->second.item;
+    }
+    return nullptr;
+}
+
+template<class T, class Hash, size_t ShardCount>
+bool ShardedMap<T, Hash, ShardCount>::releaseElement(const T &key)
+{
+    Shard &shard = getShard(key);
+    std::unique_lock<std::mutex> lock(shard.mutex);
+    auto i = shard.keyValueMap.find(key);
+    if (i == shard.keyValueMap.end())
+    {
+        return false;
+    }
+
+    if (i->second.numReaders == 0)
+    {
+        throw std::runtime_error("Invalid close on Mutex MAP");
+    }
+
+    // if no more readers... emit the signal to notify it:
+    if (--i->second.numReaders == 0)
+    {
+        i->second.noReadersCondition.notify_one();
+    }
+    return true;
+}
+
+template<class T, class Hash, size_t ShardCount>
+bool ShardedMap<T, Hash, ShardCount>::destroyElement(const T key)
+{
+    Shard &shard = getShard(key);
+    std::unique_lock<std::mutex> lock(shard.mutex);
+    auto i = shard.keyValueMap.find(key);
+    if (i == shard.keyValueMap.end() || i->second.item == nullptr)
+    {
+        return false;
+    }
+
+    // No more open readers and destroy element.. (inaccesible for openElement and for destroyElement)
+    // (keep the reference: other keys may be added to the shard while waiting, invalidating the iterator)
+    MapElement &element = i->second;
+    MapItem *delElement = element.item;
+    element.item = nullptr;
+
+    while (element.numReaders != 0)
+    {
+        delElement->stopReaders();
+        // unlock and retake the lock until signal is emited.
+        element.noReadersCondition.wait(lock);
+    }
+
+    // Now is time to delete and remove.
+    delete delElement;
+    shard.keyValueMap.erase(key);
+    lock.unlock();
+
+    if (--m_elementCount == 0)
+    {
+        std::unique_lock<std::mutex> emptyLock(m_noItemsOnMapMutex);
+        m_noItemsOnMapCondition.notify_all();
+    }
+    return true;
+}
+
+template<class T, class Hash, size_t ShardCount>
+void ShardedMap<T, Hash, ShardCount>::waitForEmptyMap()
+{
+    std::unique_lock<std::mutex> lock(m_noItemsOnMapMutex);
+    m_noItemsOnMapCondition.wait(lock, [this] { return m_elementCount == 0; });
+}
+
+} // namespace Mantids30::Threads::Safe
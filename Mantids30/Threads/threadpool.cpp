@@ -1,31 +1,51 @@
 #include "threadpool.h"
 
-#include <Mantids30/Helpers/random.h>
+#include <chrono>
+#include <random>
 
 using namespace Mantids30::Threads::Pool;
 
-ThreadPool::ThreadPool(uint32_t threadsCount, uint32_t taskQueues)
+std::mutex ThreadPool::m_livePoolsMutex;
+std::set<ThreadPool *> ThreadPool::m_livePools;
+
+static std::minstd_rand &threadRandomGenerator()
 {
-    std::random_device rd;
-    m_lRand.seed(rd());
+    thread_local std::minstd_rand generator(static_cast<std::minstd_rand::result_type>(std::random_device{}() ^ std::hash<std::thread::id>()(std::this_thread::get_id())));
+    return generator;
+}
 
+ThreadPool::ThreadPool(uint32_t threadsCount, uint32_t taskQueues)
+{
     setMaxTasksPerQueue(100);
 
-    m_terminate = false;
-    m_queuedElements = 0;
     this->m_threadCount = threadsCount;
-    for (size_t i = 0; i < taskQueues; i++)
+    for (size_t i = 0; i < std::max<uint32_t>(1, taskQueues); i++)
+    {
+        m_queues.push_back(std::make_unique<TasksQueue>());
+    }
+    for (size_t i = 0; i < threadsCount; i++)
     {
-        m_queues[i].init = true;
+        m_workerStatistics.push_back(std::make_unique<WorkerStatistics>());
     }
+
+    std::lock_guard<std::mutex> lk(m_livePoolsMutex);
+    m_livePools.insert(this);
 }
 
 ThreadPool::~ThreadPool()
 {
+    {
+        std::lock_guard<std::mutex> lk(m_livePoolsMutex);
+        m_livePools.erase(this);
+    }
+
     stop();
-    for (uint32_t i = 0; i < m_threadCount; i++)
+    for (std::thread &thread : m_threads)
     {
-        m_threads[i].join();
+        if (thread.joinable())
+        {
+            thread.join();
+        }
     }
 }
 
@@ -33,126 +53,178 @@ void ThreadPool::start()
 {
     for (size_t i = 0; i < m_threadCount; i++)
     {
-        m_threads[i] = std::thread(taskProcessor, this);
+        m_threads.emplace_back(taskProcessor, this, i);
     }
 }
 
 void ThreadPool::stop()
 {
-    std::unique_lock<std::mutex> lk(m_queuesMutex);
     m_terminate = true;
-    lk.unlock();
+
+    // Wake up the idle workers (they will consume the remaining tasks and exit)
+    {
+        std::lock_guard<std::mutex> lk(m_idleMutex);
+    }
     m_insertedElementCond.notify_all();
+
+    // Release the producers waiting for room in a queue
+    for (std::unique_ptr<TasksQueue> &queue : m_queues)
+    {
+        {
+            std::lock_guard<std::mutex> lk(queue->mutex);
+        }
+        queue->cond_removedElement.notify_all();
+    }
 }
 
 bool ThreadPool::pushTask(void (*task)(const std::shared_ptr<void> &), const std::shared_ptr<void> &taskData, uint32_t timeoutMS, const float &priority, const std::string &key)
 {
-    size_t currentQueue = getRandomQueueByKey(key, priority);
-
-    // TODO: put to best place first
-    std::unique_lock<std::mutex> lk(m_queuesMutex);
+    TasksQueue &queue = *m_queues[getRandomQueueByKey(key, priority)];
 
     // Don't insert on termination...
     if (m_terminate)
     {
+        queue.rejected.fetch_add(1, std::memory_order_relaxed);
         return false;
     }
 
-    // Check if the queue is up the limit
-    while (m_queues[currentQueue].tasks.size() > m_maxTasksPerQueue)
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMS);
+
+    std::unique_lock<std::mutex> lk(queue.mutex);
+
+    // Check if the queue is up the limit (backpressure)
+    while (queue.tasks.size() >= m_maxTasksPerQueue)
     {
+        if (m_terminate)
+        {
+            queue.rejected.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
         if (timeoutMS == static_cast<uint32_t>(-1))
         {
-            m_queues[currentQueue].cond_removedElement.wait(lk);
+            queue.cond_removedElement.wait(lk);
         }
-        else
+        else if (queue.cond_removedElement.wait_until(lk, deadline) == std::cv_status::timeout && queue.tasks.size() >= m_maxTasksPerQueue)
         {
-            if (m_queues[currentQueue].cond_removedElement.wait_for(lk, std::chrono::milliseconds(timeoutMS)) == std::cv_status::timeout)
-            {
-                return false;
-            }
+            queue.timedOut.fetch_add(1, std::memory_order_relaxed);
+            return false;
         }
     }
 
+    if (m_terminate)
+    {
+        queue.rejected.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
     // Now is not full, insert it.
     Task toInsert;
     toInsert.data = taskData;
     toInsert.task = task;
-    m_queues[currentQueue].tasks.push(toInsert);
+    toInsert.enqueueTime = std::chrono::steady_clock::now();
+    queue.tasks.push_back(toInsert);
+    queue.count++;
+    queue.enqueued.fetch_add(1, std::memory_order_relaxed);
+    m_queuedElements++;
+    lk.unlock();
 
     // Notify that there is one element in one of the lists...
-    lk.unlock();
-    m_insertedElementCond.notify_one();
+    wakeUpWorker();
     return true;
 }
 
-ThreadPool::Task ThreadPool::popTask()
+ThreadPool::Task ThreadPool::popTask(size_t workerId)
 {
-#ifndef _WIN32
-    pthread_setname_np(pthread_self(), "tp_poptask");
-#endif
-
-    // lock and wait for an incoming task
-    std::unique_lock<std::mutex> lk(m_queuesMutex);
+    size_t homeQueue = workerId % m_queues.size();
 
-    TasksQueue *tq = getRandomTaskQueueWithElements();
-    while (tq == nullptr)
+    for (;;)
     {
-        // No available elements...
-        m_insertedElementCond.wait(lk);
+        Task r;
 
-        // On termination, empty queue means exit
-        if (m_terminate && (tq = getRandomTaskQueueWithElements()) == nullptr)
+        // First, our own queue:
+        if (tryPopFromQueue(homeQueue, &r, true))
         {
-            Task r;
             return r;
         }
-        else if (!m_terminate)
+
+        // Then, steal from the other queues (starting from a random one, without waiting for busy queues):
+        size_t start = threadRandomGenerator()() % m_queues.size();
+        for (size_t i = 0; i < m_queues.size(); i++)
         {
-            tq = getRandomTaskQueueWithElements();
+            size_t queueId = (start + i) % m_queues.size();
+            if (queueId != homeQueue && tryPopFromQueue(queueId, &r, false))
+            {
+                m_queues[queueId]->stolen.fetch_add(1, std::memory_order_relaxed);
+                return r;
+            }
         }
-    }
 
-    Task r = tq->tasks.front();
-    tq->tasks.pop();
+        // Nothing to do, wait for an incoming task
+        std::unique_lock<std::mutex> lk(m_idleMutex);
+        m_idleWorkers++;
+        m_insertedElementCond.wait(lk, [this] { return m_queuedElements > 0 || m_terminate; });
+        m_idleWorkers--;
 
-    // Notify!
-    lk.unlock();
-    tq->cond_removedElement.notify_one();
-    return r;
+        // On termination, empty queues means exit
+        if (m_terminate && m_queuedElements == 0)
+        {
+            return Task();
+        }
+    }
 }
 
-ThreadPool::TasksQueue *ThreadPool::getRandomTaskQueueWithElements()
+bool ThreadPool::tryPopFromQueue(size_t queueId, Task *task, bool waitForLock)
 {
-    std::vector<size_t> fullVector;
-    // Randomize the full vector
-    for (size_t i = 0; i < m_queues.size(); ++i)
+    TasksQueue &queue = *m_queues[queueId];
+
+    // Cheap check without locking.
+    if (queue.count == 0)
+    {
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lk(queue.mutex, std::defer_lock);
+    if (waitForLock)
     {
-        fullVector.push_back(i);
+        lk.lock();
     }
-    std::uniform_int_distribution<size_t> dis;
-    m_randomMutex.lock();
-    Mantids30::Helpers::Random::safe_random_shuffle(fullVector.begin(), fullVector.end(), static_cast<size_t>(dis(m_lRand)));
-    m_randomMutex.unlock();
+    else if (!lk.try_lock())
+    {
+        return false;
+    }
+
+    if (queue.tasks.empty())
+    {
+        return false;
+    }
+
+    *task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    queue.count--;
+    queue.dequeued.fetch_add(1, std::memory_order_relaxed);
+    m_queuedElements--;
 
-    // Iterate full Vector...
-    for (size_t i : fullVector)
+    // Notify!
+    lk.unlock();
+    queue.cond_removedElement.notify_one();
+    return true;
+}
+
+void ThreadPool::wakeUpWorker()
+{
+    if (m_idleWorkers > 0)
     {
-        if (!m_queues[i].tasks.empty())
         {
-            return &(m_queues[i]);
+            std::lock_guard<std::mutex> lk(m_idleMutex);
         }
+        m_insertedElementCond.notify_one();
     }
-    return nullptr;
 }
 
 size_t ThreadPool::getRandomQueueByKey(const std::string &key, const float &priority)
 {
-    size_t x;
-    std::vector<size_t> reducedVector;
-    std::vector<size_t> fullVector;
-
-    // Convert priority in vector elements...
+    // Convert priority in queue elements...
     size_t elements = static_cast<size_t>(m_queues.size() * priority);
     if (elements == 0)
     {
@@ -163,26 +235,9 @@ size_t ThreadPool::getRandomQueueByKey(const std::string &key, const float &prio
         elements = m_queues.size();
     }
 
-    // Randomize the full vector using the hash of key
-    for (size_t i = 0; i < m_queues.size(); ++i)
-    {
-        fullVector.push_back(i);
-    }
-    Mantids30::Helpers::Random::safe_random_shuffle(fullVector.begin(), fullVector.end(), m_hashFunction(key));
-
-    // Copy the first n-elements (based on priority)
-    for (size_t i = 0; i < elements; i++)
-    {
-        reducedVector.push_back(fullVector[i]);
-    }
-
-    // Get random element from the reduced vector:
-    std::uniform_int_distribution<> dis(0, static_cast<int>(elements - 1));
-    m_randomMutex.lock();
-    x = reducedVector.at(static_cast<size_t>(dis(m_lRand)));
-    m_randomMutex.unlock();
-
-    return x;
+    // The key selects a deterministic window of queues, get a random queue inside that window:
+    size_t base = m_hashFunction(key) % m_queues.size();
+    return (base + (threadRandomGenerator()() % elements)) % m_queues.size();
 }
 
 uint32_t ThreadPool::getMaxTasksPerQueue() const
@@ -194,21 +249,152 @@ void ThreadPool::setMaxTasksPerQueue(const uint32_t &value)
 {
     m_maxTasksPerQueue = value;
 
-    for (std::pair<const size_t, TasksQueue> &i : m_queues)
+    for (std::unique_ptr<TasksQueue> &queue : m_queues)
     {
-        i.second.cond_removedElement.notify_all();
+        queue->cond_removedElement.notify_all();
     }
 }
 
-void ThreadPool::taskProcessor(ThreadPool *tp)
+void ThreadPool::taskProcessor(ThreadPool *tp, size_t workerId)
 {
 #ifdef __linux__
     pthread_setname_np(pthread_self(), "ThrPool:TaskC");
 #endif
 
-    for (Task task = tp->popTask(); !task.isNull(); task = tp->popTask())
+    WorkerStatistics &workerStatistics = *tp->m_workerStatistics[workerId];
+
+    for (Task task = tp->popTask(workerId); !task.isNull(); task = tp->popTask(workerId))
     {
-        //std::cout << "ejecutando " << task.data << '\n' << std::flush;
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+        tp->m_queueWaitHistogram.add(std::chrono::duration_cast<std::chrono::microseconds>(startTime - task.enqueueTime).count());
+
+        workerStatistics.busy.store(true, std::memory_order_relaxed);
         task.task(task.data);
+        workerStatistics.busy.store(false, std::memory_order_relaxed);
+
+        uint64_t elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+        tp->m_executionHistogram.add(elapsed);
+        workerStatistics.executedTasks.fetch_add(1, std::memory_order_relaxed);
+        workerStatistics.busyMicroseconds.fetch_add(elapsed, std::memory_order_relaxed);
+    }
+}
+
+void ThreadPool::setName(const std::string &name)
+{
+    std::lock_guard<std::mutex> lk(m_nameMutex);
+    m_name = name;
+}
+
+std::string ThreadPool::getName() const
+{
+    std::lock_guard<std::mutex> lk(m_nameMutex);
+    return m_name;
+}
+
+Json::Value ThreadPool::getStatisticsSnapshot() const
+{
+    Json::Value r;
+
+    r["name"] = getName();
+    r["threads"] = m_threadCount;
+    r["maxTasksPerQueue"] = m_maxTasksPerQueue.load();
+    r["queuedTasks"] = m_queuedElements.load();
+    r["idleWorkers"] = m_idleWorkers.load();
+
+    Json::UInt64 enqueued = 0, dequeued = 0, stolen = 0, rejected = 0, timedOut = 0;
+    r["queues"] = Json::arrayValue;
+    for (const std::unique_ptr<TasksQueue> &queue : m_queues)
+    {
+        Json::Value q;
+        q["depth"] = queue->count.load(std::memory_order_relaxed);
+        q["enqueued"] = static_cast<Json::UInt64>(queue->enqueued.load(std::memory_order_relaxed));
+        q["dequeued"] = static_cast<Json::UInt64>(queue->dequeued.load(std::memory_order_relaxed));
+        q["stolen"] = static_cast<Json::UInt64>(queue->stolen.load(std::memory_order_relaxed));
+        q["rejected"] = static_cast<Json::UInt64>(queue->rejected.load(std::memory_order_relaxed));
+        q["timedOut"] = static_cast<Json::UInt64>(queue->timedOut.load(std::memory_order_relaxed));
+
+        enqueued += q["enqueued"].asUInt64();
+        dequeued += q["dequeued"].asUInt64();
+        stolen += q["stolen"].asUInt64();
+        rejected += q["rejected"].asUInt64();
+        timedOut += q["timedOut"].asUInt64();
+
+        r["queues"].append(q);
+    }
+
+    r["totals"]["enqueued"] = enqueued;
+    r["totals"]["dequeued"] = dequeued;
+    r["totals"]["stolen"] = stolen;
+    r["totals"]["rejected"] = rejected;
+    r["totals"]["timedOut"] = timedOut;
+
+    uint32_t busyWorkers = 0;
+    r["workers"] = Json::arrayValue;
+    for (const std::unique_ptr<WorkerStatistics> &worker : m_workerStatistics)
+    {
+        Json::Value w;
+        w["busy"] = worker->busy.load(std::memory_order_relaxed);
+        w["executedTasks"] = static_cast<Json::UInt64>(worker->executedTasks.load(std::memory_order_relaxed));
+        w["busyMicroseconds"] = static_cast<Json::UInt64>(worker->busyMicroseconds.load(std::memory_order_relaxed));
+        if (w["busy"].asBool())
+        {
+            busyWorkers++;
+        }
+        r["workers"].append(w);
+    }
+    r["busyWorkers"] = busyWorkers;
+
+    r["queueWaitTime"] = m_queueWaitHistogram.toJSON();
+    r["executionTime"] = m_executionHistogram.toJSON();
+
+    return r;
+}
+
+Json::Value ThreadPool::getGlobalStatisticsSnapshot()
+{
+    Json::Value r = Json::arrayValue;
+    std::lock_guard<std::mutex> lk(m_livePoolsMutex);
+    for (ThreadPool *pool : m_livePools)
+    {
+        r.append(pool->getStatisticsSnapshot());
     }
+    return r;
+}
+
+void ThreadPool::LatencyHistogram::add(uint64_t microseconds)
+{
+    size_t bucket = 0;
+    while (bucket < BUCKETS - 1 && (static_cast<uint64_t>(1) << bucket) <= microseconds)
+    {
+        bucket++;
+    }
+
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    totalMicroseconds.fetch_add(microseconds, std::memory_order_relaxed);
+
+    uint64_t currentMax = maxMicroseconds.load(std::memory_order_relaxed);
+    while (microseconds > currentMax && !maxMicroseconds.compare_exchange_weak(currentMax, microseconds, std::memory_order_relaxed))
+    {
+    }
+}
+
+Json::Value ThreadPool::LatencyHistogram::toJSON() const
+{
+    Json::Value r;
+    r["count"] = static_cast<Json::UInt64>(count.load(std::memory_order_relaxed));
+    r["totalMicroseconds"] = static_cast<Json::UInt64>(totalMicroseconds.load(std::memory_order_relaxed));
+    r["maxMicroseconds"] = static_cast<Json::UInt64>(maxMicroseconds.load(std::memory_order_relaxed));
+
+    // Buckets by upper bound ("<2^n us"), only the non-empty ones:
+    r["buckets"] = Json::objectValue;
+    for (size_t i = 0; i < BUCKETS; i++)
+    {
+        uint64_t value = buckets[i].load(std::memory_order_relaxed);
+        if (value)
+        {
+            r["buckets"][i == BUCKETS - 1 ? std::string("inf") : ("<" + std::to_string(static_cast<uint64_t>(1) << i) + "us")] = static_cast<Json::UInt64>(value);
+        }
+    }
+    return r;
 }
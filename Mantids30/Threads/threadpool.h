@@ -1,19 +1,33 @@
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
-#include <map>
+#include <deque>
+#include <json/json.h>
 #include <memory>
-#include <queue>
-#include <random>
+#include <mutex>
+#include <set>
 #include <string>
 #include <thread>
+#include <vector>
 
 namespace Mantids30::Threads::Pool {
 
-// TODO: statistics
 /**
  * @brief Advanced Thread Pool.
+ *
+ * Tasks are stored in bounded queues, each worker thread has its own home queue and steals from the other
+ * queues when its home queue is empty. Every queue has its own lock, so producers and consumers only contend
+ * when they touch the same queue.
+ *
+ * Key affinity: the tasks pushed with the same key are distributed only within a deterministic subset of the
+ * queues (the subset size is defined by the priority), so a single key can't saturate all the queues.
+ *
+ * Statistics: every queue and worker keeps relaxed atomic counters (and the pool keeps queue-wait/execution
+ * latency histograms), they can be read at any time as a JSON snapshot (see getStatisticsSnapshot and
+ * getGlobalStatisticsSnapshot).
  */
 class ThreadPool
 {
@@ -30,14 +44,45 @@ public:
 
         void (*task)(const std::shared_ptr<void> &);
         std::shared_ptr<void> data;
+        std::chrono::steady_clock::time_point enqueueTime;
+    };
+
+    /**
+     * @brief The LatencyHistogram struct counts durations in power-of-two microsecond buckets (bucket n: < 2^n us).
+     */
+    struct LatencyHistogram
+    {
+        static constexpr size_t BUCKETS = 24;
+
+        void add(uint64_t microseconds);
+        [[nodiscard]] Json::Value toJSON() const;
+
+        std::array<std::atomic<uint64_t>, BUCKETS> buckets{};
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> totalMicroseconds{0};
+        std::atomic<uint64_t> maxMicroseconds{0};
     };
 
     struct TasksQueue
     {
-        TasksQueue() { init = true; }
-        std::queue<Task> tasks;
+        std::deque<Task> tasks;
+        std::atomic<uint32_t> count{0};
+        std::mutex mutex;
         std::condition_variable cond_removedElement;
-        bool init;
+
+        // Statistics:
+        std::atomic<uint64_t> enqueued{0};
+        std::atomic<uint64_t> dequeued{0};
+        std::atomic<uint64_t> stolen{0};
+        std::atomic<uint64_t> rejected{0};
+        std::atomic<uint64_t> timedOut{0};
+    };
+
+    struct alignas(64) WorkerStatistics
+    {
+        std::atomic<bool> busy{false};
+        std::atomic<uint64_t> executedTasks{0};
+        std::atomic<uint64_t> busyMicroseconds{0};
     };
 
     /**
@@ -67,10 +112,11 @@ public:
     bool pushTask(void (*task)(const std::shared_ptr<void> &), const std::shared_ptr<void> &taskData, uint32_t timeoutMS = static_cast<uint32_t>(-1), const float &priority = 0.5,
                   const std::string &key = "");
     /**
-     * @brief popTask function used by thread processor
-     * @return task
+     * @brief popTask function used by thread processor, takes a task from the worker home queue, or steals it from another queue.
+     * @param workerId worker number (determines the home queue)
+     * @return task (null task when the pool is terminated and there are no pending tasks)
      */
-    Task popTask();
+    Task popTask(size_t workerId = 0);
 
     /**
      * @brief getMaxTasksPerQueue Retrieves the maximum number of tasks a single queue can hold before it reaches capacity.
@@ -85,33 +131,65 @@ public:
      */
     void setMaxTasksPerQueue(const uint32_t &value);
 
+    /**
+     * @brief setName Set the pool name used to identify it in the statistics snapshots.
+     * @param name pool name (eg. "FastRPC3")
+     */
+    void setName(const std::string &name);
+    /**
+     * @brief getName Get the pool name
+     */
+    [[nodiscard]] std::string getName() const;
+
+    /**
+     * @brief getStatisticsSnapshot Get the current pool counters (queues, workers and latency histograms).
+     * @return JSON object with the statistics (the counters are read without stopping the pool, so they can be slightly inconsistent between them)
+     */
+    [[nodiscard]] Json::Value getStatisticsSnapshot() const;
+    /**
+     * @brief getGlobalStatisticsSnapshot Get the statistics of every live thread pool in this process (eg. to be exposed by a service status endpoint).
+     * @return JSON array with one snapshot per pool
+     */
+    static Json::Value getGlobalStatisticsSnapshot();
+
 private:
-    static void taskProcessor(ThreadPool *tp);
+    static void taskProcessor(ThreadPool *tp, size_t workerId);
 
     size_t getRandomQueueByKey(const std::string &key, const float &priority);
-    TasksQueue *getRandomTaskQueueWithElements();
+    bool tryPopFromQueue(size_t queueId, Task *task, bool waitForLock);
+    void wakeUpWorker();
 
     // TERMINATION:
-    bool m_terminate;
+    std::atomic<bool> m_terminate{false};
 
     // LIMITS:
     std::atomic<uint32_t> m_maxTasksPerQueue;
 
     // THREADS:
-    std::map<size_t, std::thread> m_threads;
+    std::vector<std::thread> m_threads;
     uint32_t m_threadCount;
 
-    // QUEUE OPERATIONS/CONDITIONS:
-    std::map<size_t, TasksQueue> m_queues;
-    std::mutex m_queuesMutex;
+    // QUEUES:
+    std::vector<std::unique_ptr<TasksQueue>> m_queues;
+    std::atomic<uint32_t> m_queuedElements{0};
+
+    // IDLE WORKERS:
+    std::mutex m_idleMutex;
     std::condition_variable m_insertedElementCond;
-    std::condition_variable m_emptyCond;
-    uint32_t m_queuedElements;
+    std::atomic<uint32_t> m_idleWorkers{0};
 
-    // RANDOM:
+    // KEY HASHING:
     std::hash<std::string> m_hashFunction;
-    std::mutex m_randomMutex;
-    std::minstd_rand0 m_lRand;
+
+    // STATISTICS:
+    std::string m_name = "ThreadPool";
+    mutable std::mutex m_nameMutex;
+    std::vector<std::unique_ptr<WorkerStatistics>> m_workerStatistics;
+    LatencyHistogram m_queueWaitHistogram;
+    LatencyHistogram m_executionHistogram;
+
+    static std::mutex m_livePoolsMutex;
+    static std::set<ThreadPool *> m_livePools;
 };
 
 } // namespace Mantids30::Threads::Pool
@@ -0,0 +1,192 @@
+// B_Chunks benchmark: displace and prepend heavy workloads on the chunked binary container.
+//
+// The same workloads run against PreviousChunks, a compact model of the previous B_Chunks layout (a vector of exactly
+// sized chunks, where displacing copies the remaining part of the first chunk and both displacing and prepending
+// recalculate every chunk offset), to keep the comparison reproducible in-tree.
+//
+// Usage: bench_b_chunks [networkReads] [bytewiseAppends] [prepends]
+
+#include "bench_common.h"
+
+#include <Mantids30/Memory/b_chunks.h>
+
+#include <cstring>
+#include <optional>
+#include <vector>
+
+using namespace Mantids30;
+
+namespace {
+
+class PreviousChunks
+{
+public:
+    ~PreviousChunks()
+    {
+        for (auto &chunk : m_chunks)
+            delete[] chunk.data;
+    }
+
+    void append(const void *buf, size_t len) { insert(buf, len, false); }
+    void prepend(const void *buf, size_t len) { insert(buf, len, true); }
+
+    void displace(size_t bytes)
+    {
+        while (bytes && !m_chunks.empty())
+        {
+            Chunk &first = m_chunks.front();
+            if (bytes >= first.size)
+            {
+                bytes -= first.size;
+                m_size -= first.size;
+                delete[] first.data;
+                m_chunks.erase(m_chunks.begin());
+            }
+            else
+            {
+                char *data = new char[first.size - bytes];
+                memcpy(data, first.data + bytes, first.size - bytes);
+                delete[] first.data;
+                first.data = data;
+                first.size -= bytes;
+                m_size -= bytes;
+                bytes = 0;
+            }
+        }
+        recalcChunkOffsets();
+    }
+
+    [[nodiscard]] std::optional<size_t> findChar(char c) const
+    {
+        for (const auto &chunk : m_chunks)
+        {
+            if (const void *found = memchr(chunk.data, c, chunk.size))
+                return chunk.offset + static_cast<size_t>(static_cast<const char *>(found) - chunk.data);
+        }
+        return std::nullopt;
+    }
+
+    [[nodiscard]] size_t size() const { return m_size; }
+
+private:
+    struct Chunk
+    {
+        char *data;
+        size_t size;
+        size_t offset;
+    };
+
+    void insert(const void *buf, size_t len, bool prependMode)
+    {
+        Chunk chunk{new char[len], len, prependMode || m_chunks.empty() ? 0 : m_chunks.back().offset + m_chunks.back().size};
+        memcpy(chunk.data, buf, len);
+        if (prependMode)
+        {
+            m_chunks.insert(m_chunks.begin(), chunk);
+            recalcChunkOffsets();
+        }
+        else
+        {
+            m_chunks.push_back(chunk);
+        }
+        m_size += len;
+    }
+
+    void recalcChunkOffsets()
+    {
+        size_t offset = 0;
+        for (auto &chunk : m_chunks)
+        {
+            chunk.offset = offset;
+            offset += chunk.size;
+        }
+    }
+
+    std::vector<Chunk> m_chunks;
+    size_t m_size = 0;
+};
+
+/**
+ * @brief The CurrentChunks struct exposes B_Chunks through the same calls used by PreviousChunks.
+ */
+struct CurrentChunks
+{
+    void append(const void *buf, size_t len) { container.append(buf, len); }
+    void prepend(const void *buf, size_t len) { container.prepend(buf, len); }
+    void displace(size_t bytes) { container.displace(bytes); }
+    [[nodiscard]] std::optional<size_t> findChar(char c) { return container.findChar(c, 0, container.size(), false); }
+    [[nodiscard]] size_t size() { return container.size(); }
+
+    Memory::Containers::B_Chunks container;
+};
+
+// Network style line parsing: append 4KB reads and consume 40 byte lines from the front.
+template<typename Container>
+void runLineParsing(const std::string &name, size_t reads)
+{
+    std::string networkRead;
+    for (size_t i = 0; i < 4096; i++)
+        networkRead += (i % 40 == 39) ? '\n' : 'x';
+
+    Container container;
+    size_t consumed = 0;
+    Bench::Stopwatch stopwatch;
+    for (size_t r = 0; r < reads; r++)
+    {
+        container.append(networkRead.data(), networkRead.size());
+        for (std::optional<size_t> pos = container.findChar('\n'); pos; pos = container.findChar('\n'))
+        {
+            container.displace(*pos + 1);
+            consumed += *pos + 1;
+        }
+    }
+    Bench::report(name, consumed, stopwatch.elapsedSeconds());
+}
+
+// One byte appends, displacing most of the data every 64 bytes.
+template<typename Container>
+void runBytewise(const std::string &name, size_t appends)
+{
+    Container container;
+    Bench::Stopwatch stopwatch;
+    for (size_t i = 0; i < appends; i++)
+    {
+        char c = 'a';
+        container.append(&c, 1);
+        if (i % 64 == 63)
+            container.displace(60);
+    }
+    Bench::report(name, appends, stopwatch.elapsedSeconds());
+}
+
+// Protocol framing: prepend a small header in front of the growing payload.
+template<typename Container>
+void runPrepend(const std::string &name, size_t prepends)
+{
+    const char header[64] = {};
+    Container container;
+    Bench::Stopwatch stopwatch;
+    for (size_t i = 0; i < prepends; i++)
+        container.prepend(header, sizeof(header));
+    Bench::report(name, prepends, stopwatch.elapsedSeconds());
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    size_t reads = Bench::argOrDefault(argc, argv, 1, 20000);
+    size_t appends = Bench::argOrDefault(argc, argv, 2, 200000);
+    size_t prepends = Bench::argOrDefault(argc, argv, 3, 20000);
+
+    printf("B_Chunks: %zu network reads, %zu bytewise appends, %zu prepends\n", reads, appends, prepends);
+
+    runLineParsing<PreviousChunks>("line parsing, bytes (previous)", reads);
+    runLineParsing<CurrentChunks>("line parsing, bytes (B_Chunks)", reads);
+    runBytewise<PreviousChunks>("bytewise append + displace (previous)", appends);
+    runBytewise<CurrentChunks>("bytewise append + displace (B_Chunks)", appends);
+    runPrepend<PreviousChunks>("prepend 64 bytes (previous)", prepends);
+    runPrepend<CurrentChunks>("prepend 64 bytes (B_Chunks)", prepends);
+
+    return 0;
+}
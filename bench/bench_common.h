@@ -0,0 +1,54 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace Mantids30::Bench {
+
+/**
+ * @brief The Stopwatch class measures the wall time of a benchmark section.
+ */
+class Stopwatch
+{
+public:
+    Stopwatch() { reset(); }
+
+    void reset() { m_start = std::chrono::steady_clock::now(); }
+
+    [[nodiscard]] double elapsedSeconds() const { return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count(); }
+
+private:
+    std::chrono::steady_clock::time_point m_start;
+};
+
+/**
+ * @brief argOrDefault Read an optional positive numeric argument (used to scale the benchmark size from the command line).
+ * @param argc main argc
+ * @param argv main argv
+ * @param pos argument position
+ * @param defaultValue value used when the argument is missing or invalid
+ * @return the argument value
+ */
+inline size_t argOrDefault(int argc, char *argv[], int pos, size_t defaultValue)
+{
+    if (argc <= pos)
+        return defaultValue;
+    size_t value = std::strtoull(argv[pos], nullptr, 10);
+    return value ? value : defaultValue;
+}
+
+/**
+ * @brief report Print one result line as: name, operations, seconds and operations per second.
+ * @param name benchmark case name
+ * @param operations operations performed
+ * @param seconds elapsed time
+ */
+inline void report(const std::string &name, size_t operations, double seconds)
+{
+    printf("%-48s %12zu ops %10.3f s %14.0f ops/s\n", name.c_str(), operations, seconds, seconds > 0 ? static_cast<double>(operations) / seconds : 0.0);
+    fflush(stdout);
+}
+
+} // namespace Mantids30::Bench
@@ -0,0 +1,127 @@
+// FastRPC3 batch benchmark: the same echo calls sent one by one (executeTask) and grouped in batch frames (executeBatch)
+// over a loopback TCP connection.
+//
+// Usage: bench_fastrpc3_batch [rounds] [callsPerBatch]
+
+#include "bench_common.h"
+
+#include <Mantids30/Net_Sockets/socket_tcp.h>
+#include <Mantids30/Protocol_FastRPC3/fastrpc3.h>
+
+#include <ctime>
+#include <thread>
+#include <unistd.h>
+
+using namespace Mantids30;
+using namespace Mantids30::Network::Protocol::FastRPC;
+using namespace Mantids30::Network::Sockets;
+
+static Json::Value echo(void *, const std::shared_ptr<Sessions::Session> &, const Json::Value &payload)
+{
+    return payload;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t rounds = Bench::argOrDefault(argc, argv, 1, 200);
+    size_t callsPerBatch = Bench::argOrDefault(argc, argv, 2, 50);
+
+    FastRPC3 server(8, 16), client(4, 8);
+
+    API::Monolith::Endpoints::EndpointDefinition definition;
+    definition.endpointFunction = {echo, nullptr};
+    definition.endpointName = "echo";
+    definition.isActiveSessionRequired = false;
+    server.config.methodHandlers->addEndpoint(definition);
+
+    // Calls without a session are rejected by the endpoint requirements, so the client logs in with a signed token.
+    auto jwt = std::make_shared<DataFormat::JWT>(DataFormat::JWT::Algorithm::HS256);
+    jwt->setSharedSecret("benchmark shared secret");
+    server.config.jwtValidator = jwt;
+
+    DataFormat::JWT::Token token;
+    token.setSubject("bench");
+    token.setClaim("isAdmin", true);
+    token.setExpirationTime(time(nullptr) + 3600);
+    std::string signedToken = jwt->signFromToken(token);
+
+    auto listener = std::make_shared<Socket_TCP>();
+    if (!listener->listenOn(0, "127.0.0.1"))
+    {
+        fprintf(stderr, "unable to listen on the loopback interface\n");
+        return 1;
+    }
+    uint16_t port = listener->getLocalPort();
+
+    std::thread serverThread([&]() {
+        std::shared_ptr<Socket_Stream> stream = listener->acceptConnection();
+        if (stream)
+        {
+            stream->postAcceptSubInitialization();
+            server.handleClientConnection(stream);
+        }
+    });
+
+    auto clientSocket = std::make_shared<Socket_TCP>();
+    if (!clientSocket->connectTo("127.0.0.1", port))
+    {
+        fprintf(stderr, "unable to connect to the loopback server\n");
+        return 1;
+    }
+    std::thread clientThread([&]() { client.handleConnection(clientSocket, true); });
+
+    while (!client.doesConnectionExist("SERVER"))
+        usleep(1000);
+
+    std::vector<FastRPC3::BatchCall> calls;
+    for (size_t i = 0; i < callsPerBatch; i++)
+    {
+        Json::Value payload;
+        payload["i"] = static_cast<Json::UInt64>(i);
+        payload["text"] = "benchmark payload";
+        calls.push_back({"echo", payload});
+    }
+
+    Json::Value loginError;
+    client.remote("SERVER").loginViaJWTToken(signedToken, &loginError);
+    if (!loginError["succeed"].asBool())
+    {
+        fprintf(stderr, "login failed: %s\n", loginError.toStyledString().c_str());
+        return 1;
+    }
+
+    // Warm up (this also lets both peers exchange the batch capability).
+    client.remote("SERVER").executeBatch(calls);
+
+    printf("FastRPC3 loopback echo: %zu rounds of %zu calls\n", rounds, callsPerBatch);
+
+    size_t failures = 0;
+    Bench::Stopwatch stopwatch;
+    for (size_t r = 0; r < rounds; r++)
+    {
+        for (const auto &call : calls)
+        {
+            Json::Value error;
+            client.remote("SERVER").executeTask(call.methodName, call.payload, &error);
+            failures += error["succeed"].asBool() ? 0 : 1;
+        }
+    }
+    Bench::report("executeTask, one call per frame", rounds * callsPerBatch, stopwatch.elapsedSeconds());
+
+    stopwatch.reset();
+    for (size_t r = 0; r < rounds; r++)
+    {
+        for (const auto &result : client.remote("SERVER").executeBatch(calls))
+            failures += result.error["succeed"].asBool() ? 0 : 1;
+    }
+    Bench::report("executeBatch, " + std::to_string(callsPerBatch) + " calls per frame", rounds * callsPerBatch, stopwatch.elapsedSeconds());
+
+    if (failures)
+        fprintf(stderr, "%zu calls failed\n", failures);
+
+    clientSocket->shutdownSocket();
+    clientThread.join();
+    serverThread.join();
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,86 @@
+// RESTful Router benchmark: lookups over a few thousand registered endpoint paths.
+//
+// Static paths are also looked up in a std::map<std::string, ...> keyed by the full path (the previous per-method
+// endpoint map), so the radix tree cost can be compared with an exact-match lookup. Parameterized and wildcard paths
+// can only be resolved by the Router.
+//
+// Usage: bench_restful_router [resources] [lookups]
+
+#include "bench_common.h"
+
+#include <Mantids30/API_EndpointsAndSessions/api_restful_router.h>
+
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace Mantids30;
+using Method = Network::Protocol::HTTP::Method;
+
+int main(int argc, char *argv[])
+{
+    size_t resources = Bench::argOrDefault(argc, argv, 1, 1000);
+    size_t lookups = Bench::argOrDefault(argc, argv, 2, 2000000);
+
+    API::RESTful::Router router;
+    std::map<std::string, size_t> previousMap;
+
+    // Every resource gets a static listing route, a typed parameter route, a nested parameter route and a wildcard.
+    size_t routeId = 0;
+    std::vector<std::string> staticPaths, parameterPaths, wildcardPaths;
+    for (size_t i = 0; i < resources; i++)
+    {
+        std::string resource = "api/resource" + std::to_string(i);
+
+        router.addRoute(Method::GET, resource + "/list", routeId);
+        previousMap[resource + "/list"] = routeId++;
+        router.addRoute(Method::GET, resource + "/{id:uint}", routeId++);
+        router.addRoute(Method::GET, resource + "/{id:uint}/items/{item}", routeId++);
+        router.addRoute(Method::GET, resource + "/files/{path*}", routeId++);
+
+        staticPaths.push_back(resource + "/list");
+        parameterPaths.push_back(resource + "/" + std::to_string(i * 7) + "/items/item" + std::to_string(i));
+        wildcardPaths.push_back(resource + "/files/a/b/c/file" + std::to_string(i) + ".txt");
+    }
+
+    printf("RESTful Router: %zu routes, %zu lookups per case\n", routeId, lookups);
+
+    // Same pseudo-random access sequence for every case.
+    std::vector<size_t> order(lookups);
+    std::mt19937 random(12345);
+    for (auto &index : order)
+        index = random() % resources;
+
+    size_t found = 0;
+    Bench::Stopwatch stopwatch;
+    for (size_t index : order)
+    {
+        // The previous endpoint lookup built a std::string key for each request.
+        std::string key(staticPaths[index]);
+        found += previousMap.find(key) != previousMap.end();
+    }
+    Bench::report("static path, std::map exact match (previous)", lookups, stopwatch.elapsedSeconds());
+
+    struct Case
+    {
+        const char *name;
+        const std::vector<std::string> *paths;
+    };
+    for (const Case &c : {Case{"static path, Router", &staticPaths}, Case{"two parameters, Router", &parameterPaths}, Case{"wildcard, Router", &wildcardPaths}})
+    {
+        stopwatch.reset();
+        for (size_t index : order)
+        {
+            API::RESTful::PathParameters parameters;
+            found += router.match(Method::GET, (*c.paths)[index], parameters).has_value();
+        }
+        Bench::report(c.name, lookups, stopwatch.elapsedSeconds());
+    }
+
+    if (found != lookups * 4)
+    {
+        fprintf(stderr, "unexpected lookup misses: %zu found of %zu\n", found, lookups * 4);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,72 @@
+// ShardedMap benchmark: threads open and release elements of a shared map (the connection/session lookup pattern),
+// comparing the single-lock Safe::Map against the lock-sharded Safe::ShardedMap as the thread count grows.
+//
+// Usage: bench_shardedmap [operationsPerThread] [elements]
+
+#include "bench_common.h"
+
+#include <Mantids30/Threads/safe_map.h>
+#include <Mantids30/Threads/safe_shardedmap.h>
+
+#include <thread>
+#include <vector>
+
+using namespace Mantids30;
+using namespace Mantids30::Threads::Safe;
+
+namespace {
+
+struct BenchItem : public MapItem
+{
+};
+
+template<typename SafeMap>
+void runOpenRelease(const std::string &name, size_t threadsCount, size_t operationsPerThread, const std::vector<std::string> &keys)
+{
+    SafeMap map;
+    for (const auto &key : keys)
+        map.addElement(key, new BenchItem);
+
+    Bench::Stopwatch stopwatch;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threadsCount; t++)
+    {
+        threads.emplace_back([&map, &keys, t, operationsPerThread]() {
+            for (size_t i = 0; i < operationsPerThread; i++)
+            {
+                const std::string &key = keys[(i * 7 + t) % keys.size()];
+                if (map.openElement(key))
+                    map.releaseElement(key);
+            }
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    Bench::report(name + ", " + std::to_string(threadsCount) + " threads", threadsCount * operationsPerThread, stopwatch.elapsedSeconds());
+
+    // destroyElement deletes each released element:
+    for (const auto &key : keys)
+        map.destroyElement(key);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    size_t operationsPerThread = Bench::argOrDefault(argc, argv, 1, 200000);
+    size_t elements = Bench::argOrDefault(argc, argv, 2, 1024);
+
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < elements; i++)
+        keys.push_back("connection-" + std::to_string(i));
+
+    printf("Safe map open/release: %zu elements, %zu operations per thread\n", elements, operationsPerThread);
+
+    for (size_t threadsCount : {1, 2, 4, 8, 16, 32, 64})
+    {
+        runOpenRelease<Map<std::string>>("Map (single lock)", threadsCount, operationsPerThread, keys);
+        runOpenRelease<ShardedMap<std::string>>("ShardedMap (32 shards)", threadsCount, operationsPerThread, keys);
+    }
+
+    return 0;
+}
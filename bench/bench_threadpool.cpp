@@ -0,0 +1,191 @@
+// ThreadPool benchmark: several producers push short keyed tasks into the work-stealing pool.
+//
+// The same workload runs against GlobalLockPool, a compact model of the previous pool design (one mutex for every
+// queue, a shuffled scan to find a non-empty queue on each pop), to keep the comparison reproducible in-tree.
+//
+// Usage: bench_threadpool [tasksPerProducer] [producers] [threads] [queues]
+
+#include "bench_common.h"
+
+#include <Mantids30/Helpers/random.h>
+#include <Mantids30/Threads/threadpool.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace Mantids30;
+
+namespace {
+
+std::atomic<uint64_t> executedTasks{0};
+
+void countTask(const std::shared_ptr<void> &)
+{
+    executedTasks.fetch_add(1, std::memory_order_relaxed);
+}
+
+class GlobalLockPool
+{
+public:
+    using TaskFunction = void (*)(const std::shared_ptr<void> &);
+
+    GlobalLockPool(uint32_t threadsCount, uint32_t taskQueues)
+        : m_threadCount(threadsCount)
+    {
+        m_random.seed(std::random_device()());
+        for (uint32_t i = 0; i < taskQueues; i++)
+            m_queues[i];
+    }
+    ~GlobalLockPool()
+    {
+        std::unique_lock<std::mutex> lk(m_queuesMutex);
+        m_terminate = true;
+        lk.unlock();
+        m_insertedElementCond.notify_all();
+        for (auto &thread : m_threads)
+            thread.join();
+    }
+
+    void start()
+    {
+        for (uint32_t i = 0; i < m_threadCount; i++)
+            m_threads.emplace_back(&GlobalLockPool::taskProcessor, this);
+    }
+
+    bool pushTask(TaskFunction task, const std::shared_ptr<void> &taskData, const float &priority, const std::string &key)
+    {
+        size_t currentQueue = getRandomQueueByKey(key, priority);
+        std::unique_lock<std::mutex> lk(m_queuesMutex);
+        if (m_terminate)
+            return false;
+        while (m_queues[currentQueue].tasks.size() > m_maxTasksPerQueue)
+            m_queues[currentQueue].cond_removedElement.wait(lk);
+        m_queues[currentQueue].tasks.push({task, taskData});
+        lk.unlock();
+        m_insertedElementCond.notify_one();
+        return true;
+    }
+
+private:
+    struct TasksQueue
+    {
+        std::queue<std::pair<TaskFunction, std::shared_ptr<void>>> tasks;
+        std::condition_variable cond_removedElement;
+    };
+
+    void taskProcessor()
+    {
+        for (;;)
+        {
+            std::unique_lock<std::mutex> lk(m_queuesMutex);
+            TasksQueue *tq;
+            while ((tq = getRandomTaskQueueWithElements()) == nullptr)
+            {
+                if (m_terminate)
+                    return;
+                m_insertedElementCond.wait(lk);
+            }
+            auto task = tq->tasks.front();
+            tq->tasks.pop();
+            lk.unlock();
+            tq->cond_removedElement.notify_one();
+            task.first(task.second);
+        }
+    }
+
+    TasksQueue *getRandomTaskQueueWithElements()
+    {
+        std::vector<size_t> fullVector;
+        for (size_t i = 0; i < m_queues.size(); ++i)
+            fullVector.push_back(i);
+        std::uniform_int_distribution<size_t> dis;
+        m_randomMutex.lock();
+        Helpers::Random::safe_random_shuffle(fullVector.begin(), fullVector.end(), dis(m_random));
+        m_randomMutex.unlock();
+        for (size_t i : fullVector)
+        {
+            if (!m_queues[i].tasks.empty())
+                return &m_queues[i];
+        }
+        return nullptr;
+    }
+
+    size_t getRandomQueueByKey(const std::string &key, const float &priority)
+    {
+        size_t elements = std::min(std::max(static_cast<size_t>(m_queues.size() * priority), static_cast<size_t>(1)), m_queues.size());
+        std::vector<size_t> fullVector;
+        for (size_t i = 0; i < m_queues.size(); ++i)
+            fullVector.push_back(i);
+        Helpers::Random::safe_random_shuffle(fullVector.begin(), fullVector.end(), m_hashFunction(key));
+        std::uniform_int_distribution<size_t> dis(0, elements - 1);
+        std::lock_guard<std::mutex> lock(m_randomMutex);
+        return fullVector[dis(m_random)];
+    }
+
+    uint32_t m_threadCount;
+    uint32_t m_maxTasksPerQueue = 100;
+    bool m_terminate = false;
+    std::vector<std::thread> m_threads;
+    std::map<size_t, TasksQueue> m_queues;
+    std::mutex m_queuesMutex;
+    std::condition_variable m_insertedElementCond;
+    std::mutex m_randomMutex;
+    std::minstd_rand0 m_random;
+    std::hash<std::string> m_hashFunction;
+};
+
+template<typename Pool, typename PushFunction>
+void runProducers(const std::string &name, Pool &pool, size_t producers, size_t tasksPerProducer, PushFunction push)
+{
+    executedTasks = 0;
+    Bench::Stopwatch stopwatch;
+    pool.start();
+
+    std::vector<std::thread> producerThreads;
+    for (size_t p = 0; p < producers; p++)
+    {
+        producerThreads.emplace_back([&pool, &push, p, tasksPerProducer]() {
+            for (size_t i = 0; i < tasksPerProducer; i++)
+                push(pool, std::make_shared<size_t>(i), "key" + std::to_string((p * tasksPerProducer + i) % 64));
+        });
+    }
+    for (auto &thread : producerThreads)
+        thread.join();
+
+    // Wait until the consumers drain the queues.
+    while (executedTasks.load() < producers * tasksPerProducer)
+        std::this_thread::yield();
+
+    Bench::report(name, producers * tasksPerProducer, stopwatch.elapsedSeconds());
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    size_t tasksPerProducer = Bench::argOrDefault(argc, argv, 1, 200000);
+    size_t producers = Bench::argOrDefault(argc, argv, 2, 4);
+    uint32_t threads = static_cast<uint32_t>(Bench::argOrDefault(argc, argv, 3, 8));
+    uint32_t queues = static_cast<uint32_t>(Bench::argOrDefault(argc, argv, 4, 6));
+
+    printf("ThreadPool push/execute: %zu producers x %zu tasks, %u threads, %u queues\n", producers, tasksPerProducer, threads, queues);
+
+    {
+        GlobalLockPool pool(threads, queues);
+        runProducers("global lock + shuffled queue scan (previous)", pool, producers, tasksPerProducer,
+                     [](GlobalLockPool &p, const std::shared_ptr<void> &data, const std::string &key) { p.pushTask(countTask, data, 0.5, key); });
+    }
+    {
+        Threads::Pool::ThreadPool pool(threads, queues);
+        runProducers("per-queue lock + work stealing (ThreadPool)", pool, producers, tasksPerProducer,
+                     [](Threads::Pool::ThreadPool &p, const std::shared_ptr<void> &data, const std::string &key) { p.pushTask(countTask, data, static_cast<uint32_t>(-1), 0.5, key); });
+    }
+
+    return 0;
+}
@@ -38,6 +38,8 @@ BuildRequires:  jsoncpp-devel
 BuildRequires:  boost-devel
 BuildRequires:  boost-static
 BuildRequires:  openssl-devel
+BuildRequires:  zlib-devel
+BuildRequires:  brotli-devel
 BuildRequires:  sqlite-devel
 BuildRequires:  postgresql-devel
 BuildRequires:  mariadb-devel
@@ -46,6 +48,8 @@ Requires:       jsoncpp
 Requires:       boost-regex
 Requires:       boost-thread
 Requires:       openssl
+Requires:       zlib
+Requires:       brotli
 # RHEL 7 specific: may need openssl11 from EPEL if using SSLRHEL7
 %if 0%{?rhel} == 7
 BuildRequires:  openssl11-devel